@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/// @file       linalg.cpp
+/// @author     João André
+///
+/// @brief      Cross-checks (and times) the external CBLAS/LAPACKE backend against the built-in kernels of
+///             storage/linalg.hpp, for GEMM, LU solves and Cholesky decompositions in single and double precision.
+///
+/// Both backends are run on the same random inputs (well conditioned: diagonally dominant for LU, B * B^T + n * I for
+/// Cholesky), and the maximum difference between their outputs, relative to the largest output magnitude, is checked
+/// against tolerance(n) = 64 * n * epsilon. The backends differ only in accumulation order, i.e. differences are
+/// rounding errors, bounded by n * epsilon (times a small constant for well conditioned systems).
+///
+/// Usage: bench_linalg [size = 256]. Returns EXIT_FAILURE if any difference exceeds its tolerance.
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "storage/linalg.hpp"
+
+#ifndef CPP_UTILS_USE_BLAS
+#error "bench_linalg requires the external backend (cpp_utils_USE_BLAS)"
+#endif
+
+//------------------------------------------------------------------------------
+/// @brief      Maximum difference of *a* & *b*, relative to the largest magnitude in *b*.
+///
+template < typename T >
+double difference(const std::matrix< T >& a, const std::matrix< T >& b) {
+    double error = 0.0;
+    double scale = 0.0;
+    for (size_t i = 0; i < a.rows() * a.cols(); i++) {
+        error = std::max(error, std::fabs(double(a.data()[i]) - double(b.data()[i])));
+        scale = std::max(scale, std::fabs(double(b.data()[i])));
+    }
+    return (scale > 0.0) ? error / scale : error;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Wall time (ms) of *function()*.
+///
+template < typename Function >
+double elapsed(Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Reports comparison, returning false if *error* exceeds *tolerance*.
+///
+bool report(const char* type, const char* routine, double external, double builtin, double error, double tolerance) {
+    bool pass = error <= tolerance;
+    std::printf("%-7s %-9s external %9.3f ms   built-in %9.3f ms   max difference %.3e (tolerance %.3e)  %s\n", type, routine, external, builtin, error, tolerance, pass ? "OK" : "FAILED");
+    return pass;
+}
+
+template < typename T >
+bool compare(size_t n, const char* type) {
+    using std::matrix;
+    using std::matrix_view;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution< double > uniform(-1.0, 1.0);
+    auto view = [](matrix< T >& m) { return matrix_view< T >(m.data(), m.rows(), m.cols()); };
+    auto cview = [](const matrix< T >& m) { return matrix_view< const T >(m.data(), m.rows(), m.cols()); };
+    double tolerance = 64.0 * n * std::numeric_limits< T >::epsilon();
+    size_t nrhs = 8;
+    bool pass = true;
+
+    // GEMM
+    matrix< T > a(n, n);
+    matrix< T > b(n, n);
+    for (size_t i = 0; i < n * n; i++) {
+        a.data()[i] = T(uniform(generator));
+        b.data()[i] = T(uniform(generator));
+    }
+    matrix< T > c_external(n, n);
+    matrix< T > c_builtin(n, n);
+    double t_external = elapsed([&] { std::linalg::gemm(T(1), cview(a), cview(b), T(0), view(c_external)); });
+    double t_builtin = elapsed([&] { std::linalg::details::gemm(T(1), cview(a), cview(b), T(0), view(c_builtin), std::work_stealing_pool::instance()); });
+    pass &= report(type, "gemm", t_external, t_builtin, difference(c_external, c_builtin), tolerance);
+
+    // LU solve (diagonally dominant system)
+    for (size_t i = 0; i < n; i++) {
+        a(i, i) += T(n);
+    }
+    matrix< T > rhs(n, nrhs);
+    for (size_t i = 0; i < n * nrhs; i++) {
+        rhs.data()[i] = T(uniform(generator));
+    }
+    matrix< T > lu_external(a);
+    matrix< T > lu_builtin(a);
+    matrix< T > x_external(rhs);
+    matrix< T > x_builtin(rhs);
+    std::vector< size_t > p_external;
+    std::vector< size_t > p_builtin;
+    t_external = elapsed([&] {
+        std::linalg::lu_factor(view(lu_external), p_external);
+        std::linalg::lu_solve(cview(lu_external), p_external, view(x_external));
+    });
+    t_builtin = elapsed([&] {
+        std::linalg::details::lu_factor(view(lu_builtin), p_builtin, std::work_stealing_pool::instance());
+        std::linalg::details::lu_solve(cview(lu_builtin), p_builtin, view(x_builtin));
+    });
+    pass &= report(type, "lu_solve", t_external, t_builtin, difference(x_external, x_builtin), tolerance);
+
+    // Cholesky (B * B^T + n * I, i.e. exactly symmetric & positive definite)
+    matrix< T > bt(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            bt(j, i) = b(i, j);
+        }
+    }
+    matrix< T > spd(n, n);
+    std::linalg::details::gemm(T(1), cview(b), cview(bt), T(0), view(spd), std::work_stealing_pool::instance());
+    for (size_t i = 0; i < n; i++) {
+        spd(i, i) += T(n);
+    }
+    matrix< T > l_external(spd);
+    matrix< T > l_builtin(spd);
+    t_external = elapsed([&] { std::linalg::cholesky_factor(view(l_external)); });
+    t_builtin = elapsed([&] { std::linalg::details::cholesky_factor(view(l_builtin), std::work_stealing_pool::instance()); });
+    pass &= report(type, "cholesky", t_external, t_builtin, difference(l_external, l_builtin), tolerance);
+    return pass;
+}
+
+int main(int argc, char** argv) {
+    size_t n = (argc > 1) ? std::stoul(argv[1]) : 256;
+    bool pass = compare< float >(n, "float");
+    pass &= compare< double >(n, "double");
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -9,6 +9,12 @@
 #include <algorithm>
 #include <numeric>
 #include <cassert>
+#include "storage/argsort.hpp"
+#include "storage/blas.hpp"
+#include "storage/summation.hpp"
+#include "storage/resample.hpp"
+#include "storage/similarity.hpp"
+#include "storage/view.hpp"
 
 namespace math {
 
@@ -55,11 +61,7 @@ inline size_t ndigits(size_t value) {
 /// @return     Norm of the data array (||data||).
 ///
 inline double norm(const double * data, const int N) {
-    double n = 0.0;
-    for (int i = 0; i < N; ++i) {
-        n += pow(data[i], 2);
-    }
-    return sqrt(n);
+    return std::blas::nrm2(std::matrix_view< const double >(data, 1, N));
 }
 
 
@@ -78,25 +80,18 @@ inline std::vector< double > normalize(const std::vector< double >& data, const
     double max;
     double min;
     if (bounds.empty()) {
-        min = data[0];
-        max = data[0];
-        for (int idx = 1; idx < data.size(); idx++) {
-            if (data[idx] > max) {
-                max = data[idx];
-            }
-            else if (data[idx] < min) {
-                min = data[idx];
-            }
-        }
+        auto minmax = std::minmax_element(data.begin(), data.end());
+        min = *minmax.first;
+        max = *minmax.second;
     } else {
         min = bounds[0];
         max = bounds[1];
     }
 
-    double range = max - min;
+    double scale = 1.0 / (max - min);
     std::vector< double > normalized(data.size());
-    for (int idx = 1; idx < data.size(); idx++) {
-        normalized[idx] =  (data[idx] - min) / (range);
+    for (size_t idx = 0; idx < data.size(); idx++) {
+        normalized[idx] = (data[idx] - min) * scale;
     }
 
     return normalized;
@@ -111,16 +106,13 @@ inline std::vector< double > normalize(const std::vector< double >& data, const
 ///
 /// @return     Value of the RMSD metric between input vectors.
 ///
+/// @note       Lock-step distance, cf. std::similarity (storage/similarity.hpp) for DTW & subsequence search.
+///
 inline double rmsd(const std::vector< double >& data, const std::vector< double >& reference) {
     if (data.size() != reference.size()) {
         throw std::invalid_argument(std::string(__func__) + ": data and reference containers must have same size.");
     }
-    double rmsd = 0.0;
-    for (size_t idx = 0; idx < data.size(); idx++) {
-        rmsd += sqrt(pow(data[idx] - reference[idx], 2));
-        // rmsd += pow(data[idx] - reference[idx], 2);
-    }
-    return rmsd;
+    return std::similarity::euclidean(data, reference);
 }
 
 
@@ -188,27 +180,42 @@ void mean_filter(const std::vector< T >& ref, const std::vector< T >& input, siz
             out[i] = lw * input[i-1] + hw * input[i+1];
         }
     } else if (filter_type == 2) {  // method 2 (large variable window)
+        // inverse distance weights of the wsize neighbours on each side (centre sample excluded)
         size_t wsize = 20;
-        T dtotal = 0.0;
-        // std::vector<float> f2y (ref.size(),0.0);
-        std::vector< T > lws(wsize, 0.0);
-        std::vector< T > hws(wsize, 0.0);
-        for (int i = 0; i < wsize; ++i) {
+        size_t n = input.size();
+        if (n <= 2 * wsize) {
+            out = input;
+            return;
+        }
+        for (size_t i = 0; i < wsize; ++i) {
             out[i] = input[i];
-            out[out.size()-1-i] = input[input.size()-1-i];
+            out[n - 1 - i] = input[n - 1 - i];
+        }
+        // uniform spacing -> constant kernel, computed once
+        T step = ref[1] - ref[0];
+        bool uniform = true;
+        for (size_t i = 1; i < n && uniform; ++i) {
+            uniform = (abs((ref[i] - ref[i - 1]) - step) <= 1e-6 * abs(step));
         }
-        for (int i = wsize; i < ref.size()-wsize; ++i) {
-            // compute distances
-            for (int j = 0; j < lws.size(); ++j) {
-                lws[j] = 1.0 / abs(ref[i-wsize+j]-ref[i]);
-                hws[j] = 1.0 / abs(ref[i+wsize-j]-ref[i]);
-                dtotal += (lws[j] + hws[j]);
+        std::vector< T > kernel(wsize, 0.0);
+        T ktotal = 0.0;
+        if (uniform) {
+            for (size_t j = 0; j < wsize; ++j) {
+                kernel[j] = 1.0 / abs(static_cast< T >(wsize - j) * step);
+                ktotal += 2.0 * kernel[j];
             }
-            // compute value
-            for (int j = 0; j < lws.size(); ++j) {
-                out[i] += (lws[j] / dtotal) * input[i-wsize+j] + (hws[j]/dtotal) * input[i+wsize-j];
+        }
+        for (size_t i = wsize; i < n - wsize; ++i) {
+            // single pass: weighted sum & total weight, normalized once per sample
+            T sum = 0.0;
+            T dtotal = 0.0;
+            for (size_t j = 0; j < wsize; ++j) {
+                T lw = uniform ? kernel[j] : 1.0 / abs(ref[i - wsize + j] - ref[i]);
+                T hw = uniform ? kernel[j] : 1.0 / abs(ref[i + wsize - j] - ref[i]);
+                sum += lw * input[i - wsize + j] + hw * input[i + wsize - j];
+                dtotal += lw + hw;
             }
-            dtotal = 0.0;
+            out[i] = sum / (uniform ? ktotal : dtotal);
         }
     }
 }
@@ -233,7 +240,7 @@ std::vector< T > mean_filter(const std::vector< T >& ref, const std::vector< T >
 
 //------------------------------------------------------------------------------
 /// @brief      Sorts *input* data & returns the sorted indexes.
-///             Wraps around std::sort();
+///             Wraps around std::argsort() i.e. radix sort for numeric types, parallel merge sort otherwise.
 ///
 /// @param[in]  input  Input data to sort
 /// @param[out] idx    Output container for sorted indexes.
@@ -242,15 +249,12 @@ std::vector< T > mean_filter(const std::vector< T >& ref, const std::vector< T >
 ///
 template <typename T >
 void sort(const std::vector< T >& input, std::vector< size_t >& idx) {
-    idx.assign(input.size(), 0);
-    std::iota(idx.begin(), idx.end(), 0);
-    // sort indexes based on comparing values in v
-    std::sort(idx.begin(), idx.end(), [ &input ](size_t i1, size_t i2) { return input[i1] < input[i2]; });
+    idx = std::argsort(input);
 }
 
 //------------------------------------------------------------------------------
 /// @brief      Sorts *input* data & returns the sorted indexes (inline initialization overload).
-///             Wraps around std::sort();
+///             Wraps around std::argsort();
 ///
 /// @param[in]  input  Input data to sort
 ///
@@ -264,62 +268,34 @@ std::vector< size_t > sort(const std::vector< T >& input) {
 }
 
 
+//------------------------------------------------------------------------------
+/// @brief      Linearly resamples (x, y) samples onto a new x reference, cf. storage/resample.hpp for multi-channel and
+///             reusable resampling plans.
+///
+/// @param[in]  _inputRefs   Input x-values (strictly increasing).
+/// @param[in]  _inputVals   Input y-values.
+/// @param[in]  _outputRefs  Output x-values.
+/// @param[in]  _periodic    Periodic flag. If true, input is assumed to span one period (of uniform mean spacing,
+///                          i.e. period = (x.back() - x.front()) * N / (N - 1)), otherwise values outside input range
+///                          are linearly extrapolated.
+/// @param[out] _outputVals  Output y-values.
+///
+/// @throws     std::invalid_argument if input x-values are not strictly increasing.
+///
 template < typename _t >
 void ref_resample(const std::vector<_t>& _inputRefs, const std::vector<_t>& _inputVals, const std::vector<_t>& _outputRefs, bool _periodic, std::vector<_t>& _outputVals){
     assert(_inputRefs.size()==_inputVals.size());
-    int prev_size=_inputVals.size();
-    int new_size=_outputRefs.size();
+    size_t prev_size=_inputVals.size();
+    size_t new_size=_outputRefs.size();
     if (new_size>1 && prev_size>0 && _inputRefs.size()==prev_size) {
-        _outputVals.assign(new_size,0.0);
-        float step=prev_size/new_size;
-
-        int j = 0;
-        for (int i = 0; i < new_size; ++i){
-            float slope = 0.0;
-            // int j = 0; // assumes input values sorted by reference, in order to speed up
-            while (_inputRefs[j]<_outputRefs[i] && j<prev_size) j++;
-
-            // if (j>0) printf("%d : %d\t%f : %f (%f) -> ",i,j,_outputRefs[i],_inputRefs[j],_inputRefs[j-1]);
-            // else printf("%d : %d\t%f : %f -> ",i,j,_outputRefs[i],_inputRefs[j]);
-
-            if (_outputRefs[i]==_inputRefs[j]) {
-                // exact match between old and new reference - value is copied
-                _outputVals[i]=_inputVals[j];
-                // printf("1\n");
-                continue;
-            }
-            else if (j == prev_size) {
-                // all input references are smaller than desired output reference
-                // last 2 input values are used to compute slope
-                if (_periodic){
-                    slope = (_inputVals[0]-_inputVals[prev_size-1])/(_inputRefs[0]-_inputRefs[prev_size-1]);
-                } else {
-                    slope = (_inputVals[prev_size-1]-_inputVals[prev_size-2])/(_inputRefs[prev_size-1]-_inputRefs[prev_size-2]);
-                }
-                // compute & populate new values
-                _outputVals[i] = _inputVals.back() + slope * (_outputRefs[i]-_inputRefs.back());
-                // printf("2\n");
-            }
-            else if (j == 0) {
-                // all input references are greater than the desired output reference
-                // first 2 input values are used to compute slope
-                if (_periodic){
-                    slope = (_inputVals[0]-_inputVals[prev_size-1])/(_inputRefs[0]-_inputRefs[prev_size-1]);
-                } else {
-                    slope = (_inputVals[1]-_inputVals[0])/(_inputRefs[1]-_inputRefs[0]);
-                }
-                // compute & populate new values
-                _outputVals[i] = _inputVals[0] + slope * (_outputRefs[i]-_inputRefs[0]);
-                // printf("3\n");
-            }
-            else {
-                // output reference falls between 2 input references
-                slope = (_inputVals[j]-_inputVals[j-1])/(_inputRefs[j]-_inputRefs[j-1]);
-                // compute & populate new values
-                _outputVals[i] = _inputVals[j-1] + slope * (_outputRefs[i]-_inputRefs[j-1]);
-                // printf("4\n");
-            }
+        typedef typename std::conditional< std::is_floating_point< _t >::value, _t, double >::type ref_type;
+        std::vector< ref_type > from(_inputRefs.begin(), _inputRefs.end());
+        std::vector< ref_type > to(_outputRefs.begin(), _outputRefs.end());
+        ref_type period = 0;
+        if (_periodic && prev_size > 1) {
+            period = (from.back() - from.front()) * prev_size / (prev_size - 1);
         }
+        _outputVals = std::resampling::plan< ref_type >(from, to, std::resampling::method::linear, period).apply(_inputVals);
     }
 }
 
@@ -426,12 +402,7 @@ std::vector< T > interpolate(const std::vector< T >& x, const std::vector< T >&
 ///
 template < typename T = double >
 double average(const std::vector< T >& data) {
-    double avg = 0.0;
-    double w = 1.0 / data.size();
-    for (const auto& sample : data) {
-        avg += (w * sample);
-    }
-    return avg;
+    return std::summation::mean(data);
 }
 
 
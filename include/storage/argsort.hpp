@@ -0,0 +1,373 @@
+//------------------------------------------------------------------------------
+/// @file       argsort.hpp
+/// @author     João André
+///
+/// @brief      Argsort engine for generic storage containers (e.g. std::vector, std::matrix, std::volume and their subsets),
+///             i.e. computes the permutation of positions that sorts the container elements.
+///
+/// Keys are first copied next to their positions, so that sorting works on contiguous (key, position) data rather than
+/// through an indirect comparison on the source container. Integer and floating point keys are sorted with a parallel
+/// LSD radix sort (8-bit digits, per-chunk histograms, passes skipped when all keys share a digit). Other key types, or
+/// custom comparisons, are sorted with a parallel merge sort: chunks are sorted independently and then merged pairwise,
+/// each merge being split into independent segments (merge path partitioning) so that all workers remain busy up to the
+/// final merge. Positions are stored as 32-bit integers whenever the container size allows it, halving memory traffic.
+///
+/// @note       Radix sort is always stable. Merge sort is stable if requested (otherwise chunks are sorted with std::sort).
+///
+/// @note       Floating point keys are ordered as per operator<, with -0.0 == 0.0 and all NaN values placed last.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_ARGSORT_HPP_
+#define STORAGE_INCLUDE_STORAGE_ARGSORT_HPP_
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "storage/type_check.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace sorting {
+
+//------------------------------------------------------------------------------
+/// @brief      Number of bits per radix digit.
+///
+constexpr size_t radix_bits = 8;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of elements per chunk; smaller inputs are sorted by a single worker.
+///
+constexpr size_t min_chunk = 1 << 14;
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Maps keys of type T into unsigned integers with the same ordering (radix sortable keys).
+///
+/// @tparam     T     Key type. Specializations provide *key_type* and *encode()* for integral and IEEE 754 types.
+///
+template < typename T, typename = void >
+struct radix_traits {
+    static constexpr bool enabled = false;
+};
+
+template < typename T >
+struct radix_traits< T, typename enable_if< is_integral< T >::value && !is_same< T, bool >::value >::type > {
+    static constexpr bool enabled = true;
+    typedef typename make_unsigned< T >::type key_type;
+    static key_type encode(T value) {
+        // flip sign bit of signed types, so that negative values come first
+        constexpr key_type sign = is_signed< T >::value ? key_type(key_type(1) << (8 * sizeof(T) - 1)) : key_type(0);
+        return key_type(static_cast< key_type >(value) ^ sign);
+    }
+};
+
+template < typename T >
+struct radix_traits< T, typename enable_if< is_floating_point< T >::value && numeric_limits< T >::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8) >::type > {
+    static constexpr bool enabled = true;
+    typedef typename conditional< sizeof(T) == 4, uint32_t, uint64_t >::type key_type;
+    static key_type encode(T value) {
+        constexpr key_type sign = key_type(1) << (8 * sizeof(T) - 1);
+        if (value != value) {
+            value = numeric_limits< T >::quiet_NaN();  // canonical (positive) NaN, i.e. last
+        } else if (value == T(0)) {
+            value = T(0);  // -0.0 == 0.0
+        }
+        key_type bits;
+        memcpy(&bits, &value, sizeof(T));
+        // negative values: all bits flipped (reverse order); positive values: sign bit set
+        return (bits & sign) ? key_type(~bits) : key_type(bits | sign);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Computes number of chunks for *n* elements.
+///
+size_t chunks(size_t n, const work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Sorts *keys* (and *pos* along with them) with a parallel LSD radix sort.
+///
+/// @param      keys  Encoded keys.
+/// @param      pos   Positions.
+/// @param      pool  Thread pool.
+///
+/// @tparam     K     Encoded key type (unsigned integer).
+/// @tparam     I     Position type.
+///
+template < typename K, typename I >
+void radix_sort(vector< K >& keys, vector< I >& pos, work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Merge path partitioning: number of elements of *a* among the first *d* elements of the (stable) merge of *a* and *b*.
+///
+template < typename It, typename Compare >
+size_t merge_path(It a, size_t na, It b, size_t nb, size_t d, Compare comp);
+
+//------------------------------------------------------------------------------
+/// @brief      Sorts (key, position) *items* with a parallel merge sort.
+///
+/// @param      items   Key/position pairs.
+/// @param[in]  comp    Key comparison.
+/// @param[in]  stable  Whether equal keys keep their relative order.
+/// @param      pool    Thread pool.
+///
+template < typename T, typename I, typename Compare >
+void merge_sort(vector< pair< T, I > >& items, Compare comp, bool stable, work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Argsort implementation, for given position type.
+///
+template < typename I, typename Container, typename Compare >
+vector< size_t > argsort(const Container& container, Compare comp, bool radix, bool stable, work_stealing_pool& pool);
+
+}  // namespace details
+}  // namespace sorting
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Computes the positions that sort *container* in ascending order (i.e. container[idx[0]] <= container[idx[1]] ...).
+///
+/// @param[in]  container  Input container (e.g. std::vector, std::matrix, std::volume, storage::st_subset_base).
+/// @param[in]  stable     Whether equal elements keep their relative order. Defaults to false. Ignored for arithmetic types (always stable).
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     Container  Container type, requiring size() and operator[](size_t).
+///
+/// @return     Sorted positions, i.e. indexes in [0, container.size()).
+///
+template < typename Container >
+vector< size_t > argsort(const Container& container, bool stable = false, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Computes the positions that sort *container* w/ a custom comparison (merge sort).
+///
+/// @param[in]  container  Input container.
+/// @param[in]  comp       Comparison callable, with signature bool(const value_type&, const value_type&).
+/// @param[in]  stable     Whether equal elements keep their relative order. Defaults to false.
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     Container  Container type, requiring size() and operator[](size_t).
+/// @tparam     Compare    Comparison type.
+///
+/// @return     Sorted positions.
+///
+template < typename Container, typename Compare, typename = typename enable_if< !is_same< typename decay< Compare >::type, bool >::value >::type >
+vector< size_t > argsort(const Container& container, Compare comp, bool stable = false, work_stealing_pool& pool = work_stealing_pool::instance());
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+inline size_t sorting::details::chunks(size_t n, const work_stealing_pool& pool) {
+    return max< size_t >(1, min(pool.size() * parallel::chunks_per_worker, n / sorting::min_chunk));
+}
+
+
+
+template < typename K, typename I >
+void sorting::details::radix_sort(vector< K >& keys, vector< I >& pos, work_stealing_pool& pool) {
+    constexpr size_t n_buckets = size_t(1) << sorting::radix_bits;
+    size_t n = keys.size();
+    size_t n_chunks = chunks(n, pool);
+    vector< K > keys_buffer(n);
+    vector< I > pos_buffer(n);
+    vector< array< size_t, n_buckets > > histograms(n_chunks);
+    for (size_t shift = 0; shift < 8 * sizeof(K); shift += sorting::radix_bits) {
+        // per-chunk digit histograms
+        pool.run(n_chunks, [&](size_t chunk) {
+            auto& histogram = histograms[chunk];
+            histogram.fill(0);
+            for (size_t i = (n * chunk) / n_chunks; i < (n * (chunk + 1)) / n_chunks; i++) {
+                histogram[(keys[i] >> shift) & (n_buckets - 1)]++;
+            }
+        });
+        // skip pass if all keys share the same digit
+        bool trivial = false;
+        for (size_t digit = 0; digit < n_buckets && !trivial; digit++) {
+            size_t total = 0;
+            for (const auto& histogram : histograms) {
+                total += histogram[digit];
+            }
+            trivial = (total == n);
+        }
+        if (trivial) {
+            continue;
+        }
+        // exclusive prefix sum, digit-major & chunk-minor (preserves order of equal digits, i.e. stable)
+        size_t offset = 0;
+        for (size_t digit = 0; digit < n_buckets; digit++) {
+            for (auto& histogram : histograms) {
+                size_t count = histogram[digit];
+                histogram[digit] = offset;
+                offset += count;
+            }
+        }
+        // scatter
+        pool.run(n_chunks, [&](size_t chunk) {
+            auto& histogram = histograms[chunk];
+            for (size_t i = (n * chunk) / n_chunks; i < (n * (chunk + 1)) / n_chunks; i++) {
+                size_t dst = histogram[(keys[i] >> shift) & (n_buckets - 1)]++;
+                keys_buffer[dst] = keys[i];
+                pos_buffer[dst] = pos[i];
+            }
+        });
+        keys.swap(keys_buffer);
+        pos.swap(pos_buffer);
+    }
+}
+
+
+
+template < typename It, typename Compare >
+size_t sorting::details::merge_path(It a, size_t na, It b, size_t nb, size_t d, Compare comp) {
+    size_t lo = (d > nb) ? d - nb : 0;
+    size_t hi = min(d, na);
+    while (lo < hi) {
+        size_t i = (lo + hi) / 2;
+        // a[i] is merged before b[d - i - 1] (ties favour a, i.e. stable): more elements of a are required
+        if (!comp(b[d - i - 1], a[i])) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+
+
+template < typename T, typename I, typename Compare >
+void sorting::details::merge_sort(vector< pair< T, I > >& items, Compare comp, bool stable, work_stealing_pool& pool) {
+    typedef pair< T, I > item_type;
+    auto item_comp = [&comp](const item_type& lhs, const item_type& rhs) { return comp(lhs.first, rhs.first); };
+    size_t n = items.size();
+    size_t n_chunks = chunks(n, pool);
+    // sort runs independently
+    vector< size_t > bounds(n_chunks + 1);
+    for (size_t chunk = 0; chunk <= n_chunks; chunk++) {
+        bounds[chunk] = (n * chunk) / n_chunks;
+    }
+    pool.run(n_chunks, [&](size_t chunk) {
+        if (stable) {
+            std::stable_sort(items.begin() + bounds[chunk], items.begin() + bounds[chunk + 1], item_comp);
+        } else {
+            std::sort(items.begin() + bounds[chunk], items.begin() + bounds[chunk + 1], item_comp);
+        }
+    });
+    if (n_chunks == 1) {
+        return;
+    }
+    // merge runs pairwise, splitting each merge into segments of (roughly) equal output size
+    vector< item_type > buffer(items);
+    while (bounds.size() > 2) {
+        size_t n_runs = bounds.size() - 1;
+        size_t n_pairs = (n_runs + 1) / 2;
+        size_t n_segments = max< size_t >(1, n_chunks / n_pairs);
+        pool.run(n_pairs * n_segments, [&](size_t task) {
+            size_t p = task / n_segments;
+            size_t s = task % n_segments;
+            size_t first = bounds[2 * p];
+            size_t middle = bounds[min(2 * p + 1, n_runs)];
+            size_t last = bounds[min(2 * p + 2, n_runs)];
+            auto a = items.begin() + first;
+            auto b = items.begin() + middle;
+            size_t na = middle - first;
+            size_t nb = last - middle;
+            size_t d0 = ((na + nb) * s) / n_segments;
+            size_t d1 = ((na + nb) * (s + 1)) / n_segments;
+            size_t i0 = merge_path(a, na, b, nb, d0, item_comp);
+            size_t i1 = merge_path(a, na, b, nb, d1, item_comp);
+            std::merge(a + i0, a + i1, b + (d0 - i0), b + (d1 - i1), buffer.begin() + first + d0, item_comp);
+        });
+        items.swap(buffer);
+        vector< size_t > merged;
+        for (size_t r = 0; r < bounds.size(); r += 2) {
+            merged.push_back(bounds[r]);
+        }
+        if (merged.back() != n) {
+            merged.push_back(n);
+        }
+        bounds.swap(merged);
+    }
+}
+
+
+
+template < typename I, typename Container, typename Compare >
+vector< size_t > sorting::details::argsort(const Container& container, Compare comp, bool radix, bool stable, work_stealing_pool& pool) {
+    typedef typename decay< decltype(container[0]) >::type value_type;
+    size_t n = container.size();
+    size_t grain = sorting::min_chunk;
+    vector< size_t > out(n);
+    if constexpr (radix_traits< value_type >::enabled) {
+        if (radix) {
+            typedef typename radix_traits< value_type >::key_type key_type;
+            vector< key_type > keys(n);
+            vector< I > pos(n);
+            parallel_for(0, n, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; i++) {
+                    keys[i] = radix_traits< value_type >::encode(container[i]);
+                    pos[i] = static_cast< I >(i);
+                }
+            }, grain, pool);
+            radix_sort(keys, pos, pool);
+            parallel_for(0, n, [&](size_t first, size_t last) {
+                std::copy(pos.begin() + first, pos.begin() + last, out.begin() + first);
+            }, grain, pool);
+            return out;
+        }
+    }
+    vector< pair< value_type, I > > items;
+    items.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        items.emplace_back(container[i], static_cast< I >(i));
+    }
+    merge_sort(items, comp, stable, pool);
+    parallel_for(0, n, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            out[i] = items[i].second;
+        }
+    }, grain, pool);
+    return out;
+}
+
+
+
+template < typename Container >
+vector< size_t > argsort(const Container& container, bool stable, work_stealing_pool& pool) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    if (container.size() <= numeric_limits< uint32_t >::max()) {
+        return sorting::details::argsort< uint32_t >(container, less<>(), true, stable, pool);
+    }
+    return sorting::details::argsort< size_t >(container, less<>(), true, stable, pool);
+}
+
+
+
+template < typename Container, typename Compare, typename >
+vector< size_t > argsort(const Container& container, Compare comp, bool stable, work_stealing_pool& pool) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    if (container.size() <= numeric_limits< uint32_t >::max()) {
+        return sorting::details::argsort< uint32_t >(container, comp, false, stable, pool);
+    }
+    return sorting::details::argsort< size_t >(container, comp, false, stable, pool);
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_ARGSORT_HPP_
@@ -0,0 +1,452 @@
+//------------------------------------------------------------------------------
+/// @file       blas.hpp
+/// @author     João André
+///
+/// @brief      BLAS level-1 kernels (dot, axpy, axpby, scal, nrm2, asum, iamax) for generic storage containers,
+///             e.g. std::vector, std::matrix, matrix/volume views, and container subsets (e.g. matrix rows and columns).
+///
+/// Operands are resolved once per call into either a (pointer, stride) accessor or, for arbitrary subsets, an indexed
+/// accessor. Contiguous containers and subsets whose positions form an arithmetic progression (e.g. matrix rows, columns
+/// and diagonals) are thus processed without index lookups, with unit-stride loops auto-vectorized by the compiler.
+/// Reductions are unrolled over independent accumulators, breaking the loop-carried dependency on a single sum, and use
+/// fused multiply-add where the target provides it in hardware (FP_FAST_FMA).
+///
+/// @note       Operands must have the same size (asserted).
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_BLAS_HPP_
+#define STORAGE_INCLUDE_STORAGE_BLAS_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include "storage/type_check.hpp"
+
+namespace std {
+namespace blas {
+
+//------------------------------------------------------------------------------
+/// @brief      Number of independent accumulators in reductions.
+///
+constexpr size_t accumulators = 4;
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Floating point type used for results of norms/absolute sums of *T* values (double for integer types).
+///
+template < typename T >
+using real_t = typename conditional< is_floating_point< T >::value, T, double >::type;
+
+//------------------------------------------------------------------------------
+/// @brief      Element type of container *C*, w/ constness.
+///
+template < typename C >
+using element_t = typename remove_reference< decltype(declval< C& >()[0]) >::type;
+
+//------------------------------------------------------------------------------
+/// @brief      Checks if container *C* provides a pointer to contiguous storage (i.e. data() returning a pointer).
+///
+template < typename C, typename = void >
+struct has_pointer : false_type {};
+
+template < typename C >
+struct has_pointer< C, typename enable_if< is_pointer< decltype(declval< C& >().data()) >::value >::type > : true_type {};
+
+//------------------------------------------------------------------------------
+/// @brief      Checks if container *C* is a subset i.e. provides source() and index().
+///
+template < typename C, typename = void >
+struct is_subset : false_type {};
+
+template < typename C >
+struct is_subset< C, decltype(void(declval< C& >().source()), void(declval< C& >().index())) > : true_type {};
+
+//------------------------------------------------------------------------------
+/// @brief      Strided accessor, i.e. element *i* @ ptr[i * stride].
+///
+template < typename T >
+struct strided {
+    T* ptr;
+    ptrdiff_t stride;
+    T& operator[](size_t i) const { return ptr[static_cast< ptrdiff_t >(i) * stride]; }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Indexed accessor, i.e. element *i* @ container[i].
+///
+template < typename C >
+struct indexed {
+    C* container;
+    element_t< C >& operator[](size_t i) const { return (*container)[i]; }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Resolves *container* into the fastest available accessor and invokes *function* with it.
+///
+/// @param      container  Input container.
+/// @param      function   Callable taking an accessor (strided<> or indexed<>).
+///
+/// @return     Value returned by *function*.
+///
+template < typename C, typename Function >
+auto dispatch(C& container, Function&& function);
+
+//------------------------------------------------------------------------------
+/// @brief      Fused multiply-add (a * b + c), w/ a single rounding when supported in hardware.
+///
+template < typename T >
+T fmadd(T a, T b, T c);
+
+//------------------------------------------------------------------------------
+/// @brief      Sum of squares of (x - y) scaled by 1 / *scale* (y ignored if null accessor).
+///
+template < typename R, typename X, typename Y >
+R scaled_squares(const X& x, const Y* y, size_t n, R scale);
+
+//------------------------------------------------------------------------------
+/// @brief      Overflow/underflow safe Euclidean norm of x (or x - y if *y* is non-null).
+///
+template < typename R, typename X, typename Y >
+R nrm2(const X& x, const Y* y, size_t n);
+
+}  // namespace details
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Dot product of *x* and *y*.
+///
+/// @param[in]  x     First operand.
+/// @param[in]  y     Second operand.
+///
+/// @return     sum(x[i] * y[i]).
+///
+template < typename X, typename Y >
+auto dot(const X& x, const Y& y);
+
+//------------------------------------------------------------------------------
+/// @brief      Scaled addition, y = alpha * x + y.
+///
+/// @param[in]  alpha  Scale factor.
+/// @param[in]  x      Input operand.
+/// @param      y      Input/output operand (can be a temporary subset e.g. mat.row(0)).
+///
+template < typename A, typename X, typename Y >
+void axpy(const A& alpha, const X& x, Y&& y);
+
+//------------------------------------------------------------------------------
+/// @brief      Scaled addition, y = alpha * x + beta * y.
+///
+/// @param[in]  alpha  Scale factor of *x*.
+/// @param[in]  x      Input operand.
+/// @param[in]  beta   Scale factor of *y*.
+/// @param      y      Input/output operand (can be a temporary subset e.g. mat.row(0)).
+///
+template < typename A, typename X, typename B, typename Y >
+void axpby(const A& alpha, const X& x, const B& beta, Y&& y);
+
+//------------------------------------------------------------------------------
+/// @brief      Scaling, x = alpha * x.
+///
+/// @param[in]  alpha  Scale factor.
+/// @param      x      Input/output operand (can be a temporary subset e.g. mat.col(0)).
+///
+template < typename A, typename X >
+void scal(const A& alpha, X&& x);
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean norm of *x*, i.e. sqrt(sum(x[i]^2)).
+///
+/// @note       Safe against intermediate overflow/underflow: falls back to a scaled sum of squares when the plain sum is not
+///             representable, e.g. for values above sqrt(numeric_limits<T>::max()).
+///
+/// @param[in]  x     Input operand.
+///
+/// @return     Norm (floating point; double for integer types).
+///
+template < typename X >
+auto nrm2(const X& x);
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean distance between *x* and *y*, i.e. nrm2(x - y), without a temporary container.
+///
+/// @param[in]  x     First operand.
+/// @param[in]  y     Second operand.
+///
+/// @return     Distance (floating point; double for integer types).
+///
+template < typename X, typename Y >
+auto dist(const X& x, const Y& y);
+
+//------------------------------------------------------------------------------
+/// @brief      Sum of absolute values of *x*.
+///
+/// @param[in]  x     Input operand.
+///
+/// @return     sum(|x[i]|) (floating point; double for integer types).
+///
+template < typename X >
+auto asum(const X& x);
+
+//------------------------------------------------------------------------------
+/// @brief      Position of the element of *x* with largest absolute value (first one, if repeated).
+///
+/// @param[in]  x     Input operand.
+///
+/// @return     Position within *x* (0 if empty).
+///
+template < typename X >
+size_t iamax(const X& x);
+
+}  // namespace blas
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename C, typename Function >
+auto blas::details::dispatch(C& container, Function&& function) {
+    typedef element_t< C > value_type;
+    if constexpr (has_pointer< C >::value) {
+        return function(strided< value_type >{ container.data(), 1 });
+    } else {
+        if constexpr (is_subset< C >::value) {
+            typedef typename remove_pointer< decltype(container.source()) >::type source_type;
+            if constexpr (has_pointer< source_type >::value) {
+                // subsets w/ evenly spaced positions (e.g. rows, columns) are accessed directly
+                const auto& idx = container.index();
+                size_t n = idx.size();
+                ptrdiff_t stride = (n > 1) ? static_cast< ptrdiff_t >(idx[1]) - static_cast< ptrdiff_t >(idx[0]) : 1;
+                bool regular = (n > 0);
+                for (size_t i = 1; i < n; i++) {
+                    regular &= (static_cast< ptrdiff_t >(idx[i]) - static_cast< ptrdiff_t >(idx[i - 1]) == stride);
+                }
+                if (regular) {
+                    return function(strided< value_type >{ container.source()->data() + idx[0], stride });
+                }
+            }
+        }
+        return function(indexed< C >{ &container });
+    }
+}
+
+
+
+template < typename T >
+T blas::details::fmadd(T a, T b, T c) {
+#if defined(FP_FAST_FMA) && defined(FP_FAST_FMAF)
+    if constexpr (is_floating_point< T >::value) {
+        return std::fma(a, b, c);
+    }
+#endif
+    return a * b + c;
+}
+
+
+
+template < typename R, typename X, typename Y >
+R blas::details::scaled_squares(const X& x, const Y* y, size_t n, R scale) {
+    R acc[accumulators] = { };
+    R inv = R(1) / scale;
+    size_t i = 0;
+    for (; i + accumulators <= n; i += accumulators) {
+        for (size_t k = 0; k < accumulators; k++) {
+            R v = (y ? R(x[i + k]) - R((*y)[i + k]) : R(x[i + k])) * inv;
+            acc[k] = fmadd(v, v, acc[k]);
+        }
+    }
+    for (; i < n; i++) {
+        R v = (y ? R(x[i]) - R((*y)[i]) : R(x[i])) * inv;
+        acc[0] = fmadd(v, v, acc[0]);
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+
+
+template < typename R, typename X, typename Y >
+R blas::details::nrm2(const X& x, const Y* y, size_t n) {
+    // fast path: plain sum of squares, valid if neither overflown nor (partially) underflown
+    R sum = scaled_squares< R >(x, y, n, R(1));
+    if (std::isnan(sum) || (std::isfinite(sum) && sum >= numeric_limits< R >::min() / numeric_limits< R >::epsilon())) {
+        return sqrt(sum);
+    }
+    // scaled path: sum of squares relative to largest magnitude
+    R scale = R(0);
+    for (size_t i = 0; i < n; i++) {
+        scale = max(scale, R(std::abs(y ? R(x[i]) - R((*y)[i]) : R(x[i]))));
+    }
+    if (scale == R(0) || std::isinf(scale)) {
+        return scale;
+    }
+    return scale * sqrt(scaled_squares< R >(x, y, n, scale));
+}
+
+
+
+template < typename X, typename Y >
+auto blas::dot(const X& x, const Y& y) {
+    static_assert(is_generic_container< X >() && is_generic_container< Y >(), "INVALID INPUT CONTAINER!");
+    assert(x.size() == y.size());
+    typedef typename common_type< typename decay< details::element_t< const X > >::type, typename decay< details::element_t< const Y > >::type >::type result_type;
+    size_t n = x.size();
+    return details::dispatch(x, [&](const auto& xa) {
+        return details::dispatch(y, [&](const auto& ya) {
+            result_type acc[accumulators] = { };
+            size_t i = 0;
+            for (; i + accumulators <= n; i += accumulators) {
+                for (size_t k = 0; k < accumulators; k++) {
+                    acc[k] = details::fmadd< result_type >(xa[i + k], ya[i + k], acc[k]);
+                }
+            }
+            for (; i < n; i++) {
+                acc[0] = details::fmadd< result_type >(xa[i], ya[i], acc[0]);
+            }
+            return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        });
+    });
+}
+
+
+
+template < typename A, typename X, typename Y >
+void blas::axpy(const A& alpha, const X& x, Y&& y) {
+    typedef typename remove_reference< Y >::type y_type;
+    static_assert(is_generic_container< X >() && is_generic_container< y_type >(), "INVALID INPUT CONTAINER!");
+    assert(x.size() == y.size());
+    typedef typename decay< details::element_t< y_type > >::type value_type;
+    size_t n = x.size();
+    value_type a = static_cast< value_type >(alpha);
+    details::dispatch(x, [&](const auto& xa) {
+        details::dispatch(y, [&](const auto& ya) {
+            for (size_t i = 0; i < n; i++) {
+                ya[i] = details::fmadd< value_type >(a, xa[i], ya[i]);
+            }
+            return 0;
+        });
+        return 0;
+    });
+}
+
+
+
+template < typename A, typename X, typename B, typename Y >
+void blas::axpby(const A& alpha, const X& x, const B& beta, Y&& y) {
+    typedef typename remove_reference< Y >::type y_type;
+    static_assert(is_generic_container< X >() && is_generic_container< y_type >(), "INVALID INPUT CONTAINER!");
+    assert(x.size() == y.size());
+    typedef typename decay< details::element_t< y_type > >::type value_type;
+    size_t n = x.size();
+    value_type a = static_cast< value_type >(alpha);
+    value_type b = static_cast< value_type >(beta);
+    details::dispatch(x, [&](const auto& xa) {
+        details::dispatch(y, [&](const auto& ya) {
+            for (size_t i = 0; i < n; i++) {
+                ya[i] = details::fmadd< value_type >(a, xa[i], b * ya[i]);
+            }
+            return 0;
+        });
+        return 0;
+    });
+}
+
+
+
+template < typename A, typename X >
+void blas::scal(const A& alpha, X&& x) {
+    typedef typename remove_reference< X >::type x_type;
+    static_assert(is_generic_container< x_type >(), "INVALID INPUT CONTAINER!");
+    typedef typename decay< details::element_t< x_type > >::type value_type;
+    size_t n = x.size();
+    value_type a = static_cast< value_type >(alpha);
+    details::dispatch(x, [&](const auto& xa) {
+        for (size_t i = 0; i < n; i++) {
+            xa[i] *= a;
+        }
+        return 0;
+    });
+}
+
+
+
+template < typename X >
+auto blas::nrm2(const X& x) {
+    static_assert(is_generic_container< X >(), "INVALID INPUT CONTAINER!");
+    typedef details::real_t< typename decay< details::element_t< const X > >::type > result_type;
+    return details::dispatch(x, [&](const auto& xa) {
+        typedef typename decay< decltype(xa) >::type accessor_type;
+        return details::nrm2< result_type, accessor_type, accessor_type >(xa, nullptr, x.size());
+    });
+}
+
+
+
+template < typename X, typename Y >
+auto blas::dist(const X& x, const Y& y) {
+    static_assert(is_generic_container< X >() && is_generic_container< Y >(), "INVALID INPUT CONTAINER!");
+    assert(x.size() == y.size());
+    typedef typename common_type< typename decay< details::element_t< const X > >::type, typename decay< details::element_t< const Y > >::type >::type value_type;
+    typedef details::real_t< value_type > result_type;
+    return details::dispatch(x, [&](const auto& xa) {
+        return details::dispatch(y, [&](const auto& ya) {
+            return details::nrm2< result_type >(xa, &ya, x.size());
+        });
+    });
+}
+
+
+
+template < typename X >
+auto blas::asum(const X& x) {
+    static_assert(is_generic_container< X >(), "INVALID INPUT CONTAINER!");
+    typedef details::real_t< typename decay< details::element_t< const X > >::type > result_type;
+    size_t n = x.size();
+    return details::dispatch(x, [&](const auto& xa) {
+        result_type acc[accumulators] = { };
+        size_t i = 0;
+        for (; i + accumulators <= n; i += accumulators) {
+            for (size_t k = 0; k < accumulators; k++) {
+                acc[k] += std::abs(result_type(xa[i + k]));
+            }
+        }
+        for (; i < n; i++) {
+            acc[0] += std::abs(result_type(xa[i]));
+        }
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    });
+}
+
+
+
+template < typename X >
+size_t blas::iamax(const X& x) {
+    static_assert(is_generic_container< X >(), "INVALID INPUT CONTAINER!");
+    typedef details::real_t< typename decay< details::element_t< const X > >::type > value_type;
+    size_t n = x.size();
+    return details::dispatch(x, [&](const auto& xa) {
+        size_t pos = 0;
+        value_type best = n ? std::abs(value_type(xa[0])) : value_type(0);
+        for (size_t i = 1; i < n; i++) {
+            value_type v = std::abs(value_type(xa[i]));
+            if (v > best) {
+                best = v;
+                pos = i;
+            }
+        }
+        return pos;
+    });
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_BLAS_HPP_
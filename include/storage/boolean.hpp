@@ -5,120 +5,151 @@
 #include <storage/comparer.hpp>
 #include <storage/subset.hpp>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #include <functional>
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // templated header-only boolean operators for std::matrix, std::volume
+// subset operands are moved into the returned comparer, which can thus be stored and evaluated later;
+// the comparison predicate is a template argument of the comparer (inlined in the evaluation loop)
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace std {
 namespace storage {
-template <typename lCT, typename rCT>
-using subset_comparer = st_comparer_base<st_subset_base<lCT>, st_subset_base<rCT>>;
+template <typename lCT, typename rCT, typename Predicate = equal_to<typename lCT::value_type>>
+using subset_comparer = st_comparer_base<st_subset_base<lCT>, st_subset_base<rCT>, Predicate>;
 }  // namespace storage
 }  // namespace std
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename lCT, typename rCT>
-inline std::storage::subset_comparer<lCT, rCT> operator== (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
-    return std::storage::subset_comparer<lCT, rCT> (&_lhs, &_rhs, std::equal_to<typename lCT::value_type>());
+inline std::storage::subset_comparer<lCT, rCT, std::equal_to<typename lCT::value_type>> operator==(std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
+    return std::storage::subset_comparer<lCT, rCT, std::equal_to<typename lCT::value_type>> (std::move(_lhs), std::move(_rhs));
 }
 template <typename lCT, typename rCT>
-inline std::storage::subset_comparer<lCT, rCT> operator!= (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
-    return std::storage::subset_comparer<lCT, rCT> (&_lhs, &_rhs, std::not_equal_to<typename lCT::value_type>());
+inline std::storage::subset_comparer<lCT, rCT, std::not_equal_to<typename lCT::value_type>> operator!=(std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
+    return std::storage::subset_comparer<lCT, rCT, std::not_equal_to<typename lCT::value_type>> (std::move(_lhs), std::move(_rhs));
 }
 template <typename lCT, typename rCT>
-inline std::storage::subset_comparer<lCT, rCT> operator<  (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
-    return std::storage::subset_comparer<lCT, rCT> (&_lhs, &_rhs, std::less<typename lCT::value_type>());
+inline std::storage::subset_comparer<lCT, rCT, std::less<typename lCT::value_type>> operator< (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
+    return std::storage::subset_comparer<lCT, rCT, std::less<typename lCT::value_type>> (std::move(_lhs), std::move(_rhs));
 }
 template <typename lCT, typename rCT>
-inline std::storage::subset_comparer<lCT, rCT> operator>  (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
-    return std::storage::subset_comparer<lCT, rCT> (&_lhs, &_rhs, std::greater<typename lCT::value_type>());
-    // return operator<(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::subset_comparer<lCT, rCT, std::greater<typename lCT::value_type>> operator> (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
+    return std::storage::subset_comparer<lCT, rCT, std::greater<typename lCT::value_type>> (std::move(_lhs), std::move(_rhs));
 }
 template <typename lCT, typename rCT>
-inline std::storage::subset_comparer<lCT, rCT> operator<= (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
-    return std::storage::subset_comparer<lCT, rCT> (&_lhs, &_rhs, std::less_equal<typename lCT::value_type>());
-    // return !operator>(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::subset_comparer<lCT, rCT, std::less_equal<typename lCT::value_type>> operator<=(std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
+    return std::storage::subset_comparer<lCT, rCT, std::less_equal<typename lCT::value_type>> (std::move(_lhs), std::move(_rhs));
 }
 template <typename lCT, typename rCT>
-inline std::storage::subset_comparer<lCT, rCT> operator>= (std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
-    return std::storage::subset_comparer<lCT, rCT> (&_lhs, &_rhs, std::greater_equal<typename lCT::value_type>());
-    // return !operator<(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::subset_comparer<lCT, rCT, std::greater_equal<typename lCT::value_type>> operator>=(std::storage::st_subset_base<lCT>&& _lhs, std::storage::st_subset_base<rCT>&& _rhs) {
+    return std::storage::subset_comparer<lCT, rCT, std::greater_equal<typename lCT::value_type>> (std::move(_lhs), std::move(_rhs));
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace std {
 namespace storage {
-template <typename lCT, typename rCT>
-using vector_comparer = st_comparer_base<st_subset_base<lCT>, const vector<rCT>>;
+// right operand held by reference, i.e. must outlive the comparer
+template <typename lCT, typename rCT, typename Predicate = equal_to<typename lCT::value_type>>
+using vector_comparer = st_comparer_base<st_subset_base<lCT>, const vector<rCT>&, Predicate>;
 }  // namespace storage
 }  // namespace std
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename lCT, typename rCT>
-inline std::storage::vector_comparer<lCT, rCT> operator== (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
-    return std::storage::vector_comparer<lCT, rCT> (&_lhs, &_rhs, std::equal_to<typename lCT::value_type>());
+inline std::storage::vector_comparer<lCT, rCT, std::equal_to<typename lCT::value_type>> operator==(std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
+    return std::storage::vector_comparer<lCT, rCT, std::equal_to<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rCT>
-inline std::storage::vector_comparer<lCT, rCT> operator!= (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
-    return std::storage::vector_comparer<lCT, rCT> (&_lhs, &_rhs, std::not_equal_to<typename lCT::value_type>());
+inline std::storage::vector_comparer<lCT, rCT, std::not_equal_to<typename lCT::value_type>> operator!=(std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
+    return std::storage::vector_comparer<lCT, rCT, std::not_equal_to<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rCT>
-inline std::storage::vector_comparer<lCT, rCT> operator<  (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
-    return std::storage::vector_comparer<lCT, rCT> (&_lhs, &_rhs, std::less<typename lCT::value_type>());
+inline std::storage::vector_comparer<lCT, rCT, std::less<typename lCT::value_type>> operator< (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
+    return std::storage::vector_comparer<lCT, rCT, std::less<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rCT>
-inline std::storage::vector_comparer<lCT, rCT> operator>  (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
-    return std::storage::vector_comparer<lCT, rCT> (&_lhs, &_rhs, std::greater<typename lCT::value_type>());
-    // return operator<(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::vector_comparer<lCT, rCT, std::greater<typename lCT::value_type>> operator> (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
+    return std::storage::vector_comparer<lCT, rCT, std::greater<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rCT>
-inline std::storage::vector_comparer<lCT, rCT> operator<= (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
-    return std::storage::vector_comparer<lCT, rCT> (&_lhs, &_rhs, std::less_equal<typename lCT::value_type>());
-    // return !operator>(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::vector_comparer<lCT, rCT, std::less_equal<typename lCT::value_type>> operator<=(std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
+    return std::storage::vector_comparer<lCT, rCT, std::less_equal<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rCT>
-inline std::storage::vector_comparer<lCT, rCT> operator>= (std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
-    return std::storage::vector_comparer<lCT, rCT> (&_lhs, &_rhs, std::greater_equal<typename lCT::value_type>());
-    // return !operator<(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::vector_comparer<lCT, rCT, std::greater_equal<typename lCT::value_type>> operator>=(std::storage::st_subset_base<lCT>&& _lhs, const std::vector<rCT>& _rhs) {
+    return std::storage::vector_comparer<lCT, rCT, std::greater_equal<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace std {
 namespace storage {
-template <typename lCT, typename rDT>
-using bulk_comparer = st_bulk_comparer_base<st_subset_base<lCT>, const rDT>;
+template <typename lCT, typename rDT, typename Predicate = equal_to<typename lCT::value_type>>
+using bulk_comparer = st_bulk_comparer_base<st_subset_base<lCT>, rDT, Predicate>;
 }
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename lCT, typename rDT>
-inline std::storage::bulk_comparer<lCT, rDT> operator== (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
+inline std::storage::bulk_comparer<lCT, rDT, std::equal_to<typename lCT::value_type>> operator==(std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
     static_assert(std::is_convertible<typename lCT::value_type, rDT>::value, "");  // required as no explicit cast is performed in comparer class
-    return std::storage::bulk_comparer<lCT, rDT> (&_lhs, &_rhs, std::equal_to<typename lCT::value_type>());
+    return std::storage::bulk_comparer<lCT, rDT, std::equal_to<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rDT>
-inline std::storage::bulk_comparer<lCT, rDT> operator!= (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
-    return std::storage::bulk_comparer<lCT, rDT> (&_lhs, &_rhs, std::not_equal_to<typename lCT::value_type>());
+inline std::storage::bulk_comparer<lCT, rDT, std::not_equal_to<typename lCT::value_type>> operator!=(std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
+    return std::storage::bulk_comparer<lCT, rDT, std::not_equal_to<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rDT>
-inline std::storage::bulk_comparer<lCT, rDT> operator<  (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
-    return std::storage::bulk_comparer<lCT, rDT> (&_lhs, &_rhs, std::less<typename lCT::value_type>());
+inline std::storage::bulk_comparer<lCT, rDT, std::less<typename lCT::value_type>> operator< (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
+    return std::storage::bulk_comparer<lCT, rDT, std::less<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rDT>
-inline std::storage::bulk_comparer<lCT, rDT> operator>  (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
-    return std::storage::bulk_comparer<lCT, rDT> (&_lhs, &_rhs, std::greater<typename lCT::value_type>());
-    // return operator<(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::bulk_comparer<lCT, rDT, std::greater<typename lCT::value_type>> operator> (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
+    return std::storage::bulk_comparer<lCT, rDT, std::greater<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rDT>
-inline std::storage::bulk_comparer<lCT, rDT> operator<= (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
-    return std::storage::bulk_comparer<lCT, rDT> (&_lhs, &_rhs, std::less_equal<typename lCT::value_type>());
-    // return !operator>(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::bulk_comparer<lCT, rDT, std::less_equal<typename lCT::value_type>> operator<=(std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
+    return std::storage::bulk_comparer<lCT, rDT, std::less_equal<typename lCT::value_type>> (std::move(_lhs), _rhs);
 }
 template <typename lCT, typename rDT>
-inline std::storage::bulk_comparer<lCT, rDT> operator>= (std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
-    return std::storage::bulk_comparer<lCT, rDT> (&_lhs, &_rhs, std::greater_equal<typename lCT::value_type>());
-    // return !operator<(_rhs,_lhs); //types aren't symmetric!
+inline std::storage::bulk_comparer<lCT, rDT, std::greater_equal<typename lCT::value_type>> operator>=(std::storage::st_subset_base<lCT>&& _lhs, const rDT& _rhs) {
+    return std::storage::bulk_comparer<lCT, rDT, std::greater_equal<typename lCT::value_type>> (std::move(_lhs), _rhs);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// element-wise mask algebra on comparers (and combinations thereof), e.g. '(a.row(0) > 0) && !(b.row(0) == 5)';
+// expressions are lazy and fused, i.e. evaluated in a single pass into packed words (cf. mask(), indexes(), count(), ...)
+// @note: operators apply element-wise, hence 'if (!(a == b))' holds if all elements differ (use 'if (!static_cast<bool>(a == b))' otherwise)
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+/// @brief      Element-wise AND of two mask expressions (lazy). @warning Both operands are always evaluated, i.e. no
+///             short-circuit evaluation (unlike built-in &&).
+///
+template <typename lE, typename rE, typename = typename std::enable_if<std::storage::is_mask_expression<lE>() && std::storage::is_mask_expression<rE>()>::type>
+inline std::storage::mask_and<std::storage::details::operand_t<lE>, std::storage::details::operand_t<rE>> operator&&(lE&& _lhs, rE&& _rhs) {
+    return std::storage::mask_and<std::storage::details::operand_t<lE>, std::storage::details::operand_t<rE>> (std::forward<lE>(_lhs), std::forward<rE>(_rhs));
+}
+//------------------------------------------------------------------------------
+/// @brief      Element-wise OR of two mask expressions (lazy). @warning Both operands are always evaluated, i.e. no
+///             short-circuit evaluation (unlike built-in ||).
+///
+template <typename lE, typename rE, typename = typename std::enable_if<std::storage::is_mask_expression<lE>() && std::storage::is_mask_expression<rE>()>::type>
+inline std::storage::mask_or<std::storage::details::operand_t<lE>, std::storage::details::operand_t<rE>> operator||(lE&& _lhs, rE&& _rhs) {
+    return std::storage::mask_or<std::storage::details::operand_t<lE>, std::storage::details::operand_t<rE>> (std::forward<lE>(_lhs), std::forward<rE>(_rhs));
+}
+//------------------------------------------------------------------------------
+/// @brief      Element-wise XOR of two mask expressions (lazy).
+///
+template <typename lE, typename rE, typename = typename std::enable_if<std::storage::is_mask_expression<lE>() && std::storage::is_mask_expression<rE>()>::type>
+inline std::storage::mask_xor<std::storage::details::operand_t<lE>, std::storage::details::operand_t<rE>> operator^(lE&& _lhs, rE&& _rhs) {
+    return std::storage::mask_xor<std::storage::details::operand_t<lE>, std::storage::details::operand_t<rE>> (std::forward<lE>(_lhs), std::forward<rE>(_rhs));
+}
+//------------------------------------------------------------------------------
+/// @brief      Element-wise negation of a mask expression (lazy). @warning Yields a mask, not the negated bool of its
+///             operand, i.e. 'if (!(a == b))' holds only if all elements differ (use '!static_cast<bool>(a == b)'
+///             otherwise).
+///
+template <typename E, typename = typename std::enable_if<std::storage::is_mask_expression<E>()>::type>
+inline std::storage::st_mask_not<std::storage::details::operand_t<E>> operator!(E&& _expr) {
+    return std::storage::st_mask_not<std::storage::details::operand_t<E>> (std::forward<E>(_expr));
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -126,4 +157,4 @@ inline std::storage::bulk_comparer<lCT, rDT> operator>= (std::storage::st_subset
 // } // storage
 // } // std
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-#endif // BOOLEAN_HPP
\ No newline at end of file
+#endif // BOOLEAN_HPP
@@ -0,0 +1,812 @@
+//------------------------------------------------------------------------------
+/// @file       chunked_volume.hpp
+/// @author     João André
+///
+/// @brief      Header file providing declaration & definition of std::chunked_volume, an out-of-core 3D container whose
+///             storage is split into fixed-size 3D chunks kept in a file.
+///
+/// Chunks are loaded on demand (POSIX pread()) into an LRU cache bounded by a configurable memory budget, and written back
+/// (pwrite()) when evicted or flushed, if modified. Sequential traversal of the chunk grid is detected and the following chunks
+/// are announced to the kernel (posix_fadvise()), so that disk reads overlap computation.
+///
+/// Element access mirrors std::volume (operator()(l, r, c), operator[], layer(), begin()/end()), thus existing volume code can be
+/// ported by changing the container type. Bulk transfers of layer ranges to/from memory are provided by read()/write().
+///
+/// File layout: fixed-size header (page-aligned) followed by all chunks, in layer-major chunk grid order. Edge chunks are stored
+/// with full chunk size. Chunks never written are read back as zero (sparse file).
+///
+/// @note       Not thread-safe: even const access modifies the chunk cache.
+///
+/// @note       References returned by element accessors are only valid until the next access to a different chunk (which may
+///             evict the chunk holding the referenced element).
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_CHUNKED_VOLUME_HPP_
+#define STORAGE_INCLUDE_STORAGE_CHUNKED_VOLUME_HPP_
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "storage/subset.hpp"
+#include "storage/view.hpp"
+#include "storage/iterator.hpp"
+
+#define _FUNC_NAME_ "std::chunked_volume< >::" + std::string(__func__) + "(): "
+
+namespace std {
+
+template < typename T > class chunked_volume;  // forward declaration required for 'using' typedefs below
+
+template < typename dT >
+using chunked_volume_subset = storage::st_subset_base< chunked_volume< dT > >;
+
+//------------------------------------------------------------------------------
+/// @brief      Out-of-core (file-backed) 3D container, with chunked storage and LRU chunk cache.
+///
+/// @tparam     T     Element data type. Must be trivially copyable (stored as raw bytes).
+///
+template < typename T >
+class chunked_volume {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Static assertion on element type.
+    ///
+    static_assert(is_trivially_copyable< T >::value, "ELEMENT TYPE MUST BE TRIVIALLY COPYABLE!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Element value type.
+    ///
+    typedef T value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Default chunk dimension (along each axis).
+    ///
+    static constexpr size_t default_chunk = 32;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Default memory budget (bytes) for cached chunks.
+    ///
+    static constexpr size_t default_budget = size_t(256) << 20;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of chunks announced ahead of sequential accesses.
+    ///
+    static constexpr size_t prefetch_depth = 2;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance, creating (or truncating) backing *file*.
+    ///
+    /// @param[in]  file         Path to backing file.
+    /// @param[in]  layers       Number of layers.
+    /// @param[in]  rows         Number of rows.
+    /// @param[in]  cols         Number of columns.
+    /// @param[in]  chunk_shape  Chunk dimensions (layers, rows, cols). Defaults to default_chunk along each axis.
+    /// @param[in]  budget       Memory budget (bytes) for cached chunks. Defaults to default_budget.
+    ///
+    /// @throw      std::runtime_error if file can not be created.
+    ///
+    /// @note       In order to avoid thrashing on row-major traversal, budget should hold at least a full row of chunks
+    ///             i.e. ceil(cols / chunk_shape[2]) chunks.
+    ///
+    chunked_volume(const string& file, size_t layers, size_t rows, size_t cols,
+                   const vector< size_t >& chunk_shape = { default_chunk, default_chunk, default_chunk }, size_t budget = default_budget);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance from an existing backing *file*.
+    ///
+    /// @param[in]  file    Path to backing file (previously created by a chunked_volume w/ same element type).
+    /// @param[in]  budget  Memory budget (bytes) for cached chunks. Defaults to default_budget.
+    ///
+    /// @throw      std::runtime_error if file can not be opened or is not a valid chunked volume file.
+    ///
+    explicit chunked_volume(const string& file, size_t budget = default_budget);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Destroys the object. Writes back modified chunks and closes backing file.
+    ///
+    ~chunked_volume();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Deleted copy constructor (instance owns file descriptor and cache).
+    ///
+    chunked_volume(const chunked_volume&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Deleted copy assignment operator (instance owns file descriptor and cache).
+    ///
+    chunked_volume& operator=(const chunked_volume&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Element-wise accessor. Holding chunk is marked as modified.
+    ///
+    /// @param[in]  layer  Layer index.
+    /// @param[in]  row    Row index.
+    /// @param[in]  col    Column index.
+    ///
+    /// @return     Reference to element @ (layer, row, col).
+    ///
+    /// @note       Read-only traversal should be done through a const reference, in order to avoid needless write-back.
+    ///
+    T& operator()(size_t layer, size_t row, size_t col);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Element-wise accessor (const overload).
+    ///
+    const T& operator()(size_t layer, size_t row, size_t col) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Positional element accessor (layer-major order, as std::volume). Holding chunk is marked as modified.
+    ///
+    T& operator[](size_t idx);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Positional element accessor (const overload).
+    ///
+    const T& operator[](size_t idx) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of layers.
+    ///
+    size_t layers() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of rows.
+    ///
+    size_t rows() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of columns.
+    ///
+    size_t cols() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get volume dimensions (layers, rows, cols).
+    ///
+    vector< size_t > shape() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get layer, row and column of element @ given index/position.
+    ///
+    vector< size_t > position(size_t idx) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get chunk dimensions (layers, rows, cols).
+    ///
+    vector< size_t > chunk_shape() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get memory budget (bytes) for cached chunks.
+    ///
+    size_t budget() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Set memory budget (bytes) for cached chunks. Chunks are evicted if required.
+    ///
+    /// @note       At least one chunk is always cached, regardless of budget.
+    ///
+    void budget(size_t bytes);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of chunks currently cached.
+    ///
+    size_t cached() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get index of every element in given layer (cf. std::volume::layerID()).
+    ///
+    vector< size_t > layerID(size_t layer) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get subset of elements in given layer (cf. std::volume::layer()).
+    ///
+    chunked_volume_subset< T > layer(size_t layer);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Copies layers [*first_layer*, *first_layer* + out.layers()) into in-memory view *out*.
+    ///
+    /// @param[in]  first_layer  First layer to read.
+    /// @param[in]  out          Output view (rows & cols must match).
+    ///
+    /// @note       Elements are copied by contiguous row segments, chunk by chunk.
+    ///
+    void read(size_t first_layer, const volume_view< T >& out) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Copies in-memory view *in* into layers [*first_layer*, *first_layer* + in.layers()).
+    ///
+    /// @param[in]  first_layer  First layer to write.
+    /// @param[in]  in           Input view (rows & cols must match).
+    ///
+    void write(size_t first_layer, const volume_view< const T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Writes back all modified chunks to backing file.
+    ///
+    /// @throw      std::runtime_error on I/O error.
+    ///
+    void flush();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator to first element (layer-major order).
+    ///
+    storage::st_pseudo_iterator< chunked_volume > begin();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator past last element.
+    ///
+    storage::st_pseudo_iterator< chunked_volume > end();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator to first element (const overload).
+    ///
+    storage::st_pseudo_iterator< const chunked_volume > begin() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator past last element (const overload).
+    ///
+    storage::st_pseudo_iterator< const chunked_volume > end() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Backing file header.
+    ///
+    struct header {
+        char     magic[8];
+        uint64_t element_size;
+        uint64_t dims[3];
+        uint64_t chunk[3];
+    };
+
+    //--------------------------------------------------------------------------
+    /// @brief      Cached chunk.
+    ///
+    struct chunk {
+        vector< T > data;
+        bool dirty;
+        list< size_t >::iterator lru;
+    };
+
+    //--------------------------------------------------------------------------
+    /// @brief      Byte offset of first chunk in backing file (header is padded to a page).
+    ///
+    static constexpr off_t data_offset = 4096;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sets derived chunk grid dimensions and cache capacity.
+    ///
+    void setup(size_t budget);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get pointer to data of chunk *id*, loading it (and evicting least recently used chunks) if required.
+    ///
+    /// @param[in]  id     Chunk index.
+    /// @param[in]  dirty  Whether chunk is to be marked as modified.
+    ///
+    T* fetch(size_t id, bool dirty) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evicts least recently used chunk, writing it back if modified.
+    ///
+    void evict() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Reads chunk *id* from file.
+    ///
+    void load(size_t id, vector< T >& data) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Writes chunk *id* to file.
+    ///
+    void store(size_t id, const vector< T >& data) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Announces chunks following *id* to the kernel, on sequential access.
+    ///
+    void prefetch(size_t id) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get index of chunk holding element @ (layer, row, col), and offset of element within chunk.
+    ///
+    size_t locate(size_t layer, size_t row, size_t col, size_t& offset) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      File descriptor of backing file.
+    ///
+    int _fd;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Volume dimensions (layers, rows, cols).
+    ///
+    size_t _dims[3];
+
+    //--------------------------------------------------------------------------
+    /// @brief      Chunk dimensions (layers, rows, cols).
+    ///
+    size_t _chunk[3];
+
+    //--------------------------------------------------------------------------
+    /// @brief      Chunk grid dimensions (number of chunks along each axis).
+    ///
+    size_t _grid[3];
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of elements per chunk.
+    ///
+    size_t _chunk_size;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Memory budget (bytes).
+    ///
+    size_t _budget;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Maximum number of cached chunks.
+    ///
+    size_t _capacity;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Cached chunks, by chunk index.
+    ///
+    mutable unordered_map< size_t, chunk > _cache;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Chunk indexes, from most to least recently used.
+    ///
+    mutable list< size_t > _lru;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Last accessed chunk (fast path, bypasses cache lookup).
+    ///
+    mutable chunk* _last;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Index of last accessed chunk.
+    ///
+    mutable size_t _last_id;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Index of last chunk loaded from file (sequential access detection).
+    ///
+    mutable size_t _last_loaded;
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename T >
+chunked_volume< T >::chunked_volume(const string& file, size_t layers, size_t rows, size_t cols, const vector< size_t >& chunk_shape, size_t budget) :
+    _fd(-1),
+    _dims { layers, rows, cols },
+    _last(nullptr),
+    _last_id(0),
+    _last_loaded(0) {
+        assert(layers > 0 && rows > 0 && cols > 0);
+        assert(chunk_shape.size() == 3);
+        for (size_t a = 0; a < 3; a++) {
+            assert(chunk_shape[a] > 0);
+            _chunk[a] = min(chunk_shape[a], _dims[a]);
+        }
+        setup(budget);
+        _fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (_fd < 0) {
+            throw runtime_error(_FUNC_NAME_ + "Unable to create file '" + file + "': " + strerror(errno));
+        }
+        header head;
+        memset(&head, 0, sizeof(header));
+        memcpy(head.magic, "CHUNKVOL", sizeof(head.magic));
+        head.element_size = sizeof(T);
+        for (size_t a = 0; a < 3; a++) {
+            head.dims[a]  = _dims[a];
+            head.chunk[a] = _chunk[a];
+        }
+        // file is extended (sparse) to full size upfront, unwritten chunks are read as zero
+        off_t length = data_offset + static_cast< off_t >(_grid[0] * _grid[1] * _grid[2] * _chunk_size * sizeof(T));
+        if (::pwrite(_fd, &head, sizeof(header), 0) != static_cast< ssize_t >(sizeof(header)) || ::ftruncate(_fd, length) != 0) {
+            string error = strerror(errno);
+            ::close(_fd);
+            throw runtime_error(_FUNC_NAME_ + "Unable to initialize file '" + file + "': " + error);
+        }
+}
+
+
+
+template < typename T >
+chunked_volume< T >::chunked_volume(const string& file, size_t budget) :
+    _fd(-1),
+    _last(nullptr),
+    _last_id(0),
+    _last_loaded(0) {
+        _fd = ::open(file.c_str(), O_RDWR);
+        if (_fd < 0) {
+            throw runtime_error(_FUNC_NAME_ + "Unable to open file '" + file + "': " + strerror(errno));
+        }
+        header head;
+        if (::pread(_fd, &head, sizeof(header), 0) != static_cast< ssize_t >(sizeof(header)) ||
+            memcmp(head.magic, "CHUNKVOL", sizeof(head.magic)) != 0 || head.element_size != sizeof(T)) {
+            ::close(_fd);
+            throw runtime_error(_FUNC_NAME_ + "Invalid chunked volume file '" + file + "'!");
+        }
+        for (size_t a = 0; a < 3; a++) {
+            _dims[a]  = head.dims[a];
+            _chunk[a] = head.chunk[a];
+        }
+        setup(budget);
+}
+
+
+
+template < typename T >
+chunked_volume< T >::~chunked_volume() {
+    if (_fd < 0) {
+        return;
+    }
+    try {
+        flush();
+    } catch (...) {
+        // destructors must not throw; flush() should be called explicitly where I/O errors are to be handled
+    }
+    ::close(_fd);
+}
+
+
+
+template < typename T >
+T& chunked_volume< T >::operator()(size_t layer, size_t row, size_t col) {
+    assert(layer < _dims[0] && row < _dims[1] && col < _dims[2]);
+    size_t offset = 0;
+    size_t id = locate(layer, row, col, offset);
+    if (_last && id == _last_id && _last->dirty) {
+        return _last->data[offset];
+    }
+    return fetch(id, true)[offset];
+}
+
+
+
+template < typename T >
+const T& chunked_volume< T >::operator()(size_t layer, size_t row, size_t col) const {
+    assert(layer < _dims[0] && row < _dims[1] && col < _dims[2]);
+    size_t offset = 0;
+    size_t id = locate(layer, row, col, offset);
+    if (_last && id == _last_id) {
+        return _last->data[offset];
+    }
+    return fetch(id, false)[offset];
+}
+
+
+
+template < typename T >
+T& chunked_volume< T >::operator[](size_t idx) {
+    assert(idx < size());
+    size_t layer_size = _dims[1] * _dims[2];
+    return (*this)(idx / layer_size, (idx % layer_size) / _dims[2], idx % _dims[2]);
+}
+
+
+
+template < typename T >
+const T& chunked_volume< T >::operator[](size_t idx) const {
+    assert(idx < size());
+    size_t layer_size = _dims[1] * _dims[2];
+    return (*this)(idx / layer_size, (idx % layer_size) / _dims[2], idx % _dims[2]);
+}
+
+
+
+template < typename T >
+size_t chunked_volume< T >::layers() const {
+    return _dims[0];
+}
+
+
+
+template < typename T >
+size_t chunked_volume< T >::rows() const {
+    return _dims[1];
+}
+
+
+
+template < typename T >
+size_t chunked_volume< T >::cols() const {
+    return _dims[2];
+}
+
+
+
+template < typename T >
+size_t chunked_volume< T >::size() const {
+    return _dims[0] * _dims[1] * _dims[2];
+}
+
+
+
+template < typename T >
+vector< size_t > chunked_volume< T >::shape() const {
+    return vector< size_t >({ _dims[0], _dims[1], _dims[2] });
+}
+
+
+
+template < typename T >
+vector< size_t > chunked_volume< T >::position(size_t idx) const {
+    assert(idx < size());
+    size_t layer_size = _dims[1] * _dims[2];
+    return vector< size_t >({ idx / layer_size, (idx % layer_size) / _dims[2], idx % _dims[2] });
+}
+
+
+
+template < typename T >
+vector< size_t > chunked_volume< T >::chunk_shape() const {
+    return vector< size_t >({ _chunk[0], _chunk[1], _chunk[2] });
+}
+
+
+
+template < typename T >
+size_t chunked_volume< T >::budget() const {
+    return _budget;
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::budget(size_t bytes) {
+    setup(bytes);
+    while (_cache.size() > _capacity) {
+        evict();
+    }
+}
+
+
+
+template < typename T >
+size_t chunked_volume< T >::cached() const {
+    return _cache.size();
+}
+
+
+
+template < typename T >
+vector< size_t > chunked_volume< T >::layerID(size_t layer) const {
+    assert(layer < _dims[0]);
+    size_t layer_size = _dims[1] * _dims[2];
+    vector< size_t > ids(layer_size);
+    for (size_t i = 0; i < layer_size; i++) {
+        ids[i] = layer * layer_size + i;
+    }
+    return ids;
+}
+
+
+
+template < typename T >
+chunked_volume_subset< T > chunked_volume< T >::layer(size_t layer) {
+    return chunked_volume_subset< T >(this, layerID(layer));
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::read(size_t first_layer, const volume_view< T >& out) const {
+    assert(first_layer + out.layers() <= _dims[0] && out.rows() == _dims[1] && out.cols() == _dims[2]);
+    for (size_t l = 0; l < out.layers(); l++) {
+        for (size_t r = 0; r < _dims[1]; r++) {
+            for (size_t c = 0; c < _dims[2]; c += _chunk[2]) {
+                size_t offset = 0;
+                size_t id = locate(first_layer + l, r, c, offset);
+                const T* src = fetch(id, false) + offset;
+                copy(src, src + min(_chunk[2], _dims[2] - c), &out(l, r, c));
+            }
+        }
+    }
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::write(size_t first_layer, const volume_view< const T >& in) {
+    assert(first_layer + in.layers() <= _dims[0] && in.rows() == _dims[1] && in.cols() == _dims[2]);
+    for (size_t l = 0; l < in.layers(); l++) {
+        for (size_t r = 0; r < _dims[1]; r++) {
+            for (size_t c = 0; c < _dims[2]; c += _chunk[2]) {
+                size_t offset = 0;
+                size_t id = locate(first_layer + l, r, c, offset);
+                const T* src = &in(l, r, c);
+                copy(src, src + min(_chunk[2], _dims[2] - c), fetch(id, true) + offset);
+            }
+        }
+    }
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::flush() {
+    for (auto& entry : _cache) {
+        if (entry.second.dirty) {
+            store(entry.first, entry.second.data);
+            entry.second.dirty = false;
+        }
+    }
+}
+
+
+
+template < typename T >
+storage::st_pseudo_iterator< chunked_volume< T > > chunked_volume< T >::begin() {
+    return storage::st_pseudo_iterator< chunked_volume >(this, 0);
+}
+
+
+
+template < typename T >
+storage::st_pseudo_iterator< chunked_volume< T > > chunked_volume< T >::end() {
+    return storage::st_pseudo_iterator< chunked_volume >(this, size());
+}
+
+
+
+template < typename T >
+storage::st_pseudo_iterator< const chunked_volume< T > > chunked_volume< T >::begin() const {
+    return storage::st_pseudo_iterator< const chunked_volume >(this, 0);
+}
+
+
+
+template < typename T >
+storage::st_pseudo_iterator< const chunked_volume< T > > chunked_volume< T >::end() const {
+    return storage::st_pseudo_iterator< const chunked_volume >(this, size());
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::setup(size_t budget) {
+    _chunk_size = _chunk[0] * _chunk[1] * _chunk[2];
+    for (size_t a = 0; a < 3; a++) {
+        _grid[a] = (_dims[a] + _chunk[a] - 1) / _chunk[a];
+    }
+    _budget   = budget;
+    _capacity = max< size_t >(1, budget / (_chunk_size * sizeof(T)));
+}
+
+
+
+template < typename T >
+T* chunked_volume< T >::fetch(size_t id, bool dirty) const {
+    auto it = _cache.find(id);
+    if (it == _cache.end()) {
+        while (_cache.size() >= _capacity) {
+            evict();
+        }
+        if (id == _last_loaded + 1) {
+            prefetch(id);
+        }
+        _last_loaded = id;
+        _lru.push_front(id);
+        it = _cache.emplace(id, chunk { vector< T >(_chunk_size), false, _lru.begin() }).first;
+        load(id, it->second.data);
+    } else if (it->second.lru != _lru.begin()) {
+        _lru.splice(_lru.begin(), _lru, it->second.lru);
+    }
+    it->second.dirty = it->second.dirty || dirty;
+    _last    = &it->second;
+    _last_id = id;
+    return it->second.data.data();
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::evict() const {
+    size_t id = _lru.back();
+    auto it = _cache.find(id);
+    if (it->second.dirty) {
+        store(id, it->second.data);
+    }
+    if (_last == &it->second) {
+        _last = nullptr;
+    }
+    _lru.pop_back();
+    _cache.erase(it);
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::load(size_t id, vector< T >& data) const {
+    size_t length = _chunk_size * sizeof(T);
+    off_t  offset = data_offset + static_cast< off_t >(id * length);
+    char*  dst    = reinterpret_cast< char* >(data.data());
+    size_t done   = 0;
+    while (done < length) {
+        ssize_t count = ::pread(_fd, dst + done, length - done, offset + static_cast< off_t >(done));
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw runtime_error(_FUNC_NAME_ + "Unable to read chunk: " + strerror(errno));
+        }
+        if (count == 0) {
+            // beyond end of file, remaining elements are zero
+            memset(dst + done, 0, length - done);
+            break;
+        }
+        done += static_cast< size_t >(count);
+    }
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::store(size_t id, const vector< T >& data) const {
+    size_t length = _chunk_size * sizeof(T);
+    off_t  offset = data_offset + static_cast< off_t >(id * length);
+    const char* src = reinterpret_cast< const char* >(data.data());
+    size_t done = 0;
+    while (done < length) {
+        ssize_t count = ::pwrite(_fd, src + done, length - done, offset + static_cast< off_t >(done));
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw runtime_error(_FUNC_NAME_ + "Unable to write chunk: " + strerror(errno));
+        }
+        done += static_cast< size_t >(count);
+    }
+}
+
+
+
+template < typename T >
+void chunked_volume< T >::prefetch(size_t id) const {
+#ifdef POSIX_FADV_WILLNEED
+    size_t n_chunks = _grid[0] * _grid[1] * _grid[2];
+    size_t count    = min(prefetch_depth, n_chunks - id - 1);
+    if (count) {
+        size_t length = _chunk_size * sizeof(T);
+        ::posix_fadvise(_fd, data_offset + static_cast< off_t >((id + 1) * length), static_cast< off_t >(count * length), POSIX_FADV_WILLNEED);
+    }
+#else
+    (void) id;
+#endif
+}
+
+
+
+template < typename T >
+size_t chunked_volume< T >::locate(size_t layer, size_t row, size_t col, size_t& offset) const {
+    offset = ((layer % _chunk[0]) * _chunk[1] + (row % _chunk[1])) * _chunk[2] + (col % _chunk[2]);
+    return ((layer / _chunk[0]) * _grid[1] + (row / _chunk[1])) * _grid[2] + (col / _chunk[2]);
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#undef _FUNC_NAME_
+
+#endif  // STORAGE_INCLUDE_STORAGE_CHUNKED_VOLUME_HPP_
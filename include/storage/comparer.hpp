@@ -1,131 +1,1063 @@
+//------------------------------------------------------------------------------
+/// @file       comparer.hpp
+/// @author     João André
+///
+/// @brief      Comparer class templates for generic storage containers, i.e. lazy element-wise comparison between two
+///             containers (st_comparer_base) or between a container and a single value (st_bulk_comparer_base).
+///
+/// Comparers hold their operands and predicate, and are only evaluated when converted or queried. The predicate is a template
+/// parameter (e.g. std::less<>), thus inlined in the comparison loop. Results are produced in blocks of 64 elements, packed into
+/// 64-bit mask words (cf. st_bitmask): each block is evaluated w/ a branch-free loop, which the compiler vectorizes for contiguous
+/// operands. Conversions to std::vector<bool> (boolean mask) and std::vector<int> (index list) are kept for compatibility,
+/// as slower adapters over mask words.
+///
+/// Mask expressions (comparers and their combinations, cf. st_mask_binary, st_mask_not) are composable: combined expressions
+/// stay lazy and are evaluated word by word in a single pass, without intermediate masks.
+///
+/// Operand containers require only:
+/// 1) size_t size() [for runtime assertions];
+/// 2) operator[](size_t) [for data retrieval];
+/// 3) a predicate callable defined for the element types.
+///
+//------------------------------------------------------------------------------
+
 #ifndef COMPARER_HPP
 #define COMPARER_HPP
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-#include <functional>
+
 #include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+#include <atomic>
+#include <functional>
 #include <storage/type_check.hpp>
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Provides a comparer class for generic storage containers, requiring only:
-// 1) size_t size() [for runtime assertions];
-// 2) operator[](int) [for data retrieval];
-// 3) boolean function cpr defined for the type;
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <storage/parallel.hpp>
+
 namespace std {
 namespace storage {
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// _lDT, _lCT : left_operand data type && container type; _rDT: right_operand data type;
-// template <typename _lDT, typename _lCT, typename _rDT>
-// class st_bulk_comparer_base {
-// protected:
-// 	const _lCT* left_operand;
-// 	const _rDT* right_operand;
-// 	std::function<bool(_lDT,_rDT)> cpr;
-// public:
-// 	st_bulk_comparer_base(const _lCT* _in_lhs, const _rDT* _in_rhs, const std::function<bool(_lDT,_rDT)>& _cpr) : left_operand(_in_lhs), right_operand(_in_rhs), cpr(_cpr) { /* */ };
-// 	explicit operator bool() const { 
-// 		if (!(*left_operand).size()) return false;
-// 		for (int i = 0; i < (*left_operand).size(); ++i) if (!cpr((*left_operand)[i],(*right_operand))) return false;
-// 		return true;
-// 	};
-// 	operator std::vector<bool> () const {
-// 		std::vector<bool> mask ((*left_operand).size());
-// 		for (int i = 0; i < mask.size(); ++i) mask[i]=cpr((*left_operand)[i],(*right_operand));
-// 		return mask;
-// 	};
-// };
-// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// // _lDT, _lCT : left_operand data type && container type; _rDT, _rCT : right_operand data type && container type;
-// template <typename _lDT, typename _lCT, typename _rDT,  typename _rCT>
-// class st_elementwise_comparer_base {
-// protected:
-// 	const _lCT* left_operand;
-// 	const _rCT* right_operand;
-// 	std::function<bool(_lDT,_rDT)> cpr;
-// public:
-// 	st_elementwise_comparer_base(_lCT* _in_lhs, _rCT* _in_rhs, const std::function<bool(_lDT,_rDT)>& _cpr) : left_operand(_in_lhs), right_operand(_in_rhs), cpr(_cpr) { /* */ };
-// 	explicit operator bool() const { 
-// 		if (!(*left_operand).size()) return false; // in the case of empty containers
-// 		int len = min((*left_operand).size(),(*right_operand).size());
-// 		for (int i = 0; i < len; ++i) if (!cpr((*left_operand)[i],(*right_operand)[i])) return false; // will only return true if all elements of the smallest operand verity the condition
-// 		return true;
-// 	};
-// 	operator std::vector<bool> () const {
-// 		std::vector<bool> mask (min((*left_operand).size(),(*right_operand).size()),false);
-// 		for (int i = 0; i < mask.size(); ++i) mask[i]=cpr((*left_operand)[i],(*right_operand)[i]);
-// 		return mask;
-// 	};
-// };	
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// performs comparison on container-type classes with other containers (elementwise)
-template <typename lT, typename rT>
-class st_comparer_base {
-protected:
-	// container operand pointers
-	const lT* left_operand;
-	const rT* right_operand;
-	// type descriptors
-	typedef typename lT::value_type ltype;
-	typedef typename rT::value_type rtype;
-	// comparison function
-	std::function<bool(ltype,rtype)> cpr;
-public:
-	st_comparer_base(lT* _in_lhs, rT* _in_rhs, const std::function<bool(ltype,rtype)>& _cpr) : left_operand(_in_lhs), right_operand(_in_rhs), cpr(_cpr) { 
-		static_assert(is_generic_container<lT>(), "");
-		static_assert(is_generic_container<rT>(), "");
-	};
-	explicit operator bool() const { 
-		if (!(*left_operand).size()) return false; // in the case of empty containers
-		int len = min((*left_operand).size(),(*right_operand).size());
-		for (int i = 0; i < len; ++i) if (!cpr((*left_operand)[i],(*right_operand)[i])) return false;
-		return true;
-	};
-	operator std::vector<bool> () const { //cast to vector<int> (bool mask)
-		std::vector<bool> mask (min((*left_operand).size(),(*right_operand).size()),false);
-		for (int i = 0; i < mask.size(); ++i) mask[i]=cpr((*left_operand)[i],(*right_operand)[i]);
-		return mask;
-	};
-	operator std::vector<int> () const { //cast to vector<int> (index mask)
-		std::vector<int> ids (0);
-		for (int i = 0; i < min((*left_operand).size(),(*right_operand).size()); ++i) if (cpr((*left_operand)[i],(*right_operand)[i])) ids.push_back((*left_operand).index()[i]);
-		return ids;
-	};
+
+//------------------------------------------------------------------------------
+/// @brief      Number of elements (bits) per mask word.
+///
+constexpr size_t mask_word_bits = 64;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of mask words evaluated per parallel task (i.e. 1024 elements); cancellation is checked between words.
+///
+constexpr size_t mask_block_words = 16;
+
+//------------------------------------------------------------------------------
+/// @brief      Position returned by mask searches when no element is set.
+///
+constexpr size_t mask_npos = static_cast< size_t >(-1);
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Gets source index of element @ given position: index within source container for subsets, position otherwise.
+///
+template < typename C, typename = void >
+struct source_index {
+    static size_t get(const C&, size_t pos) { return pos; }
+};
+
+template < typename C >
+struct source_index< C, decltype(void(declval< const C& >().index())) > {
+    static size_t get(const C& container, size_t pos) { return container.index()[pos]; }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Container type held by a comparer operand (reference qualifiers removed).
+///
+template < typename T >
+using operand_t = typename remove_cv< typename remove_reference< T >::type >::type;
+
+}  // namespace details
+
+template < typename Derived >
+class st_mask_base;
+
+//------------------------------------------------------------------------------
+/// @brief      Checks if given type is a mask expression (i.e. derived from st_mask_base).
+///
+template < typename E >
+constexpr bool is_mask_expression() {
+    return is_base_of< st_mask_base< details::operand_t< E > >, details::operand_t< E > >::value;
+}
+
+
+//------------------------------------------------------------------------------
+/// @brief      Packed boolean mask, stored in 64-bit words (bit *i* of word *w* represents element w * 64 + i).
+///
+/// @note       Bits past size() in the last word are always zero.
+///
+class st_bitmask {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  size   Number of elements.
+    /// @param[in]  value  Initial value of all elements. Defaults to false.
+    ///
+    explicit st_bitmask(size_t size = 0, bool value = false);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get value of element @ given position.
+    ///
+    bool operator[](size_t pos) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Set value of element @ given position.
+    ///
+    void set(size_t pos, bool value = true);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of mask words.
+    ///
+    size_t n_words() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get mask words.
+    ///
+    const vector< uint64_t >& words() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get mask words (mutable). Bits past size() *must* be kept at zero.
+    ///
+    vector< uint64_t >& words();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of set elements.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get positions of set elements (ascending).
+    ///
+    vector< size_t > indexes() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Conversion to (unpacked) boolean vector.
+    ///
+    operator vector< bool >() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get mask of valid bits for word *w* (all ones except for trailing bits of last word).
+    ///
+    static uint64_t valid_bits(size_t size, size_t w);
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Mask words.
+    ///
+    vector< uint64_t > _words;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of elements.
+    ///
+    size_t _size;
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Base class template of (lazy) mask expressions, e.g. comparers.
+///
+/// @tparam     Derived  Derived expression type (CRTP). Must provide:
+///                      1) size_t size() [number of elements];
+///                      2) bool test(size_t) [value of single element];
+///                      3) uint64_t word(size_t) [packed values of elements in given word];
+///                      4) size_t source_index(size_t) [index of element within source container].
+///
+template < typename Derived >
+class st_mask_base {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates expression into a packed mask.
+    ///
+    st_bitmask mask() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Boolean conversion operator.
+    ///
+    /// @return     True if expression holds for all elements, false otherwise (or if empty). Stops at first mismatching word.
+    ///
+    explicit operator bool() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if expression holds for any element. Stops at first set word.
+    ///
+    bool any() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if expression holds for any element, in parallel. Remaining tasks are cancelled once a set word is found.
+    ///
+    /// @param      pool  Thread pool.
+    ///
+    bool any(work_stealing_pool& pool) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if expression holds for all elements. Stops at first mismatching word.
+    ///
+    /// @note       Unlike operator bool(), returns true for empty expressions.
+    ///
+    bool all() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if expression holds for all elements, in parallel. Remaining tasks are cancelled once a mismatch is found.
+    ///
+    /// @param      pool  Thread pool.
+    ///
+    bool all(work_stealing_pool& pool) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if expression holds for no element, i.e. !any().
+    ///
+    bool none() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if expression holds for no element, in parallel, i.e. !any(pool).
+    ///
+    bool none(work_stealing_pool& pool) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Counts elements for which expression holds.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Counts elements for which expression holds, in parallel.
+    ///
+    /// @param      pool  Thread pool.
+    ///
+    size_t count(work_stealing_pool& pool) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Finds first element for which expression holds.
+    ///
+    /// @return     Position of element (cf. source_index() for index within source container), or mask_npos if none.
+    ///
+    size_t find_first() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Finds first element for which expression holds, in parallel. Tasks past the best match found so far are cancelled.
+    ///
+    /// @param      pool  Thread pool.
+    ///
+    /// @return     Position of element, or mask_npos if none.
+    ///
+    size_t find_first(work_stealing_pool& pool) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Finds last element for which expression holds.
+    ///
+    /// @return     Position of element (cf. source_index() for index within source container), or mask_npos if none.
+    ///
+    size_t find_last() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Finds last element for which expression holds, in parallel. Tasks before the best match found so far are cancelled.
+    ///
+    /// @param      pool  Thread pool.
+    ///
+    /// @return     Position of element, or mask_npos if none.
+    ///
+    size_t find_last(work_stealing_pool& pool) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates expression into an index list, i.e. source container indexes of elements for which expression holds.
+    ///             Indexes are collected while words are evaluated (no intermediate mask).
+    ///
+    vector< size_t > indexes() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Conversion to boolean mask (slow path, cf. mask()).
+    ///
+    operator vector< bool >() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Conversion to index list, i.e. source container indexes of elements for which expression holds.
+    ///
+    operator vector< int >() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Access derived expression.
+    ///
+    const Derived& derived() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of mask words of expression.
+    ///
+    size_t n_words() const;
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Element-wise comparison between two containers.
+///
+/// @tparam     lT         Left operand type. Held by value if non-reference (e.g. moved subsets), by reference otherwise.
+/// @tparam     rT         Right operand type. Held by value if non-reference, by reference otherwise.
+/// @tparam     Predicate  Comparison callable type, with signature bool(lvalue_type, rvalue_type).
+///
+/// @note       Only the first min(left.size(), right.size()) elements are compared.
+///
+template < typename lT, typename rT, typename Predicate >
+class st_comparer_base : public st_mask_base< st_comparer_base< lT, rT, Predicate > > {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Static assertions.
+    ///
+    static_assert(is_generic_container< details::operand_t< lT > >(), "INVALID LEFT OPERAND CONTAINER!");
+    static_assert(is_generic_container< details::operand_t< rT > >(), "INVALID RIGHT OPERAND CONTAINER!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param      lhs   Left operand (forwarded).
+    /// @param      rhs   Right operand (forwarded).
+    /// @param[in]  cpr   Comparison predicate.
+    ///
+    template < typename iL, typename iR >
+    st_comparer_base(iL&& lhs, iR&& rhs, Predicate cpr = Predicate());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of compared elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Compares element @ given position.
+    ///
+    bool test(size_t pos) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Compares a block of (up to) 64 elements.
+    ///
+    /// @param[in]  w     Word index, i.e. elements [w * 64, w * 64 + 64).
+    ///
+    /// @return     Packed comparison results.
+    ///
+    uint64_t word(size_t w) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get index of element @ given position within source container of left operand.
+    ///
+    size_t source_index(size_t pos) const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Left operand.
+    ///
+    lT _lhs;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Right operand.
+    ///
+    rT _rhs;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Comparison predicate.
+    ///
+    Predicate _cpr;
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Comparison between all elements of a container and a single value.
+///
+/// @tparam     lT         Left operand type. Held by value if non-reference (e.g. moved subsets), by reference otherwise.
+/// @tparam     rT         Right operand (value) type. Held by value.
+/// @tparam     Predicate  Comparison callable type, with signature bool(lvalue_type, rT).
+///
+template < typename lT, typename rT, typename Predicate >
+class st_bulk_comparer_base : public st_mask_base< st_bulk_comparer_base< lT, rT, Predicate > > {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Static assertion.
+    ///
+    static_assert(is_generic_container< details::operand_t< lT > >(), "INVALID LEFT OPERAND CONTAINER!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param      lhs   Left operand (forwarded).
+    /// @param[in]  rhs   Right operand value.
+    /// @param[in]  cpr   Comparison predicate.
+    ///
+    template < typename iL >
+    st_bulk_comparer_base(iL&& lhs, const rT& rhs, Predicate cpr = Predicate());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of compared elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Compares element @ given position.
+    ///
+    bool test(size_t pos) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Compares a block of (up to) 64 elements.
+    ///
+    uint64_t word(size_t w) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get index of element @ given position within source container of left operand.
+    ///
+    size_t source_index(size_t pos) const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Left operand.
+    ///
+    lT _lhs;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Right operand value.
+    ///
+    rT _rhs;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Comparison predicate.
+    ///
+    Predicate _cpr;
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Element-wise binary combination of two mask expressions (e.g. logical AND/OR/XOR), evaluated lazily.
+///             Operand words are combined as they are produced, so nested expressions are evaluated in a single pass.
+///
+/// @tparam     lE    Left mask expression type (held by value).
+/// @tparam     rE    Right mask expression type (held by value).
+/// @tparam     Op    Word-wise operation type, with signature uint64_t(uint64_t, uint64_t) (e.g. std::bit_and<uint64_t>).
+///
+/// @note       Only the first min(left.size(), right.size()) elements are combined. Source indexes refer to the left operand.
+///
+template < typename lE, typename rE, typename Op >
+class st_mask_binary : public st_mask_base< st_mask_binary< lE, rE, Op > > {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Static assertions.
+    ///
+    static_assert(is_mask_expression< lE >(), "INVALID LEFT OPERAND EXPRESSION!");
+    static_assert(is_mask_expression< rE >(), "INVALID RIGHT OPERAND EXPRESSION!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param      lhs   Left operand (forwarded).
+    /// @param      rhs   Right operand (forwarded).
+    ///
+    template < typename iL, typename iR >
+    st_mask_binary(iL&& lhs, iR&& rhs);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates element @ given position.
+    ///
+    bool test(size_t pos) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates a block of (up to) 64 elements.
+    ///
+    uint64_t word(size_t w) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get index of element @ given position within source container of left operand.
+    ///
+    size_t source_index(size_t pos) const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Left operand.
+    ///
+    lE _lhs;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Right operand.
+    ///
+    rE _rhs;
 };
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// performs comparison on container-type classes with single object
-template <typename lT, typename rT>
-class st_bulk_comparer_base {
-protected:
-	// container operand pointers
-	const lT* left_operand;
-	const rT* right_operand;
-	// type descriptors
-	typedef typename lT::value_type ltype;
-	typedef rT				rtype;
-	// comparison function
-	std::function<bool(ltype,rtype)> cpr;
-public:
-	st_bulk_comparer_base(lT* _in_lhs, rT* _in_rhs, const std::function<bool(ltype,rtype)>& _cpr) : left_operand(_in_lhs), right_operand(_in_rhs), cpr(_cpr) { 
-		static_assert(is_generic_container<lT>(), "");
-	};
-	explicit operator bool() const { 
-		if (!(*left_operand).size()) return false;  // in the case of empty containers
-		for (int i = 0; i < (*left_operand).size(); ++i) if (!cpr((*left_operand)[i],(*right_operand))) return false;
-		return true;
-	};
-	operator std::vector<bool> () const { 			//cast to vector<int> (bool mask)
-		std::vector<bool> mask ((*left_operand).size(),false);
-		for (int i = 0; i < mask.size(); ++i) mask[i]=cpr((*left_operand)[i],(*right_operand));
-		return mask;
-	};
-	operator std::vector<int> () const { 			//cast to vector<int> (index mask)
-		std::vector<int> ids (0);
-		for (int i = 0; i < (*left_operand).size(); ++i) if (cpr((*left_operand)[i],(*right_operand))) ids.push_back((*left_operand).index()[i]);
-		return ids;
-	};
 
+
+
+//------------------------------------------------------------------------------
+/// @brief      Element-wise negation of a mask expression, evaluated lazily.
+///
+/// @tparam     E     Mask expression type (held by value).
+///
+template < typename E >
+class st_mask_not : public st_mask_base< st_mask_not< E > > {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Static assertion.
+    ///
+    static_assert(is_mask_expression< E >(), "INVALID OPERAND EXPRESSION!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param      expr  Operand (forwarded).
+    ///
+    template < typename iE >
+    explicit st_mask_not(iE&& expr);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates element @ given position.
+    ///
+    bool test(size_t pos) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates a block of (up to) 64 elements. Bits past size() are cleared.
+    ///
+    uint64_t word(size_t w) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get index of element @ given position within source container of operand.
+    ///
+    size_t source_index(size_t pos) const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Operand.
+    ///
+    E _expr;
 };
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-} // storage
-} // std
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-#endif
\ No newline at end of file
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Lazy mask expression aliases.
+///
+template < typename lE, typename rE >
+using mask_and = st_mask_binary< lE, rE, bit_and< uint64_t > >;
+
+template < typename lE, typename rE >
+using mask_or = st_mask_binary< lE, rE, bit_or< uint64_t > >;
+
+template < typename lE, typename rE >
+using mask_xor = st_mask_binary< lE, rE, bit_xor< uint64_t > >;
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+inline st_bitmask::st_bitmask(size_t size, bool value) :
+    _words((size + mask_word_bits - 1) / mask_word_bits, value ? ~uint64_t(0) : uint64_t(0)),
+    _size(size) {
+        if (value && !_words.empty()) {
+            _words.back() &= valid_bits(_size, _words.size() - 1);
+        }
+}
+
+
+
+inline size_t st_bitmask::size() const {
+    return _size;
+}
+
+
+
+inline bool st_bitmask::operator[](size_t pos) const {
+    assert(pos < _size);
+    return (_words[pos / mask_word_bits] >> (pos % mask_word_bits)) & 1;
+}
+
+
+
+inline void st_bitmask::set(size_t pos, bool value) {
+    assert(pos < _size);
+    uint64_t bit = uint64_t(1) << (pos % mask_word_bits);
+    if (value) {
+        _words[pos / mask_word_bits] |= bit;
+    } else {
+        _words[pos / mask_word_bits] &= ~bit;
+    }
+}
+
+
+
+inline size_t st_bitmask::n_words() const {
+    return _words.size();
+}
+
+
+
+inline const vector< uint64_t >& st_bitmask::words() const {
+    return _words;
+}
+
+
+
+inline vector< uint64_t >& st_bitmask::words() {
+    return _words;
+}
+
+
+
+inline size_t st_bitmask::count() const {
+    size_t total = 0;
+    for (uint64_t word : _words) {
+        total += static_cast< size_t >(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+
+
+inline vector< size_t > st_bitmask::indexes() const {
+    vector< size_t > ids;
+    ids.reserve(count());
+    for (size_t w = 0; w < _words.size(); w++) {
+        // iterate over set bits only
+        for (uint64_t word = _words[w]; word; word &= word - 1) {
+            ids.push_back(w * mask_word_bits + static_cast< size_t >(__builtin_ctzll(word)));
+        }
+    }
+    return ids;
+}
+
+
+
+inline st_bitmask::operator vector< bool >() const {
+    vector< bool > out(_size, false);
+    for (size_t pos = 0; pos < _size; pos++) {
+        out[pos] = (*this)[pos];
+    }
+    return out;
+}
+
+
+
+inline uint64_t st_bitmask::valid_bits(size_t size, size_t w) {
+    size_t remaining = size - w * mask_word_bits;
+    return (remaining >= mask_word_bits) ? ~uint64_t(0) : ((uint64_t(1) << remaining) - 1);
+}
+
+
+
+template < typename Derived >
+st_bitmask st_mask_base< Derived >::mask() const {
+    st_bitmask out(derived().size());
+    auto& words = out.words();
+    for (size_t w = 0; w < words.size(); w++) {
+        words[w] = derived().word(w);
+    }
+    return out;
+}
+
+
+
+template < typename Derived >
+st_mask_base< Derived >::operator bool() const {
+    return derived().size() && all();  // false in the case of empty containers
+}
+
+
+
+template < typename Derived >
+bool st_mask_base< Derived >::any() const {
+    size_t n = n_words();
+    for (size_t w = 0; w < n; w++) {
+        if (derived().word(w)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+template < typename Derived >
+bool st_mask_base< Derived >::any(work_stealing_pool& pool) const {
+    atomic< bool > found(false);
+    parallel_for(0, n_words(), [&](size_t first, size_t last) {
+        for (size_t w = first; w < last && !found.load(memory_order_relaxed); w++) {
+            if (derived().word(w)) {
+                found.store(true, memory_order_relaxed);
+            }
+        }
+    }, mask_block_words, pool);
+    return found.load();
+}
+
+
+
+template < typename Derived >
+bool st_mask_base< Derived >::all() const {
+    size_t size = derived().size();
+    size_t n = n_words();
+    for (size_t w = 0; w < n; w++) {
+        if (derived().word(w) != st_bitmask::valid_bits(size, w)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+template < typename Derived >
+bool st_mask_base< Derived >::all(work_stealing_pool& pool) const {
+    size_t size = derived().size();
+    atomic< bool > mismatch(false);
+    parallel_for(0, n_words(), [&](size_t first, size_t last) {
+        for (size_t w = first; w < last && !mismatch.load(memory_order_relaxed); w++) {
+            if (derived().word(w) != st_bitmask::valid_bits(size, w)) {
+                mismatch.store(true, memory_order_relaxed);
+            }
+        }
+    }, mask_block_words, pool);
+    return !mismatch.load();
+}
+
+
+
+template < typename Derived >
+bool st_mask_base< Derived >::none() const {
+    return !any();
+}
+
+
+
+template < typename Derived >
+bool st_mask_base< Derived >::none(work_stealing_pool& pool) const {
+    return !any(pool);
+}
+
+
+
+template < typename Derived >
+size_t st_mask_base< Derived >::count() const {
+    size_t total = 0;
+    size_t n = n_words();
+    for (size_t w = 0; w < n; w++) {
+        total += static_cast< size_t >(__builtin_popcountll(derived().word(w)));
+    }
+    return total;
+}
+
+
+
+template < typename Derived >
+size_t st_mask_base< Derived >::count(work_stealing_pool& pool) const {
+    atomic< size_t > total(0);
+    parallel_for(0, n_words(), [&](size_t first, size_t last) {
+        size_t partial = 0;
+        for (size_t w = first; w < last; w++) {
+            partial += static_cast< size_t >(__builtin_popcountll(derived().word(w)));
+        }
+        total.fetch_add(partial, memory_order_relaxed);
+    }, mask_block_words, pool);
+    return total.load();
+}
+
+
+
+template < typename Derived >
+size_t st_mask_base< Derived >::find_first() const {
+    size_t n = n_words();
+    for (size_t w = 0; w < n; w++) {
+        uint64_t bits = derived().word(w);
+        if (bits) {
+            return w * mask_word_bits + static_cast< size_t >(__builtin_ctzll(bits));
+        }
+    }
+    return mask_npos;
+}
+
+
+
+template < typename Derived >
+size_t st_mask_base< Derived >::find_first(work_stealing_pool& pool) const {
+    atomic< size_t > best(mask_npos);
+    parallel_for(0, n_words(), [&](size_t first, size_t last) {
+        // words are scanned forward; any match within a word past the current best can be skipped
+        for (size_t w = first; w < last && w * mask_word_bits < best.load(memory_order_relaxed); w++) {
+            uint64_t bits = derived().word(w);
+            if (bits) {
+                size_t pos = w * mask_word_bits + static_cast< size_t >(__builtin_ctzll(bits));
+                size_t current = best.load(memory_order_relaxed);
+                while (pos < current && !best.compare_exchange_weak(current, pos, memory_order_relaxed)) {}
+                return;
+            }
+        }
+    }, mask_block_words, pool);
+    return best.load();
+}
+
+
+
+template < typename Derived >
+size_t st_mask_base< Derived >::find_last() const {
+    for (size_t w = n_words(); w-- > 0;) {
+        uint64_t bits = derived().word(w);
+        if (bits) {
+            return w * mask_word_bits + (mask_word_bits - 1) - static_cast< size_t >(__builtin_clzll(bits));
+        }
+    }
+    return mask_npos;
+}
+
+
+
+template < typename Derived >
+size_t st_mask_base< Derived >::find_last(work_stealing_pool& pool) const {
+    atomic< size_t > best(0);  // match position + 1, 0 if none
+    parallel_for(0, n_words(), [&](size_t first, size_t last) {
+        // words are scanned backward; any match within a word before the current best can be skipped
+        for (size_t w = last; w-- > first && (w + 1) * mask_word_bits > best.load(memory_order_relaxed);) {
+            uint64_t bits = derived().word(w);
+            if (bits) {
+                size_t pos = w * mask_word_bits + mask_word_bits - static_cast< size_t >(__builtin_clzll(bits));
+                size_t current = best.load(memory_order_relaxed);
+                while (pos > current && !best.compare_exchange_weak(current, pos, memory_order_relaxed)) {}
+                return;
+            }
+        }
+    }, mask_block_words, pool);
+    size_t pos = best.load();
+    return pos ? pos - 1 : mask_npos;
+}
+
+
+
+template < typename Derived >
+st_mask_base< Derived >::operator vector< bool >() const {
+    return static_cast< vector< bool > >(mask());
+}
+
+
+
+template < typename Derived >
+st_mask_base< Derived >::operator vector< int >() const {
+    vector< size_t > ids = indexes();
+    return vector< int >(ids.begin(), ids.end());
+}
+
+
+
+template < typename Derived >
+vector< size_t > st_mask_base< Derived >::indexes() const {
+    vector< size_t > ids;
+    size_t n = n_words();
+    for (size_t w = 0; w < n; w++) {
+        // iterate over set bits only
+        for (uint64_t bits = derived().word(w); bits; bits &= bits - 1) {
+            ids.push_back(derived().source_index(w * mask_word_bits + static_cast< size_t >(__builtin_ctzll(bits))));
+        }
+    }
+    return ids;
+}
+
+
+
+template < typename Derived >
+const Derived& st_mask_base< Derived >::derived() const {
+    return static_cast< const Derived& >(*this);
+}
+
+
+
+template < typename Derived >
+size_t st_mask_base< Derived >::n_words() const {
+    return (derived().size() + mask_word_bits - 1) / mask_word_bits;
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+template < typename iL, typename iR >
+st_comparer_base< lT, rT, Predicate >::st_comparer_base(iL&& lhs, iR&& rhs, Predicate cpr) :
+    _lhs(forward< iL >(lhs)),
+    _rhs(forward< iR >(rhs)),
+    _cpr(cpr) {
+        /* ... */
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+size_t st_comparer_base< lT, rT, Predicate >::size() const {
+    return min< size_t >(_lhs.size(), _rhs.size());
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+bool st_comparer_base< lT, rT, Predicate >::test(size_t pos) const {
+    return _cpr(_lhs[pos], _rhs[pos]);
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+uint64_t st_comparer_base< lT, rT, Predicate >::word(size_t w) const {
+    size_t first = w * mask_word_bits;
+    size_t n = min(mask_word_bits, size() - first);
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n; i++) {
+        bits |= static_cast< uint64_t >(_cpr(_lhs[first + i], _rhs[first + i])) << i;  // branch-free
+    }
+    return bits;
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+size_t st_comparer_base< lT, rT, Predicate >::source_index(size_t pos) const {
+    return details::source_index< details::operand_t< lT > >::get(_lhs, pos);
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+template < typename iL >
+st_bulk_comparer_base< lT, rT, Predicate >::st_bulk_comparer_base(iL&& lhs, const rT& rhs, Predicate cpr) :
+    _lhs(forward< iL >(lhs)),
+    _rhs(rhs),
+    _cpr(cpr) {
+        /* ... */
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+size_t st_bulk_comparer_base< lT, rT, Predicate >::size() const {
+    return _lhs.size();
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+bool st_bulk_comparer_base< lT, rT, Predicate >::test(size_t pos) const {
+    return _cpr(_lhs[pos], _rhs);
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+uint64_t st_bulk_comparer_base< lT, rT, Predicate >::word(size_t w) const {
+    size_t first = w * mask_word_bits;
+    size_t n = min(mask_word_bits, size() - first);
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n; i++) {
+        bits |= static_cast< uint64_t >(_cpr(_lhs[first + i], _rhs)) << i;  // branch-free
+    }
+    return bits;
+}
+
+
+
+template < typename lT, typename rT, typename Predicate >
+size_t st_bulk_comparer_base< lT, rT, Predicate >::source_index(size_t pos) const {
+    return details::source_index< details::operand_t< lT > >::get(_lhs, pos);
+}
+
+
+
+template < typename lE, typename rE, typename Op >
+template < typename iL, typename iR >
+st_mask_binary< lE, rE, Op >::st_mask_binary(iL&& lhs, iR&& rhs) :
+    _lhs(forward< iL >(lhs)),
+    _rhs(forward< iR >(rhs)) {
+        /* ... */
+}
+
+
+
+template < typename lE, typename rE, typename Op >
+size_t st_mask_binary< lE, rE, Op >::size() const {
+    return min< size_t >(_lhs.size(), _rhs.size());
+}
+
+
+
+template < typename lE, typename rE, typename Op >
+bool st_mask_binary< lE, rE, Op >::test(size_t pos) const {
+    return Op()(uint64_t(_lhs.test(pos)), uint64_t(_rhs.test(pos))) & 1;
+}
+
+
+
+template < typename lE, typename rE, typename Op >
+uint64_t st_mask_binary< lE, rE, Op >::word(size_t w) const {
+    // operands may differ in size, hence trailing bits are cleared
+    return Op()(_lhs.word(w), _rhs.word(w)) & st_bitmask::valid_bits(size(), w);
+}
+
+
+
+template < typename lE, typename rE, typename Op >
+size_t st_mask_binary< lE, rE, Op >::source_index(size_t pos) const {
+    return _lhs.source_index(pos);
+}
+
+
+
+template < typename E >
+template < typename iE >
+st_mask_not< E >::st_mask_not(iE&& expr) :
+    _expr(forward< iE >(expr)) {
+        /* ... */
+}
+
+
+
+template < typename E >
+size_t st_mask_not< E >::size() const {
+    return _expr.size();
+}
+
+
+
+template < typename E >
+bool st_mask_not< E >::test(size_t pos) const {
+    return !_expr.test(pos);
+}
+
+
+
+template < typename E >
+uint64_t st_mask_not< E >::word(size_t w) const {
+    return ~_expr.word(w) & st_bitmask::valid_bits(size(), w);
+}
+
+
+
+template < typename E >
+size_t st_mask_not< E >::source_index(size_t pos) const {
+    return _expr.source_index(pos);
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace storage
+}  // namespace std
+
+#endif  // COMPARER_HPP
@@ -0,0 +1,887 @@
+//------------------------------------------------------------------------------
+/// @file       fft.hpp
+/// @author     João André
+///
+/// @brief      Fast Fourier transforms (mixed-radix complex, real) w/ cached per-size plans, batched over matrix columns.
+///
+/// Plans hold precomputed twiddle factors & factorization of a given size, and are shared through process-wide caches
+/// (cf. plan::get(), real_plan::get()), thus repeated transforms of the same size only pay for the butterflies.
+/// Complex plans support any size: radix-4/2/3 butterflies, generic butterflies for remaining small prime factors, and
+/// Bluestein's algorithm (chirp-z convolution over a power of two plan) for sizes w/ large prime factors. Real plans
+/// transform even sizes through a complex plan of half size, & odd sizes through a full complex plan.
+///
+/// Batched transforms process all columns of row-major (samples x channels) matrices/views in parallel, gathering
+/// groups of columns per task s.t. reads & writes stay row-contiguous.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_FFT_HPP_
+#define STORAGE_INCLUDE_STORAGE_FFT_HPP_
+
+#include <map>
+#include <cmath>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace fft {
+
+//------------------------------------------------------------------------------
+/// @brief      Largest prime factor handled w/ generic butterflies; sizes w/ larger prime factors use Bluestein's
+///             algorithm.
+///
+constexpr size_t max_radix = 31;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of columns gathered per task in batched transforms.
+///
+constexpr size_t batch_columns = 8;
+
+//------------------------------------------------------------------------------
+/// @brief      Smallest power of two not lower than *n*.
+///
+inline size_t next_power_of_two(size_t n);
+
+//------------------------------------------------------------------------------
+/// @brief      Smallest size not lower than *n* whose prime factors are 2, 3 or 5 (i.e. fast transform size).
+///
+inline size_t next_fast_size(size_t n);
+
+//------------------------------------------------------------------------------
+/// @brief      Complex transform plan for a given size.
+///
+/// @tparam     R     Real (floating point) type.
+///
+template < typename R >
+class plan {
+ public:
+    static_assert(is_floating_point< R >::value, "INVALID REAL TYPE!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  n     Transform size (> 0).
+    ///
+    /// @throws     std::invalid_argument if *n* is 0.
+    ///
+    explicit plan(size_t n);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Gets (shared, cached) plan of size *n*.
+    ///
+    /// @param[in]  n     Transform size (> 0).
+    ///
+    /// @return     Reference to cached plan, valid for the lifetime of the process.
+    ///
+    static const plan& get(size_t n);
+
+    //--------------------------------------------------------------------------
+    /// @brief      In-place forward transform, i.e. X[k] = sum(x[n] * exp(-2 pi i k n / N)).
+    ///
+    /// @param      data  Pointer to size() elements.
+    ///
+    void forward(complex< R >* data) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      In-place inverse transform, i.e. x[n] = 1 / N * sum(X[k] * exp(2 pi i k n / N)).
+    ///
+    /// @param      data  Pointer to size() elements.
+    ///
+    void inverse(complex< R >* data) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Transform size.
+    ///
+    size_t size() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Recursive (decimation in time) stage, from *in* (w/ given stride) onto *out* (contiguous).
+    ///
+    void work(complex< R >* out, const complex< R >* in, size_t stride, size_t stage) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Radix-2 butterflies.
+    ///
+    void radix2(complex< R >* out, size_t stride, size_t m) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Radix-3 butterflies.
+    ///
+    void radix3(complex< R >* out, size_t stride, size_t m) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Radix-4 butterflies.
+    ///
+    void radix4(complex< R >* out, size_t stride, size_t m) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Generic radix-p butterflies (O(p^2)).
+    ///
+    void generic(complex< R >* out, size_t stride, size_t m, size_t p) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Forward transform w/ Bluestein's algorithm.
+    ///
+    void bluestein(complex< R >* data) const;
+
+    size_t _n;
+    vector< size_t > _factors;              ///< radices, outermost stage first
+    vector< size_t > _spans;                ///< butterfly span of each stage (product of remaining radices)
+    vector< complex< R > > _twiddles;       ///< exp(-2 pi i k / N), k < N
+    vector< complex< R > > _chirp;          ///< exp(-i pi k^2 / N), k < N (Bluestein)
+    vector< complex< R > > _kernel;         ///< transformed conjugate chirp (Bluestein)
+    unique_ptr< plan > _inner;              ///< power of two plan (Bluestein)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Real transform plan for a given size, i.e. transforms N real samples onto N / 2 + 1 (non-redundant)
+///             complex bins.
+///
+/// @tparam     R     Real (floating point) type.
+///
+template < typename R >
+class real_plan {
+ public:
+    static_assert(is_floating_point< R >::value, "INVALID REAL TYPE!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  n     Transform size (> 0).
+    ///
+    /// @throws     std::invalid_argument if *n* is 0.
+    ///
+    explicit real_plan(size_t n);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Gets (shared, cached) plan of size *n*.
+    ///
+    static const real_plan& get(size_t n);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Forward transform.
+    ///
+    /// @param[in]  in    Pointer to size() samples.
+    /// @param      out   Pointer to bins() elements. Must not overlap *in*.
+    ///
+    void forward(const R* in, complex< R >* out) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Inverse transform (imaginary parts of first & last (even size) bins are ignored).
+    ///
+    /// @param[in]  in    Pointer to bins() elements.
+    /// @param      out   Pointer to size() samples. Must not overlap *in*.
+    ///
+    void inverse(const complex< R >* in, R* out) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Transform size.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of bins, i.e. size() / 2 + 1.
+    ///
+    size_t bins() const;
+
+ protected:
+    size_t _n;
+    const plan< R >* _complex;           ///< complex plan (of half size if size() is even)
+    vector< complex< R > > _twiddles;    ///< exp(-2 pi i k / N), k <= N / 2 (even sizes)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Forward complex transform.
+///
+template < typename R >
+vector< complex< R > > forward(vector< complex< R > > data);
+
+//------------------------------------------------------------------------------
+/// @brief      Inverse complex transform.
+///
+template < typename R >
+vector< complex< R > > inverse(vector< complex< R > > data);
+
+//------------------------------------------------------------------------------
+/// @brief      In-place forward complex transform of all columns of *data*.
+///
+template < typename R >
+void forward(matrix_view< complex< R > > data, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      In-place inverse complex transform of all columns of *data*.
+///
+template < typename R >
+void inverse(matrix_view< complex< R > > data, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Real forward transform.
+///
+/// @param[in]  data  Input samples (non-empty).
+///
+/// @return     size() / 2 + 1 complex bins.
+///
+template < typename R >
+vector< complex< R > > rfft(const vector< R >& data);
+
+//------------------------------------------------------------------------------
+/// @brief      Real inverse transform.
+///
+/// @param[in]  bins  n / 2 + 1 complex bins.
+/// @param[in]  n     Output size.
+///
+/// @return     *n* real samples.
+///
+template < typename R >
+vector< R > irfft(const vector< complex< R > >& bins, size_t n);
+
+//------------------------------------------------------------------------------
+/// @brief      Real forward transform of all columns of *data* (samples x channels).
+///
+/// @return     Complex bins (rows / 2 + 1 x channels).
+///
+template < typename R >
+matrix< complex< R > > rfft(matrix_view< const R > data, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Real forward transform of all columns of *data* (samples x channels).
+///
+template < typename R >
+matrix< complex< R > > rfft(const matrix< R >& data, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Real inverse transform of all columns of *bins* (n / 2 + 1 x channels).
+///
+/// @return     Real samples (n x channels).
+///
+template < typename R >
+matrix< R > irfft(matrix_view< const complex< R > > bins, size_t n, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Real inverse transform of all columns of *bins* (n / 2 + 1 x channels).
+///
+template < typename R >
+matrix< R > irfft(const matrix< complex< R > >& bins, size_t n, work_stealing_pool& pool = work_stealing_pool::instance());
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Complex product, w/o the NaN/Inf recovery of std::complex multiplication (i.e. vectorizable).
+///
+template < typename R >
+inline complex< R > multiply(const complex< R >& a, const complex< R >& b) {
+    return complex< R >(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Per-thread scratch buffer of (at least) *n* elements.
+///
+/// @tparam     Slot  Buffer index, s.t. nested users (e.g. real plans over complex plans) do not share buffers.
+///
+template < typename R, size_t Slot = 0 >
+inline complex< R >* scratch(size_t n) {
+    static thread_local vector< complex< R > > buffer;
+    if (buffer.size() < n) {
+        buffer.resize(n);
+    }
+    return buffer.data();
+}
+
+}  // namespace details
+}  // namespace fft
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+inline size_t fft::next_power_of_two(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+
+
+inline size_t fft::next_fast_size(size_t n) {
+    for (size_t m = max< size_t >(n, 1);; m++) {
+        size_t r = m;
+        for (size_t p : { 2, 3, 5 }) {
+            while (r % p == 0) {
+                r /= p;
+            }
+        }
+        if (r == 1) {
+            return m;
+        }
+    }
+}
+
+
+
+template < typename R >
+fft::plan< R >::plan(size_t n) : _n(n) {
+    if (!n) {
+        throw invalid_argument("fft::plan(): invalid size");
+    }
+    // factorization: radix-4 first, then 2, then odd primes
+    size_t r = n;
+    while (r % 4 == 0) {
+        _factors.push_back(4);
+        r /= 4;
+    }
+    while (r % 2 == 0) {
+        _factors.push_back(2);
+        r /= 2;
+    }
+    for (size_t p = 3; p * p <= r; p += 2) {
+        while (r % p == 0) {
+            _factors.push_back(p);
+            r /= p;
+        }
+    }
+    if (r > 1) {
+        _factors.push_back(r);
+    }
+    if (!_factors.empty() && *max_element(_factors.begin(), _factors.end()) > fft::max_radix) {
+        // large prime factor: chirp-z convolution, w/ chirp angles reduced modulo 2N (exact for large k)
+        _factors.clear();
+        _chirp.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            long double angle = -3.141592653589793238462643383279502884L * static_cast< long double >((static_cast< uint64_t >(k) * k) % (2 * n)) / static_cast< long double >(n);
+            _chirp[k] = complex< R >(static_cast< R >(cos(angle)), static_cast< R >(sin(angle)));
+        }
+        _inner.reset(new plan(fft::next_power_of_two(2 * n - 1)));
+        size_t m = _inner->size();
+        _kernel.assign(m, complex< R >(0));
+        _kernel[0] = conj(_chirp[0]);
+        for (size_t k = 1; k < n; k++) {
+            _kernel[k] = _kernel[m - k] = conj(_chirp[k]);
+        }
+        _inner->forward(_kernel.data());
+        return;
+    }
+    _spans.resize(_factors.size());
+    for (size_t s = 0, span = n; s < _factors.size(); s++) {
+        span /= _factors[s];
+        _spans[s] = span;
+    }
+    _twiddles.resize(n);
+    for (size_t k = 0; k < n; k++) {
+        // evaluated in long double, so that large tables remain accurate
+        long double angle = -2.0L * 3.141592653589793238462643383279502884L * static_cast< long double >(k) / static_cast< long double >(n);
+        _twiddles[k] = complex< R >(static_cast< R >(cos(angle)), static_cast< R >(sin(angle)));
+    }
+}
+
+
+
+template < typename R >
+const fft::plan< R >& fft::plan< R >::get(size_t n) {
+    static mutex guard;
+    static map< size_t, unique_ptr< plan > > cache;
+    lock_guard< mutex > lock(guard);
+    auto& entry = cache[n];
+    if (!entry) {
+        entry.reset(new plan(n));
+    }
+    return *entry;
+}
+
+
+
+template < typename R >
+void fft::plan< R >::work(complex< R >* out, const complex< R >* in, size_t stride, size_t stage) const {
+    size_t p = _factors[stage];
+    size_t m = _spans[stage];
+    if (m == 1) {
+        for (size_t j = 0; j < p; j++) {
+            out[j] = in[j * stride];
+        }
+    } else {
+        for (size_t j = 0; j < p; j++) {
+            work(out + j * m, in + j * stride, stride * p, stage + 1);
+        }
+    }
+    switch (p) {
+        case 2: radix2(out, stride, m); break;
+        case 3: radix3(out, stride, m); break;
+        case 4: radix4(out, stride, m); break;
+        default: generic(out, stride, m, p); break;
+    }
+}
+
+
+
+template < typename R >
+void fft::plan< R >::radix2(complex< R >* out, size_t stride, size_t m) const {
+    complex< R >* a = out;
+    complex< R >* b = out + m;
+    for (size_t u = 0; u < m; u++) {
+        complex< R > t = details::multiply(b[u], _twiddles[u * stride]);
+        b[u] = a[u] - t;
+        a[u] += t;
+    }
+}
+
+
+
+template < typename R >
+void fft::plan< R >::radix3(complex< R >* out, size_t stride, size_t m) const {
+    // sin(-2 pi / 3)
+    const R s = -static_cast< R >(0.866025403784438646763723170752936183L);
+    for (size_t u = 0; u < m; u++) {
+        complex< R > t1 = details::multiply(out[u + m], _twiddles[u * stride]);
+        complex< R > t2 = details::multiply(out[u + 2 * m], _twiddles[2 * u * stride]);
+        complex< R > sum = t1 + t2;
+        complex< R > diff = (t1 - t2) * s;
+        complex< R > half = out[u] - sum * R(0.5);
+        out[u] += sum;
+        out[u + m] = complex< R >(half.real() - diff.imag(), half.imag() + diff.real());
+        out[u + 2 * m] = complex< R >(half.real() + diff.imag(), half.imag() - diff.real());
+    }
+}
+
+
+
+template < typename R >
+void fft::plan< R >::radix4(complex< R >* out, size_t stride, size_t m) const {
+    for (size_t u = 0; u < m; u++) {
+        complex< R > t0 = out[u];
+        complex< R > t1 = details::multiply(out[u + m], _twiddles[u * stride]);
+        complex< R > t2 = details::multiply(out[u + 2 * m], _twiddles[2 * u * stride]);
+        complex< R > t3 = details::multiply(out[u + 3 * m], _twiddles[3 * u * stride]);
+        complex< R > a = t0 + t2;
+        complex< R > b = t0 - t2;
+        complex< R > c = t1 + t3;
+        complex< R > d = t1 - t3;
+        out[u] = a + c;
+        out[u + 2 * m] = a - c;
+        // b -/+ i d
+        out[u + m] = complex< R >(b.real() + d.imag(), b.imag() - d.real());
+        out[u + 3 * m] = complex< R >(b.real() - d.imag(), b.imag() + d.real());
+    }
+}
+
+
+
+template < typename R >
+void fft::plan< R >::generic(complex< R >* out, size_t stride, size_t m, size_t p) const {
+    complex< R > scratch[fft::max_radix];
+    for (size_t u = 0; u < m; u++) {
+        for (size_t q = 0; q < p; q++) {
+            scratch[q] = out[u + q * m];
+        }
+        for (size_t q1 = 0; q1 < p; q1++) {
+            size_t k = u + q1 * m;
+            size_t index = 0;
+            complex< R > sum = scratch[0];
+            for (size_t q = 1; q < p; q++) {
+                // twiddle & DFT factor combined, i.e. exp(-2 pi i q k stride / N)
+                index += stride * k;
+                if (index >= _n) {
+                    index %= _n;
+                }
+                sum += details::multiply(scratch[q], _twiddles[index]);
+            }
+            out[k] = sum;
+        }
+    }
+}
+
+
+
+template < typename R >
+void fft::plan< R >::bluestein(complex< R >* data) const {
+    size_t m = _inner->size();
+    vector< complex< R > > buffer(m, complex< R >(0));
+    for (size_t k = 0; k < _n; k++) {
+        buffer[k] = details::multiply(data[k], _chirp[k]);
+    }
+    _inner->forward(buffer.data());
+    for (size_t k = 0; k < m; k++) {
+        buffer[k] = details::multiply(buffer[k], _kernel[k]);
+    }
+    _inner->inverse(buffer.data());
+    for (size_t k = 0; k < _n; k++) {
+        data[k] = details::multiply(buffer[k], _chirp[k]);
+    }
+}
+
+
+
+template < typename R >
+void fft::plan< R >::forward(complex< R >* data) const {
+    if (_inner) {
+        bluestein(data);
+        return;
+    }
+    if (_factors.empty()) {
+        return;
+    }
+    complex< R >* in = details::scratch< R >(_n);
+    std::copy(data, data + _n, in);
+    work(data, in, 1, 0);
+}
+
+
+
+template < typename R >
+void fft::plan< R >::inverse(complex< R >* data) const {
+    // conj(forward(conj(x))) / N
+    for (size_t i = 0; i < _n; i++) {
+        data[i] = conj(data[i]);
+    }
+    forward(data);
+    R scale = R(1) / static_cast< R >(_n);
+    for (size_t i = 0; i < _n; i++) {
+        data[i] = complex< R >(data[i].real() * scale, -data[i].imag() * scale);
+    }
+}
+
+
+
+template < typename R >
+size_t fft::plan< R >::size() const {
+    return _n;
+}
+
+
+
+template < typename R >
+fft::real_plan< R >::real_plan(size_t n) : _n(n) {
+    if (!n) {
+        throw invalid_argument("fft::real_plan(): invalid size");
+    }
+    if (n % 2) {
+        _complex = &plan< R >::get(n);
+        return;
+    }
+    _complex = &plan< R >::get(n / 2);
+    _twiddles.resize(n / 2 + 1);
+    for (size_t k = 0; k <= n / 2; k++) {
+        long double angle = -2.0L * 3.141592653589793238462643383279502884L * static_cast< long double >(k) / static_cast< long double >(n);
+        _twiddles[k] = complex< R >(static_cast< R >(cos(angle)), static_cast< R >(sin(angle)));
+    }
+}
+
+
+
+template < typename R >
+const fft::real_plan< R >& fft::real_plan< R >::get(size_t n) {
+    static mutex guard;
+    static map< size_t, unique_ptr< real_plan > > cache;
+    lock_guard< mutex > lock(guard);
+    auto& entry = cache[n];
+    if (!entry) {
+        entry.reset(new real_plan(n));
+    }
+    return *entry;
+}
+
+
+
+template < typename R >
+void fft::real_plan< R >::forward(const R* in, complex< R >* out) const {
+    if (_n % 2) {
+        complex< R >* buffer = details::scratch< R, 1 >(_n);
+        for (size_t i = 0; i < _n; i++) {
+            buffer[i] = complex< R >(in[i], R(0));
+        }
+        _complex->forward(buffer);
+        std::copy(buffer, buffer + bins(), out);
+        return;
+    }
+    // even samples as real, odd samples as imaginary parts of a half size transform
+    size_t h = _n / 2;
+    for (size_t k = 0; k < h; k++) {
+        out[k] = complex< R >(in[2 * k], in[2 * k + 1]);
+    }
+    _complex->forward(out);
+    // split: X[k] = E[k] + W^k O[k], w/ E[k] = (Z[k] + Z*[h - k]) / 2 & O[k] = -i (Z[k] - Z*[h - k]) / 2
+    complex< R > z0 = out[0];
+    out[0] = complex< R >(z0.real() + z0.imag(), R(0));
+    out[h] = complex< R >(z0.real() - z0.imag(), R(0));
+    for (size_t k = 1; k <= h / 2; k++) {
+        complex< R > a = out[k];
+        complex< R > b = out[h - k];
+        complex< R > e = (a + conj(b)) * R(0.5);
+        complex< R > d = (a - conj(b)) * R(0.5);
+        complex< R > o(d.imag(), -d.real());
+        out[k] = e + details::multiply(_twiddles[k], o);
+        if (k != h - k) {
+            // E[h - k] = E*[k], O[h - k] = O*[k], W^(h - k) = -W*^k
+            out[h - k] = conj(e) - details::multiply(conj(_twiddles[k]), conj(o));
+        }
+    }
+}
+
+
+
+template < typename R >
+void fft::real_plan< R >::inverse(const complex< R >* in, R* out) const {
+    if (_n % 2) {
+        complex< R >* buffer = details::scratch< R, 1 >(_n);
+        // Hermitian extension
+        buffer[0] = complex< R >(in[0].real(), R(0));
+        for (size_t k = 1; k < bins(); k++) {
+            buffer[k] = in[k];
+            buffer[_n - k] = conj(in[k]);
+        }
+        _complex->inverse(buffer);
+        for (size_t i = 0; i < _n; i++) {
+            out[i] = buffer[i].real();
+        }
+        return;
+    }
+    size_t h = _n / 2;
+    complex< R >* buffer = details::scratch< R, 1 >(h);
+    // merge: Z[k] = E[k] + i O[k], w/ E[k] = (X[k] + X*[h - k]) / 2 & O[k] = W*^k (X[k] - X*[h - k]) / 2
+    for (size_t k = 0; k < h; k++) {
+        complex< R > a = in[k];
+        complex< R > b = conj(in[h - k]);
+        if (k == 0) {
+            a = complex< R >(a.real(), R(0));
+            b = complex< R >(b.real(), R(0));
+        }
+        complex< R > e = (a + b) * R(0.5);
+        complex< R > o = details::multiply(conj(_twiddles[k]), (a - b) * R(0.5));
+        buffer[k] = complex< R >(e.real() - o.imag(), e.imag() + o.real());
+    }
+    _complex->inverse(buffer);
+    for (size_t k = 0; k < h; k++) {
+        out[2 * k] = buffer[k].real();
+        out[2 * k + 1] = buffer[k].imag();
+    }
+}
+
+
+
+template < typename R >
+size_t fft::real_plan< R >::size() const {
+    return _n;
+}
+
+
+
+template < typename R >
+size_t fft::real_plan< R >::bins() const {
+    return _n / 2 + 1;
+}
+
+
+
+template < typename R >
+vector< complex< R > > fft::forward(vector< complex< R > > data) {
+    if (!data.empty()) {
+        plan< R >::get(data.size()).forward(data.data());
+    }
+    return data;
+}
+
+
+
+template < typename R >
+vector< complex< R > > fft::inverse(vector< complex< R > > data) {
+    if (!data.empty()) {
+        plan< R >::get(data.size()).inverse(data.data());
+    }
+    return data;
+}
+
+
+
+template < typename R >
+void fft::forward(matrix_view< complex< R > > data, work_stealing_pool& pool) {
+    if (data.isEmpty()) {
+        return;
+    }
+    size_t rows = data.rows();
+    size_t cols = data.cols();
+    const auto& p = plan< R >::get(rows);
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        vector< complex< R > > buffer(rows * fft::batch_columns);
+        for (size_t c0 = first; c0 < last; c0 += fft::batch_columns) {
+            size_t width = min(fft::batch_columns, last - c0);
+            // gather/scatter row-wise (contiguous), transform column-wise
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < width; j++) {
+                    buffer[j * rows + i] = data(i, c0 + j);
+                }
+            }
+            for (size_t j = 0; j < width; j++) {
+                p.forward(buffer.data() + j * rows);
+            }
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < width; j++) {
+                    data(i, c0 + j) = buffer[j * rows + i];
+                }
+            }
+        }
+    }, 1, pool);
+}
+
+
+
+template < typename R >
+void fft::inverse(matrix_view< complex< R > > data, work_stealing_pool& pool) {
+    if (data.isEmpty()) {
+        return;
+    }
+    size_t rows = data.rows();
+    size_t cols = data.cols();
+    const auto& p = plan< R >::get(rows);
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        vector< complex< R > > buffer(rows * fft::batch_columns);
+        for (size_t c0 = first; c0 < last; c0 += fft::batch_columns) {
+            size_t width = min(fft::batch_columns, last - c0);
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < width; j++) {
+                    buffer[j * rows + i] = data(i, c0 + j);
+                }
+            }
+            for (size_t j = 0; j < width; j++) {
+                p.inverse(buffer.data() + j * rows);
+            }
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < width; j++) {
+                    data(i, c0 + j) = buffer[j * rows + i];
+                }
+            }
+        }
+    }, 1, pool);
+}
+
+
+
+template < typename R >
+vector< complex< R > > fft::rfft(const vector< R >& data) {
+    if (data.empty()) {
+        throw invalid_argument("fft::rfft(): empty input");
+    }
+    const auto& p = real_plan< R >::get(data.size());
+    vector< complex< R > > out(p.bins());
+    p.forward(data.data(), out.data());
+    return out;
+}
+
+
+
+template < typename R >
+vector< R > fft::irfft(const vector< complex< R > >& bins, size_t n) {
+    const auto& p = real_plan< R >::get(n);
+    if (bins.size() != p.bins()) {
+        throw invalid_argument("fft::irfft(): size mismatch");
+    }
+    vector< R > out(n);
+    p.inverse(bins.data(), out.data());
+    return out;
+}
+
+
+
+template < typename R >
+matrix< complex< R > > fft::rfft(matrix_view< const R > data, work_stealing_pool& pool) {
+    if (data.isEmpty()) {
+        throw invalid_argument("fft::rfft(): empty input");
+    }
+    size_t rows = data.rows();
+    size_t cols = data.cols();
+    const auto& p = real_plan< R >::get(rows);
+    size_t bins = p.bins();
+    matrix< complex< R > > out(bins, cols);
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        vector< R > samples(rows * fft::batch_columns);
+        vector< complex< R > > spectra(bins * fft::batch_columns);
+        for (size_t c0 = first; c0 < last; c0 += fft::batch_columns) {
+            size_t width = min(fft::batch_columns, last - c0);
+            for (size_t i = 0; i < rows; i++) {
+                const R* row = data.data() + i * cols + c0;
+                for (size_t j = 0; j < width; j++) {
+                    samples[j * rows + i] = row[j];
+                }
+            }
+            for (size_t j = 0; j < width; j++) {
+                p.forward(samples.data() + j * rows, spectra.data() + j * bins);
+            }
+            for (size_t k = 0; k < bins; k++) {
+                complex< R >* row = out.data() + k * cols + c0;
+                for (size_t j = 0; j < width; j++) {
+                    row[j] = spectra[j * bins + k];
+                }
+            }
+        }
+    }, 1, pool);
+    return out;
+}
+
+
+
+template < typename R >
+matrix< complex< R > > fft::rfft(const matrix< R >& data, work_stealing_pool& pool) {
+    return rfft(matrix_view< const R >(data.data(), data.rows(), data.cols()), pool);
+}
+
+
+
+template < typename R >
+matrix< R > fft::irfft(matrix_view< const complex< R > > bins, size_t n, work_stealing_pool& pool) {
+    const auto& p = real_plan< R >::get(n);
+    if (bins.rows() != p.bins()) {
+        throw invalid_argument("fft::irfft(): size mismatch");
+    }
+    size_t cols = bins.cols();
+    size_t rows = p.bins();
+    matrix< R > out(n, cols);
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        vector< complex< R > > spectra(rows * fft::batch_columns);
+        vector< R > samples(n * fft::batch_columns);
+        for (size_t c0 = first; c0 < last; c0 += fft::batch_columns) {
+            size_t width = min(fft::batch_columns, last - c0);
+            for (size_t k = 0; k < rows; k++) {
+                const complex< R >* row = bins.data() + k * cols + c0;
+                for (size_t j = 0; j < width; j++) {
+                    spectra[j * rows + k] = row[j];
+                }
+            }
+            for (size_t j = 0; j < width; j++) {
+                p.inverse(spectra.data() + j * rows, samples.data() + j * n);
+            }
+            for (size_t i = 0; i < n; i++) {
+                R* row = out.data() + i * cols + c0;
+                for (size_t j = 0; j < width; j++) {
+                    row[j] = samples[j * n + i];
+                }
+            }
+        }
+    }, 1, pool);
+    return out;
+}
+
+
+
+template < typename R >
+matrix< R > fft::irfft(const matrix< complex< R > >& bins, size_t n, work_stealing_pool& pool) {
+    return irfft(matrix_view< const complex< R > >(bins.data(), bins.rows(), bins.cols()), n, pool);
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_FFT_HPP_
@@ -0,0 +1,1142 @@
+//------------------------------------------------------------------------------
+/// @file       filter.hpp
+/// @author     João André
+///
+/// @brief      Streaming (stateful) multichannel digital filters: moving average, rolling min/max, FIR (direct or FFT
+///             overlap-add) and IIR (biquad cascades), and zero-phase (forward-backward) filtering.
+///
+/// Filters process blocks of samples stored row-major, i.e. one row per sample and one column per channel (e.g. a
+/// std::matrix of multichannel recordings), carrying their state across calls: a stream can be filtered in blocks of
+/// arbitrary size w/ the same result as filtering it at once. Input and output blocks may alias (in-place filtering).
+///
+/// All filters share the same interface (process(), reset(), initialize(), padding()), thus can be used w/ filtfilt().
+/// Complexity per sample and channel is O(1) for moving averages (running sums) and rolling min/max (monotonic
+/// queues), O(taps) for direct FIR, O(log(taps)) for FFT FIR and O(sections) for IIR cascades.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_FILTER_HPP_
+#define STORAGE_INCLUDE_STORAGE_FILTER_HPP_
+
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+#include "storage/summation.hpp"
+#include "storage/fft.hpp"
+
+namespace std {
+namespace filtering {
+
+//------------------------------------------------------------------------------
+/// @brief      FIR implementation.
+///
+enum class fir_method {
+    automatic,  ///< direct for short filters (< fft_taps), FFT overlap-add otherwise
+    direct,     ///< direct form convolution
+    fft         ///< FFT overlap-add
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Pi (M_PI is not provided by standard C++).
+///
+constexpr double pi = 3.14159265358979323846;
+
+//------------------------------------------------------------------------------
+/// @brief      Butterworth (maximally flat) quality factor of 2nd order sections, i.e. 1 / sqrt(2).
+///
+constexpr double butterworth_q = 0.70710678118654752440;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of taps from which FIR filters use FFT overlap-add (fir_method::automatic).
+///
+constexpr size_t fft_taps = 64;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of rows per parallel task (row-parallel filters).
+///
+constexpr size_t min_rows = 256;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of channels per parallel task (channel-parallel filters).
+///
+constexpr size_t min_channels = 16;
+
+//------------------------------------------------------------------------------
+/// @brief      Causal moving average over the last *window* samples (fewer at stream start), w/ running sums.
+///
+/// @tparam     T     Sample type.
+///
+template < typename T >
+class moving_average {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Accumulator type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  window    Window size (samples).
+    /// @param[in]  channels  Number of channels. Defaults to 1.
+    ///
+    explicit moving_average(size_t window, size_t channels = 1);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples.
+    ///
+    /// @param[in]  in    Input block (samples x channels).
+    /// @param[in]  out   Output block (samples x channels). May alias *in*.
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    void process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (samples x channels).
+    ///
+    matrix< T > process(const matrix< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (single channel).
+    ///
+    vector< T > process(const vector< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets filter state (i.e. starts a new stream).
+    ///
+    void reset();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Initializes filter state as if *row* had been input indefinitely (steady state).
+    ///
+    /// @param[in]  row   Pointer to channels() values.
+    ///
+    void initialize(const T* row);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Recommended edge padding (samples) for zero-phase filtering.
+    ///
+    size_t padding() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Window size.
+    ///
+    size_t window() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of channels.
+    ///
+    size_t channels() const;
+
+ protected:
+    size_t _window;
+    size_t _channels;
+    size_t _count = 0;            ///< number of samples in window
+    size_t _head = 0;             ///< ring buffer position of next sample
+    vector< T > _buffer;          ///< last *window* samples (window x channels)
+    vector< value_type > _sum;    ///< per-channel running sums
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Causal rolling extremum (e.g. min or max) over the last *window* samples, w/ monotonic queues.
+///
+/// @tparam     T        Sample type.
+/// @tparam     Compare  Strict ordering, s.t. the extremum *e* satisfies !Compare(x, e) for all x in window (i.e.
+///                      std::less yields the minimum, std::greater the maximum).
+///
+template < typename T, typename Compare >
+class moving_extremum {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  window    Window size (samples).
+    /// @param[in]  channels  Number of channels. Defaults to 1.
+    ///
+    explicit moving_extremum(size_t window, size_t channels = 1);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples.
+    ///
+    /// @param[in]  in    Input block (samples x channels).
+    /// @param[in]  out   Output block (samples x channels). May alias *in*.
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    void process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (samples x channels).
+    ///
+    matrix< T > process(const matrix< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (single channel).
+    ///
+    vector< T > process(const vector< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets filter state (i.e. starts a new stream).
+    ///
+    void reset();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Initializes filter state as if *row* had been input indefinitely (steady state).
+    ///
+    void initialize(const T* row);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Recommended edge padding (samples) for zero-phase filtering.
+    ///
+    size_t padding() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Window size.
+    ///
+    size_t window() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of channels.
+    ///
+    size_t channels() const;
+
+ protected:
+    size_t _window;
+    size_t _channels;
+    size_t _position = 0;          ///< stream position (samples)
+    vector< T > _values;           ///< per-channel ring buffers of queued values (channels x window)
+    vector< size_t > _positions;   ///< per-channel ring buffers of queued positions (channels x window)
+    vector< size_t > _front;       ///< per-channel ring buffer position of queue front
+    vector< size_t > _size;        ///< per-channel queue size
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling minimum.
+///
+template < typename T >
+using moving_min = moving_extremum< T, std::less< T > >;
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling maximum.
+///
+template < typename T >
+using moving_max = moving_extremum< T, std::greater< T > >;
+
+//------------------------------------------------------------------------------
+/// @brief      Finite impulse response filter, i.e. y[n] = sum(b[k] * x[n - k]).
+///
+/// @tparam     T     Sample type.
+///
+template < typename T >
+class fir {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Coefficient (and accumulator) type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  taps       Filter coefficients b[k] (non-empty).
+    /// @param[in]  channels   Number of channels. Defaults to 1.
+    /// @param[in]  algorithm  Implementation. Defaults to automatic.
+    ///
+    explicit fir(const vector< value_type >& taps, size_t channels = 1, fir_method algorithm = fir_method::automatic);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples.
+    ///
+    /// @param[in]  in    Input block (samples x channels).
+    /// @param[in]  out   Output block (samples x channels). May alias *in*.
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    void process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (samples x channels).
+    ///
+    matrix< T > process(const matrix< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (single channel).
+    ///
+    vector< T > process(const vector< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets filter state (i.e. zero history).
+    ///
+    void reset();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Initializes filter state as if *row* had been input indefinitely (steady state).
+    ///
+    void initialize(const T* row);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Recommended edge padding (samples) for zero-phase filtering, i.e. 3 * taps.
+    ///
+    size_t padding() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filter coefficients.
+    ///
+    const vector< value_type >& taps() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of channels.
+    ///
+    size_t channels() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Direct form convolution of a block.
+    ///
+    void direct(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool);
+
+    //--------------------------------------------------------------------------
+    /// @brief      FFT overlap-add convolution of a block.
+    ///
+    void overlap_add(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool);
+
+    vector< value_type > _taps;
+    size_t _channels;
+    bool _fft;
+    vector< T > _history;                    ///< last taps - 1 input samples ((taps - 1) x channels), direct form
+    size_t _size = 0;                        ///< FFT size
+    vector< complex< value_type > > _spectrum;  ///< filter spectrum (FFT size)
+    vector< value_type > _tail;              ///< pending overlap (channels x (taps - 1)), overlap-add
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Second order IIR section (normalized, i.e. a0 = 1), w/ RBJ (bilinear) designs.
+///
+struct biquad {
+    double b0 = 1.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Low-pass section.
+    ///
+    /// @param[in]  cutoff  Cutoff frequency.
+    /// @param[in]  rate    Sampling rate (same units as *cutoff*).
+    /// @param[in]  q       Quality factor. Defaults to 1 / sqrt(2) (Butterworth).
+    ///
+    static biquad lowpass(double cutoff, double rate, double q = butterworth_q);
+
+    //--------------------------------------------------------------------------
+    /// @brief      High-pass section.
+    ///
+    static biquad highpass(double cutoff, double rate, double q = butterworth_q);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Band-pass section (0 dB peak gain).
+    ///
+    static biquad bandpass(double center, double rate, double q);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Notch (band-stop) section.
+    ///
+    static biquad notch(double center, double rate, double q);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Butterworth filter design, as a cascade of biquad sections.
+///
+/// @param[in]  order     Filter order (> 0). Odd orders include a first order section.
+/// @param[in]  cutoff    Cutoff (-3 dB) frequency.
+/// @param[in]  rate      Sampling rate (same units as *cutoff*).
+/// @param[in]  highpass  High-pass flag. Defaults to false (low-pass).
+///
+/// @return     Biquad sections.
+///
+inline vector< biquad > butterworth(size_t order, double cutoff, double rate, bool highpass = false);
+
+//------------------------------------------------------------------------------
+/// @brief      Infinite impulse response filter, as a cascade of biquad sections (transposed direct form II).
+///
+/// @tparam     T     Sample type.
+///
+template < typename T >
+class iir {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      State (and accumulator) type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  sections  Biquad sections, applied in order.
+    /// @param[in]  channels  Number of channels. Defaults to 1.
+    ///
+    explicit iir(const vector< biquad >& sections, size_t channels = 1);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples.
+    ///
+    /// @param[in]  in    Input block (samples x channels).
+    /// @param[in]  out   Output block (samples x channels). May alias *in*.
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    void process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (samples x channels).
+    ///
+    matrix< T > process(const matrix< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filters a block of samples (single channel).
+    ///
+    vector< T > process(const vector< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets filter state (i.e. zero state).
+    ///
+    void reset();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Initializes filter state as if *row* had been input indefinitely (steady state).
+    ///
+    void initialize(const T* row);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Recommended edge padding (samples) for zero-phase filtering, i.e. 3 * (2 * sections + 1).
+    ///
+    size_t padding() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Biquad sections.
+    ///
+    const vector< biquad >& sections() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of channels.
+    ///
+    size_t channels() const;
+
+ protected:
+    vector< biquad > _sections;
+    size_t _channels;
+    vector< value_type > _z1;    ///< per-section, per-channel state (sections x channels)
+    vector< value_type > _z2;    ///< per-section, per-channel state (sections x channels)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Zero-phase filtering, i.e. filters forward and backward, w/ odd extension of edges (cf. padding()) and
+///             steady state initialization.
+///
+/// @param[in]  filter  Filter (copied, i.e. its state is not modified).
+/// @param[in]  in      Input samples (samples x channels).
+/// @param[in]  out     Output samples (samples x channels). May alias *in*.
+/// @param      pool    Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     Filter  Filter type (e.g. fir< T >, iir< T >).
+///
+/// @throws     std::invalid_argument if (non-empty) input has no more samples than filter.padding().
+///
+template < typename Filter, typename T >
+void filtfilt(Filter filter, matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Zero-phase filtering of all columns of *in* (cf. filtfilt()).
+///
+template < typename Filter, typename T >
+matrix< T > filtfilt(const Filter& filter, const matrix< T >& in);
+
+//------------------------------------------------------------------------------
+/// @brief      Zero-phase filtering of a single channel (cf. filtfilt()).
+///
+template < typename Filter, typename T >
+vector< T > filtfilt(const Filter& filter, const vector< T >& in);
+
+}  // namespace filtering
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename T >
+filtering::moving_average< T >::moving_average(size_t window, size_t channels)
+    : _window(max< size_t >(window, 1)), _channels(channels), _buffer(_window * channels), _sum(channels, value_type(0)) {
+    // ...
+}
+
+
+
+template < typename T >
+void filtering::moving_average< T >::process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    assert(in.cols() == _channels && out.cols() == _channels && in.rows() == out.rows());
+    size_t rows = in.rows();
+    size_t count = _count;
+    size_t head = _head;
+    parallel_for(0, _channels, [&](size_t first, size_t last) {
+        size_t n = count;
+        size_t h = head;
+        for (size_t i = 0; i < rows; i++) {
+            const T* x = in.data() + i * _channels;
+            T* y = out.data() + i * _channels;
+            T* slot = _buffer.data() + h * _channels;
+            bool full = (n == _window);
+            n += !full;
+            value_type scale = value_type(1) / static_cast< value_type >(n);
+            for (size_t j = first; j < last; j++) {
+                T v = x[j];
+                _sum[j] += static_cast< value_type >(v) - (full ? static_cast< value_type >(slot[j]) : value_type(0));
+                slot[j] = v;
+                y[j] = static_cast< T >(_sum[j] * scale);
+            }
+            h = (h + 1) % _window;
+            if (!h && full) {
+                // resynchronize running sums once per window (bounds rounding drift, O(1) amortized)
+                for (size_t j = first; j < last; j++) {
+                    value_type sum = value_type(0);
+                    for (size_t k = 0; k < _window; k++) {
+                        sum += static_cast< value_type >(_buffer[k * _channels + j]);
+                    }
+                    _sum[j] = sum;
+                }
+            }
+        }
+    }, filtering::min_channels, pool);
+    _count = min(_window, _count + rows);
+    _head = (_head + rows) % _window;
+}
+
+
+
+template < typename T >
+matrix< T > filtering::moving_average< T >::process(const matrix< T >& in) {
+    matrix< T > out(in.rows(), in.cols());
+    process(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()));
+    return out;
+}
+
+
+
+template < typename T >
+vector< T > filtering::moving_average< T >::process(const vector< T >& in) {
+    vector< T > out(in.size());
+    process(matrix_view< const T >(in.data(), in.size(), 1), matrix_view< T >(out.data(), out.size(), 1));
+    return out;
+}
+
+
+
+template < typename T >
+void filtering::moving_average< T >::reset() {
+    _count = 0;
+    _head = 0;
+    std::fill(_sum.begin(), _sum.end(), value_type(0));
+}
+
+
+
+template < typename T >
+void filtering::moving_average< T >::initialize(const T* row) {
+    for (size_t k = 0; k < _window; k++) {
+        std::copy(row, row + _channels, _buffer.data() + k * _channels);
+    }
+    for (size_t j = 0; j < _channels; j++) {
+        _sum[j] = static_cast< value_type >(row[j]) * static_cast< value_type >(_window);
+    }
+    _count = _window;
+    _head = 0;
+}
+
+
+
+template < typename T >
+size_t filtering::moving_average< T >::padding() const {
+    return _window;
+}
+
+
+
+template < typename T >
+size_t filtering::moving_average< T >::window() const {
+    return _window;
+}
+
+
+
+template < typename T >
+size_t filtering::moving_average< T >::channels() const {
+    return _channels;
+}
+
+
+
+template < typename T, typename Compare >
+filtering::moving_extremum< T, Compare >::moving_extremum(size_t window, size_t channels)
+    : _window(max< size_t >(window, 1)), _channels(channels), _values(_window * channels), _positions(_window * channels), _front(channels, 0), _size(channels, 0) {
+    // ...
+}
+
+
+
+template < typename T, typename Compare >
+void filtering::moving_extremum< T, Compare >::process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    assert(in.cols() == _channels && out.cols() == _channels && in.rows() == out.rows());
+    size_t rows = in.rows();
+    Compare comp;
+    parallel_for(0, _channels, [&](size_t first, size_t last) {
+        for (size_t j = first; j < last; j++) {
+            T* values = _values.data() + j * _window;
+            size_t* positions = _positions.data() + j * _window;
+            size_t front = _front[j];
+            size_t size = _size[j];
+            for (size_t i = 0; i < rows; i++) {
+                size_t position = _position + i;
+                T v = in.data()[i * _channels + j];
+                // drop expired front, then dominated back entries (queue is monotonic w.r.t. Compare)
+                if (size && positions[front] + _window <= position) {
+                    front = (front + 1) % _window;
+                    size--;
+                }
+                while (size && !comp(values[(front + size - 1) % _window], v)) {
+                    size--;
+                }
+                size_t back = (front + size) % _window;
+                values[back] = v;
+                positions[back] = position;
+                size++;
+                out.data()[i * _channels + j] = values[front];
+            }
+            _front[j] = front;
+            _size[j] = size;
+        }
+    }, filtering::min_channels, pool);
+    _position += rows;
+}
+
+
+
+template < typename T, typename Compare >
+matrix< T > filtering::moving_extremum< T, Compare >::process(const matrix< T >& in) {
+    matrix< T > out(in.rows(), in.cols());
+    process(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()));
+    return out;
+}
+
+
+
+template < typename T, typename Compare >
+vector< T > filtering::moving_extremum< T, Compare >::process(const vector< T >& in) {
+    vector< T > out(in.size());
+    process(matrix_view< const T >(in.data(), in.size(), 1), matrix_view< T >(out.data(), out.size(), 1));
+    return out;
+}
+
+
+
+template < typename T, typename Compare >
+void filtering::moving_extremum< T, Compare >::reset() {
+    _position = 0;
+    std::fill(_front.begin(), _front.end(), 0);
+    std::fill(_size.begin(), _size.end(), 0);
+}
+
+
+
+template < typename T, typename Compare >
+void filtering::moving_extremum< T, Compare >::initialize(const T* row) {
+    reset();
+    for (size_t j = 0; j < _channels; j++) {
+        _values[j * _window] = row[j];
+        _positions[j * _window] = 0;
+        _size[j] = 1;
+    }
+    // constant history: a single queued entry, kept for a full window
+    _position = 1;
+}
+
+
+
+template < typename T, typename Compare >
+size_t filtering::moving_extremum< T, Compare >::padding() const {
+    return _window;
+}
+
+
+
+template < typename T, typename Compare >
+size_t filtering::moving_extremum< T, Compare >::window() const {
+    return _window;
+}
+
+
+
+template < typename T, typename Compare >
+size_t filtering::moving_extremum< T, Compare >::channels() const {
+    return _channels;
+}
+
+
+
+template < typename T >
+filtering::fir< T >::fir(const vector< value_type >& taps, size_t channels, fir_method algorithm)
+    : _taps(taps), _channels(channels) {
+    if (_taps.empty()) {
+        throw invalid_argument("filtering::fir(): empty filter");
+    }
+    _fft = (algorithm == fir_method::fft) || (algorithm == fir_method::automatic && _taps.size() >= filtering::fft_taps);
+    size_t length = _taps.size();
+    if (_fft) {
+        // segments of (at least) as many samples as taps, i.e. FFT size >= 2 * taps - 1
+        _size = fft::next_power_of_two(2 * length - 1);
+        _spectrum.assign(_size, complex< value_type >(0));
+        std::copy(_taps.begin(), _taps.end(), _spectrum.begin());
+        fft::plan< value_type >::get(_size).forward(_spectrum.data());
+        _tail.assign(_channels * (length - 1), value_type(0));
+    } else {
+        _history.assign((length - 1) * _channels, T(0));
+    }
+}
+
+
+
+template < typename T >
+void filtering::fir< T >::process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    assert(in.cols() == _channels && out.cols() == _channels && in.rows() == out.rows());
+    if (_fft) {
+        overlap_add(in, out, pool);
+    } else {
+        direct(in, out, pool);
+    }
+}
+
+
+
+template < typename T >
+void filtering::fir< T >::direct(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    size_t rows = in.rows();
+    size_t length = _taps.size();
+    size_t delay = length - 1;
+    // extended input: history followed by block (also decouples aliased input/output)
+    vector< T > extended((delay + rows) * _channels);
+    std::copy(_history.begin(), _history.end(), extended.begin());
+    std::copy(in.data(), in.data() + rows * _channels, extended.begin() + delay * _channels);
+    parallel_for(0, rows, [&](size_t first, size_t last) {
+        vector< value_type > acc(_channels);
+        for (size_t i = first; i < last; i++) {
+            std::fill(acc.begin(), acc.end(), value_type(0));
+            // y[i] = sum(b[k] * x[i - k]), i.e. row (i + delay - k) of extended input
+            for (size_t k = 0; k < length; k++) {
+                value_type b = _taps[k];
+                const T* x = extended.data() + (i + delay - k) * _channels;
+                for (size_t j = 0; j < _channels; j++) {
+                    acc[j] += b * static_cast< value_type >(x[j]);
+                }
+            }
+            T* y = out.data() + i * _channels;
+            for (size_t j = 0; j < _channels; j++) {
+                y[j] = static_cast< T >(acc[j]);
+            }
+        }
+    }, filtering::min_rows, pool);
+    std::copy(extended.end() - delay * _channels, extended.end(), _history.begin());
+}
+
+
+
+template < typename T >
+void filtering::fir< T >::overlap_add(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    typedef complex< value_type > complex_type;
+    size_t rows = in.rows();
+    size_t delay = _taps.size() - 1;
+    size_t segment = _size - delay;
+    const auto& plan = fft::plan< value_type >::get(_size);
+    // channels are transformed in pairs, packed as real & imaginary parts (filter is real i.e. outputs remain separable)
+    size_t pairs = (_channels + 1) / 2;
+    parallel_for(0, pairs, [&](size_t first, size_t last) {
+        vector< complex_type > buffer(_size);
+        vector< value_type > y(2 * _size);
+        for (size_t p = first; p < last; p++) {
+            size_t c0 = 2 * p;
+            size_t c1 = c0 + 1;
+            bool paired = c1 < _channels;
+            value_type* tail0 = _tail.data() + c0 * delay;
+            value_type* tail1 = paired ? _tail.data() + c1 * delay : nullptr;
+            for (size_t start = 0; start < rows; start += segment) {
+                size_t n = min(segment, rows - start);
+                std::fill(buffer.begin(), buffer.end(), complex_type(0));
+                for (size_t i = 0; i < n; i++) {
+                    const T* x = in.data() + (start + i) * _channels;
+                    buffer[i] = complex_type(static_cast< value_type >(x[c0]), paired ? static_cast< value_type >(x[c1]) : value_type(0));
+                }
+                plan.forward(buffer.data());
+                for (size_t k = 0; k < _size; k++) {
+                    buffer[k] *= _spectrum[k];
+                }
+                plan.inverse(buffer.data());
+                // output: first n samples of segment convolution, plus pending overlap
+                for (size_t i = 0; i < n; i++) {
+                    T* row = out.data() + (start + i) * _channels;
+                    row[c0] = static_cast< T >(buffer[i].real() + ((i < delay) ? tail0[i] : value_type(0)));
+                    if (paired) {
+                        row[c1] = static_cast< T >(buffer[i].imag() + ((i < delay) ? tail1[i] : value_type(0)));
+                    }
+                }
+                // new overlap: remaining convolution samples, plus not yet emitted overlap
+                for (size_t t = 0; t < delay; t++) {
+                    size_t i = n + t;
+                    tail0[t] = buffer[i].real() + ((i < delay) ? tail0[i] : value_type(0));
+                    if (paired) {
+                        tail1[t] = buffer[i].imag() + ((i < delay) ? tail1[i] : value_type(0));
+                    }
+                }
+            }
+        }
+    }, max< size_t >(1, filtering::min_channels / 2), pool);
+}
+
+
+
+template < typename T >
+matrix< T > filtering::fir< T >::process(const matrix< T >& in) {
+    matrix< T > out(in.rows(), in.cols());
+    process(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()));
+    return out;
+}
+
+
+
+template < typename T >
+vector< T > filtering::fir< T >::process(const vector< T >& in) {
+    vector< T > out(in.size());
+    process(matrix_view< const T >(in.data(), in.size(), 1), matrix_view< T >(out.data(), out.size(), 1));
+    return out;
+}
+
+
+
+template < typename T >
+void filtering::fir< T >::reset() {
+    std::fill(_history.begin(), _history.end(), T(0));
+    std::fill(_tail.begin(), _tail.end(), value_type(0));
+}
+
+
+
+template < typename T >
+void filtering::fir< T >::initialize(const T* row) {
+    size_t delay = _taps.size() - 1;
+    if (!_fft) {
+        for (size_t k = 0; k < delay; k++) {
+            std::copy(row, row + _channels, _history.data() + k * _channels);
+        }
+        return;
+    }
+    // pending overlap of a constant past input: tail[t] = x * sum(b[k], k > t)
+    value_type suffix = value_type(0);
+    for (size_t t = delay; t-- > 0;) {
+        suffix += _taps[t + 1];
+        for (size_t j = 0; j < _channels; j++) {
+            _tail[j * delay + t] = static_cast< value_type >(row[j]) * suffix;
+        }
+    }
+}
+
+
+
+template < typename T >
+size_t filtering::fir< T >::padding() const {
+    return 3 * _taps.size();
+}
+
+
+
+template < typename T >
+const vector< typename filtering::fir< T >::value_type >& filtering::fir< T >::taps() const {
+    return _taps;
+}
+
+
+
+template < typename T >
+size_t filtering::fir< T >::channels() const {
+    return _channels;
+}
+
+
+
+inline filtering::biquad filtering::biquad::lowpass(double cutoff, double rate, double q) {
+    double w0 = 2.0 * pi * cutoff / rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double c = cos(w0);
+    double a0 = 1.0 + alpha;
+    biquad out;
+    out.b0 = (1.0 - c) / 2.0 / a0;
+    out.b1 = (1.0 - c) / a0;
+    out.b2 = out.b0;
+    out.a1 = -2.0 * c / a0;
+    out.a2 = (1.0 - alpha) / a0;
+    return out;
+}
+
+
+
+inline filtering::biquad filtering::biquad::highpass(double cutoff, double rate, double q) {
+    double w0 = 2.0 * pi * cutoff / rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double c = cos(w0);
+    double a0 = 1.0 + alpha;
+    biquad out;
+    out.b0 = (1.0 + c) / 2.0 / a0;
+    out.b1 = -(1.0 + c) / a0;
+    out.b2 = out.b0;
+    out.a1 = -2.0 * c / a0;
+    out.a2 = (1.0 - alpha) / a0;
+    return out;
+}
+
+
+
+inline filtering::biquad filtering::biquad::bandpass(double center, double rate, double q) {
+    double w0 = 2.0 * pi * center / rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+    biquad out;
+    out.b0 = alpha / a0;
+    out.b1 = 0.0;
+    out.b2 = -alpha / a0;
+    out.a1 = -2.0 * cos(w0) / a0;
+    out.a2 = (1.0 - alpha) / a0;
+    return out;
+}
+
+
+
+inline filtering::biquad filtering::biquad::notch(double center, double rate, double q) {
+    double w0 = 2.0 * pi * center / rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+    biquad out;
+    out.b0 = 1.0 / a0;
+    out.b1 = -2.0 * cos(w0) / a0;
+    out.b2 = out.b0;
+    out.a1 = out.b1;
+    out.a2 = (1.0 - alpha) / a0;
+    return out;
+}
+
+
+
+inline vector< filtering::biquad > filtering::butterworth(size_t order, double cutoff, double rate, bool highpass) {
+    if (!order || !(cutoff > 0.0) || !(cutoff < rate / 2.0)) {
+        throw invalid_argument("filtering::butterworth(): invalid order or cutoff frequency");
+    }
+    vector< biquad > sections;
+    // conjugate pole pairs at angles phi from the negative real axis, i.e. Q = 1 / (2 cos(phi))
+    for (size_t k = 0; k < order / 2; k++) {
+        double phi = (order % 2) ? pi * (k + 1) / order : pi * (2 * k + 1) / (2 * order);
+        double q = 1.0 / (2.0 * cos(phi));
+        sections.push_back(highpass ? biquad::highpass(cutoff, rate, q) : biquad::lowpass(cutoff, rate, q));
+    }
+    if (order % 2) {
+        // real pole: first order (bilinear) section
+        double k = tan(pi * cutoff / rate);
+        biquad first;
+        first.b0 = highpass ? 1.0 / (1.0 + k) : k / (1.0 + k);
+        first.b1 = highpass ? -first.b0 : first.b0;
+        first.a1 = (k - 1.0) / (k + 1.0);
+        sections.push_back(first);
+    }
+    return sections;
+}
+
+
+
+template < typename T >
+filtering::iir< T >::iir(const vector< biquad >& sections, size_t channels)
+    : _sections(sections), _channels(channels), _z1(sections.size() * channels, value_type(0)), _z2(sections.size() * channels, value_type(0)) {
+    // ...
+}
+
+
+
+template < typename T >
+void filtering::iir< T >::process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    assert(in.cols() == _channels && out.cols() == _channels && in.rows() == out.rows());
+    size_t rows = in.rows();
+    size_t n_sections = _sections.size();
+    parallel_for(0, _channels, [&](size_t first, size_t last) {
+        vector< value_type > v(last - first);
+        for (size_t i = 0; i < rows; i++) {
+            const T* x = in.data() + i * _channels;
+            for (size_t j = first; j < last; j++) {
+                v[j - first] = static_cast< value_type >(x[j]);
+            }
+            for (size_t s = 0; s < n_sections; s++) {
+                const biquad& section = _sections[s];
+                value_type b0 = section.b0, b1 = section.b1, b2 = section.b2, a1 = section.a1, a2 = section.a2;
+                value_type* z1 = _z1.data() + s * _channels;
+                value_type* z2 = _z2.data() + s * _channels;
+                // transposed direct form II, vectorized across channels
+                for (size_t j = first; j < last; j++) {
+                    value_type u = v[j - first];
+                    value_type y = b0 * u + z1[j];
+                    z1[j] = b1 * u - a1 * y + z2[j];
+                    z2[j] = b2 * u - a2 * y;
+                    v[j - first] = y;
+                }
+            }
+            T* y = out.data() + i * _channels;
+            for (size_t j = first; j < last; j++) {
+                y[j] = static_cast< T >(v[j - first]);
+            }
+        }
+    }, filtering::min_channels, pool);
+}
+
+
+
+template < typename T >
+matrix< T > filtering::iir< T >::process(const matrix< T >& in) {
+    matrix< T > out(in.rows(), in.cols());
+    process(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()));
+    return out;
+}
+
+
+
+template < typename T >
+vector< T > filtering::iir< T >::process(const vector< T >& in) {
+    vector< T > out(in.size());
+    process(matrix_view< const T >(in.data(), in.size(), 1), matrix_view< T >(out.data(), out.size(), 1));
+    return out;
+}
+
+
+
+template < typename T >
+void filtering::iir< T >::reset() {
+    std::fill(_z1.begin(), _z1.end(), value_type(0));
+    std::fill(_z2.begin(), _z2.end(), value_type(0));
+}
+
+
+
+template < typename T >
+void filtering::iir< T >::initialize(const T* row) {
+    for (size_t j = 0; j < _channels; j++) {
+        value_type u = static_cast< value_type >(row[j]);
+        for (size_t s = 0; s < _sections.size(); s++) {
+            const biquad& section = _sections[s];
+            // steady state for constant input u: y = G u, w/ G = B(1) / A(1) (DC gain)
+            double denominator = 1.0 + section.a1 + section.a2;
+            value_type y = (denominator != 0.0) ? u * static_cast< value_type >((section.b0 + section.b1 + section.b2) / denominator) : value_type(0);
+            value_type z2 = static_cast< value_type >(section.b2) * u - static_cast< value_type >(section.a2) * y;
+            _z2[s * _channels + j] = z2;
+            _z1[s * _channels + j] = static_cast< value_type >(section.b1) * u - static_cast< value_type >(section.a1) * y + z2;
+            u = y;
+        }
+    }
+}
+
+
+
+template < typename T >
+size_t filtering::iir< T >::padding() const {
+    return 3 * (2 * _sections.size() + 1);
+}
+
+
+
+template < typename T >
+const vector< filtering::biquad >& filtering::iir< T >::sections() const {
+    return _sections;
+}
+
+
+
+template < typename T >
+size_t filtering::iir< T >::channels() const {
+    return _channels;
+}
+
+
+
+template < typename Filter, typename T >
+void filtering::filtfilt(Filter filter, matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    assert(in.rows() == out.rows() && in.cols() == out.cols());
+    size_t rows = in.rows();
+    size_t cols = in.cols();
+    if (!rows) {
+        return;
+    }
+    // odd extension mirrors *pad* samples about each edge, i.e. requires more than *pad* samples (as scipy.signal.filtfilt)
+    size_t pad = filter.padding();
+    if (rows <= pad) {
+        throw invalid_argument("filtering::filtfilt(): input shorter than (or equal to) padding");
+    }
+    size_t n = rows + 2 * pad;
+    // odd extension: x[-k] = 2 x[0] - x[k], x[N - 1 + k] = 2 x[N - 1] - x[N - 1 - k]
+    vector< T > extended(n * cols);
+    std::copy(in.data(), in.data() + rows * cols, extended.begin() + pad * cols);
+    const T* front = in.data();
+    const T* back = in.data() + (rows - 1) * cols;
+    for (size_t k = 1; k <= pad; k++) {
+        T* before = extended.data() + (pad - k) * cols;
+        T* after = extended.data() + (pad + rows - 1 + k) * cols;
+        const T* mirror_front = in.data() + k * cols;
+        const T* mirror_back = in.data() + (rows - 1 - k) * cols;
+        for (size_t j = 0; j < cols; j++) {
+            before[j] = static_cast< T >(2 * front[j] - mirror_front[j]);
+            after[j] = static_cast< T >(2 * back[j] - mirror_back[j]);
+        }
+    }
+    matrix_view< T > view(extended.data(), n, cols);
+    auto reverse_rows = [&]() {
+        for (size_t i = 0; i < n / 2; i++) {
+            std::swap_ranges(extended.data() + i * cols, extended.data() + (i + 1) * cols, extended.data() + (n - 1 - i) * cols);
+        }
+    };
+    for (size_t pass = 0; pass < 2; pass++) {
+        filter.reset();
+        filter.initialize(extended.data());
+        filter.process(view, view, pool);
+        reverse_rows();
+    }
+    std::copy(extended.begin() + pad * cols, extended.begin() + (pad + rows) * cols, out.data());
+}
+
+
+
+template < typename Filter, typename T >
+matrix< T > filtering::filtfilt(const Filter& filter, const matrix< T >& in) {
+    matrix< T > out(in.rows(), in.cols());
+    filtfilt(filter, matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()));
+    return out;
+}
+
+
+
+template < typename Filter, typename T >
+vector< T > filtering::filtfilt(const Filter& filter, const vector< T >& in) {
+    vector< T > out(in.size());
+    filtfilt(filter, matrix_view< const T >(in.data(), in.size(), 1), matrix_view< T >(out.data(), out.size(), 1));
+    return out;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_FILTER_HPP_
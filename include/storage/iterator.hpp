@@ -1,6 +1,8 @@
 #ifndef PSEUDO_ITERATOR_HPP
 #define PSEUDO_ITERATOR_HPP
 #include <iterator>
+#include <cassert>
+#include <cstddef>
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Provides a pseudo-iterator class for generic storage container classes, requiring:
 // 1) size_t size() [for runtime assertions]
@@ -13,9 +15,9 @@ namespace storage {
 template <typename _CT>
 class st_pseudo_iterator {
 	_CT* container; // requires size() for runtime size assertion, operator[](int) for value access
-	int pos; 
+	size_t pos; // size_t, for containers beyond 2^31 elements (e.g. std::chunked_volume)
 public:
-	st_pseudo_iterator(_CT* _d, int _p): container(_d),pos(_p) { assert(_p >= 0 && _p <= container->size()); };
+	st_pseudo_iterator(_CT* _d, size_t _p): container(_d),pos(_p) { assert(_p <= container->size()); };
 	void operator++() { pos++; };
 	auto operator*() -> decltype((*container)[pos]) { return (*container)[pos]; }; //C++11
 	// auto& operator*()  { return (*container)[pos]; }; //C++14
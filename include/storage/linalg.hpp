@@ -0,0 +1,537 @@
+//------------------------------------------------------------------------------
+/// @file       linalg.hpp
+/// @author     João André
+///
+/// @brief      Dense linear algebra over contiguous (row-major) storage i.e. std::matrix and std::matrix_view: matrix
+///             product (GEMM), LU (partial pivoting) and Cholesky decompositions, and linear system solvers.
+///
+/// All routines operate in-place on matrix_view instances (zero-copy), w/ std::matrix convenience overloads returning
+/// new matrices. Single and double precision calls are dispatched to an external CBLAS/LAPACKE implementation
+/// (e.g. OpenBLAS, BLIS, MKL) when CPP_UTILS_USE_BLAS is defined (cf. cpp_utils_USE_BLAS CMake option), passing
+/// storage pointers directly (LAPACK_ROW_MAJOR, leading dimension = cols); otherwise (or for other element types) the
+/// built-in (cache-blocked, multithreaded) kernels are used.
+///
+/// @note       Both backends return the same results up to rounding, as accumulation order differs between them.
+///             Built-in kernels remain available as linalg::details overloads, cf. bench/linalg.cpp (backend cross-check).
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_LINALG_HPP_
+#define STORAGE_INCLUDE_STORAGE_LINALG_HPP_
+
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+
+#ifdef CPP_UTILS_USE_BLAS
+#include <cblas.h>
+#include <lapacke.h>
+#endif
+
+namespace std {
+namespace linalg {
+
+//------------------------------------------------------------------------------
+/// @brief      Number of rows of C processed per (parallel) GEMM task.
+///
+constexpr size_t block_rows = 64;
+
+//------------------------------------------------------------------------------
+/// @brief      Depth (inner dimension) of GEMM blocks, sized so that a block of B rows remains in cache.
+///
+constexpr size_t block_depth = 256;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of columns of C processed per GEMM block.
+///
+constexpr size_t block_cols = 512;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of trailing rows updated in parallel in LU/Cholesky factorizations.
+///
+constexpr size_t min_parallel_rows = 128;
+
+//------------------------------------------------------------------------------
+/// @brief      Checks if calls on *T* elements are dispatched to the external CBLAS/LAPACKE backend.
+///
+template < typename T >
+constexpr bool external() {
+#ifdef CPP_UTILS_USE_BLAS
+    return is_same< typename remove_const< T >::type, float >::value || is_same< typename remove_const< T >::type, double >::value;
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/// @brief      General matrix product, i.e. C = alpha * A * B + beta * C.
+///
+/// @param[in]  alpha  Scaling factor of product.
+/// @param[in]  a      Left-hand side operand (m x k).
+/// @param[in]  b      Right-hand side operand (k x n).
+/// @param[in]  beta   Scaling factor of C. If zero, C is not read (i.e. may be uninitialized).
+/// @param[in]  c      Output (m x n).
+/// @param      pool   Thread pool (built-in backend only). Defaults to shared pool instance.
+///
+/// @tparam     T      Element type (arithmetic).
+///
+/// @note       C must not overlap A or B.
+///
+template < typename T >
+void gemm(T alpha, matrix_view< const T > a, matrix_view< const T > b, T beta, matrix_view< T > c, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Matrix product, i.e. A * B.
+///
+/// @param[in]  a     Left-hand side operand (m x k).
+/// @param[in]  b     Right-hand side operand (k x n).
+/// @param      pool  Thread pool (built-in backend only). Defaults to shared pool instance.
+///
+/// @return     Product (m x n).
+///
+/// @throws     std::invalid_argument if dimensions do not agree.
+///
+template < typename T >
+matrix< T > product(const matrix< T >& a, const matrix< T >& b, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      In-place LU decomposition w/ partial (row) pivoting, i.e. P * A = L * U.
+///
+/// @param[in]  a       Square matrix. On return, holds U in its upper triangle and L (unit diagonal omitted) below it.
+/// @param      pivots  Output pivot indexes (0-based), i.e. row i was interchanged with row pivots[i].
+/// @param      pool    Thread pool (built-in backend only). Defaults to shared pool instance.
+///
+/// @throws     std::runtime_error if *a* is (exactly) singular.
+///
+template < typename T >
+void lu_factor(matrix_view< T > a, vector< size_t >& pivots, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Solves A * X = B in-place, given the LU decomposition of A (cf. lu_factor()).
+///
+/// @param[in]  lu      LU decomposition of A (n x n).
+/// @param[in]  pivots  Pivot indexes of LU decomposition.
+/// @param[in]  b       Right-hand side(s) (n x nrhs). On return, holds solution X.
+///
+template < typename T >
+void lu_solve(matrix_view< const T > lu, const vector< size_t >& pivots, matrix_view< T > b);
+
+//------------------------------------------------------------------------------
+/// @brief      In-place Cholesky decomposition of a symmetric positive definite matrix, i.e. A = L * L^T.
+///
+/// @param[in]  a     Symmetric positive definite matrix (only its lower triangle is read). On return, holds L in its
+///                   lower triangle, w/ upper triangle set to zero.
+/// @param      pool  Thread pool (built-in backend only). Defaults to shared pool instance.
+///
+/// @throws     std::runtime_error if *a* is not positive definite.
+///
+template < typename T >
+void cholesky_factor(matrix_view< T > a, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      LU decomposition w/ partial pivoting (cf. lu_factor()).
+///
+/// @param[in]  a       Square matrix.
+/// @param      pivots  Output pivot indexes.
+///
+/// @return     Packed LU factors.
+///
+template < typename T >
+matrix< T > lu(const matrix< T >& a, vector< size_t >& pivots);
+
+//------------------------------------------------------------------------------
+/// @brief      Cholesky decomposition (cf. cholesky_factor()).
+///
+/// @param[in]  a     Symmetric positive definite matrix.
+///
+/// @return     Lower triangular factor L.
+///
+template < typename T >
+matrix< T > cholesky(const matrix< T >& a);
+
+//------------------------------------------------------------------------------
+/// @brief      Solves linear system(s) A * X = B (LU decomposition w/ partial pivoting).
+///
+/// @param[in]  a     Square coefficient matrix (n x n).
+/// @param[in]  b     Right-hand side(s) (n x nrhs).
+///
+/// @return     Solution X (n x nrhs).
+///
+/// @throws     std::invalid_argument if dimensions do not agree, std::runtime_error if *a* is singular.
+///
+template < typename T >
+matrix< T > solve(const matrix< T >& a, const matrix< T >& b);
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Built-in GEMM kernel, over rows [first, last) of C.
+///
+template < typename T >
+void gemm(T alpha, const matrix_view< const T >& a, const matrix_view< const T >& b, T beta, const matrix_view< T >& c, size_t first, size_t last);
+
+//------------------------------------------------------------------------------
+/// @brief      Built-in GEMM, i.e. C = alpha * A * B + beta * C (cf. linalg::gemm()), over row blocks in parallel.
+///
+template < typename T >
+void gemm(T alpha, matrix_view< const T > a, matrix_view< const T > b, T beta, matrix_view< T > c, work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Built-in LU decomposition w/ partial pivoting (cf. linalg::lu_factor()).
+///
+template < typename T >
+void lu_factor(matrix_view< T > a, vector< size_t >& pivots, work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Built-in LU solver (cf. linalg::lu_solve()).
+///
+template < typename T >
+void lu_solve(matrix_view< const T > lu, const vector< size_t >& pivots, matrix_view< T > b);
+
+//------------------------------------------------------------------------------
+/// @brief      Built-in Cholesky decomposition (cf. linalg::cholesky_factor()).
+///
+template < typename T >
+void cholesky_factor(matrix_view< T > a, work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Executes *function(first, last)* over row range [first, last), in parallel if large enough.
+///
+template < typename Function >
+void for_rows(size_t first, size_t last, Function&& function, work_stealing_pool& pool);
+
+}  // namespace details
+
+}  // namespace linalg
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename T >
+void linalg::details::gemm(T alpha, const matrix_view< const T >& a, const matrix_view< const T >& b, T beta, const matrix_view< T >& c, size_t first, size_t last) {
+    size_t depth = a.cols();
+    size_t n = c.cols();
+    for (size_t i = first; i < last; i++) {
+        T* c_row = c.data() + i * n;
+        if (beta == T(0)) {
+            // BLAS semantics: C is not read when beta is zero (NaN/Inf in C are discarded)
+            std::fill(c_row, c_row + n, T(0));
+        } else if (beta != T(1)) {
+            for (size_t j = 0; j < n; j++) {
+                c_row[j] *= beta;
+            }
+        }
+    }
+    // i-k-j loop order: innermost loop is a contiguous (vectorizable) axpy of a row of B into a row of C; blocks of
+    // block_depth rows of B and block_cols columns are reused across all rows in [first, last)
+    for (size_t jj = 0; jj < n; jj += linalg::block_cols) {
+        size_t j_last = min(n, jj + linalg::block_cols);
+        for (size_t kk = 0; kk < depth; kk += linalg::block_depth) {
+            size_t k_last = min(depth, kk + linalg::block_depth);
+            for (size_t i = first; i < last; i++) {
+                const T* a_row = a.data() + i * depth;
+                T* c_row = c.data() + i * n;
+                for (size_t k = kk; k < k_last; k++) {
+                    T scale = alpha * a_row[k];
+                    const T* b_row = b.data() + k * n;
+                    for (size_t j = jj; j < j_last; j++) {
+                        c_row[j] += scale * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+template < typename Function >
+void linalg::details::for_rows(size_t first, size_t last, Function&& function, work_stealing_pool& pool) {
+    if (last - first < linalg::min_parallel_rows || pool.size() < 2) {
+        function(first, last);
+        return;
+    }
+    parallel_for(first, last, function, linalg::min_parallel_rows / 2, pool);
+}
+
+
+
+template < typename T >
+void linalg::gemm(T alpha, matrix_view< const T > a, matrix_view< const T > b, T beta, matrix_view< T > c, work_stealing_pool& pool) {
+    assert(a.cols() == b.rows() && a.rows() == c.rows() && b.cols() == c.cols());
+    if (c.isEmpty()) {
+        return;
+    }
+#ifdef CPP_UTILS_USE_BLAS
+    if constexpr (is_same< T, float >::value) {
+        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, c.rows(), c.cols(), a.cols(), alpha, a.data(), max< size_t >(1, a.cols()), b.data(), c.cols(), beta, c.data(), c.cols());
+        return;
+    } else if constexpr (is_same< T, double >::value) {
+        cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, c.rows(), c.cols(), a.cols(), alpha, a.data(), max< size_t >(1, a.cols()), b.data(), c.cols(), beta, c.data(), c.cols());
+        return;
+    }
+#endif
+    details::gemm(alpha, a, b, beta, c, pool);
+}
+
+
+
+template < typename T >
+void linalg::details::gemm(T alpha, matrix_view< const T > a, matrix_view< const T > b, T beta, matrix_view< T > c, work_stealing_pool& pool) {
+    parallel_for(0, c.rows(), [&](size_t first, size_t last) {
+        gemm(alpha, a, b, beta, c, first, last);
+    }, linalg::block_rows, pool);
+}
+
+
+
+template < typename T >
+matrix< T > linalg::product(const matrix< T >& a, const matrix< T >& b, work_stealing_pool& pool) {
+    if (a.cols() != b.rows()) {
+        throw invalid_argument("linalg::product(): dimension mismatch");
+    }
+    matrix< T > c(a.rows(), b.cols());
+    gemm(T(1), matrix_view< const T >(a.data(), a.rows(), a.cols()), matrix_view< const T >(b.data(), b.rows(), b.cols()), T(0), matrix_view< T >(c.data(), c.rows(), c.cols()), pool);
+    return c;
+}
+
+
+
+template < typename T >
+void linalg::lu_factor(matrix_view< T > a, vector< size_t >& pivots, work_stealing_pool& pool) {
+    assert(a.rows() == a.cols());
+    size_t n = a.rows();
+    pivots.resize(n);
+#ifdef CPP_UTILS_USE_BLAS
+    if constexpr (external< T >()) {
+        vector< lapack_int > ipiv(n);
+        lapack_int info = 0;
+        if constexpr (is_same< T, float >::value) {
+            info = LAPACKE_sgetrf(LAPACK_ROW_MAJOR, n, n, a.data(), max< size_t >(1, n), ipiv.data());
+        } else {
+            info = LAPACKE_dgetrf(LAPACK_ROW_MAJOR, n, n, a.data(), max< size_t >(1, n), ipiv.data());
+        }
+        if (info > 0) {
+            throw runtime_error("linalg::lu_factor(): singular matrix");
+        }
+        for (size_t i = 0; i < n; i++) {
+            pivots[i] = static_cast< size_t >(ipiv[i] - 1);
+        }
+        return;
+    }
+#endif
+    details::lu_factor(a, pivots, pool);
+}
+
+
+
+template < typename T >
+void linalg::details::lu_factor(matrix_view< T > a, vector< size_t >& pivots, work_stealing_pool& pool) {
+    size_t n = a.rows();
+    pivots.resize(n);
+    for (size_t k = 0; k < n; k++) {
+        // partial pivoting: largest magnitude in column k (at or below diagonal)
+        size_t p = k;
+        for (size_t i = k + 1; i < n; i++) {
+            if (abs(a(i, k)) > abs(a(p, k))) {
+                p = i;
+            }
+        }
+        pivots[k] = p;
+        if (a(p, k) == T(0)) {
+            throw runtime_error("linalg::lu_factor(): singular matrix");
+        }
+        if (p != k) {
+            std::swap_ranges(a.data() + k * n, a.data() + (k + 1) * n, a.data() + p * n);
+        }
+        // rank-1 update of trailing submatrix, row-wise (contiguous)
+        T inv = T(1) / a(k, k);
+        const T* pivot_row = a.data() + k * n;
+        for_rows(k + 1, n, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                T* row = a.data() + i * n;
+                T l = (row[k] *= inv);
+                for (size_t j = k + 1; j < n; j++) {
+                    row[j] -= l * pivot_row[j];
+                }
+            }
+        }, pool);
+    }
+}
+
+
+
+template < typename T >
+void linalg::lu_solve(matrix_view< const T > lu, const vector< size_t >& pivots, matrix_view< T > b) {
+    assert(lu.rows() == lu.cols() && lu.rows() == b.rows() && pivots.size() == lu.rows());
+    size_t n = lu.rows();
+    size_t nrhs = b.cols();
+    if (!n || !nrhs) {
+        return;
+    }
+#ifdef CPP_UTILS_USE_BLAS
+    if constexpr (external< T >()) {
+        vector< lapack_int > ipiv(n);
+        for (size_t i = 0; i < n; i++) {
+            ipiv[i] = static_cast< lapack_int >(pivots[i] + 1);
+        }
+        if constexpr (is_same< T, float >::value) {
+            LAPACKE_sgetrs(LAPACK_ROW_MAJOR, 'N', n, nrhs, lu.data(), n, ipiv.data(), b.data(), nrhs);
+        } else {
+            LAPACKE_dgetrs(LAPACK_ROW_MAJOR, 'N', n, nrhs, lu.data(), n, ipiv.data(), b.data(), nrhs);
+        }
+        return;
+    }
+#endif
+    details::lu_solve(lu, pivots, b);
+}
+
+
+
+template < typename T >
+void linalg::details::lu_solve(matrix_view< const T > lu, const vector< size_t >& pivots, matrix_view< T > b) {
+    size_t n = lu.rows();
+    size_t nrhs = b.cols();
+    for (size_t i = 0; i < n; i++) {
+        if (pivots[i] != i) {
+            std::swap_ranges(b.data() + i * nrhs, b.data() + (i + 1) * nrhs, b.data() + pivots[i] * nrhs);
+        }
+    }
+    // forward substitution (unit lower triangle), row-wise over all right-hand sides
+    for (size_t i = 1; i < n; i++) {
+        T* row = b.data() + i * nrhs;
+        for (size_t k = 0; k < i; k++) {
+            T l = lu(i, k);
+            const T* solved = b.data() + k * nrhs;
+            for (size_t j = 0; j < nrhs; j++) {
+                row[j] -= l * solved[j];
+            }
+        }
+    }
+    // back substitution (upper triangle)
+    for (size_t i = n; i-- > 0;) {
+        T* row = b.data() + i * nrhs;
+        for (size_t k = i + 1; k < n; k++) {
+            T u = lu(i, k);
+            const T* solved = b.data() + k * nrhs;
+            for (size_t j = 0; j < nrhs; j++) {
+                row[j] -= u * solved[j];
+            }
+        }
+        T inv = T(1) / lu(i, i);
+        for (size_t j = 0; j < nrhs; j++) {
+            row[j] *= inv;
+        }
+    }
+}
+
+
+
+template < typename T >
+void linalg::cholesky_factor(matrix_view< T > a, work_stealing_pool& pool) {
+    assert(a.rows() == a.cols());
+#ifdef CPP_UTILS_USE_BLAS
+    if constexpr (external< T >()) {
+        size_t n = a.rows();
+        lapack_int info = 0;
+        if constexpr (is_same< T, float >::value) {
+            info = LAPACKE_spotrf(LAPACK_ROW_MAJOR, 'L', n, a.data(), max< size_t >(1, n));
+        } else {
+            info = LAPACKE_dpotrf(LAPACK_ROW_MAJOR, 'L', n, a.data(), max< size_t >(1, n));
+        }
+        if (info > 0) {
+            throw runtime_error("linalg::cholesky_factor(): matrix is not positive definite");
+        }
+        for (size_t i = 0; i < n; i++) {
+            std::fill(a.data() + i * n + i + 1, a.data() + (i + 1) * n, T(0));
+        }
+        return;
+    }
+#endif
+    details::cholesky_factor(a, pool);
+}
+
+
+
+template < typename T >
+void linalg::details::cholesky_factor(matrix_view< T > a, work_stealing_pool& pool) {
+    size_t n = a.rows();
+    // column-by-column (left-looking) factorization; inner products run over contiguous row prefixes of L
+    for (size_t j = 0; j < n; j++) {
+        const T* l_j = a.data() + j * n;
+        T d = a(j, j);
+        for (size_t k = 0; k < j; k++) {
+            d -= l_j[k] * l_j[k];
+        }
+        if (!(d > T(0))) {
+            throw runtime_error("linalg::cholesky_factor(): matrix is not positive definite");
+        }
+        T diag = sqrt(d);
+        a(j, j) = diag;
+        T inv = T(1) / diag;
+        for_rows(j + 1, n, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                T* l_i = a.data() + i * n;
+                T s = l_i[j];
+                for (size_t k = 0; k < j; k++) {
+                    s -= l_i[k] * l_j[k];
+                }
+                l_i[j] = s * inv;
+            }
+        }, pool);
+        std::fill(a.data() + j * n + j + 1, a.data() + (j + 1) * n, T(0));
+    }
+}
+
+
+
+template < typename T >
+matrix< T > linalg::lu(const matrix< T >& a, vector< size_t >& pivots) {
+    if (a.rows() != a.cols()) {
+        throw invalid_argument("linalg::lu(): matrix is not square");
+    }
+    matrix< T > out(a);
+    lu_factor(matrix_view< T >(out.data(), out.rows(), out.cols()), pivots);
+    return out;
+}
+
+
+
+template < typename T >
+matrix< T > linalg::cholesky(const matrix< T >& a) {
+    if (a.rows() != a.cols()) {
+        throw invalid_argument("linalg::cholesky(): matrix is not square");
+    }
+    matrix< T > out(a);
+    cholesky_factor(matrix_view< T >(out.data(), out.rows(), out.cols()));
+    return out;
+}
+
+
+
+template < typename T >
+matrix< T > linalg::solve(const matrix< T >& a, const matrix< T >& b) {
+    if (a.rows() != a.cols() || a.rows() != b.rows()) {
+        throw invalid_argument("linalg::solve(): dimension mismatch");
+    }
+    vector< size_t > pivots;
+    matrix< T > factors = lu(a, pivots);
+    matrix< T > x(b);
+    lu_solve(matrix_view< const T >(factors.data(), factors.rows(), factors.cols()), pivots, matrix_view< T >(x.data(), x.rows(), x.cols()));
+    return x;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_LINALG_HPP_
@@ -43,6 +43,11 @@ using matrix_subset = storage::st_subset_base< matrix< dT > >;
 template < typename dT >
 using matrix_subset_const = storage::st_subset_base< const matrix< dT > >;
 
+//------------------------------------------------------------------------------
+/// @brief      Non-owning 2D view over contiguous row-major storage (cf. storage/view.hpp).
+///
+template < typename T > class matrix_view;
+
 //------------------------------------------------------------------------------
 /// @brief      Class implementing a STL-like 2D container
 ///
@@ -159,6 +164,16 @@ class matrix {
     template < typename iT, typename = typename enable_if< !is_nd_container< iT >()>::type, typename = void >
     explicit matrix(const storage::st_subset_base< iT >& in);    // from non-nd containers, constructs unidimensional matrix;
 
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance, copying the elements (and shape) of a matrix view.
+    ///
+    /// @param[in]  in   Input view (cf. storage/view.hpp).
+    ///
+    /// @tparam     iT   Input element type (possibly const-qualified), which must be convertible to T.
+    ///
+    template < typename iT, typename = typename enable_if< is_convertible< iT, T >::value >::type >
+    explicit matrix(const matrix_view< iT >& in);
+
     //--------------------------------------------------------------------------
     /// @brief      Constructs a new [*rows* x *cols*] matrix, sourcing elements from a generic container.
     ///
@@ -872,6 +887,15 @@ matrix< T >::matrix(const storage::st_subset_base< iT >& in) {
 }
 
 
+template < typename T >
+template < typename iT, typename >
+matrix< T >::matrix(const matrix_view< iT >& in) {
+    _rows = in.rows();
+    _cols = in.cols();
+    _data = vector< T >(in.data(), in.data() + in.rows() * in.cols());
+}
+
+
 template < typename T >
 template < typename iT, typename >  // input type == generic container, requires size() and operator[](size_t)
 matrix< T >::matrix(size_t rows, size_t cols, const iT& in) {
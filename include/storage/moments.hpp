@@ -0,0 +1,1039 @@
+//------------------------------------------------------------------------------
+/// @file       moments.hpp
+/// @author     João André
+///
+/// @brief      Single-pass, mergeable statistics accumulators for generic storage containers (e.g. std::vector,
+///             std::matrix, std::volume, views and subsets): count, mean, central moments (M2/M3/M4), min/max and
+///             covariance, w/ scalar, batch and per-column (optionally windowed) updates.
+///
+/// Scalar updates follow Welford's algorithm (extended to higher order moments by Terriberry); partial accumulators are
+/// combined w/ Chan/Pébay's pairwise update formulas, thus per-thread or per-chunk partials can be merged exactly as if
+/// all values had been pushed sequentially (up to rounding). Batch updates process input in cache-sized chunks of
+/// batch_chunk elements: each chunk is reduced lane-wise (cf. summation.hpp) in two vectorizable sweeps (mean, then
+/// central moments and min/max) and merged into the accumulator, which is both faster and more accurate than
+/// element-wise Welford updates.
+///
+/// Integer data is accumulated in double precision; floating point data in its own precision.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_MOMENTS_HPP_
+#define STORAGE_INCLUDE_STORAGE_MOMENTS_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include "storage/type_check.hpp"
+#include "storage/blas.hpp"
+#include "storage/summation.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace stats {
+
+//------------------------------------------------------------------------------
+/// @brief      Number of elements per batch update chunk.
+///
+constexpr size_t batch_chunk = 4096;
+
+//------------------------------------------------------------------------------
+/// @brief      Mergeable accumulator of count, mean, 2nd to 4th central moments, min and max of a stream of values.
+///
+/// @tparam     T     Value type.
+///
+template < typename T >
+class moments {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Accumulator (result) type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new (empty) instance.
+    ///
+    moments() = default;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds a single value (Welford update).
+    ///
+    /// @param[in]  value  Input value.
+    ///
+    void push(const T& value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds all elements of *container* (batch update).
+    ///
+    /// @param[in]  container  Input container.
+    ///
+    /// @tparam     Container  Container type, requiring size() and operator[](size_t).
+    ///
+    template < typename Container, typename = typename enable_if< is_generic_container< Container >() >::type >
+    void push(const Container& container);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges another accumulator, i.e. combines statistics of both streams.
+    ///
+    /// @param[in]  other  Accumulator to merge.
+    ///
+    /// @return     Reference to self.
+    ///
+    moments& merge(const moments& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges another accumulator (cf. merge()).
+    ///
+    moments& operator+=(const moments& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Clears accumulated statistics.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of accumulated values.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Mean of accumulated values. NaN if empty.
+    ///
+    value_type mean() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Variance of accumulated values.
+    ///
+    /// @param[in]  ddof  Delta degrees of freedom, i.e. divisor is N - ddof. Defaults to 0 (population variance).
+    ///
+    /// @return     Variance. NaN if N <= ddof.
+    ///
+    value_type variance(size_t ddof = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Standard deviation of accumulated values, i.e. sqrt(variance()).
+    ///
+    value_type stddev(size_t ddof = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Skewness (population, i.e. biased) of accumulated values.
+    ///
+    value_type skewness() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Excess kurtosis (population, i.e. biased) of accumulated values.
+    ///
+    value_type kurtosis() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Minimum of accumulated values. Undefined if empty.
+    ///
+    T min() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Maximum of accumulated values. Undefined if empty.
+    ///
+    T max() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sum of squared deviations from the mean (2nd central moment, unnormalized).
+    ///
+    value_type m2() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sum of cubed deviations from the mean (3rd central moment, unnormalized).
+    ///
+    value_type m3() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sum of 4th powers of deviations from the mean (4th central moment, unnormalized).
+    ///
+    value_type m4() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds elements [first, last) of *x* as a single chunk (two lane-wise sweeps, then merge).
+    ///
+    /// @param[in]  x         Input container or accessor, requiring operator[](size_t).
+    /// @param[in]  first     First index.
+    /// @param[in]  last      Last index (exclusive).
+    ///
+    template < typename Accessor >
+    void push(const Accessor& x, size_t first, size_t last);
+
+ protected:
+    size_t _count = 0;
+    value_type _mean = value_type(0);
+    value_type _m2 = value_type(0);
+    value_type _m3 = value_type(0);
+    value_type _m4 = value_type(0);
+    T _min = numeric_limits< T >::has_infinity ? numeric_limits< T >::infinity() : numeric_limits< T >::max();
+    T _max = numeric_limits< T >::has_infinity ? -numeric_limits< T >::infinity() : numeric_limits< T >::lowest();
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Mergeable accumulator of means, variances and covariance of a stream of paired values (x, y).
+///
+/// @tparam     T     Value type.
+///
+template < typename T >
+class covariance {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Accumulator (result) type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new (empty) instance.
+    ///
+    covariance() = default;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds a single pair of values.
+    ///
+    void push(const T& x, const T& y);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds all element pairs (x[i], y[i]) of two equally sized containers (batch update).
+    ///
+    /// @tparam     X     Container type, requiring size() and operator[](size_t).
+    /// @tparam     Y     Container type, requiring size() and operator[](size_t).
+    ///
+    template < typename X, typename Y, typename = typename enable_if< is_generic_container< X >() && is_generic_container< Y >() >::type >
+    void push(const X& x, const Y& y);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges another accumulator, i.e. combines statistics of both streams.
+    ///
+    covariance& merge(const covariance& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges another accumulator (cf. merge()).
+    ///
+    covariance& operator+=(const covariance& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Clears accumulated statistics.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of accumulated pairs.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Mean of x values. NaN if empty.
+    ///
+    value_type mean_x() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Mean of y values. NaN if empty.
+    ///
+    value_type mean_y() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Variance of x values (divisor N - ddof). NaN if N <= ddof.
+    ///
+    value_type variance_x(size_t ddof = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Variance of y values (divisor N - ddof). NaN if N <= ddof.
+    ///
+    value_type variance_y(size_t ddof = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Covariance of x and y (divisor N - ddof). NaN if N <= ddof.
+    ///
+    value_type value(size_t ddof = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Pearson correlation coefficient of x and y. NaN if either variance is zero.
+    ///
+    value_type correlation() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds pairs [first, last) of *x* and *y* as a single chunk (two lane-wise sweeps, then merge).
+    ///
+    template < typename xAccessor, typename yAccessor >
+    void push(const xAccessor& x, const yAccessor& y, size_t first, size_t last);
+
+ protected:
+    size_t _count = 0;
+    value_type _mean_x = value_type(0);
+    value_type _mean_y = value_type(0);
+    value_type _m2_x = value_type(0);
+    value_type _m2_y = value_type(0);
+    value_type _c = value_type(0);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Per-column mean, variance, min and max of a stream of rows (e.g. samples of a multichannel signal),
+///             either cumulative or over a sliding window of the last *window* rows.
+///
+/// Updates run over contiguous rows, i.e. columns are updated independently in vectorizable loops. Windowed
+/// accumulators keep a ring buffer of the last *window* rows and replace the oldest row in-place (Welford
+/// add/remove update); min/max are then evaluated on demand, over the buffer.
+///
+/// @tparam     T     Value type.
+///
+template < typename T >
+class columns {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Accumulator (result) type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  cols    Number of columns (row size).
+    /// @param[in]  window  Number of (most recent) rows to accumulate. Defaults to 0 (cumulative).
+    ///
+    explicit columns(size_t cols = 0, size_t window = 0);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds a row.
+    ///
+    /// @param[in]  row        Input row, w/ cols() elements.
+    ///
+    /// @tparam     Container  Container type, requiring size() and operator[](size_t).
+    ///
+    template < typename Container >
+    void push(const Container& row);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds all rows of *rows*, in order.
+    ///
+    /// @param[in]  rows  Input rows, w/ cols() columns.
+    ///
+    void push_rows(matrix_view< const T > rows);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges another (cumulative) accumulator, i.e. combines statistics of both streams.
+    ///
+    /// @note       Not available for windowed accumulators.
+    ///
+    columns& merge(const columns& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Clears accumulated statistics.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of columns.
+    ///
+    size_t cols() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Window size (0 if cumulative).
+    ///
+    size_t window() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of accumulated rows (at most window(), if windowed).
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Per-column means.
+    ///
+    const vector< value_type >& mean() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Per-column variances (divisor N - ddof). NaN if N <= ddof.
+    ///
+    vector< value_type > variance(size_t ddof = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Per-column standard deviations (divisor N - ddof). NaN if N <= ddof.
+    ///
+    vector< value_type > stddev(size_t ddof = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Per-column minima.
+    ///
+    vector< T > min() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Per-column maxima.
+    ///
+    vector< T > max() const;
+
+ protected:
+    size_t _cols;
+    size_t _window;
+    size_t _count = 0;
+    size_t _head = 0;              ///< position of oldest row in ring buffer (windowed)
+    vector< value_type > _mean;
+    vector< value_type > _m2;
+    vector< T > _min;              ///< cumulative only
+    vector< T > _max;              ///< cumulative only
+    vector< T > _buffer;           ///< ring buffer of last *window* rows (windowed only)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Accumulates all elements of *container*, in parallel (per-chunk partials merged in order).
+///
+/// @param[in]  container  Input container.
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @return     Accumulator of all elements.
+///
+template < typename Container >
+auto accumulate(const Container& container, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Accumulates all element pairs of *x* and *y*, in parallel (per-chunk partials merged in order).
+///
+/// @param[in]  x     Input container.
+/// @param[in]  y     Input container, w/ x.size() elements.
+/// @param      pool  Thread pool. Defaults to shared pool instance.
+///
+/// @return     Covariance accumulator of all pairs.
+///
+template < typename X, typename Y >
+auto accumulate(const X& x, const Y& y, work_stealing_pool& pool = work_stealing_pool::instance());
+
+}  // namespace stats
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename T >
+void stats::moments< T >::push(const T& value) {
+    value_type x = static_cast< value_type >(value);
+    value_type n1 = static_cast< value_type >(_count);
+    _count++;
+    value_type n = static_cast< value_type >(_count);
+    value_type delta = x - _mean;
+    value_type delta_n = delta / n;
+    value_type delta_n2 = delta_n * delta_n;
+    value_type term = delta * delta_n * n1;
+    _mean += delta_n;
+    _m4 += term * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * _m2 - 4 * delta_n * _m3;
+    _m3 += term * delta_n * (n - 2) - 3 * delta_n * _m2;
+    _m2 += term;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+}
+
+
+
+template < typename T >
+template < typename Container, typename >
+void stats::moments< T >::push(const Container& container) {
+    size_t n = container.size();
+    blas::details::dispatch(container, [&](const auto& x) {
+        for (size_t first = 0; first < n; first += stats::batch_chunk) {
+            push(x, first, std::min(n, first + stats::batch_chunk));
+        }
+    });
+}
+
+
+
+template < typename T >
+template < typename Accessor >
+void stats::moments< T >::push(const Accessor& x, size_t first, size_t last) {
+    constexpr size_t lanes = summation::lanes;
+    if (last <= first) {
+        return;
+    }
+    moments chunk;
+    chunk._count = last - first;
+    value_type n = static_cast< value_type >(chunk._count);
+    chunk._mean = summation::details::naive< value_type >(x, first, last, [](const T& v) { return static_cast< value_type >(v); }) / n;
+    value_type m2[lanes] = { };
+    value_type m3[lanes] = { };
+    value_type m4[lanes] = { };
+    value_type deviations[lanes] = { };
+    T lo[lanes];
+    T hi[lanes];
+    std::fill(lo, lo + lanes, _min);
+    std::fill(hi, hi + lanes, _max);
+    size_t i = first;
+    value_type mu = chunk._mean;
+    auto step = [&](size_t k, const T& v) {
+        value_type d = static_cast< value_type >(v) - mu;
+        value_type d2 = d * d;
+        deviations[k] += d;
+        m2[k] += d2;
+        m3[k] += d2 * d;
+        m4[k] += d2 * d2;
+        lo[k] = (v < lo[k]) ? v : lo[k];
+        hi[k] = (v > hi[k]) ? v : hi[k];
+    };
+    for (; i + lanes <= last; i += lanes) {
+        for (size_t k = 0; k < lanes; k++) {
+            step(k, x[i + k]);
+        }
+    }
+    for (size_t k = 0; i < last; i++, k++) {
+        step(k, x[i]);
+    }
+    value_type deviation = value_type(0);
+    for (size_t k = 0; k < lanes; k++) {
+        deviation += deviations[k];
+        chunk._m2 += m2[k];
+        chunk._m3 += m3[k];
+        chunk._m4 += m4[k];
+        chunk._min = std::min(chunk._min, lo[k]);
+        chunk._max = std::max(chunk._max, hi[k]);
+    }
+    // correct for rounding errors in chunk mean (cf. summation::variance()); residual shift of higher order moments is
+    // negligible (second order in the error)
+    chunk._m2 -= deviation * deviation / n;
+    merge(chunk);
+}
+
+
+
+template < typename T >
+stats::moments< T >& stats::moments< T >::merge(const moments& other) {
+    if (!other._count) {
+        return *this;
+    }
+    if (!_count) {
+        *this = other;
+        return *this;
+    }
+    value_type na = static_cast< value_type >(_count);
+    value_type nb = static_cast< value_type >(other._count);
+    value_type n = na + nb;
+    value_type delta = other._mean - _mean;
+    value_type delta_n = delta / n;
+    value_type delta_n2 = delta_n * delta_n;
+    value_type term = delta * delta_n * na * nb;
+    _m4 += other._m4 + term * delta_n2 * (na * na - na * nb + nb * nb) + 6 * delta_n2 * (na * na * other._m2 + nb * nb * _m2) + 4 * delta_n * (na * other._m3 - nb * _m3);
+    _m3 += other._m3 + term * delta_n * (na - nb) + 3 * delta_n * (na * other._m2 - nb * _m2);
+    _m2 += other._m2 + term;
+    _mean += delta_n * nb;
+    _count += other._count;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    return *this;
+}
+
+
+
+template < typename T >
+stats::moments< T >& stats::moments< T >::operator+=(const moments& other) {
+    return merge(other);
+}
+
+
+
+template < typename T >
+void stats::moments< T >::clear() {
+    *this = moments();
+}
+
+
+
+template < typename T >
+size_t stats::moments< T >::count() const {
+    return _count;
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::mean() const {
+    return _count ? _mean : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::variance(size_t ddof) const {
+    return (_count > ddof) ? _m2 / static_cast< value_type >(_count - ddof) : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::stddev(size_t ddof) const {
+    return sqrt(variance(ddof));
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::skewness() const {
+    return sqrt(static_cast< value_type >(_count)) * _m3 / pow(_m2, value_type(1.5));
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::kurtosis() const {
+    return static_cast< value_type >(_count) * _m4 / (_m2 * _m2) - 3;
+}
+
+
+
+template < typename T >
+T stats::moments< T >::min() const {
+    return _min;
+}
+
+
+
+template < typename T >
+T stats::moments< T >::max() const {
+    return _max;
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::m2() const {
+    return _m2;
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::m3() const {
+    return _m3;
+}
+
+
+
+template < typename T >
+typename stats::moments< T >::value_type stats::moments< T >::m4() const {
+    return _m4;
+}
+
+
+
+template < typename T >
+void stats::covariance< T >::push(const T& x, const T& y) {
+    _count++;
+    value_type n = static_cast< value_type >(_count);
+    value_type dx = static_cast< value_type >(x) - _mean_x;
+    value_type dy = static_cast< value_type >(y) - _mean_y;
+    _mean_x += dx / n;
+    _mean_y += dy / n;
+    value_type ey = static_cast< value_type >(y) - _mean_y;
+    _m2_x += dx * (static_cast< value_type >(x) - _mean_x);
+    _m2_y += dy * ey;
+    _c += dx * ey;
+}
+
+
+
+template < typename T >
+template < typename X, typename Y, typename >
+void stats::covariance< T >::push(const X& x, const Y& y) {
+    assert(x.size() == y.size());
+    size_t n = x.size();
+    blas::details::dispatch(x, [&](const auto& xa) {
+        blas::details::dispatch(y, [&](const auto& ya) {
+            for (size_t first = 0; first < n; first += stats::batch_chunk) {
+                push(xa, ya, first, std::min(n, first + stats::batch_chunk));
+            }
+        });
+    });
+}
+
+
+
+template < typename T >
+template < typename xAccessor, typename yAccessor >
+void stats::covariance< T >::push(const xAccessor& x, const yAccessor& y, size_t first, size_t last) {
+    constexpr size_t lanes = summation::lanes;
+    if (last <= first) {
+        return;
+    }
+    covariance chunk;
+    chunk._count = last - first;
+    value_type n = static_cast< value_type >(chunk._count);
+    auto cast = [](const auto& v) { return static_cast< value_type >(v); };
+    value_type mx = chunk._mean_x = summation::details::naive< value_type >(x, first, last, cast) / n;
+    value_type my = chunk._mean_y = summation::details::naive< value_type >(y, first, last, cast) / n;
+    value_type sxx[lanes] = { };
+    value_type syy[lanes] = { };
+    value_type sxy[lanes] = { };
+    value_type sx[lanes] = { };
+    value_type sy[lanes] = { };
+    auto step = [&](size_t k, size_t i) {
+        value_type dx = static_cast< value_type >(x[i]) - mx;
+        value_type dy = static_cast< value_type >(y[i]) - my;
+        sx[k] += dx;
+        sy[k] += dy;
+        sxx[k] += dx * dx;
+        syy[k] += dy * dy;
+        sxy[k] += dx * dy;
+    };
+    size_t i = first;
+    for (; i + lanes <= last; i += lanes) {
+        for (size_t k = 0; k < lanes; k++) {
+            step(k, i + k);
+        }
+    }
+    for (size_t k = 0; i < last; i++, k++) {
+        step(k, i);
+    }
+    value_type dx = value_type(0);
+    value_type dy = value_type(0);
+    for (size_t k = 0; k < lanes; k++) {
+        dx += sx[k];
+        dy += sy[k];
+        chunk._m2_x += sxx[k];
+        chunk._m2_y += syy[k];
+        chunk._c += sxy[k];
+    }
+    // correct for rounding errors in chunk means
+    chunk._m2_x -= dx * dx / n;
+    chunk._m2_y -= dy * dy / n;
+    chunk._c -= dx * dy / n;
+    merge(chunk);
+}
+
+
+
+template < typename T >
+stats::covariance< T >& stats::covariance< T >::merge(const covariance& other) {
+    if (!other._count) {
+        return *this;
+    }
+    if (!_count) {
+        *this = other;
+        return *this;
+    }
+    value_type na = static_cast< value_type >(_count);
+    value_type nb = static_cast< value_type >(other._count);
+    value_type n = na + nb;
+    value_type dx = other._mean_x - _mean_x;
+    value_type dy = other._mean_y - _mean_y;
+    value_type w = na * nb / n;
+    _m2_x += other._m2_x + dx * dx * w;
+    _m2_y += other._m2_y + dy * dy * w;
+    _c += other._c + dx * dy * w;
+    _mean_x += dx * nb / n;
+    _mean_y += dy * nb / n;
+    _count += other._count;
+    return *this;
+}
+
+
+
+template < typename T >
+stats::covariance< T >& stats::covariance< T >::operator+=(const covariance& other) {
+    return merge(other);
+}
+
+
+
+template < typename T >
+void stats::covariance< T >::clear() {
+    *this = covariance();
+}
+
+
+
+template < typename T >
+size_t stats::covariance< T >::count() const {
+    return _count;
+}
+
+
+
+template < typename T >
+typename stats::covariance< T >::value_type stats::covariance< T >::mean_x() const {
+    return _count ? _mean_x : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+typename stats::covariance< T >::value_type stats::covariance< T >::mean_y() const {
+    return _count ? _mean_y : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+typename stats::covariance< T >::value_type stats::covariance< T >::variance_x(size_t ddof) const {
+    return (_count > ddof) ? _m2_x / static_cast< value_type >(_count - ddof) : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+typename stats::covariance< T >::value_type stats::covariance< T >::variance_y(size_t ddof) const {
+    return (_count > ddof) ? _m2_y / static_cast< value_type >(_count - ddof) : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+typename stats::covariance< T >::value_type stats::covariance< T >::value(size_t ddof) const {
+    return (_count > ddof) ? _c / static_cast< value_type >(_count - ddof) : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+typename stats::covariance< T >::value_type stats::covariance< T >::correlation() const {
+    value_type denominator = sqrt(_m2_x * _m2_y);
+    return (denominator > value_type(0)) ? _c / denominator : numeric_limits< value_type >::quiet_NaN();
+}
+
+
+
+template < typename T >
+stats::columns< T >::columns(size_t cols, size_t window)
+    : _cols(cols), _window(window), _mean(cols, value_type(0)), _m2(cols, value_type(0)) {
+    if (_window) {
+        _buffer.resize(_window * _cols);
+    } else {
+        _min.assign(_cols, moments< T >().min());
+        _max.assign(_cols, moments< T >().max());
+    }
+}
+
+
+
+template < typename T >
+template < typename Container >
+void stats::columns< T >::push(const Container& row) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    assert(row.size() == _cols);
+    blas::details::dispatch(row, [&](const auto& x) {
+        if (_window && _count == _window) {
+            // replace oldest row in-place: mean' = mean + (x - x_old) / n, M2' = M2 + (x - x_old) * (x - mean' + x_old - mean)
+            T* oldest = _buffer.data() + _head * _cols;
+            value_type n = static_cast< value_type >(_count);
+            for (size_t j = 0; j < _cols; j++) {
+                value_type v = static_cast< value_type >(x[j]);
+                value_type old = static_cast< value_type >(oldest[j]);
+                value_type mean = _mean[j] + (v - old) / n;
+                _m2[j] += (v - old) * (v - mean + old - _mean[j]);
+                _mean[j] = mean;
+                oldest[j] = x[j];
+            }
+            _head = (_head + 1) % _window;
+            return;
+        }
+        _count++;
+        value_type n = static_cast< value_type >(_count);
+        for (size_t j = 0; j < _cols; j++) {
+            value_type v = static_cast< value_type >(x[j]);
+            value_type delta = v - _mean[j];
+            _mean[j] += delta / n;
+            _m2[j] += delta * (v - _mean[j]);
+        }
+        if (_window) {
+            T* slot = _buffer.data() + ((_head + _count - 1) % _window) * _cols;
+            for (size_t j = 0; j < _cols; j++) {
+                slot[j] = x[j];
+            }
+        } else {
+            for (size_t j = 0; j < _cols; j++) {
+                _min[j] = std::min< T >(_min[j], x[j]);
+                _max[j] = std::max< T >(_max[j], x[j]);
+            }
+        }
+    });
+}
+
+
+
+template < typename T >
+void stats::columns< T >::push_rows(matrix_view< const T > rows) {
+    assert(rows.cols() == _cols);
+    for (size_t i = 0; i < rows.rows(); i++) {
+        push(rows.row(i));
+    }
+}
+
+
+
+template < typename T >
+stats::columns< T >& stats::columns< T >::merge(const columns& other) {
+    assert(!_window && !other._window && _cols == other._cols);
+    if (!other._count) {
+        return *this;
+    }
+    if (!_count) {
+        *this = other;
+        return *this;
+    }
+    value_type na = static_cast< value_type >(_count);
+    value_type nb = static_cast< value_type >(other._count);
+    value_type n = na + nb;
+    for (size_t j = 0; j < _cols; j++) {
+        value_type delta = other._mean[j] - _mean[j];
+        _m2[j] += other._m2[j] + delta * delta * na * nb / n;
+        _mean[j] += delta * nb / n;
+        _min[j] = std::min(_min[j], other._min[j]);
+        _max[j] = std::max(_max[j], other._max[j]);
+    }
+    _count += other._count;
+    return *this;
+}
+
+
+
+template < typename T >
+void stats::columns< T >::clear() {
+    *this = columns(_cols, _window);
+}
+
+
+
+template < typename T >
+size_t stats::columns< T >::cols() const {
+    return _cols;
+}
+
+
+
+template < typename T >
+size_t stats::columns< T >::window() const {
+    return _window;
+}
+
+
+
+template < typename T >
+size_t stats::columns< T >::count() const {
+    return _count;
+}
+
+
+
+template < typename T >
+const vector< typename stats::columns< T >::value_type >& stats::columns< T >::mean() const {
+    return _mean;
+}
+
+
+
+template < typename T >
+vector< typename stats::columns< T >::value_type > stats::columns< T >::variance(size_t ddof) const {
+    vector< value_type > out(_cols, numeric_limits< value_type >::quiet_NaN());
+    if (_count > ddof) {
+        value_type scale = value_type(1) / static_cast< value_type >(_count - ddof);
+        for (size_t j = 0; j < _cols; j++) {
+            // add/remove updates may drift slightly below zero on constant columns
+            out[j] = std::max(value_type(0), _m2[j] * scale);
+        }
+    }
+    return out;
+}
+
+
+
+template < typename T >
+vector< typename stats::columns< T >::value_type > stats::columns< T >::stddev(size_t ddof) const {
+    vector< value_type > out = variance(ddof);
+    for (auto& value : out) {
+        value = sqrt(value);
+    }
+    return out;
+}
+
+
+
+template < typename T >
+vector< T > stats::columns< T >::min() const {
+    if (!_window) {
+        return _min;
+    }
+    vector< T > out(_cols, moments< T >().min());
+    for (size_t i = 0; i < _count; i++) {
+        const T* row = _buffer.data() + i * _cols;
+        for (size_t j = 0; j < _cols; j++) {
+            out[j] = std::min(out[j], row[j]);
+        }
+    }
+    return out;
+}
+
+
+
+template < typename T >
+vector< T > stats::columns< T >::max() const {
+    if (!_window) {
+        return _max;
+    }
+    vector< T > out(_cols, moments< T >().max());
+    for (size_t i = 0; i < _count; i++) {
+        const T* row = _buffer.data() + i * _cols;
+        for (size_t j = 0; j < _cols; j++) {
+            out[j] = std::max(out[j], row[j]);
+        }
+    }
+    return out;
+}
+
+
+
+template < typename Container >
+auto stats::accumulate(const Container& container, work_stealing_pool& pool) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    typedef typename decay< decltype(container[0]) >::type value_type;
+    size_t n = container.size();
+    size_t n_chunks = (n + stats::batch_chunk - 1) / stats::batch_chunk;
+    vector< parallel::padded< moments< value_type > > > partials(n_chunks);
+    blas::details::dispatch(container, [&](const auto& x) {
+        parallel_for(0, n_chunks, [&](size_t first, size_t last) {
+            for (size_t chunk = first; chunk < last; chunk++) {
+                size_t begin = chunk * stats::batch_chunk;
+                partials[chunk].value.push(x, begin, std::min(n, begin + stats::batch_chunk));
+            }
+        }, 1, pool);
+    });
+    // merge in chunk order, i.e. result is independent of the number of threads
+    moments< value_type > out;
+    for (const auto& partial : partials) {
+        out.merge(partial.value);
+    }
+    return out;
+}
+
+
+
+template < typename X, typename Y >
+auto stats::accumulate(const X& x, const Y& y, work_stealing_pool& pool) {
+    static_assert(is_generic_container< X >() && is_generic_container< Y >(), "INVALID INPUT CONTAINER!");
+    assert(x.size() == y.size());
+    typedef typename common_type< typename decay< decltype(x[0]) >::type, typename decay< decltype(y[0]) >::type >::type value_type;
+    size_t n = x.size();
+    size_t n_chunks = (n + stats::batch_chunk - 1) / stats::batch_chunk;
+    vector< parallel::padded< covariance< value_type > > > partials(n_chunks);
+    blas::details::dispatch(x, [&](const auto& xa) {
+        blas::details::dispatch(y, [&](const auto& ya) {
+            parallel_for(0, n_chunks, [&](size_t first, size_t last) {
+                for (size_t chunk = first; chunk < last; chunk++) {
+                    size_t begin = chunk * stats::batch_chunk;
+                    partials[chunk].value.push(xa, ya, begin, std::min(n, begin + stats::batch_chunk));
+                }
+            }, 1, pool);
+        });
+    });
+    covariance< value_type > out;
+    for (const auto& partial : partials) {
+        out.merge(partial.value);
+    }
+    return out;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_MOMENTS_HPP_
@@ -0,0 +1,716 @@
+//------------------------------------------------------------------------------
+/// @file       multivariate.hpp
+/// @author     João André
+///
+/// @brief      Multivariate statistics over std::matrix data (samples x channels): covariance and correlation matrices
+///             of channels, and pairwise Euclidean distance matrices of samples (rows), w/ a streaming (row batch)
+///             covariance accumulator.
+///
+/// Work is formulated as blocked matrix products: covariance is the product of the (centered) data w/ its transpose,
+/// accumulated per block_channels x block_channels tile of the output as outer products of contiguous row segments
+/// (i.e. inner loops run over channels and vectorize), and pairwise distances derive from the Gram matrix of rows,
+/// computed per tile w/ lane-wise dot products over block_depth wide column blocks. Symmetric outputs compute only
+/// their upper triangle tiles (in parallel), mirrored once complete.
+///
+/// Samples are shifted by a reference sample (the first one) and centered per batch of batch_rows samples w/ corrected
+/// centering, and batches are combined w/ Chan's pairwise update; thus large data offsets cancel exactly instead of
+/// leaking rounding errors of the means, and results are independent of the number of threads. Pairwise distances are computed
+/// on column-centered data (distances are translation invariant), limiting cancellation in |x|^2 + |y|^2 - 2 x.y.
+///
+/// Integer data is accumulated in double precision; floating point data in its own precision.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_MULTIVARIATE_HPP_
+#define STORAGE_INCLUDE_STORAGE_MULTIVARIATE_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+#include "storage/summation.hpp"
+
+namespace std {
+namespace multivariate {
+
+//------------------------------------------------------------------------------
+/// @brief      Number of rows (samples) per centered batch.
+///
+constexpr size_t batch_rows = 4096;
+
+//------------------------------------------------------------------------------
+/// @brief      Size of (square) output tiles, i.e. channels (covariance) or samples (distances) per tile side.
+///
+constexpr size_t block_channels = 64;
+
+//------------------------------------------------------------------------------
+/// @brief      Depth (columns) of dot product blocks in Gram matrix tiles.
+///
+constexpr size_t block_depth = 256;
+
+//------------------------------------------------------------------------------
+/// @brief      Streaming (mergeable) accumulator of channel means and covariance matrix, updated w/ batches of rows.
+///
+/// @tparam     T     Sample type.
+///
+template < typename T >
+class scatter {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Accumulator (result) type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new (empty) instance.
+    ///
+    /// @param[in]  channels  Number of channels (columns).
+    ///
+    explicit scatter(size_t channels);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Accumulates all rows of *rows* (samples x channels()).
+    ///
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    void push(matrix_view< const T > rows, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Accumulates all rows of *rows* (samples x channels()).
+    ///
+    void push(const matrix< T >& rows, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges *other* accumulator (same number of channels) into this instance.
+    ///
+    scatter& merge(const scatter& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges *other* accumulator into this instance.
+    ///
+    scatter& operator+=(const scatter& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Clears accumulator.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of accumulated samples.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of channels.
+    ///
+    size_t channels() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Channel means.
+    ///
+    vector< value_type > means() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Covariance matrix (channels x channels), normalized by count() - ddof. NaN if count() <= ddof.
+    ///
+    matrix< value_type > covariance(size_t ddof = 1) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Pearson correlation matrix (channels x channels). NaN for channels w/ zero variance.
+    ///
+    matrix< value_type > correlation() const;
+
+ protected:
+    size_t _channels;
+    size_t _count = 0;
+    vector< value_type > _shift;        ///< reference sample (first pushed row), subtracted from all samples
+    vector< value_type > _mean;         ///< mean of shifted samples
+    vector< value_type > _comoment;     ///< sum of centered cross products (upper triangle, channels x channels)
+    vector< value_type > _buffer;       ///< centered batch (batch_rows x channels)
+    vector< value_type > _batch;        ///< batch comoment (channels x channels)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Covariance matrix of the columns (channels) of *data*.
+///
+/// @param[in]  data  Input samples (samples x channels).
+/// @param[in]  ddof  Delta degrees of freedom, i.e. normalization by samples - ddof. Defaults to 1.
+/// @param      pool  Thread pool. Defaults to shared pool instance.
+///
+/// @return     Covariance matrix (channels x channels).
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > covariance(matrix_view< const T > data, size_t ddof = 1, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Covariance matrix of the columns (channels) of *data* (cf. view overload).
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > covariance(const matrix< T >& data, size_t ddof = 1, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Pearson correlation matrix of the columns (channels) of *data*. NaN for channels w/ zero variance.
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > correlation(matrix_view< const T > data, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Pearson correlation matrix of the columns (channels) of *data* (cf. view overload).
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > correlation(const matrix< T >& data, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean distances between all pairs of rows (samples) of *data*.
+///
+/// @param[in]  data     Input points (samples x dimensions).
+/// @param[in]  squared  Squared distances flag. Defaults to false.
+/// @param      pool     Thread pool. Defaults to shared pool instance.
+///
+/// @return     Symmetric distance matrix (samples x samples), w/ zero diagonal.
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > pairwise_distances(matrix_view< const T > data, bool squared = false, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean distances between each row of *a* and each row of *b*.
+///
+/// @param[in]  a        First set of points (m x dimensions).
+/// @param[in]  b        Second set of points (n x dimensions).
+/// @param[in]  squared  Squared distances flag. Defaults to false.
+/// @param      pool     Thread pool. Defaults to shared pool instance.
+///
+/// @return     Distance matrix (m x n).
+///
+/// @throws     std::invalid_argument if dimensions do not agree.
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > pairwise_distances(matrix_view< const T > a, matrix_view< const T > b, bool squared = false, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean distances between all pairs of rows of *data* (cf. view overload).
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > pairwise_distances(const matrix< T >& data, bool squared = false, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean distances between each row of *a* and each row of *b* (cf. view overload).
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > pairwise_distances(const matrix< T >& a, const matrix< T >& b, bool squared = false, work_stealing_pool& pool = work_stealing_pool::instance());
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Accumulates upper triangle of X^T * X into *c* (d x d), i.e. c[i][j] += sum_r x[r][i] * x[r][j], j >= i.
+///
+/// @param[in]  x     Input (rows x d, contiguous).
+/// @param      c     Output (d x d, contiguous).
+///
+template < typename A >
+void syrk(const A* x, size_t rows, size_t d, A* c, work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Gram matrix of rows of *a* & *b*, i.e. g[i][j] = a[i] . b[j] (only j >= i if *symmetric*).
+///
+/// @param[in]  a     First input (m x d, contiguous).
+/// @param[in]  b     Second input (n x d, contiguous).
+/// @param      g     Output (m x n, contiguous).
+///
+template < typename A >
+void gram(const A* a, size_t m, const A* b, size_t n, size_t d, bool symmetric, A* g, work_stealing_pool& pool);
+
+//------------------------------------------------------------------------------
+/// @brief      Lane-wise dot product of *n* elements.
+///
+template < typename A >
+A dot(const A* x, const A* y, size_t n);
+
+//------------------------------------------------------------------------------
+/// @brief      Copies upper triangle of square matrix *c* (n x n) into its lower triangle.
+///
+template < typename A >
+void mirror(A* c, size_t n);
+
+}  // namespace details
+
+}  // namespace multivariate
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename A >
+A multivariate::details::dot(const A* x, const A* y, size_t n) {
+    A acc[summation::lanes] = { };
+    size_t i = 0;
+    for (; i + summation::lanes <= n; i += summation::lanes) {
+        for (size_t k = 0; k < summation::lanes; k++) {
+            acc[k] += x[i + k] * y[i + k];
+        }
+    }
+    for (; i < n; i++) {
+        acc[0] += x[i] * y[i];
+    }
+    A sum = A(0);
+    for (size_t k = 0; k < summation::lanes; k++) {
+        sum += acc[k];
+    }
+    return sum;
+}
+
+
+
+template < typename A >
+void multivariate::details::mirror(A* c, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        for (size_t j = 0; j < i; j++) {
+            c[i * n + j] = c[j * n + i];
+        }
+    }
+}
+
+
+
+template < typename A >
+void multivariate::details::syrk(const A* x, size_t rows, size_t d, A* c, work_stealing_pool& pool) {
+    // upper triangle tiles (I <= J), each accumulated independently
+    size_t n_tiles = (d + multivariate::block_channels - 1) / multivariate::block_channels;
+    vector< pair< size_t, size_t > > tiles;
+    for (size_t ti = 0; ti < n_tiles; ti++) {
+        for (size_t tj = ti; tj < n_tiles; tj++) {
+            tiles.emplace_back(ti, tj);
+        }
+    }
+    parallel_for(0, tiles.size(), [&](size_t first, size_t last) {
+        for (size_t t = first; t < last; t++) {
+            size_t i0 = tiles[t].first * multivariate::block_channels;
+            size_t i1 = std::min(d, i0 + multivariate::block_channels);
+            size_t j0 = tiles[t].second * multivariate::block_channels;
+            size_t j1 = std::min(d, j0 + multivariate::block_channels);
+            // outer products of row segments, 4 rows at a time (i.e. 4x fewer output tile loads/stores)
+            size_t r = 0;
+            for (; r + 4 <= rows; r += 4) {
+                const A* x0 = x + r * d;
+                const A* x1 = x0 + d;
+                const A* x2 = x1 + d;
+                const A* x3 = x2 + d;
+                for (size_t i = i0; i < i1; i++) {
+                    A a0 = x0[i];
+                    A a1 = x1[i];
+                    A a2 = x2[i];
+                    A a3 = x3[i];
+                    A* c_row = c + i * d;
+                    for (size_t j = std::max(j0, i); j < j1; j++) {
+                        c_row[j] += a0 * x0[j] + a1 * x1[j] + a2 * x2[j] + a3 * x3[j];
+                    }
+                }
+            }
+            for (; r < rows; r++) {
+                const A* x0 = x + r * d;
+                for (size_t i = i0; i < i1; i++) {
+                    A a0 = x0[i];
+                    A* c_row = c + i * d;
+                    for (size_t j = std::max(j0, i); j < j1; j++) {
+                        c_row[j] += a0 * x0[j];
+                    }
+                }
+            }
+        }
+    }, 1, pool);
+}
+
+
+
+template < typename A >
+void multivariate::details::gram(const A* a, size_t m, const A* b, size_t n, size_t d, bool symmetric, A* g, work_stealing_pool& pool) {
+    size_t m_tiles = (m + multivariate::block_channels - 1) / multivariate::block_channels;
+    size_t n_tiles = (n + multivariate::block_channels - 1) / multivariate::block_channels;
+    vector< pair< size_t, size_t > > tiles;
+    for (size_t ti = 0; ti < m_tiles; ti++) {
+        for (size_t tj = symmetric ? ti : 0; tj < n_tiles; tj++) {
+            tiles.emplace_back(ti, tj);
+        }
+    }
+    parallel_for(0, tiles.size(), [&](size_t first, size_t last) {
+        for (size_t t = first; t < last; t++) {
+            size_t i0 = tiles[t].first * multivariate::block_channels;
+            size_t i1 = std::min(m, i0 + multivariate::block_channels);
+            size_t j0 = tiles[t].second * multivariate::block_channels;
+            size_t j1 = std::min(n, j0 + multivariate::block_channels);
+            for (size_t i = i0; i < i1; i++) {
+                for (size_t j = symmetric ? std::max(j0, i) : j0; j < j1; j++) {
+                    g[i * n + j] = A(0);
+                }
+            }
+            // depth blocks, s.t. tile row segments remain in cache
+            for (size_t k0 = 0; k0 < d; k0 += multivariate::block_depth) {
+                size_t depth = std::min(d - k0, multivariate::block_depth);
+                for (size_t i = i0; i < i1; i++) {
+                    const A* a_row = a + i * d + k0;
+                    for (size_t j = symmetric ? std::max(j0, i) : j0; j < j1; j++) {
+                        g[i * n + j] += dot(a_row, b + j * d + k0, depth);
+                    }
+                }
+            }
+        }
+    }, 1, pool);
+}
+
+
+
+template < typename T >
+multivariate::scatter< T >::scatter(size_t channels)
+    : _channels(channels), _shift(channels, value_type(0)), _mean(channels, value_type(0)), _comoment(channels * channels, value_type(0)) {
+    // ...
+}
+
+
+
+template < typename T >
+void multivariate::scatter< T >::push(matrix_view< const T > rows, work_stealing_pool& pool) {
+    assert(rows.cols() == _channels);
+    size_t d = _channels;
+    if (!_count && rows.rows()) {
+        // samples are shifted by the first one, s.t. (running) means are stored w/o the data offset
+        for (size_t j = 0; j < d; j++) {
+            _shift[j] = value_type(rows.data()[j]);
+        }
+    }
+    for (size_t r0 = 0; r0 < rows.rows(); r0 += multivariate::batch_rows) {
+        size_t nb = std::min(rows.rows() - r0, multivariate::batch_rows);
+        const T* x = rows.data() + r0 * d;
+        // shifted batch & its mean
+        _buffer.resize(nb * d);
+        vector< value_type > mean(d, value_type(0));
+        for (size_t r = 0; r < nb; r++) {
+            for (size_t j = 0; j < d; j++) {
+                _buffer[r * d + j] = value_type(x[r * d + j]) - _shift[j];
+                mean[j] += _buffer[r * d + j];
+            }
+        }
+        for (size_t j = 0; j < d; j++) {
+            mean[j] /= value_type(nb);
+        }
+        for (size_t r = 0; r < nb; r++) {
+            for (size_t j = 0; j < d; j++) {
+                _buffer[r * d + j] -= mean[j];
+            }
+        }
+        // corrected centering: residual mean of centered batch (i.e. rounding error of batch mean) is removed from
+        // both batch and mean, s.t. it is not amplified by the gap between batch means in Chan's update
+        vector< value_type > residual(d, value_type(0));
+        for (size_t r = 0; r < nb; r++) {
+            for (size_t j = 0; j < d; j++) {
+                residual[j] += _buffer[r * d + j];
+            }
+        }
+        for (size_t j = 0; j < d; j++) {
+            residual[j] /= value_type(nb);
+            mean[j] += residual[j];
+        }
+        for (size_t r = 0; r < nb; r++) {
+            for (size_t j = 0; j < d; j++) {
+                _buffer[r * d + j] -= residual[j];
+            }
+        }
+        _batch.assign(d * d, value_type(0));
+        details::syrk(_buffer.data(), nb, d, _batch.data(), pool);
+        // Chan's update: C = C_a + C_b + delta * delta^T * n_a * n_b / n
+        size_t n = _count + nb;
+        value_type scale = value_type(_count) * value_type(nb) / value_type(n);
+        for (size_t j = 0; j < d; j++) {
+            mean[j] -= _mean[j];
+        }
+        for (size_t i = 0; i < d; i++) {
+            value_type di = mean[i] * scale;
+            value_type* c_row = _comoment.data() + i * d;
+            const value_type* b_row = _batch.data() + i * d;
+            for (size_t j = i; j < d; j++) {
+                c_row[j] += b_row[j] + di * mean[j];
+            }
+        }
+        for (size_t j = 0; j < d; j++) {
+            _mean[j] += mean[j] * value_type(nb) / value_type(n);
+        }
+        _count = n;
+    }
+}
+
+
+
+template < typename T >
+void multivariate::scatter< T >::push(const matrix< T >& rows, work_stealing_pool& pool) {
+    if (rows.cols() != _channels) {
+        throw invalid_argument("multivariate::scatter::push(): channel mismatch");
+    }
+    push(matrix_view< const T >(rows.data(), rows.rows(), rows.cols()), pool);
+}
+
+
+
+template < typename T >
+multivariate::scatter< T >& multivariate::scatter< T >::merge(const scatter& other) {
+    assert(other._channels == _channels);
+    if (!other._count) {
+        return *this;
+    }
+    if (!_count) {
+        _shift = other._shift;
+        _mean = other._mean;
+        _comoment = other._comoment;
+        _count = other._count;
+        return *this;
+    }
+    size_t d = _channels;
+    size_t n = _count + other._count;
+    value_type scale = value_type(_count) * value_type(other._count) / value_type(n);
+    vector< value_type > delta(d);
+    for (size_t j = 0; j < d; j++) {
+        delta[j] = (other._shift[j] - _shift[j]) + (other._mean[j] - _mean[j]);
+    }
+    for (size_t i = 0; i < d; i++) {
+        for (size_t j = i; j < d; j++) {
+            _comoment[i * d + j] += other._comoment[i * d + j] + delta[i] * delta[j] * scale;
+        }
+    }
+    for (size_t j = 0; j < d; j++) {
+        _mean[j] += delta[j] * value_type(other._count) / value_type(n);
+    }
+    _count = n;
+    return *this;
+}
+
+
+
+template < typename T >
+multivariate::scatter< T >& multivariate::scatter< T >::operator+=(const scatter& other) {
+    return merge(other);
+}
+
+
+
+template < typename T >
+void multivariate::scatter< T >::clear() {
+    _count = 0;
+    std::fill(_shift.begin(), _shift.end(), value_type(0));
+    std::fill(_mean.begin(), _mean.end(), value_type(0));
+    std::fill(_comoment.begin(), _comoment.end(), value_type(0));
+}
+
+
+
+template < typename T >
+size_t multivariate::scatter< T >::count() const {
+    return _count;
+}
+
+
+
+template < typename T >
+size_t multivariate::scatter< T >::channels() const {
+    return _channels;
+}
+
+
+
+template < typename T >
+vector< typename multivariate::scatter< T >::value_type > multivariate::scatter< T >::means() const {
+    vector< value_type > out(_channels);
+    for (size_t j = 0; j < _channels; j++) {
+        out[j] = _shift[j] + _mean[j];
+    }
+    return out;
+}
+
+
+
+template < typename T >
+matrix< typename multivariate::scatter< T >::value_type > multivariate::scatter< T >::covariance(size_t ddof) const {
+    size_t d = _channels;
+    matrix< value_type > out(d, d);
+    value_type norm = (_count > ddof) ? value_type(1) / value_type(_count - ddof) : numeric_limits< value_type >::quiet_NaN();
+    for (size_t i = 0; i < d; i++) {
+        for (size_t j = i; j < d; j++) {
+            out.data()[i * d + j] = _comoment[i * d + j] * norm;
+        }
+    }
+    details::mirror(out.data(), d);
+    return out;
+}
+
+
+
+template < typename T >
+matrix< typename multivariate::scatter< T >::value_type > multivariate::scatter< T >::correlation() const {
+    size_t d = _channels;
+    matrix< value_type > out(d, d);
+    vector< value_type > scale(d);
+    for (size_t i = 0; i < d; i++) {
+        value_type v = _comoment[i * d + i];
+        scale[i] = (v > value_type(0)) ? value_type(1) / sqrt(v) : numeric_limits< value_type >::quiet_NaN();
+    }
+    for (size_t i = 0; i < d; i++) {
+        for (size_t j = i; j < d; j++) {
+            // clamped, as rounding may slightly exceed unit magnitude
+            value_type r = _comoment[i * d + j] * scale[i] * scale[j];
+            out.data()[i * d + j] = (r == r) ? std::max(value_type(-1), std::min(value_type(1), r)) : r;
+        }
+    }
+    details::mirror(out.data(), d);
+    return out;
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::covariance(matrix_view< const T > data, size_t ddof, work_stealing_pool& pool) {
+    scatter< T > acc(data.cols());
+    acc.push(data, pool);
+    return acc.covariance(ddof);
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::covariance(const matrix< T >& data, size_t ddof, work_stealing_pool& pool) {
+    return covariance(matrix_view< const T >(data.data(), data.rows(), data.cols()), ddof, pool);
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::correlation(matrix_view< const T > data, work_stealing_pool& pool) {
+    scatter< T > acc(data.cols());
+    acc.push(data, pool);
+    return acc.correlation();
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::correlation(const matrix< T >& data, work_stealing_pool& pool) {
+    return correlation(matrix_view< const T >(data.data(), data.rows(), data.cols()), pool);
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::pairwise_distances(matrix_view< const T > data, bool squared, work_stealing_pool& pool) {
+    typedef summation::accumulator_t< T > value_type;
+    size_t n = data.rows();
+    size_t d = data.cols();
+    // column-centered copy
+    vector< value_type > mean(d, value_type(0));
+    for (size_t r = 0; r < n; r++) {
+        for (size_t j = 0; j < d; j++) {
+            mean[j] += value_type(data.data()[r * d + j]);
+        }
+    }
+    for (size_t j = 0; j < d && n; j++) {
+        mean[j] /= value_type(n);
+    }
+    vector< value_type > x(n * d);
+    for (size_t r = 0; r < n; r++) {
+        for (size_t j = 0; j < d; j++) {
+            x[r * d + j] = value_type(data.data()[r * d + j]) - mean[j];
+        }
+    }
+    matrix< value_type > out(n, n);
+    value_type* g = out.data();
+    details::gram(x.data(), n, x.data(), n, d, true, g, pool);
+    vector< value_type > norms(n);
+    for (size_t i = 0; i < n; i++) {
+        norms[i] = g[i * n + i];
+    }
+    for (size_t i = 0; i < n; i++) {
+        g[i * n + i] = value_type(0);
+        for (size_t j = i + 1; j < n; j++) {
+            value_type d2 = std::max(value_type(0), norms[i] + norms[j] - value_type(2) * g[i * n + j]);
+            g[i * n + j] = squared ? d2 : sqrt(d2);
+        }
+    }
+    details::mirror(g, n);
+    return out;
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::pairwise_distances(matrix_view< const T > a, matrix_view< const T > b, bool squared, work_stealing_pool& pool) {
+    typedef summation::accumulator_t< T > value_type;
+    if (a.cols() != b.cols()) {
+        throw invalid_argument("multivariate::pairwise_distances(): dimension mismatch");
+    }
+    size_t m = a.rows();
+    size_t n = b.rows();
+    size_t d = a.cols();
+    // both sets centered on the mean of *a* (translation invariance)
+    vector< value_type > mean(d, value_type(0));
+    for (size_t r = 0; r < m; r++) {
+        for (size_t j = 0; j < d; j++) {
+            mean[j] += value_type(a.data()[r * d + j]);
+        }
+    }
+    for (size_t j = 0; j < d && m; j++) {
+        mean[j] /= value_type(m);
+    }
+    auto center = [&](matrix_view< const T > in) {
+        vector< value_type > x(in.rows() * d);
+        for (size_t r = 0; r < in.rows(); r++) {
+            for (size_t j = 0; j < d; j++) {
+                x[r * d + j] = value_type(in.data()[r * d + j]) - mean[j];
+            }
+        }
+        return x;
+    };
+    vector< value_type > xa = center(a);
+    vector< value_type > xb = center(b);
+    matrix< value_type > out(m, n);
+    value_type* g = out.data();
+    details::gram(xa.data(), m, xb.data(), n, d, false, g, pool);
+    vector< value_type > norms_a(m);
+    vector< value_type > norms_b(n);
+    for (size_t i = 0; i < m; i++) {
+        norms_a[i] = details::dot(xa.data() + i * d, xa.data() + i * d, d);
+    }
+    for (size_t j = 0; j < n; j++) {
+        norms_b[j] = details::dot(xb.data() + j * d, xb.data() + j * d, d);
+    }
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            value_type d2 = std::max(value_type(0), norms_a[i] + norms_b[j] - value_type(2) * g[i * n + j]);
+            g[i * n + j] = squared ? d2 : sqrt(d2);
+        }
+    }
+    return out;
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::pairwise_distances(const matrix< T >& data, bool squared, work_stealing_pool& pool) {
+    return pairwise_distances(matrix_view< const T >(data.data(), data.rows(), data.cols()), squared, pool);
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > multivariate::pairwise_distances(const matrix< T >& a, const matrix< T >& b, bool squared, work_stealing_pool& pool) {
+    return pairwise_distances(matrix_view< const T >(a.data(), a.rows(), a.cols()), matrix_view< const T >(b.data(), b.rows(), b.cols()), squared, pool);
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_MULTIVARIATE_HPP_
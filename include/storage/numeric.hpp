@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <utility>
 #include "storage/matrix.hpp"
+#include "storage/argsort.hpp"
+#include "storage/random.hpp"
 
 #ifndef M_PI
     #define M_PI 3.14159265358979323846
@@ -433,14 +435,19 @@ std::matrix<_type> identity(int _s) {
     ident[ident.diag()] = std::vector<_type> (_s, static_cast<_type>(1));
     return ident;
 }
-template < typename _type = double >
-std::matrix<_type> random(int _r, int _c) {
+// random presets are reproducible: values depend only on (seed, stream), regardless of the number of threads (cf. storage/random.hpp)
+template < typename _type = double, typename _dist, typename = typename std::enable_if<!std::is_arithmetic<_dist>::value>::type >
+std::matrix<_type> random(int _r, int _c, const _dist& _distribution, uint64_t _seed = 0, uint64_t _stream = 0) {
     static_assert(std::is_arithmetic<_type>::value, "PRESET ONLY AVAILABLE TO NUMERIC TYPES");
-    std::vector<_type> vec(_r*_c);
-    std::mt19937 rng(std::time(nullptr));
-    std::normal_distribution<float> normal(0, 50);
-    for (auto& val : vec) val = normal(rng);
-    return std::matrix<_type> (vec, _r, _c);
+    std::matrix<_type> rnd(_r, _c);
+    std::rng::philox(_seed, _stream).fill(rnd, _distribution);
+    return rnd;
+}
+// normal(0, 50) distribution, drawn w/ _type precision (double for integer types)
+template < typename _type = double >
+std::matrix<_type> random(int _r, int _c, uint64_t _seed = 0, uint64_t _stream = 0) {
+    typedef typename std::conditional<std::is_floating_point<_type>::value, _type, double>::type real_type;
+    return random<_type>(_r, _c, std::rng::normal<real_type>(0, 50), _seed, _stream);
 }
 template < typename _type = double >
 std::matrix<_type> linspace(int _s, _type _low, _type _high) {
@@ -454,20 +461,20 @@ std::matrix<_type> linspace(int _s, _type _low, _type _high) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // SORTING METHODS (for std::vector, std::matrix and std::volume)
+// wrap around std::argsort (cf. storage/argsort.hpp) i.e. radix sort for numeric types, parallel merge sort otherwise
 template <typename _type>
 std::vector<size_t> sort_indexes(const std::vector<_type> &vec) {
-    // initialize original index locations
-    std::vector<size_t> idx(vec.size());
-    std::iota(idx.begin(), idx.end(), 0);
-    // sort indexes based on comparing values in vec
-    std::sort(idx.begin(), idx.end(), [&vec](size_t i1, size_t i2) { return vec[i1] < vec[i2]; });
-    return idx;
+    return std::argsort(vec);
 }
 // sorts within the whole matrix & volume, returns matrix with order
 // for segment sorting, call each segment separately e.g. sort_indexes(mat[mat.row(47)]);
 template <typename _type>
 std::matrix<size_t> sort_indexes(const std::matrix<_type> &mat) {
-    return std::matrix<_type>(sort_indexes(mat.vector()), mat.rows(), mat.cols());
+    return std::matrix<size_t>(mat.rows(), mat.cols(), std::argsort(mat));
+}
+template <typename _CT>
+std::vector<size_t> sort_indexes(const std::storage::st_subset_base<_CT> &sbst) {
+    return std::argsort(sbst);
 }
 // template <typename _type>
 // std::matrix<size_t> sort_indexes(const std::volume<_type> &vol) {
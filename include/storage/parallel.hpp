@@ -0,0 +1,300 @@
+//------------------------------------------------------------------------------
+/// @file       parallel.hpp
+/// @author     João André
+///
+/// @brief      Parallel traversal primitives (for_each, transform, reduce) over generic storage containers
+///             (e.g. std::vector, std::matrix, std::volume and their subsets).
+///
+/// Containers are partitioned into chunks of contiguous *positions* which are executed on a std::work_stealing_pool.
+/// Chunk boundaries are shifted so that no two chunks write to the same cache line, which avoids false sharing
+/// on contiguous containers and on index-based subsets alike (boundaries are placed on element addresses, not positions).
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_PARALLEL_HPP_
+#define STORAGE_INCLUDE_STORAGE_PARALLEL_HPP_
+
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include "storage/type_check.hpp"
+#include "thread/work_stealing_pool.hpp"
+
+namespace std {
+namespace parallel {
+
+//------------------------------------------------------------------------------
+/// @brief      Assumed cache line size (bytes).
+///
+/// @note       std::hardware_destructive_interference_size is not reliably provided by all supported compilers.
+///
+constexpr size_t cache_line = 64;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum chunk size (bytes) when no grain size is given. Amortizes scheduling overhead for cheap element operations.
+///
+constexpr size_t min_chunk_bytes = 16 * cache_line;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of chunks scheduled per worker, allowing work stealing to balance uneven workloads.
+///
+constexpr size_t chunks_per_worker = 4;
+
+//------------------------------------------------------------------------------
+/// @brief      Value wrapper padded to a full cache line, for per-chunk/per-thread partial results.
+///
+/// @tparam     T     Value type.
+///
+template < typename T >
+struct alignas(cache_line) padded {
+    T value;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Computes nominal chunk size (number of elements) for a range of *n* elements of *element_size* bytes.
+///
+/// @param[in]  n             Number of elements.
+/// @param[in]  element_size  Element size (bytes).
+/// @param[in]  workers       Number of workers.
+/// @param[in]  grain         Minimum number of elements per chunk. If 0, defaults to min_chunk_bytes worth of elements.
+///
+/// @return     Chunk size, rounded up to a multiple of elements per cache line.
+///
+inline size_t chunk_size(size_t n, size_t element_size, size_t workers, size_t grain = 0) {
+    size_t per_line = max< size_t >(1, cache_line / max< size_t >(1, element_size));
+    if (!grain) {
+        grain = max< size_t >(1, min_chunk_bytes / max< size_t >(1, element_size));
+    }
+    size_t target = (n + workers * chunks_per_worker - 1) / (workers * chunks_per_worker);
+    size_t size = max(target, grain);
+    return ((size + per_line - 1) / per_line) * per_line;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Partitions positions [0, *n*) into chunks whose boundaries never split a cache line.
+///
+/// @param[in]  n         Number of elements.
+/// @param[in]  size      Nominal chunk size (cf. chunk_size()).
+/// @param[in]  address   Callable returning the address of the element @ given position (as uintptr_t).
+///
+/// @return     Chunk boundaries (first value is 0, last is *n*).
+///
+/// @note       Each nominal boundary is moved forward until the element @ boundary sits on a different cache line than its predecessor.
+///             For strided/indexed subsets wider than a cache line, boundaries are left untouched.
+///
+template < typename Address >
+vector< size_t > partition(size_t n, size_t size, Address&& address) {
+    vector< size_t > bounds(1, 0);
+    bounds.reserve(n / max< size_t >(size, 1) + 2);
+    size_t pos = size;
+    while (pos < n) {
+        while (pos < n && (address(pos) / cache_line) == (address(pos - 1) / cache_line)) {
+            pos++;
+        }
+        if (pos < n) {
+            bounds.push_back(pos);
+        }
+        pos += size;
+    }
+    bounds.push_back(n);
+    return bounds;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Partitions all elements in *container* into cache-line-aware chunks.
+///
+/// @param      container  Generic container (requires size() and reference-returning operator[]).
+/// @param[in]  workers    Number of workers.
+/// @param[in]  grain      Minimum number of elements per chunk. Defaults to 0 (automatic).
+///
+/// @return     Chunk boundaries (first value is 0, last is *container.size()*).
+///
+template < typename Container >
+vector< size_t > partition(Container& container, size_t workers, size_t grain = 0) {
+    using value_type = typename remove_reference< decltype(container[0]) >::type;
+    size_t n = container.size();
+    if (!n) {
+        return { 0, 0 };
+    }
+    size_t size = chunk_size(n, sizeof(value_type), workers, grain);
+    return partition(n, size, [&container](size_t pos) {
+        return reinterpret_cast< uintptr_t >(&container[pos]);
+    });
+}
+
+}  // namespace parallel
+
+
+//------------------------------------------------------------------------------
+/// @brief      Executes *function(first, last)* over sub-ranges of [*first*, *last*) in parallel.
+///
+/// @param[in]  first     First index.
+/// @param[in]  last      Last index (exclusive).
+/// @param      function  Callable with signature void(size_t, size_t), processing a contiguous index range.
+/// @param[in]  grain     Minimum number of indexes per sub-range. Defaults to 1.
+/// @param      pool      Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     Function  Callable type.
+///
+/// @note       Low-level building block for index-space work (e.g. tiles, rows, columns); element-wise traversal
+///             of containers should use parallel_for_each()/parallel_transform() instead.
+///
+template < typename Function >
+void parallel_for(size_t first, size_t last, Function&& function, size_t grain = 1, work_stealing_pool& pool = work_stealing_pool::instance()) {
+    if (last <= first) {
+        return;
+    }
+    size_t n = last - first;
+    size_t n_chunks = min(max< size_t >(1, n / max< size_t >(grain, 1)), pool.size() * parallel::chunks_per_worker);
+    pool.run(n_chunks, [&](size_t chunk) {
+        function(first + (n * chunk) / n_chunks, first + (n * (chunk + 1)) / n_chunks);
+    });
+}
+
+
+//------------------------------------------------------------------------------
+/// @brief      Applies *function* to every element of *container* in parallel.
+///
+/// @param      container  Generic container (e.g. std::vector, std::matrix, std::volume, storage::st_subset_base).
+/// @param      function   Callable with signature void(value_type&). Elements are passed by reference and can be modified.
+/// @param[in]  grain      Minimum number of elements per chunk. Defaults to 0 (automatic).
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     Container  Container type.
+/// @tparam     Function   Callable type.
+///
+/// @note       Subsets must be passed as lvalues e.g. 'auto col = mat.col(0); parallel_for_each(col, f);'
+///
+template < typename Container, typename Function >
+void parallel_for_each(Container& container, Function&& function, size_t grain = 0, work_stealing_pool& pool = work_stealing_pool::instance()) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    auto bounds = parallel::partition(container, pool.size(), grain);
+    pool.run(bounds.size() - 1, [&](size_t chunk) {
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; i++) {
+            function(container[i]);
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+/// @brief      Applies *function* to every element of *input*, writing results to *output*, in parallel.
+///
+/// @param[in]  input      Input container.
+/// @param      output     Output container. Must hold at least input.size() elements.
+/// @param      function   Callable with signature oT(const iT&).
+/// @param[in]  grain      Minimum number of elements per chunk. Defaults to 0 (automatic).
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     iContainer  Input container type.
+/// @tparam     oContainer  Output container type.
+/// @tparam     Function    Callable type.
+///
+/// @note       Chunks are partitioned over *output* element addresses (writes), in order to avoid false sharing.
+///
+template < typename iContainer, typename oContainer, typename Function >
+void parallel_transform(const iContainer& input, oContainer& output, Function&& function, size_t grain = 0, work_stealing_pool& pool = work_stealing_pool::instance()) {
+    static_assert(is_generic_container< iContainer >(), "INVALID INPUT CONTAINER!");
+    static_assert(is_generic_container< oContainer >(), "INVALID OUTPUT CONTAINER!");
+    assert(output.size() >= input.size());
+    using value_type = typename remove_reference< decltype(output[0]) >::type;
+    size_t n = input.size();
+    if (!n) {
+        return;
+    }
+    auto bounds = parallel::partition(n, parallel::chunk_size(n, sizeof(value_type), pool.size(), grain), [&output](size_t pos) {
+        return reinterpret_cast< uintptr_t >(&output[pos]);
+    });
+    pool.run(bounds.size() - 1, [&](size_t chunk) {
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; i++) {
+            output[i] = function(input[i]);
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+/// @brief      Reduces all elements of *container* with homogeneous binary operation *op*, in parallel.
+///
+/// @param[in]  container  Input container.
+/// @param[in]  init       Initial value (left-most operand).
+/// @param      op         Associative binary operation with signature T(const T&, const T&); elements are converted to
+///                        T. Each chunk is seeded w/ its first element, and partials are combined w/ *op* as well, thus
+///                        folds mixing types (e.g. sum of squares, counting) require the *combine* overload.
+/// @param[in]  grain      Minimum number of elements per chunk. Defaults to 0 (automatic).
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     Container  Container type.
+/// @tparam     T          Result type.
+/// @tparam     BinaryOp   Binary operation type.
+///
+/// @return     init op c[0] op c[1] op ... op c[n-1], grouped by chunk.
+///
+/// @note       Partial results are kept in cache-line-padded slots (no false sharing), and combined in chunk order
+///             i.e. for a fixed chunking, results are deterministic even for non-associative (floating point) operations.
+///
+template < typename Container, typename T, typename BinaryOp >
+T parallel_reduce(const Container& container, T init, BinaryOp&& op, size_t grain = 0, work_stealing_pool& pool = work_stealing_pool::instance()) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    auto bounds = parallel::partition(container, pool.size(), grain);
+    size_t n_chunks = bounds.size() - 1;
+    if (!container.size()) {
+        return init;
+    }
+    vector< parallel::padded< T > > partials(n_chunks);
+    pool.run(n_chunks, [&](size_t chunk) {
+        T partial = static_cast< T >(container[bounds[chunk]]);
+        for (size_t i = bounds[chunk] + 1; i < bounds[chunk + 1]; i++) {
+            partial = op(partial, static_cast< T >(container[i]));
+        }
+        partials[chunk].value = partial;
+    });
+    for (const auto& partial : partials) {
+        init = op(init, partial.value);
+    }
+    return init;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Reduces all elements of *container* by folding them w/ *op* into per-chunk partials (seeded w/
+///             *identity*), combined w/ *combine*, in parallel.
+///
+/// @param[in]  container  Input container.
+/// @param[in]  identity   Identity of *combine* (e.g. 0 for sums), seeding every chunk and the result.
+/// @param      op         Fold operation with signature T(const T&, const value_type&), e.g. accumulating a function of
+///                        each element.
+/// @param      combine    Associative binary operation with signature T(const T&, const T&), merging partials.
+/// @param[in]  grain      Minimum number of elements per chunk. Defaults to 0 (automatic).
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @return     combine(... combine(identity, p[0]) ..., p[k-1]), w/ p[i] = op(... op(identity, c[first]) ..., c[last-1])
+///             over chunk i (combined in chunk order, i.e. deterministic for a fixed chunking).
+///
+template < typename Container, typename T, typename BinaryOp, typename Combine, typename = typename enable_if< !is_arithmetic< typename decay< Combine >::type >::value >::type >
+T parallel_reduce(const Container& container, T identity, BinaryOp&& op, Combine&& combine, size_t grain = 0, work_stealing_pool& pool = work_stealing_pool::instance()) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    if (!container.size()) {
+        return identity;
+    }
+    auto bounds = parallel::partition(container, pool.size(), grain);
+    size_t n_chunks = bounds.size() - 1;
+    vector< parallel::padded< T > > partials(n_chunks, parallel::padded< T >{ identity });
+    pool.run(n_chunks, [&](size_t chunk) {
+        T partial = identity;
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; i++) {
+            partial = op(partial, container[i]);
+        }
+        partials[chunk].value = partial;
+    });
+    T out = identity;
+    for (const auto& partial : partials) {
+        out = combine(out, partial.value);
+    }
+    return out;
+}
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_PARALLEL_HPP_
@@ -0,0 +1,503 @@
+//------------------------------------------------------------------------------
+/// @file       peaks.hpp
+/// @author     João André
+///
+/// @brief      Stateful (streaming) peak detector for generic storage containers (e.g. std::vector, std::matrix rows or
+///             columns, views and subsets), w/ height, width, prominence and minimum distance criteria, and batch
+///             detection over all columns (channels) of a matrix in parallel.
+///
+/// Peaks are detected over *regions*, i.e. maximal runs of samples at or above the height threshold, of at least
+/// *width* samples; the peak of a region is its (first) maximum. Prominence is measured w.r.t. the higher of the two
+/// valleys (minima) between the peak and the adjacent accepted regions (or stream boundaries), thus a peak is only
+/// reported once the next region is accepted (or the stream is flushed). Peaks closer than *distance* samples are
+/// resolved greedily, keeping the highest.
+///
+/// Samples are pushed in blocks of arbitrary size (a stream may be split anywhere), and detected peaks are written to
+/// an output iterator (e.g. a pointer to a preallocated buffer, or a back_inserter of a reserved vector). Samples are
+/// pre-screened lane-wise (cf. summation.hpp) i.e. in vectorizable loops: below threshold, up to the lane holding the
+/// next region start; within a region, up to the first lane holding a new maximum or the region end, after which the
+/// remainder of the region is processed per sample.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_PEAKS_HPP_
+#define STORAGE_INCLUDE_STORAGE_PEAKS_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include "storage/type_check.hpp"
+#include "storage/blas.hpp"
+#include "storage/summation.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace peaks {
+
+//------------------------------------------------------------------------------
+/// @brief      Number of rows per tile in column-wise batch detection (cf. push_columns()).
+///
+constexpr size_t tile_rows = 1024;
+
+//------------------------------------------------------------------------------
+/// @brief      Detected peak.
+///
+/// @tparam     T     Sample type.
+///
+template < typename T >
+struct peak {
+    size_t index;                                   ///< stream position of peak (sample index)
+    T value;                                        ///< peak (sample) value
+    summation::accumulator_t< T > prominence;       ///< height above the higher of both adjacent valleys
+    size_t width;                                   ///< region length (number of samples at or above height)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Streaming peak detector.
+///
+/// @tparam     T     Sample type (arithmetic).
+///
+template < typename T >
+class detector {
+ public:
+    static_assert(is_arithmetic< T >::value, "INVALID SAMPLE TYPE!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Internal (prominence) value type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  height      Minimum peak height, i.e. region threshold.
+    /// @param[in]  width       Minimum region width (samples). Defaults to 1.
+    /// @param[in]  prominence  Minimum peak prominence. Defaults to 0 (any).
+    /// @param[in]  distance    Minimum distance between peaks (samples). Defaults to 0 (any).
+    ///
+    explicit detector(T height, size_t width = 1, value_type prominence = value_type(0), size_t distance = 0);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Processes a block of samples, following previously pushed samples.
+    ///
+    /// @param[in]  block      Input samples.
+    /// @param[in]  out        Output iterator (peak< T >), receiving peaks confirmed w/ this block.
+    ///
+    /// @tparam     Container  Container type, requiring size() and operator[](size_t).
+    /// @tparam     OutputIt   Output iterator type.
+    ///
+    /// @return     Output iterator past last written peak.
+    ///
+    template < typename Container, typename OutputIt >
+    OutputIt push(const Container& block, OutputIt out);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Processes samples [first, last) of *x*, following previously pushed samples.
+    ///
+    /// @param[in]  x         Input container or accessor, requiring operator[](size_t).
+    /// @param[in]  first     First index.
+    /// @param[in]  last      Last index (exclusive).
+    /// @param[in]  out       Output iterator (peak< T >).
+    ///
+    /// @return     Output iterator past last written peak.
+    ///
+    template < typename Accessor, typename OutputIt >
+    OutputIt push(const Accessor& x, size_t first, size_t last, OutputIt out);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Ends stream, emitting remaining peaks (i.e. stream end is a region/valley boundary), and resets detector.
+    ///
+    /// @param[in]  out       Output iterator (peak< T >).
+    ///
+    /// @return     Output iterator past last written peak.
+    ///
+    template < typename OutputIt >
+    OutputIt flush(OutputIt out);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets detector state (discarding pending peaks), keeping detection criteria.
+    ///
+    void reset();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of samples processed since construction/last reset.
+    ///
+    size_t position() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Minimum peak height.
+    ///
+    T height() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Minimum region width.
+    ///
+    size_t width() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Minimum peak prominence.
+    ///
+    value_type prominence() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Minimum distance between peaks.
+    ///
+    size_t distance() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Closes current region; if wide enough, confirms previous candidate and makes region the new candidate.
+    ///
+    template < typename OutputIt >
+    OutputIt close(OutputIt out);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates (complete) candidate prominence and passes it through distance filter.
+    ///
+    template < typename OutputIt >
+    OutputIt confirm(value_type right, OutputIt out);
+
+    T _height;
+    size_t _width;
+    value_type _prominence;
+    size_t _distance;
+
+    size_t _position = 0;
+    value_type _valley;                  ///< min since last accepted region
+    // current region
+    bool _in_region = false;
+    size_t _length = 0;
+    T _max;
+    size_t _argmax = 0;
+    value_type _entry;                   ///< valley @ region start
+    value_type _left;                    ///< min from previous accepted region to current max
+    value_type _after;                   ///< min from current max to region end
+    // candidate (accepted region, awaiting right valley)
+    bool _has_candidate = false;
+    peak< T > _candidate;
+    value_type _candidate_left;
+    value_type _candidate_right;
+    // pending (confirmed peak, awaiting distance resolution)
+    bool _has_pending = false;
+    peak< T > _pending;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Processes a block of rows of a multichannel stream, i.e. pushes each column to its own detector, in parallel.
+///
+/// @param[in]  block      Input samples (rows x channels).
+/// @param      detectors  Per-column detectors, w/ block.cols() elements.
+/// @param      out        Per-column output peaks (appended), w/ block.cols() elements. Reserve to avoid reallocations.
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+template < typename T >
+void push_columns(matrix_view< const T > block, vector< detector< T > >& detectors, vector< vector< peak< T > > >& out, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Detects peaks in all columns of *signal*, in parallel.
+///
+/// @param[in]  signal     Input samples (rows x channels).
+/// @param[in]  prototype  Detector w/ detection criteria, copied for each column.
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @return     Per-column peaks.
+///
+template < typename T >
+vector< vector< peak< T > > > find(matrix_view< const T > signal, const detector< T >& prototype, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Detects peaks in *signal*.
+///
+/// @param[in]  signal     Input samples.
+/// @param[in]  prototype  Detector w/ detection criteria.
+///
+/// @return     Peaks.
+///
+template < typename Container, typename T >
+vector< peak< T > > find(const Container& signal, detector< T > prototype);
+
+}  // namespace peaks
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename T >
+peaks::detector< T >::detector(T height, size_t width, value_type prominence, size_t distance)
+    : _height(height), _width(max< size_t >(width, 1)), _prominence(prominence), _distance(distance) {
+    reset();
+}
+
+
+
+template < typename T >
+void peaks::detector< T >::reset() {
+    _position = 0;
+    _valley = numeric_limits< value_type >::infinity();
+    _in_region = false;
+    _length = 0;
+    _has_candidate = false;
+    _has_pending = false;
+}
+
+
+
+template < typename T >
+template < typename Container, typename OutputIt >
+OutputIt peaks::detector< T >::push(const Container& block, OutputIt out) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    size_t n = block.size();
+    return blas::details::dispatch(block, [&](const auto& x) {
+        return push(x, 0, n, out);
+    });
+}
+
+
+
+template < typename T >
+template < typename Accessor, typename OutputIt >
+OutputIt peaks::detector< T >::push(const Accessor& x, size_t first, size_t last, OutputIt out) {
+    constexpr size_t lanes = summation::lanes;
+    size_t i = first;
+    while (i < last) {
+        if (!_in_region) {
+            // pre-screen: skip (full lanes of) samples below threshold, tracking valley
+            while (i + lanes <= last) {
+                bool above = false;
+                value_type low = _valley;
+                for (size_t k = 0; k < lanes; k++) {
+                    above |= (x[i + k] >= _height);
+                    value_type v = static_cast< value_type >(x[i + k]);
+                    low = (v < low) ? v : low;
+                }
+                if (above) {
+                    break;
+                }
+                _valley = low;
+                i += lanes;
+            }
+            for (; i < last && !(x[i] >= _height); i++) {
+                _valley = min(_valley, static_cast< value_type >(x[i]));
+            }
+            if (i == last) {
+                break;
+            }
+            // region start
+            _in_region = true;
+            _length = 1;
+            _max = x[i];
+            _argmax = _position + (i - first);
+            _entry = _valley;
+            _left = _valley;
+            _after = numeric_limits< value_type >::infinity();
+            _valley = min(_valley, static_cast< value_type >(x[i]));
+            i++;
+            continue;
+        }
+        // pre-screen: skip (full lanes of) samples above threshold that do not exceed current max
+        while (i + lanes <= last) {
+            bool below = false;
+            bool higher = false;
+            value_type low = _after;
+            for (size_t k = 0; k < lanes; k++) {
+                below |= !(x[i + k] >= _height);
+                higher |= (x[i + k] > _max);
+                value_type v = static_cast< value_type >(x[i + k]);
+                low = (v < low) ? v : low;
+            }
+            if (below || higher) {
+                break;
+            }
+            _after = low;
+            _valley = min(_valley, low);
+            _length += lanes;
+            i += lanes;
+        }
+        for (; i < last && x[i] >= _height; i++) {
+            value_type v = static_cast< value_type >(x[i]);
+            if (x[i] > _max) {
+                _left = min(_left, min(_after, static_cast< value_type >(_max)));
+                _max = x[i];
+                _argmax = _position + (i - first);
+                _after = numeric_limits< value_type >::infinity();
+            } else {
+                _after = min(_after, v);
+            }
+            _valley = min(_valley, v);
+            _length++;
+        }
+        if (i < last) {
+            // region end (sample i is below threshold, processed as valley on next iteration)
+            out = close(out);
+        }
+    }
+    _position += last - first;
+    return out;
+}
+
+
+
+template < typename T >
+template < typename OutputIt >
+OutputIt peaks::detector< T >::close(OutputIt out) {
+    _in_region = false;
+    if (_length < _width) {
+        return out;
+    }
+    if (_has_candidate) {
+        out = confirm(min(_candidate_right, _entry), out);
+    }
+    _has_candidate = true;
+    _candidate = peak< T >{ _argmax, _max, value_type(0), _length };
+    _candidate_left = _left;
+    _candidate_right = _after;
+    _valley = numeric_limits< value_type >::infinity();
+    return out;
+}
+
+
+
+template < typename T >
+template < typename OutputIt >
+OutputIt peaks::detector< T >::confirm(value_type right, OutputIt out) {
+    _has_candidate = false;
+    // base is the higher of both valleys; undefined (infinite) valleys (i.e. at stream boundaries) are ignored
+    value_type left = _candidate_left;
+    value_type base = isinf(left) ? right : (isinf(right) ? left : max(left, right));
+    _candidate.prominence = isinf(base) ? value_type(0) : static_cast< value_type >(_candidate.value) - base;
+    if (_candidate.prominence < _prominence) {
+        return out;
+    }
+    if (_has_pending && _candidate.index - _pending.index < _distance) {
+        if (_candidate.value > _pending.value) {
+            _pending = _candidate;
+        }
+        return out;
+    }
+    if (_has_pending) {
+        *out++ = _pending;
+    }
+    _has_pending = true;
+    _pending = _candidate;
+    return out;
+}
+
+
+
+template < typename T >
+template < typename OutputIt >
+OutputIt peaks::detector< T >::flush(OutputIt out) {
+    if (_in_region) {
+        out = close(out);
+    }
+    if (_has_candidate) {
+        out = confirm(min(_candidate_right, _valley), out);
+    }
+    if (_has_pending) {
+        *out++ = _pending;
+    }
+    reset();
+    return out;
+}
+
+
+
+template < typename T >
+size_t peaks::detector< T >::position() const {
+    return _position;
+}
+
+
+
+template < typename T >
+T peaks::detector< T >::height() const {
+    return _height;
+}
+
+
+
+template < typename T >
+size_t peaks::detector< T >::width() const {
+    return _width;
+}
+
+
+
+template < typename T >
+typename peaks::detector< T >::value_type peaks::detector< T >::prominence() const {
+    return _prominence;
+}
+
+
+
+template < typename T >
+size_t peaks::detector< T >::distance() const {
+    return _distance;
+}
+
+
+
+template < typename T >
+void peaks::push_columns(matrix_view< const T > block, vector< detector< T > >& detectors, vector< vector< peak< T > > >& out, work_stealing_pool& pool) {
+    assert(detectors.size() == block.cols() && out.size() == block.cols());
+    size_t rows = block.rows();
+    size_t cols = block.cols();
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        // gather row tiles of each column into contiguous buffers (rows are shared by all columns in range)
+        vector< T > tile(peaks::tile_rows);
+        for (size_t r = 0; r < rows; r += peaks::tile_rows) {
+            size_t n = min(rows - r, peaks::tile_rows);
+            for (size_t j = first; j < last; j++) {
+                const T* source = block.data() + r * cols + j;
+                for (size_t i = 0; i < n; i++) {
+                    tile[i] = source[i * cols];
+                }
+                detectors[j].push(tile.data(), 0, n, back_inserter(out[j]));
+            }
+        }
+    }, 1, pool);
+}
+
+
+
+template < typename T >
+vector< vector< peaks::peak< T > > > peaks::find(matrix_view< const T > signal, const detector< T >& prototype, work_stealing_pool& pool) {
+    size_t cols = signal.cols();
+    vector< detector< T > > detectors(cols, prototype);
+    vector< vector< peak< T > > > out(cols);
+    for (auto& detector : detectors) {
+        detector.reset();
+    }
+    push_columns(signal, detectors, out, pool);
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        for (size_t j = first; j < last; j++) {
+            detectors[j].flush(back_inserter(out[j]));
+        }
+    }, 1, pool);
+    return out;
+}
+
+
+
+template < typename Container, typename T >
+vector< peaks::peak< T > > peaks::find(const Container& signal, detector< T > prototype) {
+    vector< peak< T > > out;
+    prototype.reset();
+    prototype.push(signal, back_inserter(out));
+    prototype.flush(back_inserter(out));
+    return out;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_PEAKS_HPP_
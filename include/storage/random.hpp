@@ -0,0 +1,480 @@
+//------------------------------------------------------------------------------
+/// @file       random.hpp
+/// @author     João André
+///
+/// @brief      Counter-based random number generation (Philox4x32-10, Threefry2x64-20) and parallel bulk fill of generic
+///             storage containers (e.g. std::vector, std::matrix, std::volume and their subsets).
+///
+/// Counter-based generators are stateless: a block of 128 random bits is a pure function of a (counter, key) pair, where
+/// the key is derived from a user *seed* and the counter from a *stream* ID and the block index. Element *i* of a container
+/// is thus always drawn from the same block regardless of how (and by how many threads) the container is filled, which
+/// makes results reproducible and identical across thread counts. Distinct stream IDs yield independent sequences for
+/// the same seed (e.g. one stream per matrix, or per data augmentation pass).
+///
+/// Distributions convert one block of random bits into a fixed number of values (cf. per_block), with no internal state.
+///
+/// @note       Generators follow the reference (Random123) definitions, i.e. Salmon et al., "Parallel random numbers: as easy as
+///             1, 2, 3", SC'11.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_RANDOM_HPP_
+#define STORAGE_INCLUDE_STORAGE_RANDOM_HPP_
+
+#include <array>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "storage/type_check.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace rng {
+
+//------------------------------------------------------------------------------
+/// @brief      Block of random bits produced by a counter-based generator.
+///
+typedef array< uint32_t, 4 > block_type;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of blocks generated per parallel task.
+///
+constexpr size_t min_blocks = 1024;
+
+//------------------------------------------------------------------------------
+/// @brief      Philox4x32-10 generator (multiply-based bijection, 10 rounds).
+///
+struct philox4x32 {
+    //--------------------------------------------------------------------------
+    /// @brief      Generates random block for given counter and key.
+    ///
+    /// @param[in]  counter  Counter (4 x 32-bit words).
+    /// @param[in]  key      Key (2 x 32-bit words).
+    ///
+    /// @return     Random block.
+    ///
+    static block_type generate(block_type counter, array< uint32_t, 2 > key);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Generates random block for given block index, stream ID and seed.
+    ///
+    static block_type generate(uint64_t block, uint64_t stream, uint64_t seed);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Threefry2x64-20 generator (add/rotate/xor bijection, 20 rounds).
+///
+struct threefry2x64 {
+    //--------------------------------------------------------------------------
+    /// @brief      Generates random words for given counter and key.
+    ///
+    /// @param[in]  counter  Counter (2 x 64-bit words).
+    /// @param[in]  key      Key (2 x 64-bit words).
+    ///
+    /// @return     Random words.
+    ///
+    static array< uint64_t, 2 > generate(array< uint64_t, 2 > counter, array< uint64_t, 2 > key);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Generates random block for given block index, stream ID and seed.
+    ///
+    static block_type generate(uint64_t block, uint64_t stream, uint64_t seed);
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Uniform real distribution over [low, high).
+///
+/// @tparam     T     Value type (floating point). Single precision values take 24 bits, double precision values 53 bits.
+///
+template < typename T = double >
+class uniform {
+ public:
+    static_assert(is_floating_point< T >::value, "INVALID VALUE TYPE!");
+
+    typedef T result_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values per random block.
+    ///
+    static constexpr size_t per_block = (sizeof(T) <= 4) ? 4 : 2;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  low   Lower bound (inclusive). Defaults to 0.
+    /// @param[in]  high  Upper bound (exclusive). Defaults to 1.
+    ///
+    explicit uniform(T low = T(0), T high = T(1));
+
+    //--------------------------------------------------------------------------
+    /// @brief      Converts a random block into *per_block* values.
+    ///
+    /// @param[in]  bits  Random block.
+    /// @param[out] out   Output values.
+    ///
+    void operator()(const block_type& bits, T* out) const;
+
+ protected:
+    T _low;
+    T _range;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Normal (Gaussian) distribution, via Box-Muller transform.
+///
+/// @tparam     T     Value type (floating point).
+///
+template < typename T = double >
+class normal {
+ public:
+    static_assert(is_floating_point< T >::value, "INVALID VALUE TYPE!");
+
+    typedef T result_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values per random block.
+    ///
+    static constexpr size_t per_block = (sizeof(T) <= 4) ? 4 : 2;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  mean    Mean. Defaults to 0.
+    /// @param[in]  stddev  Standard deviation. Defaults to 1.
+    ///
+    explicit normal(T mean = T(0), T stddev = T(1));
+
+    //--------------------------------------------------------------------------
+    /// @brief      Converts a random block into *per_block* values.
+    ///
+    void operator()(const block_type& bits, T* out) const;
+
+ protected:
+    T _mean;
+    T _stddev;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Uniform integer distribution over [low, high].
+///
+/// @tparam     T     Value type (integral).
+///
+/// @note       Values are mapped from 64 random bits w/ a multiply-shift reduction (bias below range / 2^64, no rejection).
+///
+template < typename T = int >
+class uniform_int {
+ public:
+    static_assert(is_integral< T >::value, "INVALID VALUE TYPE!");
+
+    typedef T result_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values per random block.
+    ///
+    static constexpr size_t per_block = 2;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  low   Lower bound (inclusive).
+    /// @param[in]  high  Upper bound (inclusive).
+    ///
+    uniform_int(T low, T high);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Converts a random block into *per_block* values.
+    ///
+    void operator()(const block_type& bits, T* out) const;
+
+ protected:
+    T _low;
+    uint64_t _range;  // 0 if full 64-bit range
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Counter-based random engine, i.e. (seed, stream) pair bound to a generator.
+///
+/// @tparam     Generator  Counter-based generator (philox4x32, threefry2x64).
+///
+template < typename Generator = philox4x32 >
+class counter_engine {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  seed    Seed (key).
+    /// @param[in]  stream  Stream ID. Defaults to 0.
+    ///
+    explicit counter_engine(uint64_t seed, uint64_t stream = 0);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get seed.
+    ///
+    uint64_t seed() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get stream ID.
+    ///
+    uint64_t stream() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get random block @ given block index.
+    ///
+    block_type operator()(uint64_t block) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Draws value @ given (element) index, i.e. the value assigned to position *index* by fill().
+    ///
+    /// @param[in]  index         Element index.
+    /// @param[in]  distribution  Distribution.
+    ///
+    template < typename Distribution >
+    typename Distribution::result_type draw(uint64_t index, const Distribution& distribution) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Fills *container* with values drawn from *distribution*, in parallel.
+    ///             Position *i* of container is assigned the value of element *offset + i*, for any number of threads.
+    ///
+    /// @param      container     Output container (e.g. std::vector, std::matrix, std::volume, storage::st_subset_base).
+    /// @param[in]  distribution  Distribution.
+    /// @param[in]  offset        Index of first element. Defaults to 0.
+    /// @param      pool          Thread pool. Defaults to shared pool instance.
+    ///
+    /// @tparam     Container     Container type. Values are cast to its value type.
+    /// @tparam     Distribution  Distribution type.
+    ///
+    template < typename Container, typename Distribution >
+    void fill(Container& container, const Distribution& distribution, uint64_t offset = 0, work_stealing_pool& pool = work_stealing_pool::instance()) const;
+
+ protected:
+    uint64_t _seed;
+    uint64_t _stream;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Default engine type.
+///
+typedef counter_engine< philox4x32 > philox;
+
+//------------------------------------------------------------------------------
+/// @brief      Threefry engine type.
+///
+typedef counter_engine< threefry2x64 > threefry;
+
+}  // namespace rng
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+inline rng::block_type rng::philox4x32::generate(block_type counter, array< uint32_t, 2 > key) {
+    constexpr uint32_t M0 = 0xD2511F53;
+    constexpr uint32_t M1 = 0xCD9E8D57;
+    constexpr uint32_t W0 = 0x9E3779B9;
+    constexpr uint32_t W1 = 0xBB67AE85;
+    for (size_t round = 0; round < 10; round++) {
+        uint64_t p0 = uint64_t(M0) * counter[0];
+        uint64_t p1 = uint64_t(M1) * counter[2];
+        counter = {{ uint32_t(p1 >> 32) ^ counter[1] ^ key[0], uint32_t(p1), uint32_t(p0 >> 32) ^ counter[3] ^ key[1], uint32_t(p0) }};
+        key[0] += W0;
+        key[1] += W1;
+    }
+    return counter;
+}
+
+
+
+inline rng::block_type rng::philox4x32::generate(uint64_t block, uint64_t stream, uint64_t seed) {
+    return generate({{ uint32_t(block), uint32_t(block >> 32), uint32_t(stream), uint32_t(stream >> 32) }}, {{ uint32_t(seed), uint32_t(seed >> 32) }});
+}
+
+
+
+inline array< uint64_t, 2 > rng::threefry2x64::generate(array< uint64_t, 2 > counter, array< uint64_t, 2 > key) {
+    constexpr unsigned rotations[8] = { 16, 42, 12, 31, 16, 32, 24, 21 };
+    const uint64_t schedule[3] = { key[0], key[1], 0x1BD11BDAA9FC1A22 ^ key[0] ^ key[1] };
+    uint64_t x0 = counter[0] + schedule[0];
+    uint64_t x1 = counter[1] + schedule[1];
+    for (size_t round = 0; round < 20; round++) {
+        unsigned r = rotations[round % 8];
+        x0 += x1;
+        x1 = (x1 << r) | (x1 >> (64 - r));
+        x1 ^= x0;
+        if (round % 4 == 3) {
+            // key injection
+            size_t s = (round + 1) / 4;
+            x0 += schedule[s % 3];
+            x1 += schedule[(s + 1) % 3] + s;
+        }
+    }
+    return {{ x0, x1 }};
+}
+
+
+
+inline rng::block_type rng::threefry2x64::generate(uint64_t block, uint64_t stream, uint64_t seed) {
+    array< uint64_t, 2 > words = generate({{ block, stream }}, {{ seed, 0 }});
+    return {{ uint32_t(words[0]), uint32_t(words[0] >> 32), uint32_t(words[1]), uint32_t(words[1] >> 32) }};
+}
+
+
+
+template < typename T >
+rng::uniform< T >::uniform(T low, T high) :
+    _low(low),
+    _range(high - low) {
+        assert(high >= low);
+}
+
+
+
+template < typename T >
+void rng::uniform< T >::operator()(const block_type& bits, T* out) const {
+    if constexpr (per_block == 4) {
+        for (size_t i = 0; i < 4; i++) {
+            out[i] = _low + _range * (T(bits[i] >> 8) * T(1.0 / 16777216.0));  // 24-bit mantissa
+        }
+    } else {
+        for (size_t i = 0; i < 2; i++) {
+            uint64_t word = (uint64_t(bits[2 * i + 1]) << 32) | bits[2 * i];
+            out[i] = _low + _range * (T(word >> 11) * T(1.0 / 9007199254740992.0));  // 53-bit mantissa
+        }
+    }
+}
+
+
+
+template < typename T >
+rng::normal< T >::normal(T mean, T stddev) :
+    _mean(mean),
+    _stddev(stddev) {
+        assert(stddev >= T(0));
+}
+
+
+
+template < typename T >
+void rng::normal< T >::operator()(const block_type& bits, T* out) const {
+    constexpr T two_pi = T(6.283185307179586476925286766559);
+    if constexpr (per_block == 4) {
+        for (size_t i = 0; i < 4; i += 2) {
+            T u1 = T((bits[i] >> 8) + 1) * T(1.0 / 16777216.0);  // (0, 1], avoids log(0)
+            T u2 = T(bits[i + 1] >> 8) * T(1.0 / 16777216.0);
+            T r = _stddev * sqrt(T(-2) * log(u1));
+            out[i] = _mean + r * cos(two_pi * u2);
+            out[i + 1] = _mean + r * sin(two_pi * u2);
+        }
+    } else {
+        uint64_t w1 = (uint64_t(bits[1]) << 32) | bits[0];
+        uint64_t w2 = (uint64_t(bits[3]) << 32) | bits[2];
+        T u1 = T((w1 >> 11) + 1) * T(1.0 / 9007199254740992.0);
+        T u2 = T(w2 >> 11) * T(1.0 / 9007199254740992.0);
+        T r = _stddev * sqrt(T(-2) * log(u1));
+        out[0] = _mean + r * cos(two_pi * u2);
+        out[1] = _mean + r * sin(two_pi * u2);
+    }
+}
+
+
+
+template < typename T >
+rng::uniform_int< T >::uniform_int(T low, T high) :
+    _low(low),
+    _range(uint64_t(high) - uint64_t(low) + 1) {
+        assert(high >= low);
+}
+
+
+
+template < typename T >
+void rng::uniform_int< T >::operator()(const block_type& bits, T* out) const {
+    for (size_t i = 0; i < 2; i++) {
+        uint64_t word = (uint64_t(bits[2 * i + 1]) << 32) | bits[2 * i];
+        uint64_t value = _range ? uint64_t((static_cast< unsigned __int128 >(word) * _range) >> 64) : word;
+        out[i] = static_cast< T >(uint64_t(_low) + value);
+    }
+}
+
+
+
+template < typename Generator >
+rng::counter_engine< Generator >::counter_engine(uint64_t seed, uint64_t stream) :
+    _seed(seed),
+    _stream(stream) {
+        /* ... */
+}
+
+
+
+template < typename Generator >
+uint64_t rng::counter_engine< Generator >::seed() const {
+    return _seed;
+}
+
+
+
+template < typename Generator >
+uint64_t rng::counter_engine< Generator >::stream() const {
+    return _stream;
+}
+
+
+
+template < typename Generator >
+rng::block_type rng::counter_engine< Generator >::operator()(uint64_t block) const {
+    return Generator::generate(block, _stream, _seed);
+}
+
+
+
+template < typename Generator >
+template < typename Distribution >
+typename Distribution::result_type rng::counter_engine< Generator >::draw(uint64_t index, const Distribution& distribution) const {
+    typename Distribution::result_type values[Distribution::per_block];
+    distribution((*this)(index / Distribution::per_block), values);
+    return values[index % Distribution::per_block];
+}
+
+
+
+template < typename Generator >
+template < typename Container, typename Distribution >
+void rng::counter_engine< Generator >::fill(Container& container, const Distribution& distribution, uint64_t offset, work_stealing_pool& pool) const {
+    static_assert(is_generic_container< Container >(), "INVALID OUTPUT CONTAINER!");
+    typedef typename Distribution::result_type result_type;
+    typedef typename decay< decltype(container[0]) >::type value_type;
+    constexpr size_t per_block = Distribution::per_block;
+    size_t n = container.size();
+    if (!n) {
+        return;
+    }
+    // blocks overlapping element range [offset, offset + n)
+    uint64_t first_block = offset / per_block;
+    uint64_t last_block = (offset + n - 1) / per_block + 1;
+    parallel_for(first_block, last_block, [&](size_t first, size_t last) {
+        result_type values[per_block];
+        for (uint64_t block = first; block < last; block++) {
+            distribution((*this)(block), values);
+            // clip first/last blocks to element range
+            uint64_t begin = max< uint64_t >(block * per_block, offset);
+            uint64_t end = min< uint64_t >((block + 1) * per_block, offset + n);
+            for (uint64_t idx = begin; idx < end; idx++) {
+                container[idx - offset] = static_cast< value_type >(values[idx - block * per_block]);
+            }
+        }
+    }, rng::min_blocks, pool);
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_RANDOM_HPP_
@@ -97,6 +97,11 @@ class range_iterator : std::iterator< std::random_access_iterator_tag, T > {
     ///
     typename Container::size_type size() const noexcept;
 
+    //--------------------------------------------------------------------------
+    /// @brief      Nominal range width, i.e. not truncated @ end of container (cf. size()).
+    ///
+    unsigned int width() const noexcept;
+
     //--------------------------------------------------------------------------
     /// @brief      Conpound addition operator. Increments the iterator *n* times (skips *n* ranges).
     ///
@@ -349,6 +354,13 @@ typename Container::size_type range_iterator< Container, T >::size() const noexc
 
 
 
+template < typename Container, typename T >
+unsigned int range_iterator< Container, T >::width() const noexcept {
+    return _width;
+}
+
+
+
 template < typename Container, typename T >
 typename range_iterator< Container, T >::reference range_iterator< Container, T >::operator*() {
     return _container->template at< reference >(_pos);
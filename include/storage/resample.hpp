@@ -0,0 +1,1046 @@
+//------------------------------------------------------------------------------
+/// @file       resample.hpp
+/// @author     João André
+///
+/// @brief      Resampling/interpolation plans between pairs of sample bases (e.g. time or phase), applied to vectors or
+///             to all columns (channels) of a std::matrix at once.
+///
+/// A plan precomputes, once per pair of bases, the bracketing input samples and interpolation weights of every output
+/// sample (and, for cubic splines, the factorization of the spline tridiagonal system). Applying a plan then reduces to
+/// weighted combinations of input rows, which are contiguous in row-major (samples x channels) storage i.e. inner
+/// loops run over channels and vectorize, while output rows are processed in parallel.
+///
+/// Supported methods:
+/// - nearest: value of closest input sample;
+/// - linear:  piecewise linear interpolation;
+/// - cubic:   natural cubic spline (or periodic spline, w/ periodic boundaries).
+///
+/// Outside the input range, samples are either wrapped (periodic boundaries, w/ explicit period) or extrapolated
+/// linearly from the first/last input segment (nearest clamps to the first/last sample).
+///
+/// Spline objects factorize the spline system once for a given input base, and are then fitted to any number of
+/// signals and evaluated at arbitrary points. Uniformly sampled signals are resampled by rational factors w/ polyphase
+/// resamplers, which process streaming blocks w/ carried filter state.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_RESAMPLE_HPP_
+#define STORAGE_INCLUDE_STORAGE_RESAMPLE_HPP_
+
+#include <cmath>
+#include <vector>
+#include <numeric>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+#include "storage/summation.hpp"
+
+namespace std {
+namespace resampling {
+
+//------------------------------------------------------------------------------
+/// @brief      Interpolation methods.
+///
+enum class method {
+    nearest,  ///< nearest input sample
+    linear,   ///< piecewise linear
+    cubic     ///< natural/periodic cubic spline
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Pi (M_PI is not provided by standard C++).
+///
+constexpr double pi = 3.14159265358979323846;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of output rows per parallel task.
+///
+constexpr size_t min_rows = 256;
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of columns per parallel (cubic spline) solver task.
+///
+constexpr size_t min_cols = 8;
+
+//------------------------------------------------------------------------------
+/// @brief      Resampling plan between two sample bases.
+///
+/// @tparam     R     Sample base (and weight) type, floating point.
+///
+template < typename R = double >
+class plan {
+ public:
+    static_assert(is_floating_point< R >::value, "INVALID SAMPLE BASE TYPE!");
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  from       Input sample base (strictly increasing).
+    /// @param[in]  to         Output sample base.
+    /// @param[in]  algorithm  Interpolation method. Defaults to linear.
+    /// @param[in]  period     Period of sample base, i.e. input sample *i* is also located at from[i] + k * period. Must
+    ///                        exceed from.back() - from.front(). Defaults to 0 (non-periodic).
+    ///
+    /// @throws     std::invalid_argument if *from* is empty or not strictly increasing, or *period* is too short.
+    ///
+    /// @note       A single input sample yields a constant output (any method).
+    ///
+    plan(const vector< R >& from, const vector< R >& to, method algorithm = method::linear, R period = R(0));
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance, between uniform bases of *n_from* and *n_to* samples spanning the same
+    ///             range (i.e. first and last samples are aligned).
+    ///
+    /// @param[in]  n_from     Number of input samples.
+    /// @param[in]  n_to       Number of output samples.
+    /// @param[in]  algorithm  Interpolation method. Defaults to linear.
+    ///
+    plan(size_t n_from, size_t n_to, method algorithm = method::linear);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resamples all columns of *in* into *out*.
+    ///
+    /// @param[in]  in    Input samples (size_in() x channels).
+    /// @param[in]  out   Output samples (size_out() x channels).
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    /// @tparam     T     Sample type.
+    ///
+    template < typename T >
+    void apply(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool = work_stealing_pool::instance()) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resamples all columns of *in*.
+    ///
+    /// @param[in]  in    Input samples (size_in() x channels).
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    /// @return     Output samples (size_out() x channels).
+    ///
+    template < typename T >
+    matrix< T > apply(const matrix< T >& in, work_stealing_pool& pool = work_stealing_pool::instance()) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resamples a single signal.
+    ///
+    /// @param[in]  in    Input samples (size_in() elements).
+    ///
+    /// @return     Output samples (size_out() elements).
+    ///
+    template < typename T >
+    vector< T > apply(const vector< T >& in) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of input samples.
+    ///
+    size_t size_in() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of output samples.
+    ///
+    size_t size_out() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Interpolation method.
+    ///
+    method interpolation() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Period of sample base (0 if non-periodic).
+    ///
+    R period() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Builds plan (brackets, weights and spline factorization).
+    ///
+    void build(const vector< R >& from, const vector< R >& to);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Locates *x* in input sample base, i.e. bracketing samples and interpolation weights (cf. _weights).
+    ///
+    void bracket(const vector< R >& from, const vector< R >& h, R x, size_t& lower, size_t& upper, R* w) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Solves spline second derivatives of columns [first, last) of *in* (size_in() x in.cols()) into *m*.
+    ///
+    template < typename T, typename A >
+    void solve(const matrix_view< const T >& in, A* m, size_t first, size_t last) const;
+
+    size_t _n_in;
+    size_t _n_out;
+    method _method;
+    R _period;
+    vector< size_t > _lower;        ///< lower bracketing input sample, per output sample
+    vector< size_t > _upper;        ///< upper bracketing input sample, per output sample
+    vector< R > _weights;           ///< per output sample: [y_lower, y_upper, m_lower, m_upper] weights (cubic) or [y_lower, y_upper] (linear)
+    // spline tridiagonal system, w/ precomputed (Thomas) elimination, per unknown
+    vector< R > _sub;               ///< sub-diagonal coefficients
+    vector< R > _inv_diagonal;      ///< reciprocal of eliminated diagonal
+    vector< R > _super;             ///< eliminated super-diagonal (c' = c / diagonal)
+    vector< R > _slope_scale;       ///< 6 / h, per interval
+    // periodic spline (Sherman-Morrison correction)
+    vector< R > _z;
+    R _beta_gamma = R(0);
+    R _correction = R(0);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Cubic spline interpolant over a fixed input sample base, i.e. the tridiagonal system is factorized once
+///             and reused to fit any number of signals (columns), which are then evaluated at arbitrary points.
+///
+/// @tparam     R     Sample base (and value) type, floating point.
+///
+template < typename R = double >
+class spline : protected plan< R > {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  knots   Input sample base (strictly increasing).
+    /// @param[in]  period  Period of sample base (cf. plan). Defaults to 0 (natural spline).
+    ///
+    /// @throws     std::invalid_argument if *knots* is empty or not strictly increasing, or *period* is too short.
+    ///
+    explicit spline(const vector< R >& knots, R period = R(0));
+
+    //--------------------------------------------------------------------------
+    /// @brief      Fits spline to all columns of *values*, replacing previous fit.
+    ///
+    /// @param[in]  values  Sample values (knots x channels).
+    /// @param      pool    Thread pool. Defaults to shared pool instance.
+    ///
+    template < typename T >
+    void fit(matrix_view< const T > values, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Fits spline to a single signal (knots elements).
+    ///
+    template < typename T >
+    void fit(const vector< T >& values);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates fitted spline of *column* at *x*.
+    ///
+    R operator()(R x, size_t column = 0) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates all fitted columns at points *x* into *out* (x.size() x channels()).
+    ///
+    void evaluate(const vector< R >& x, matrix_view< R > out, work_stealing_pool& pool = work_stealing_pool::instance()) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Evaluates all fitted columns at points *x*.
+    ///
+    /// @return     Interpolated values (x.size() x channels()).
+    ///
+    matrix< R > evaluate(const vector< R >& x, work_stealing_pool& pool = work_stealing_pool::instance()) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of fitted channels (0 before fit()).
+    ///
+    size_t channels() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Input sample base.
+    ///
+    const vector< R >& knots() const;
+
+ protected:
+    vector< R > _knots;
+    vector< R > _h;                 ///< interval widths
+    size_t _channels = 0;
+    vector< R > _values;            ///< fitted values (knots x channels)
+    vector< R > _m;                 ///< fitted second derivatives (knots x channels)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Default number of filter zero crossings (per side) of designed anti-aliasing filters.
+///
+constexpr size_t zero_crossings = 10;
+
+//------------------------------------------------------------------------------
+/// @brief      Default Kaiser window shape parameter of designed anti-aliasing filters.
+///
+constexpr double kaiser_beta = 5.0;
+
+//------------------------------------------------------------------------------
+/// @brief      Polyphase rational resampler, i.e. upsampling by *up*, anti-aliasing FIR filtering and downsampling by
+///             *down*, evaluating only the filter phase required by each output sample.
+///
+/// Input is processed in (arbitrarily sized) blocks of samples x channels; filter history and output phase are carried
+/// between blocks, s.t. streaming and one-shot processing yield the same output. Output is delayed by delay() samples
+/// w.r.t. input (cf. resample() for aligned one-shot resampling).
+///
+/// @tparam     T     Sample type.
+///
+template < typename T >
+class polyphase {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Coefficient (and accumulator) type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance, w/ a designed (Kaiser windowed sinc) anti-aliasing filter.
+    ///
+    /// @param[in]  up         Upsampling factor.
+    /// @param[in]  down       Downsampling factor.
+    /// @param[in]  channels   Number of channels. Defaults to 1.
+    /// @param[in]  crossings  Filter zero crossings per side (filter length is 2 * crossings * max(up, down) + 1
+    ///                        taps, on the upsampled rate). Defaults to zero_crossings.
+    /// @param[in]  beta       Kaiser window shape parameter. Defaults to kaiser_beta.
+    ///
+    /// @throws     std::invalid_argument if either factor or *crossings* is 0.
+    ///
+    polyphase(size_t up, size_t down, size_t channels = 1, size_t crossings = zero_crossings, double beta = kaiser_beta);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance, w/ a given anti-aliasing filter (on the upsampled rate, incl. gain *up*).
+    ///
+    /// @throws     std::invalid_argument if either factor is 0 or *taps* is empty.
+    ///
+    polyphase(size_t up, size_t down, const vector< value_type >& taps, size_t channels = 1);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of output samples of next block of *rows* input samples.
+    ///
+    size_t output_size(size_t rows) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resamples a block of samples.
+    ///
+    /// @param[in]  in    Input block (samples x channels).
+    /// @param[in]  out   Output block (at least output_size(in.rows()) x channels).
+    /// @param      pool  Thread pool. Defaults to shared pool instance.
+    ///
+    /// @return     Number of output samples written.
+    ///
+    size_t process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool = work_stealing_pool::instance());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resamples a block of samples (samples x channels).
+    ///
+    matrix< T > process(const matrix< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resamples a block of samples (single channel).
+    ///
+    vector< T > process(const vector< T >& in);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets resampler state (i.e. zero history, output phase aligned to first input sample).
+    ///
+    void reset();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filter delay (output samples).
+    ///
+    size_t delay() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Upsampling factor (reduced).
+    ///
+    size_t up() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Downsampling factor (reduced).
+    ///
+    size_t down() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Filter coefficients (on the upsampled rate).
+    ///
+    const vector< value_type >& taps() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of channels.
+    ///
+    size_t channels() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Splits filter into phases.
+    ///
+    void build();
+
+    size_t _up;
+    size_t _down;
+    size_t _channels;
+    size_t _delay = 0;
+    vector< value_type > _taps;
+    size_t _length = 0;                 ///< taps per phase
+    vector< value_type > _phases;       ///< phase-major coefficients (up x length), i.e. h[p + k * up] @ [p][k]
+    size_t _offset = 0;                 ///< next output position (upsampled rate) w.r.t. current block
+    vector< T > _buffer;                ///< last length - 1 input samples, followed by current block (rows x channels)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Resamples all columns of *in* by a rational factor *up* / *down* (polyphase, w/ designed
+///             anti-aliasing filter), compensating for filter delay.
+///
+/// @return     Output samples (ceil(in.rows() * up / down) x channels).
+///
+template < typename T >
+matrix< T > resample(const matrix< T >& in, size_t up, size_t down, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Resamples a single signal by a rational factor *up* / *down* (cf. matrix overload).
+///
+template < typename T >
+vector< T > resample(const vector< T >& in, size_t up, size_t down);
+
+}  // namespace resampling
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename R >
+resampling::plan< R >::plan(const vector< R >& from, const vector< R >& to, method algorithm, R period)
+    : _n_in(from.size()), _n_out(to.size()), _method(algorithm), _period(period) {
+    if (from.empty()) {
+        throw invalid_argument("resampling::plan(): empty input sample base");
+    }
+    for (size_t i = 1; i < from.size(); i++) {
+        if (!(from[i] > from[i - 1])) {
+            throw invalid_argument("resampling::plan(): input sample base is not strictly increasing");
+        }
+    }
+    if (_period > R(0) && !(from.back() - from.front() < _period)) {
+        throw invalid_argument("resampling::plan(): period shorter than input sample base");
+    }
+    build(from, to);
+}
+
+
+
+template < typename R >
+resampling::plan< R >::plan(size_t n_from, size_t n_to, method algorithm)
+    : _n_in(n_from), _n_out(n_to), _method(algorithm), _period(R(0)) {
+    if (!n_from) {
+        throw invalid_argument("resampling::plan(): empty input sample base");
+    }
+    vector< R > from(n_from);
+    vector< R > to(n_to);
+    for (size_t i = 0; i < n_from; i++) {
+        from[i] = R(i);
+    }
+    R step = (n_to > 1) ? R(n_from - 1) / R(n_to - 1) : R(0);
+    for (size_t i = 0; i < n_to; i++) {
+        to[i] = R(i) * step;
+    }
+    if (n_to > 1) {
+        to.back() = R(n_from - 1);  // exact endpoint alignment
+    }
+    build(from, to);
+}
+
+
+
+template < typename R >
+void resampling::plan< R >::build(const vector< R >& from, const vector< R >& to) {
+    size_t n = _n_in;
+    bool periodic = _period > R(0);
+    // interval widths (w/ closing interval from last to first sample, if periodic)
+    size_t n_intervals = periodic ? n : n - 1;
+    vector< R > h(n_intervals);
+    for (size_t i = 0; i + 1 < n; i++) {
+        h[i] = from[i + 1] - from[i];
+    }
+    if (periodic) {
+        h[n - 1] = from[0] + _period - from[n - 1];
+    }
+    // brackets & weights
+    size_t stride = (_method == method::cubic) ? 4 : 2;
+    _lower.resize(_n_out);
+    _upper.resize(_n_out);
+    _weights.assign(_n_out * stride, R(0));
+    for (size_t i = 0; i < _n_out; i++) {
+        bracket(from, h, to[i], _lower[i], _upper[i], _weights.data() + i * stride);
+    }
+    if (_method != method::cubic || n < 3) {
+        return;
+    }
+    // spline tridiagonal system: h[i-1] m[i-1] + 2 (h[i-1] + h[i]) m[i] + h[i] m[i+1] = 6 (dy[i] / h[i] - dy[i-1] / h[i-1])
+    // natural: unknowns 1..n-2 (m[0] = m[n-1] = 0); periodic: unknowns 0..n-1 (cyclic)
+    _slope_scale.resize(n_intervals);
+    for (size_t i = 0; i < n_intervals; i++) {
+        _slope_scale[i] = R(6) / h[i];
+    }
+    _sub.assign(n, R(0));
+    _inv_diagonal.assign(n, R(0));
+    _super.assign(n, R(0));
+    size_t first = periodic ? 0 : 1;
+    size_t last = periodic ? n : n - 1;
+    vector< R > diagonal(n);
+    for (size_t i = first; i < last; i++) {
+        size_t prev = (i + n - 1) % n;
+        _sub[i] = h[prev];
+        diagonal[i] = R(2) * (h[prev] + h[i]);
+        _super[i] = h[i];
+    }
+    R gamma = R(0);
+    R alpha = R(0);
+    R beta = R(0);
+    if (periodic) {
+        // Sherman-Morrison: A = A' + u v^T, u = [gamma, 0, ..., alpha], v = [1, 0, ..., beta / gamma]
+        alpha = _super[n - 1];
+        beta = _sub[0];
+        gamma = -diagonal[0];
+        diagonal[0] -= gamma;
+        diagonal[n - 1] -= alpha * beta / gamma;
+    }
+    // Thomas elimination (sub-diagonal of first unknown and super-diagonal of last one are ignored)
+    for (size_t i = first; i < last; i++) {
+        R d = diagonal[i] - ((i > first) ? _sub[i] * _super[i - 1] : R(0));
+        _inv_diagonal[i] = R(1) / d;
+        _super[i] = (i + 1 < last) ? _super[i] * _inv_diagonal[i] : R(0);
+    }
+    if (periodic) {
+        // precompute z = A'^-1 u
+        _z.assign(n, R(0));
+        _z[0] = gamma * _inv_diagonal[0];
+        for (size_t i = 1; i < n; i++) {
+            R rhs = (i == n - 1) ? alpha : R(0);
+            _z[i] = (rhs - _sub[i] * _z[i - 1]) * _inv_diagonal[i];
+        }
+        for (size_t i = n - 1; i-- > 0;) {
+            _z[i] -= _super[i] * _z[i + 1];
+        }
+        _beta_gamma = beta / gamma;
+        _correction = R(1) / (R(1) + _z[0] + _beta_gamma * _z[n - 1]);
+    }
+}
+
+
+
+template < typename R >
+void resampling::plan< R >::bracket(const vector< R >& from, const vector< R >& h, R x, size_t& lower, size_t& upper, R* w) const {
+    size_t n = from.size();
+    bool periodic = _period > R(0);
+    if (periodic) {
+        x = from[0] + fmod(x - from[0], _period);
+        if (x < from[0]) {
+            x += _period;
+        }
+    }
+    size_t k = 0;
+    if (n > 1) {
+        size_t next = static_cast< size_t >(upper_bound(from.begin(), from.end(), x) - from.begin());
+        k = (next > 0) ? next - 1 : 0;
+        if (!periodic) {
+            k = min(k, n - 2);
+        }
+    }
+    size_t k1 = (n > 1) ? (k + 1) % n : 0;
+    R t = (n > 1) ? (x - from[k]) / h[k] : R(0);
+    lower = k;
+    upper = k1;
+    if (_method == method::nearest) {
+        t = (t < R(0.5)) ? R(0) : R(1);
+    }
+    w[0] = R(1) - t;
+    w[1] = t;
+    if (_method == method::cubic) {
+        w[2] = R(0);
+        w[3] = R(0);
+        // single (non-periodic) input sample has no interval, i.e. output is constant
+        if (k < h.size() && t >= R(0) && t <= R(1)) {
+            // y = (1 - t) y_k + t y_k1 + h^2 / 6 * [((1 - t)^3 - (1 - t)) m_k + (t^3 - t) m_k1]
+            R u = R(1) - t;
+            R scale = h[k] * h[k] / R(6);
+            w[2] = scale * (u * u * u - u);
+            w[3] = scale * (t * t * t - t);
+        }
+    }
+}
+
+
+
+template < typename R >
+template < typename T, typename A >
+void resampling::plan< R >::solve(const matrix_view< const T >& in, A* m, size_t first, size_t last) const {
+    size_t n = _n_in;
+    size_t cols = in.cols();
+    bool periodic = _period > R(0);
+    size_t i_first = periodic ? 0 : 1;
+    size_t i_last = periodic ? n : n - 1;
+    auto row = [&](size_t i) { return in.data() + i * cols; };
+    if (!periodic) {
+        std::fill(m + first, m + last, A(0));
+        std::fill(m + (n - 1) * cols + first, m + (n - 1) * cols + last, A(0));
+    }
+    // forward sweep: m[i] = (rhs[i] - sub[i] * m[i-1]) / diagonal[i]
+    for (size_t i = i_first; i < i_last; i++) {
+        size_t prev = (i + n - 1) % n;
+        size_t next = (i + 1) % n;
+        const T* y_prev = row(prev);
+        const T* y = row(i);
+        const T* y_next = row(next);
+        A s_next = A(_slope_scale[i]);
+        A s_prev = A(_slope_scale[prev]);
+        A sub = (i > i_first) ? A(_sub[i]) : A(0);
+        A inv = A(_inv_diagonal[i]);
+        A* m_i = m + i * cols;
+        const A* m_prev = m + prev * cols;
+        for (size_t j = first; j < last; j++) {
+            A rhs = s_next * (A(y_next[j]) - A(y[j])) - s_prev * (A(y[j]) - A(y_prev[j]));
+            m_i[j] = (rhs - sub * m_prev[j]) * inv;
+        }
+    }
+    // back substitution: m[i] -= c'[i] * m[i+1]
+    for (size_t i = i_last - 1; i-- > i_first;) {
+        A* m_i = m + i * cols;
+        const A* m_next = m + (i + 1) * cols;
+        A super = A(_super[i]);
+        for (size_t j = first; j < last; j++) {
+            m_i[j] -= super * m_next[j];
+        }
+    }
+    if (periodic) {
+        // Sherman-Morrison correction: m -= z * (m[0] + beta / gamma * m[n-1]) / (1 + z[0] + beta / gamma * z[n-1])
+        const A* m_first = m;
+        const A* m_last = m + (n - 1) * cols;
+        vector< A > factor(last - first);
+        for (size_t j = first; j < last; j++) {
+            factor[j - first] = (m_first[j] + A(_beta_gamma) * m_last[j]) * A(_correction);
+        }
+        for (size_t i = 0; i < n; i++) {
+            A* m_i = m + i * cols;
+            A z = A(_z[i]);
+            for (size_t j = first; j < last; j++) {
+                m_i[j] -= z * factor[j - first];
+            }
+        }
+    }
+}
+
+
+
+template < typename R >
+template < typename T >
+void resampling::plan< R >::apply(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) const {
+    assert(in.rows() == _n_in && out.rows() == _n_out && in.cols() == out.cols());
+    typedef summation::accumulator_t< T > A;
+    size_t cols = in.cols();
+    bool spline = (_method == method::cubic) && _n_in > 2;
+    vector< A > m;
+    if (spline) {
+        m.resize(_n_in * cols);
+        parallel_for(0, cols, [&](size_t first, size_t last) {
+            solve(in, m.data(), first, last);
+        }, resampling::min_cols, pool);
+    }
+    size_t stride = (_method == method::cubic) ? 4 : 2;
+    parallel_for(0, _n_out, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            const R* w = _weights.data() + i * stride;
+            const T* y_lower = in.data() + _lower[i] * cols;
+            const T* y_upper = in.data() + _upper[i] * cols;
+            T* y = out.data() + i * cols;
+            A w0 = A(w[0]);
+            A w1 = A(w[1]);
+            if (spline && (w[2] != R(0) || w[3] != R(0))) {
+                const A* m_lower = m.data() + _lower[i] * cols;
+                const A* m_upper = m.data() + _upper[i] * cols;
+                A w2 = A(w[2]);
+                A w3 = A(w[3]);
+                for (size_t j = 0; j < cols; j++) {
+                    y[j] = static_cast< T >(w0 * A(y_lower[j]) + w1 * A(y_upper[j]) + w2 * m_lower[j] + w3 * m_upper[j]);
+                }
+            } else {
+                for (size_t j = 0; j < cols; j++) {
+                    y[j] = static_cast< T >(w0 * A(y_lower[j]) + w1 * A(y_upper[j]));
+                }
+            }
+        }
+    }, resampling::min_rows, pool);
+}
+
+
+
+template < typename R >
+template < typename T >
+matrix< T > resampling::plan< R >::apply(const matrix< T >& in, work_stealing_pool& pool) const {
+    if (in.rows() != _n_in) {
+        throw invalid_argument("resampling::plan::apply(): input size mismatch");
+    }
+    matrix< T > out(_n_out, in.cols());
+    apply(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()), pool);
+    return out;
+}
+
+
+
+template < typename R >
+template < typename T >
+vector< T > resampling::plan< R >::apply(const vector< T >& in) const {
+    if (in.size() != _n_in) {
+        throw invalid_argument("resampling::plan::apply(): input size mismatch");
+    }
+    vector< T > out(_n_out);
+    apply(matrix_view< const T >(in.data(), in.size(), 1), matrix_view< T >(out.data(), out.size(), 1));
+    return out;
+}
+
+
+
+template < typename R >
+size_t resampling::plan< R >::size_in() const {
+    return _n_in;
+}
+
+
+
+template < typename R >
+size_t resampling::plan< R >::size_out() const {
+    return _n_out;
+}
+
+
+
+template < typename R >
+resampling::method resampling::plan< R >::interpolation() const {
+    return _method;
+}
+
+
+
+template < typename R >
+R resampling::plan< R >::period() const {
+    return _period;
+}
+
+
+
+template < typename R >
+resampling::spline< R >::spline(const vector< R >& knots, R period)
+    : plan< R >(knots, vector< R >(), method::cubic, period), _knots(knots), _h(knots.size() - 1 + ((period > R(0)) ? 1 : 0)) {
+    for (size_t i = 0; i + 1 < _knots.size(); i++) {
+        _h[i] = _knots[i + 1] - _knots[i];
+    }
+    if (period > R(0)) {
+        _h.back() = _knots[0] + period - _knots.back();
+    }
+}
+
+
+
+template < typename R >
+template < typename T >
+void resampling::spline< R >::fit(matrix_view< const T > values, work_stealing_pool& pool) {
+    if (values.rows() != _knots.size()) {
+        throw invalid_argument("resampling::spline::fit(): input size mismatch");
+    }
+    _channels = values.cols();
+    _values.resize(values.rows() * _channels);
+    for (size_t i = 0; i < _values.size(); i++) {
+        _values[i] = R(values.data()[i]);
+    }
+    _m.assign(values.rows() * _channels, R(0));
+    if (_knots.size() > 2) {
+        parallel_for(0, _channels, [&](size_t first, size_t last) {
+            this->solve(values, _m.data(), first, last);
+        }, resampling::min_cols, pool);
+    }
+}
+
+
+
+template < typename R >
+template < typename T >
+void resampling::spline< R >::fit(const vector< T >& values) {
+    fit(matrix_view< const T >(values.data(), values.size(), 1));
+}
+
+
+
+template < typename R >
+R resampling::spline< R >::operator()(R x, size_t column) const {
+    assert(column < _channels);
+    size_t lower = 0;
+    size_t upper = 0;
+    R w[4];
+    this->bracket(_knots, _h, x, lower, upper, w);
+    return w[0] * _values[lower * _channels + column] + w[1] * _values[upper * _channels + column]
+         + w[2] * _m[lower * _channels + column] + w[3] * _m[upper * _channels + column];
+}
+
+
+
+template < typename R >
+void resampling::spline< R >::evaluate(const vector< R >& x, matrix_view< R > out, work_stealing_pool& pool) const {
+    assert(out.rows() == x.size() && out.cols() == _channels);
+    size_t cols = _channels;
+    parallel_for(0, x.size(), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            size_t lower = 0;
+            size_t upper = 0;
+            R w[4];
+            this->bracket(_knots, _h, x[i], lower, upper, w);
+            const R* y_lower = _values.data() + lower * cols;
+            const R* y_upper = _values.data() + upper * cols;
+            const R* m_lower = _m.data() + lower * cols;
+            const R* m_upper = _m.data() + upper * cols;
+            R* y = out.data() + i * cols;
+            for (size_t j = 0; j < cols; j++) {
+                y[j] = w[0] * y_lower[j] + w[1] * y_upper[j] + w[2] * m_lower[j] + w[3] * m_upper[j];
+            }
+        }
+    }, resampling::min_rows, pool);
+}
+
+
+
+template < typename R >
+matrix< R > resampling::spline< R >::evaluate(const vector< R >& x, work_stealing_pool& pool) const {
+    matrix< R > out(x.size(), _channels);
+    evaluate(x, matrix_view< R >(out.data(), out.rows(), out.cols()), pool);
+    return out;
+}
+
+
+
+template < typename R >
+size_t resampling::spline< R >::channels() const {
+    return _channels;
+}
+
+
+
+template < typename R >
+const vector< R >& resampling::spline< R >::knots() const {
+    return _knots;
+}
+
+
+
+template < typename T >
+resampling::polyphase< T >::polyphase(size_t up, size_t down, size_t channels, size_t crossings, double beta)
+    : _up(up), _down(down), _channels(channels) {
+    if (!up || !down || !crossings) {
+        throw invalid_argument("resampling::polyphase(): invalid factors");
+    }
+    size_t g = gcd(_up, _down);
+    _up /= g;
+    _down /= g;
+    // Kaiser windowed sinc, cutoff @ Nyquist of the lower rate, w/ DC gain *up*
+    size_t half = crossings * std::max(_up, _down);
+    double cutoff = 1.0 / static_cast< double >(std::max(_up, _down));
+    auto bessel = [](double x) {
+        // modified Bessel function of first kind, order 0 (power series)
+        double sum = 1.0;
+        double term = 1.0;
+        for (size_t k = 1; k < 64 && term > sum * 1e-17; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    };
+    // front padding aligns filter center w/ an output sample, i.e. integer delay
+    size_t pad = (_down - half % _down) % _down;
+    vector< double > h(pad + 2 * half + 1, 0.0);
+    double norm = 0.0;
+    for (size_t k = 0; k <= 2 * half; k++) {
+        double t = static_cast< double >(k) - static_cast< double >(half);
+        double sinc = (t == 0.0) ? 1.0 : sin(pi * cutoff * t) / (pi * cutoff * t);
+        double r = t / static_cast< double >(half);
+        double window = bessel(beta * sqrt(std::max(0.0, 1.0 - r * r))) / bessel(beta);
+        h[pad + k] = sinc * window;
+        norm += h[pad + k];
+    }
+    _taps.resize(h.size());
+    for (size_t k = 0; k < h.size(); k++) {
+        _taps[k] = static_cast< value_type >(h[k] * static_cast< double >(_up) / norm);
+    }
+    _delay = (pad + half) / _down;
+    build();
+}
+
+
+
+template < typename T >
+resampling::polyphase< T >::polyphase(size_t up, size_t down, const vector< value_type >& taps, size_t channels)
+    : _up(up), _down(down), _channels(channels), _taps(taps) {
+    if (!up || !down || taps.empty()) {
+        throw invalid_argument("resampling::polyphase(): invalid factors or filter");
+    }
+    size_t g = gcd(_up, _down);
+    _up /= g;
+    _down /= g;
+    _delay = ((_taps.size() - 1) / 2) / _down;
+    build();
+}
+
+
+
+template < typename T >
+void resampling::polyphase< T >::build() {
+    _length = (_taps.size() + _up - 1) / _up;
+    _phases.assign(_up * _length, value_type(0));
+    for (size_t k = 0; k < _taps.size(); k++) {
+        _phases[(k % _up) * _length + k / _up] = _taps[k];
+    }
+    reset();
+}
+
+
+
+template < typename T >
+size_t resampling::polyphase< T >::output_size(size_t rows) const {
+    size_t end = rows * _up;
+    return (_offset < end) ? (end - _offset + _down - 1) / _down : 0;
+}
+
+
+
+template < typename T >
+size_t resampling::polyphase< T >::process(matrix_view< const T > in, matrix_view< T > out, work_stealing_pool& pool) {
+    assert(in.cols() == _channels && out.cols() == _channels);
+    size_t rows = in.rows();
+    size_t count = output_size(rows);
+    assert(out.rows() >= count);
+    size_t cols = _channels;
+    size_t history = _length - 1;
+    // history followed by current block, i.e. input sample i of block @ row history + i
+    _buffer.resize((history + rows) * cols);
+    std::copy(in.data(), in.data() + rows * cols, _buffer.begin() + history * cols);
+    size_t offset = _offset;
+    parallel_for(0, count, [&](size_t first, size_t last) {
+        vector< value_type > acc(cols);
+        for (size_t n = first; n < last; n++) {
+            size_t position = offset + n * _down;
+            const value_type* h = _phases.data() + (position % _up) * _length;
+            const T* x = _buffer.data() + (history + position / _up) * cols;
+            std::fill(acc.begin(), acc.end(), value_type(0));
+            for (size_t k = 0; k < _length; k++) {
+                value_type w = h[k];
+                const T* row = x - k * cols;
+                for (size_t j = 0; j < cols; j++) {
+                    acc[j] += w * value_type(row[j]);
+                }
+            }
+            T* y = out.data() + n * cols;
+            for (size_t j = 0; j < cols; j++) {
+                y[j] = static_cast< T >(acc[j]);
+            }
+        }
+    }, resampling::min_rows, pool);
+    // carry state: output phase and last history rows
+    _offset += count * _down;
+    _offset -= rows * _up;
+    std::copy(_buffer.end() - history * cols, _buffer.end(), _buffer.begin());
+    _buffer.resize(history * cols);
+    return count;
+}
+
+
+
+template < typename T >
+matrix< T > resampling::polyphase< T >::process(const matrix< T >& in) {
+    if (in.cols() != _channels) {
+        throw invalid_argument("resampling::polyphase::process(): channel mismatch");
+    }
+    matrix< T > out(output_size(in.rows()), _channels);
+    process(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()));
+    return out;
+}
+
+
+
+template < typename T >
+vector< T > resampling::polyphase< T >::process(const vector< T >& in) {
+    if (_channels != 1) {
+        throw invalid_argument("resampling::polyphase::process(): channel mismatch");
+    }
+    vector< T > out(output_size(in.size()));
+    process(matrix_view< const T >(in.data(), in.size(), 1), matrix_view< T >(out.data(), out.size(), 1));
+    return out;
+}
+
+
+
+template < typename T >
+void resampling::polyphase< T >::reset() {
+    _offset = 0;
+    _buffer.assign((_length - 1) * _channels, T(0));
+}
+
+
+
+template < typename T >
+size_t resampling::polyphase< T >::delay() const {
+    return _delay;
+}
+
+
+
+template < typename T >
+size_t resampling::polyphase< T >::up() const {
+    return _up;
+}
+
+
+
+template < typename T >
+size_t resampling::polyphase< T >::down() const {
+    return _down;
+}
+
+
+
+template < typename T >
+const vector< typename resampling::polyphase< T >::value_type >& resampling::polyphase< T >::taps() const {
+    return _taps;
+}
+
+
+
+template < typename T >
+size_t resampling::polyphase< T >::channels() const {
+    return _channels;
+}
+
+
+
+template < typename T >
+matrix< T > resampling::resample(const matrix< T >& in, size_t up, size_t down, work_stealing_pool& pool) {
+    polyphase< T > resampler(up, down, in.cols());
+    size_t rows = in.rows();
+    size_t size = (rows * resampler.up() + resampler.down() - 1) / resampler.down();
+    // zero padding s.t. last aligned output sample is produced, i.e. position (delay + size - 1) * down is reached
+    size_t needed = (size) ? ((resampler.delay() + size - 1) * resampler.down()) / resampler.up() + 1 : 0;
+    matrix< T > padded(std::max(rows, needed), in.cols());
+    std::copy(in.data(), in.data() + rows * in.cols(), padded.data());
+    matrix< T > filtered(resampler.output_size(padded.rows()), in.cols());
+    resampler.process(matrix_view< const T >(padded.data(), padded.rows(), padded.cols()), matrix_view< T >(filtered.data(), filtered.rows(), filtered.cols()), pool);
+    matrix< T > out(size, in.cols());
+    size_t offset = resampler.delay() * in.cols();
+    std::copy(filtered.data() + offset, filtered.data() + offset + size * in.cols(), out.data());
+    return out;
+}
+
+
+
+template < typename T >
+vector< T > resampling::resample(const vector< T >& in, size_t up, size_t down) {
+    matrix< T > data(in.size(), 1);
+    std::copy(in.begin(), in.end(), data.data());
+    matrix< T > out = resample(data, up, down);
+    return vector< T >(out.data(), out.data() + out.rows());
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_RESAMPLE_HPP_
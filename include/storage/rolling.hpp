@@ -0,0 +1,818 @@
+//------------------------------------------------------------------------------
+/// @file       rolling.hpp
+/// @author     João André
+///
+/// @brief      Incremental rolling-window aggregators (sum, mean, variance, RMS, min/max, median), bound to
+///             std::range_iterator windows.
+///
+/// Aggregators support insertion & (first in, first out) removal of samples, s.t. moving a window by *step* samples
+/// only removes the outgoing & inserts the incoming samples (O(step) updates, O(step log(width)) for the median)
+/// instead of re-reading the whole window. std::rolling::window<> binds a set of aggregators to a range iterator and
+/// keeps them in sync w/ its current window as it is incremented.
+///
+/// Aggregators share a minimal interface, s.t. custom aggregators can be used w/ std::rolling::window<>:
+///     void insert(value_type), void erase(value_type), void clear(), size_t count() const, value() const
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_ROLLING_HPP_
+#define STORAGE_INCLUDE_STORAGE_ROLLING_HPP_
+
+#include <set>
+#include <cmath>
+#include <deque>
+#include <tuple>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "storage/range_iterator.hpp"
+
+namespace std {
+namespace rolling {
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling sum, w/ compensated (Neumaier) updates s.t. rounding errors do not drift over long streams.
+///
+/// @tparam     R     Accumulator type.
+///
+template < typename R = double >
+class sum {
+ public:
+    typedef R value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Inserts a value.
+    ///
+    void insert(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes a (previously inserted) value.
+    ///
+    void erase(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes all values.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values in window.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sum of values in window.
+    ///
+    R value() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Compensated addition.
+    ///
+    void add(R value);
+
+    R _sum = R(0);
+    R _compensation = R(0);
+    size_t _count = 0;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling mean.
+///
+/// @tparam     R     Accumulator type.
+///
+template < typename R = double >
+class mean : public sum< R > {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Mean of values in window (NaN if empty).
+    ///
+    R value() const;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling root mean square.
+///
+/// @tparam     R     Accumulator type.
+///
+template < typename R = double >
+class rms {
+ public:
+    typedef R value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Inserts a value.
+    ///
+    void insert(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes a (previously inserted) value.
+    ///
+    void erase(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes all values.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values in window.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Root mean square of values in window (NaN if empty).
+    ///
+    R value() const;
+
+ protected:
+    sum< R > _squares;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling variance, w/ Welford updates (& downdates).
+///
+/// @tparam     R     Accumulator type.
+///
+template < typename R = double >
+class variance {
+ public:
+    typedef R value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  ddof  Delta degrees of freedom, i.e. divisor is count() - ddof. Defaults to 1 (sample variance).
+    ///
+    explicit variance(size_t ddof = 1);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Inserts a value.
+    ///
+    void insert(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes a (previously inserted) value.
+    ///
+    void erase(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes all values.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values in window.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Mean of values in window (NaN if empty).
+    ///
+    R mean() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Variance of values in window (NaN if count() <= ddof).
+    ///
+    R value() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Standard deviation of values in window.
+    ///
+    R stddev() const;
+
+ protected:
+    size_t _ddof;
+    size_t _count = 0;
+    R _mean = R(0);
+    R _m2 = R(0);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling extremum (e.g. min or max), w/ a monotonic queue (O(1) amortized per update).
+///
+/// @tparam     R        Value type.
+/// @tparam     Compare  Strict ordering, s.t. the extremum *e* satisfies !Compare(x, e) for all x in window (i.e.
+///                      std::less yields the minimum, std::greater the maximum).
+///
+/// @note       Removals must follow insertion order (first in, first out), as with sliding windows.
+///
+template < typename R, typename Compare >
+class extremum {
+ public:
+    typedef R value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Inserts a value.
+    ///
+    void insert(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes the oldest value in window.
+    ///
+    void erase(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes all values.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values in window.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Extremum of values in window (NaN, if available, if empty).
+    ///
+    R value() const;
+
+ protected:
+    deque< pair< R, size_t > > _queue;   ///< candidates, w/ insertion sequence numbers
+    size_t _inserted = 0;
+    size_t _erased = 0;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling minimum.
+///
+template < typename R = double >
+using min = extremum< R, std::less< R > >;
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling maximum.
+///
+template < typename R = double >
+using max = extremum< R, std::greater< R > >;
+
+//------------------------------------------------------------------------------
+/// @brief      Rolling median, w/ two ordered halves (lower & upper) kept balanced (O(log(width)) per update).
+///
+/// @tparam     R     Value type.
+///
+template < typename R = double >
+class median {
+ public:
+    typedef R value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Inserts a value.
+    ///
+    void insert(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes a (previously inserted) value.
+    ///
+    void erase(R value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes all values.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values in window.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Median of values in window, i.e. mean of middle values for even counts (NaN if empty).
+    ///
+    R value() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Restores balance, i.e. lower half holds as many values as upper half, or one more.
+    ///
+    void balance();
+
+    multiset< R > _lower;
+    multiset< R > _upper;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Set of aggregators bound to a range iterator, updated incrementally as the iterator is incremented.
+///
+/// @tparam     Container    Container type (cf. std::range_iterator<>).
+/// @tparam     T            Element type (cf. std::range_iterator<>).
+/// @tparam     Aggregators  Aggregator types.
+///
+template < typename Container, typename T, typename... Aggregators >
+class window {
+ public:
+    typedef range_iterator< Container, T > iterator_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance, aggregating the current window of *frames* w/ default constructed
+    ///             aggregators.
+    ///
+    /// @param[in]  frames       Range iterator.
+    ///
+    explicit window(iterator_type frames);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance, aggregating the current window of *frames*.
+    ///
+    /// @param[in]  frames       Range iterator.
+    /// @param[in]  aggregators  Aggregator instances (e.g. w/ non-default parameters).
+    ///
+    window(iterator_type frames, Aggregators... aggregators);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Moves to next window, i.e. removes outgoing & inserts incoming values only.
+    ///
+    window& operator++();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if last possible window (cf. std::range_iterator::last()).
+    ///
+    bool last() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Checks if window is full, i.e. holds *width* values (false for a truncated window, e.g. the last one
+    ///             or any window wider than the container).
+    ///
+    bool full() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values in window.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Current range iterator.
+    ///
+    const iterator_type& frame() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Aggregator of index I.
+    ///
+    template < size_t I >
+    const typename tuple_element< I, tuple< Aggregators... > >::type& get() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Window bounds (container positions) of *frame*.
+    ///
+    static pair< size_t, size_t > bounds(const iterator_type& frame);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Inserts value @ given container position in all aggregators.
+    ///
+    void insert(size_t pos);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Removes value @ given container position from all aggregators.
+    ///
+    void erase(size_t pos);
+
+    iterator_type _frame;
+    tuple< Aggregators... > _aggregators;
+    size_t _width;
+    size_t _first;
+    size_t _last;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Evaluates an aggregator over all (full) windows of a range iterator, incrementally.
+///
+/// @param[in]  frames      Range iterator @ first window.
+/// @param[in]  aggregator  Aggregator instance. Defaults to a default constructed aggregator.
+///
+/// @return     Aggregated value of each window.
+///
+template < typename Aggregator, typename Container, typename T >
+vector< typename Aggregator::value_type > apply(range_iterator< Container, T > frames, Aggregator aggregator = Aggregator());
+
+}  // namespace rolling
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename R >
+void rolling::sum< R >::add(R value) {
+    R total = _sum + value;
+    if (abs(_sum) >= abs(value)) {
+        _compensation += (_sum - total) + value;
+    } else {
+        _compensation += (value - total) + _sum;
+    }
+    _sum = total;
+}
+
+
+
+template < typename R >
+void rolling::sum< R >::insert(R value) {
+    add(value);
+    _count++;
+}
+
+
+
+template < typename R >
+void rolling::sum< R >::erase(R value) {
+    assert(_count > 0);
+    add(-value);
+    if (!--_count) {
+        clear();
+    }
+}
+
+
+
+template < typename R >
+void rolling::sum< R >::clear() {
+    _sum = R(0);
+    _compensation = R(0);
+    _count = 0;
+}
+
+
+
+template < typename R >
+size_t rolling::sum< R >::count() const {
+    return _count;
+}
+
+
+
+template < typename R >
+R rolling::sum< R >::value() const {
+    return _sum + _compensation;
+}
+
+
+
+template < typename R >
+R rolling::mean< R >::value() const {
+    if (!this->_count) {
+        return numeric_limits< R >::quiet_NaN();
+    }
+    return sum< R >::value() / static_cast< R >(this->_count);
+}
+
+
+
+template < typename R >
+void rolling::rms< R >::insert(R value) {
+    _squares.insert(value * value);
+}
+
+
+
+template < typename R >
+void rolling::rms< R >::erase(R value) {
+    _squares.erase(value * value);
+}
+
+
+
+template < typename R >
+void rolling::rms< R >::clear() {
+    _squares.clear();
+}
+
+
+
+template < typename R >
+size_t rolling::rms< R >::count() const {
+    return _squares.count();
+}
+
+
+
+template < typename R >
+R rolling::rms< R >::value() const {
+    if (!_squares.count()) {
+        return numeric_limits< R >::quiet_NaN();
+    }
+    // clamped, compensated sums may round slightly below zero
+    return sqrt(std::max(R(0), _squares.value()) / static_cast< R >(_squares.count()));
+}
+
+
+
+template < typename R >
+rolling::variance< R >::variance(size_t ddof) : _ddof(ddof) {
+    // ...
+}
+
+
+
+template < typename R >
+void rolling::variance< R >::insert(R value) {
+    _count++;
+    R delta = value - _mean;
+    _mean += delta / static_cast< R >(_count);
+    _m2 += delta * (value - _mean);
+}
+
+
+
+template < typename R >
+void rolling::variance< R >::erase(R value) {
+    assert(_count > 0);
+    if (_count == 1) {
+        clear();
+        return;
+    }
+    // inverse Welford update
+    R delta = value - _mean;
+    _mean -= delta / static_cast< R >(_count - 1);
+    _m2 -= delta * (value - _mean);
+    _m2 = std::max(_m2, R(0));
+    _count--;
+}
+
+
+
+template < typename R >
+void rolling::variance< R >::clear() {
+    _count = 0;
+    _mean = R(0);
+    _m2 = R(0);
+}
+
+
+
+template < typename R >
+size_t rolling::variance< R >::count() const {
+    return _count;
+}
+
+
+
+template < typename R >
+R rolling::variance< R >::mean() const {
+    return _count ? _mean : numeric_limits< R >::quiet_NaN();
+}
+
+
+
+template < typename R >
+R rolling::variance< R >::value() const {
+    if (_count <= _ddof) {
+        return numeric_limits< R >::quiet_NaN();
+    }
+    return _m2 / static_cast< R >(_count - _ddof);
+}
+
+
+
+template < typename R >
+R rolling::variance< R >::stddev() const {
+    return sqrt(value());
+}
+
+
+
+template < typename R, typename Compare >
+void rolling::extremum< R, Compare >::insert(R value) {
+    Compare comp;
+    while (!_queue.empty() && !comp(_queue.back().first, value)) {
+        _queue.pop_back();
+    }
+    _queue.emplace_back(value, _inserted++);
+}
+
+
+
+template < typename R, typename Compare >
+void rolling::extremum< R, Compare >::erase(R /*value*/) {
+    assert(_erased < _inserted);
+    if (!_queue.empty() && _queue.front().second == _erased) {
+        _queue.pop_front();
+    }
+    _erased++;
+}
+
+
+
+template < typename R, typename Compare >
+void rolling::extremum< R, Compare >::clear() {
+    _queue.clear();
+    _inserted = 0;
+    _erased = 0;
+}
+
+
+
+template < typename R, typename Compare >
+size_t rolling::extremum< R, Compare >::count() const {
+    return _inserted - _erased;
+}
+
+
+
+template < typename R, typename Compare >
+R rolling::extremum< R, Compare >::value() const {
+    if (_queue.empty()) {
+        return numeric_limits< R >::quiet_NaN();
+    }
+    return _queue.front().first;
+}
+
+
+
+template < typename R >
+void rolling::median< R >::insert(R value) {
+    if (_lower.empty() || !(*_lower.rbegin() < value)) {
+        _lower.insert(value);
+    } else {
+        _upper.insert(value);
+    }
+    balance();
+}
+
+
+
+template < typename R >
+void rolling::median< R >::erase(R value) {
+    // values in lower half never exceed values in upper half, i.e. any copy of *value* is equivalent
+    if (!_lower.empty() && !(*_lower.rbegin() < value)) {
+        auto it = _lower.find(value);
+        assert(it != _lower.end());
+        _lower.erase(it);
+    } else {
+        auto it = _upper.find(value);
+        assert(it != _upper.end());
+        _upper.erase(it);
+    }
+    balance();
+}
+
+
+
+template < typename R >
+void rolling::median< R >::balance() {
+    if (_lower.size() > _upper.size() + 1) {
+        auto it = std::prev(_lower.end());
+        _upper.insert(*it);
+        _lower.erase(it);
+    } else if (_upper.size() > _lower.size()) {
+        auto it = _upper.begin();
+        _lower.insert(*it);
+        _upper.erase(it);
+    }
+}
+
+
+
+template < typename R >
+void rolling::median< R >::clear() {
+    _lower.clear();
+    _upper.clear();
+}
+
+
+
+template < typename R >
+size_t rolling::median< R >::count() const {
+    return _lower.size() + _upper.size();
+}
+
+
+
+template < typename R >
+R rolling::median< R >::value() const {
+    if (_lower.empty()) {
+        return numeric_limits< R >::quiet_NaN();
+    }
+    if (_lower.size() == _upper.size()) {
+        return (*_lower.rbegin() + *_upper.begin()) / R(2);
+    }
+    return *_lower.rbegin();
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+rolling::window< Container, T, Aggregators... >::window(iterator_type frames) : window(frames, Aggregators()...) {
+    // ...
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+rolling::window< Container, T, Aggregators... >::window(iterator_type frames, Aggregators... aggregators)
+    : _frame(frames), _aggregators(aggregators...) {
+    _width = _frame.width();
+    auto range = bounds(_frame);
+    _first = range.first;
+    _last = range.second;
+    for (size_t pos = _first; pos < _last; pos++) {
+        insert(pos);
+    }
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+rolling::window< Container, T, Aggregators... >& rolling::window< Container, T, Aggregators... >::operator++() {
+    ++_frame;
+    auto range = bounds(_frame);
+    // outgoing values (oldest first), then incoming values
+    size_t overlap_first = std::max(_first, std::min(range.first, _last));
+    for (size_t pos = _first; pos < overlap_first; pos++) {
+        erase(pos);
+    }
+    for (size_t pos = std::max(_last, range.first); pos < range.second; pos++) {
+        insert(pos);
+    }
+    _first = range.first;
+    _last = std::max(range.second, _first);
+    return *this;
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+bool rolling::window< Container, T, Aggregators... >::last() const {
+    return _frame.last();
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+bool rolling::window< Container, T, Aggregators... >::full() const {
+    return _width && (_last - _first) == _width;
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+size_t rolling::window< Container, T, Aggregators... >::size() const {
+    return _last - _first;
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+const typename rolling::window< Container, T, Aggregators... >::iterator_type& rolling::window< Container, T, Aggregators... >::frame() const {
+    return _frame;
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+template < size_t I >
+const typename tuple_element< I, tuple< Aggregators... > >::type& rolling::window< Container, T, Aggregators... >::get() const {
+    return std::get< I >(_aggregators);
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+pair< size_t, size_t > rolling::window< Container, T, Aggregators... >::bounds(const iterator_type& frame) {
+    typename iterator_type::value_const_iterator origin(frame._container, 0);
+    return { static_cast< size_t >(frame.begin() - origin), static_cast< size_t >(frame.end() - origin) };
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+void rolling::window< Container, T, Aggregators... >::insert(size_t pos) {
+    const auto& value = _frame._container->at(pos);
+    std::apply([&value](auto&... aggregator) {
+        (aggregator.insert(static_cast< typename std::decay_t< decltype(aggregator) >::value_type >(value)), ...);
+    }, _aggregators);
+}
+
+
+
+template < typename Container, typename T, typename... Aggregators >
+void rolling::window< Container, T, Aggregators... >::erase(size_t pos) {
+    const auto& value = _frame._container->at(pos);
+    std::apply([&value](auto&... aggregator) {
+        (aggregator.erase(static_cast< typename std::decay_t< decltype(aggregator) >::value_type >(value)), ...);
+    }, _aggregators);
+}
+
+
+
+template < typename Aggregator, typename Container, typename T >
+vector< typename Aggregator::value_type > rolling::apply(range_iterator< Container, T > frames, Aggregator aggregator) {
+    vector< typename Aggregator::value_type > out;
+    for (window< Container, T, Aggregator > current(frames, aggregator); current.full(); ++current) {
+        out.push_back(current.template get< 0 >().value());
+        if (current.last()) {
+            break;
+        }
+    }
+    return out;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_ROLLING_HPP_
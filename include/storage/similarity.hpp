@@ -0,0 +1,618 @@
+//------------------------------------------------------------------------------
+/// @file       similarity.hpp
+/// @author     João André
+///
+/// @brief      Similarity measures between sequences (Euclidean, z-normalized Euclidean, band-constrained dynamic time
+///             warping) and fast subsequence search of a query over long recordings.
+///
+/// Subsequence search follows the UCR suite: candidates are z-normalized on the fly from running (prefix) sums,
+/// pruned w/ cascading lower bounds (LB_Kim, then LB_Keogh against the query envelope), and all distance
+/// computations are abandoned as soon as they exceed the best match so far. Candidate offsets are scanned in parallel,
+/// sharing the best-so-far distance; ties resolve to the lowest offset, thus results do not depend on scheduling.
+///
+/// Distances are Euclidean, i.e. square root of accumulated squared differences; DTW w/ a band of 0 equals the
+/// (lock-step) Euclidean distance.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_SIMILARITY_HPP_
+#define STORAGE_INCLUDE_STORAGE_SIMILARITY_HPP_
+
+#include <cmath>
+#include <deque>
+#include <atomic>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "storage/type_check.hpp"
+#include "storage/summation.hpp"
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace similarity {
+
+//------------------------------------------------------------------------------
+/// @brief      Distance measure in subsequence search.
+///
+enum class metric {
+    euclidean,   ///< lock-step Euclidean distance
+    dtw          ///< dynamic time warping w/ Sakoe-Chiba band
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Unconstrained DTW band (i.e. full warping window).
+///
+constexpr size_t unconstrained = size_t(-1);
+
+//------------------------------------------------------------------------------
+/// @brief      Default DTW band of search() & profile(), i.e. 5% of query size (at least 1 sample).
+///
+constexpr size_t default_band = size_t(-2);
+
+//------------------------------------------------------------------------------
+/// @brief      Minimum number of candidate offsets per parallel task.
+///
+constexpr size_t min_offsets = 512;
+
+//------------------------------------------------------------------------------
+/// @brief      Search result.
+///
+/// @tparam     R     Distance type.
+///
+template < typename R >
+struct match {
+    size_t offset;   ///< candidate offset (first sample)
+    R distance;      ///< distance to query
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean distance between equally sized sequences.
+///
+/// @throws     std::invalid_argument on size mismatch.
+///
+template < typename X, typename Y >
+auto euclidean(const X& a, const Y& b);
+
+//------------------------------------------------------------------------------
+/// @brief      Z-normalized copy of a sequence, i.e. (x - mean) / stddev (population); zeros if constant.
+///
+template < typename Container >
+auto znormalize(const Container& x);
+
+//------------------------------------------------------------------------------
+/// @brief      Euclidean distance between z-normalized, equally sized sequences.
+///
+/// @throws     std::invalid_argument on size mismatch.
+///
+template < typename X, typename Y >
+auto znormalized_euclidean(const X& a, const Y& b);
+
+//------------------------------------------------------------------------------
+/// @brief      Dynamic time warping distance w/ Sakoe-Chiba band.
+///
+/// @param[in]  a     First sequence (non-empty).
+/// @param[in]  b     Second sequence (non-empty).
+/// @param[in]  band  Maximum warping (samples) w.r.t. the diagonal; widened to the size difference of *a* & *b* if
+///                   lower. Defaults to unconstrained.
+///
+/// @throws     std::invalid_argument if either sequence is empty.
+///
+template < typename X, typename Y >
+auto dtw(const X& a, const Y& b, size_t band = unconstrained);
+
+//------------------------------------------------------------------------------
+/// @brief      Lower & upper envelopes of a sequence, i.e. running min/max over [i - band, i + band] (O(n), Lemire).
+///
+template < typename R >
+void envelope(const vector< R >& x, size_t band, vector< R >& lower, vector< R >& upper);
+
+//------------------------------------------------------------------------------
+/// @brief      LB_Kim (first & last points) lower bound of the squared DTW distance (any band).
+///
+template < typename R >
+R lb_kim(const R* query, const R* candidate, size_t n);
+
+//------------------------------------------------------------------------------
+/// @brief      LB_Keogh lower bound of the squared DTW distance, i.e. squared excursions of *candidate* outside the
+///             query envelope, abandoned once *bound* is exceeded.
+///
+template < typename R >
+R lb_keogh(const R* lower, const R* upper, const R* candidate, size_t n, R bound = numeric_limits< R >::infinity());
+
+//------------------------------------------------------------------------------
+/// @brief      Best match of *query* within column *column* of *data* (samples x channels).
+///
+/// @param[in]  data       Input recording.
+/// @param[in]  column     Column to search.
+/// @param[in]  query      Query sequence (non-empty, not longer than *data*).
+/// @param[in]  measure    Distance measure. Defaults to Euclidean.
+/// @param[in]  normalize  Z-normalization flag (query & each candidate). Defaults to true.
+/// @param[in]  band       Sakoe-Chiba band (DTW), or unconstrained. Defaults to 5% of query size (default_band).
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @throws     std::invalid_argument if query is empty or longer than recording, or column is out of range.
+///
+template < typename T, typename Query >
+match< summation::accumulator_t< T > > search(matrix_view< const T > data, size_t column, const Query& query, metric measure = metric::euclidean, bool normalize = true, size_t band = default_band, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Best match of *query* within *data* (cf. search()).
+///
+template < typename T, typename Query >
+match< summation::accumulator_t< T > > search(const vector< T >& data, const Query& query, metric measure = metric::euclidean, bool normalize = true, size_t band = default_band);
+
+//------------------------------------------------------------------------------
+/// @brief      Distance profile, i.e. distance of *query* to every candidate offset of column *column* of *data* (cf.
+///             search(), w/o pruning).
+///
+/// @return     Distances (data.rows() - query.size() + 1 values).
+///
+template < typename T, typename Query >
+vector< summation::accumulator_t< T > > profile(matrix_view< const T > data, size_t column, const Query& query, metric measure = metric::euclidean, bool normalize = true, size_t band = default_band, work_stealing_pool& pool = work_stealing_pool::instance());
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Squared DTW distance w/ early abandoning, i.e. once the row minimum plus the lower bound of columns
+///             not yet reachable by the band exceeds *bound*.
+///
+/// @param[in]  a          First sequence.
+/// @param[in]  n          First sequence size.
+/// @param[in]  b          Second sequence.
+/// @param[in]  m          Second sequence size.
+/// @param[in]  band       Sakoe-Chiba band.
+/// @param[in]  remaining  Cumulative lower bound of columns j onwards, e.g. suffix sums of LB_Keogh terms of *b* (m + 1
+///                        values, optional).
+/// @param[in]  bound      Abandoning bound (squared).
+/// @param      buffer     Work buffer (2 * (m + 1) values).
+///
+/// @return     Squared distance, or infinity if abandoned.
+///
+template < typename R >
+R dtw(const R* a, size_t n, const R* b, size_t m, size_t band, const R* remaining, R bound, R* buffer);
+
+//------------------------------------------------------------------------------
+/// @brief      Subsequence search state, i.e. preprocessed query & recording.
+///
+template < typename R >
+class searcher {
+ public:
+    searcher(vector< R > series, vector< R > query, metric measure, bool normalize, size_t band);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Squared distance of candidate @ *offset*, or infinity if larger than *bound* (abandoned).
+    ///
+    /// @param      work  Work buffer (4 * query size + 3 values).
+    ///
+    R distance(size_t offset, R bound, R* work) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of candidate offsets.
+    ///
+    size_t offsets() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Work buffer size.
+    ///
+    size_t work_size() const;
+
+ protected:
+    vector< R > _series;
+    vector< R > _query;            ///< (normalized) query
+    vector< size_t > _order;       ///< query positions by decreasing magnitude (early abandoning order)
+    vector< R > _lower;            ///< query envelope (DTW)
+    vector< R > _upper;            ///< query envelope (DTW)
+    vector< long double > _sum;    ///< prefix sums of series
+    vector< long double > _sum2;   ///< prefix sums of squared series
+    metric _measure;
+    bool _normalize;
+    size_t _band;
+};
+
+}  // namespace details
+}  // namespace similarity
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename X, typename Y >
+auto similarity::euclidean(const X& a, const Y& b) {
+    typedef summation::accumulator_t< typename common_type< typename decay< decltype(a[0]) >::type, typename decay< decltype(b[0]) >::type >::type > value_type;
+    if (a.size() != b.size()) {
+        throw invalid_argument("similarity::euclidean(): size mismatch");
+    }
+    value_type acc[summation::lanes] = { };
+    size_t n = a.size();
+    size_t i = 0;
+    for (; i + summation::lanes <= n; i += summation::lanes) {
+        for (size_t k = 0; k < summation::lanes; k++) {
+            value_type d = static_cast< value_type >(a[i + k]) - static_cast< value_type >(b[i + k]);
+            acc[k] += d * d;
+        }
+    }
+    for (; i < n; i++) {
+        value_type d = static_cast< value_type >(a[i]) - static_cast< value_type >(b[i]);
+        acc[0] += d * d;
+    }
+    value_type sum = value_type(0);
+    for (size_t k = 0; k < summation::lanes; k++) {
+        sum += acc[k];
+    }
+    return sqrt(sum);
+}
+
+
+
+template < typename Container >
+auto similarity::znormalize(const Container& x) {
+    typedef summation::accumulator_t< typename decay< decltype(x[0]) >::type > value_type;
+    size_t n = x.size();
+    vector< value_type > out(n);
+    if (!n) {
+        return out;
+    }
+    value_type mean = value_type(0);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = static_cast< value_type >(x[i]);
+        mean += out[i];
+    }
+    mean /= static_cast< value_type >(n);
+    value_type var = value_type(0);
+    for (size_t i = 0; i < n; i++) {
+        var += (out[i] - mean) * (out[i] - mean);
+    }
+    value_type sd = sqrt(var / static_cast< value_type >(n));
+    value_type scale = (sd > numeric_limits< value_type >::epsilon() * std::max(value_type(1), abs(mean))) ? value_type(1) / sd : value_type(0);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (out[i] - mean) * scale;
+    }
+    return out;
+}
+
+
+
+template < typename X, typename Y >
+auto similarity::znormalized_euclidean(const X& a, const Y& b) {
+    if (a.size() != b.size()) {
+        throw invalid_argument("similarity::znormalized_euclidean(): size mismatch");
+    }
+    return euclidean(znormalize(a), znormalize(b));
+}
+
+
+
+template < typename X, typename Y >
+auto similarity::dtw(const X& a, const Y& b, size_t band) {
+    typedef summation::accumulator_t< typename common_type< typename decay< decltype(a[0]) >::type, typename decay< decltype(b[0]) >::type >::type > value_type;
+    if (!a.size() || !b.size()) {
+        throw invalid_argument("similarity::dtw(): empty sequence");
+    }
+    vector< value_type > x(a.size()), y(b.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = static_cast< value_type >(a[i]);
+    }
+    for (size_t j = 0; j < y.size(); j++) {
+        y[j] = static_cast< value_type >(b[j]);
+    }
+    vector< value_type > buffer(2 * (y.size() + 1));
+    value_type d2 = details::dtw< value_type >(x.data(), x.size(), y.data(), y.size(), band, nullptr, numeric_limits< value_type >::infinity(), buffer.data());
+    return sqrt(d2);
+}
+
+
+
+template < typename R >
+R similarity::details::dtw(const R* a, size_t n, const R* b, size_t m, size_t band, const R* remaining, R bound, R* buffer) {
+    const R inf = numeric_limits< R >::infinity();
+    size_t diff = (n > m) ? n - m : m - n;
+    // clamped to full window, i.e. window bounds below never overflow (e.g. w/ unconstrained or default_band)
+    band = std::min(std::max(band, diff), std::max(n, m));
+    // rolling rows of cumulative cost, w/ a leading sentinel column (index 0)
+    R* previous = buffer;
+    R* current = buffer + (m + 1);
+    std::fill(buffer, buffer + 2 * (m + 1), inf);
+    previous[0] = R(0);
+    for (size_t i = 0; i < n; i++) {
+        size_t j0 = (i > band) ? i - band : 0;
+        size_t j1 = std::min(m, i + band + 1);
+        // cells outside the band are kept @ infinity, i.e. only its borders are reset
+        current[j0] = inf;
+        if (j1 < m) {
+            current[j1 + 1] = inf;
+        }
+        R row_min = inf;
+        for (size_t j = j0; j < j1; j++) {
+            R d = a[i] - b[j];
+            R best = std::min(previous[j + 1], std::min(previous[j], current[j]));
+            R cost = d * d + best;
+            current[j + 1] = cost;
+            row_min = std::min(row_min, cost);
+        }
+        // sentinel only seeds the first row
+        if (i == 0) {
+            previous[0] = inf;
+        }
+        // any path from row i must still cross columns beyond the band, i.e. j1 onwards
+        if (row_min + (remaining ? remaining[j1] : R(0)) > bound) {
+            return inf;
+        }
+        std::swap(previous, current);
+    }
+    return previous[m];
+}
+
+
+
+template < typename R >
+void similarity::envelope(const vector< R >& x, size_t band, vector< R >& lower, vector< R >& upper) {
+    size_t n = x.size();
+    lower.assign(n, R(0));
+    upper.assign(n, R(0));
+    if (!n) {
+        return;
+    }
+    band = std::min(band, n);
+    // monotonic queues of indices over the sliding window [i - band, i + band]
+    deque< size_t > maxima, minima;
+    for (size_t k = 0; k < n + band; k++) {
+        if (k < n) {
+            while (!maxima.empty() && x[maxima.back()] <= x[k]) {
+                maxima.pop_back();
+            }
+            while (!minima.empty() && x[minima.back()] >= x[k]) {
+                minima.pop_back();
+            }
+            maxima.push_back(k);
+            minima.push_back(k);
+        }
+        if (k >= band) {
+            size_t i = k - band;
+            while (maxima.front() + band < i) {
+                maxima.pop_front();
+            }
+            while (minima.front() + band < i) {
+                minima.pop_front();
+            }
+            upper[i] = x[maxima.front()];
+            lower[i] = x[minima.front()];
+        }
+    }
+}
+
+
+
+template < typename R >
+R similarity::lb_kim(const R* query, const R* candidate, size_t n) {
+    R first = query[0] - candidate[0];
+    if (n == 1) {
+        return first * first;
+    }
+    R last = query[n - 1] - candidate[n - 1];
+    return first * first + last * last;
+}
+
+
+
+template < typename R >
+R similarity::lb_keogh(const R* lower, const R* upper, const R* candidate, size_t n, R bound) {
+    R sum = R(0);
+    for (size_t i = 0; i < n && sum <= bound; i++) {
+        R c = candidate[i];
+        R d = (c > upper[i]) ? c - upper[i] : ((c < lower[i]) ? c - lower[i] : R(0));
+        sum += d * d;
+    }
+    return sum;
+}
+
+
+
+template < typename R >
+similarity::details::searcher< R >::searcher(vector< R > series, vector< R > query, metric measure, bool normalize, size_t band)
+    : _series(std::move(series)), _query(std::move(query)), _measure(measure), _normalize(normalize), _band(band) {
+    if (_query.empty() || _query.size() > _series.size()) {
+        throw invalid_argument("similarity::search(): invalid query size");
+    }
+    if (_normalize) {
+        _query = znormalize(_query);
+        _sum.resize(_series.size() + 1, 0.0L);
+        _sum2.resize(_series.size() + 1, 0.0L);
+        for (size_t i = 0; i < _series.size(); i++) {
+            long double v = _series[i];
+            _sum[i + 1] = _sum[i] + v;
+            _sum2[i + 1] = _sum2[i] + v * v;
+        }
+    }
+    size_t m = _query.size();
+    if (_band == default_band) {
+        _band = std::max< size_t >(1, m / 20);
+    }
+    _band = std::min(_band, m);
+    // abandoning order: largest (normalized) query magnitudes first
+    R center = R(0);
+    if (!_normalize) {
+        center = std::accumulate(_query.begin(), _query.end(), R(0)) / static_cast< R >(m);
+    }
+    _order.resize(m);
+    iota(_order.begin(), _order.end(), 0);
+    stable_sort(_order.begin(), _order.end(), [&](size_t a, size_t b) { return abs(_query[a] - center) > abs(_query[b] - center); });
+    if (_measure == metric::dtw) {
+        envelope(_query, _band, _lower, _upper);
+    }
+}
+
+
+
+template < typename R >
+size_t similarity::details::searcher< R >::offsets() const {
+    return _series.size() - _query.size() + 1;
+}
+
+
+
+template < typename R >
+size_t similarity::details::searcher< R >::work_size() const {
+    return 4 * _query.size() + 3;
+}
+
+
+
+template < typename R >
+R similarity::details::searcher< R >::distance(size_t offset, R bound, R* work) const {
+    const R inf = numeric_limits< R >::infinity();
+    size_t m = _query.size();
+    const R* raw = _series.data() + offset;
+    // candidate normalization from prefix sums
+    R mean = R(0);
+    R scale = R(1);
+    if (_normalize) {
+        long double mu = (_sum[offset + m] - _sum[offset]) / m;
+        long double var = (_sum2[offset + m] - _sum2[offset]) / m - mu * mu;
+        long double sd = sqrt(std::max(var, 0.0L));
+        mean = static_cast< R >(mu);
+        scale = (sd > numeric_limits< R >::epsilon() * std::max(1.0L, fabs(mu))) ? static_cast< R >(1.0L / sd) : R(0);
+    }
+    auto value = [&](size_t i) { return (raw[i] - mean) * scale; };
+    if (_measure == metric::euclidean) {
+        R sum = R(0);
+        for (size_t k = 0; k < m; k++) {
+            size_t i = _order[k];
+            R d = _query[i] - value(i);
+            sum += d * d;
+            if (sum > bound) {
+                return inf;
+            }
+        }
+        return sum;
+    }
+    // DTW: LB_Kim, then LB_Keogh (w/ per-position contributions), then DTW w/ cumulative bound
+    R* candidate = work;
+    R* remaining = work + m;
+    R* buffer = work + 2 * m + 1;
+    R kim = R(0);
+    {
+        R first = _query[0] - value(0);
+        R last = _query[m - 1] - value(m - 1);
+        kim = (m == 1) ? first * first : first * first + last * last;
+    }
+    if (kim > bound) {
+        return inf;
+    }
+    R keogh = R(0);
+    for (size_t k = 0; k < m; k++) {
+        size_t i = _order[k];
+        R c = value(i);
+        candidate[i] = c;
+        R d = (c > _upper[i]) ? c - _upper[i] : ((c < _lower[i]) ? c - _lower[i] : R(0));
+        remaining[i] = d * d;
+        keogh += d * d;
+        if (keogh > bound) {
+            return inf;
+        }
+    }
+    // suffix sums, i.e. lower bound of columns j onwards
+    remaining[m] = R(0);
+    for (size_t i = m; i-- > 0;) {
+        remaining[i] += remaining[i + 1];
+    }
+    return dtw< R >(_query.data(), m, candidate, m, _band, remaining, bound, buffer);
+}
+
+
+
+template < typename T, typename Query >
+similarity::match< summation::accumulator_t< T > > similarity::search(matrix_view< const T > data, size_t column, const Query& query, metric measure, bool normalize, size_t band, work_stealing_pool& pool) {
+    typedef summation::accumulator_t< T > value_type;
+    if (column >= data.cols()) {
+        throw invalid_argument("similarity::search(): invalid column");
+    }
+    vector< value_type > series(data.rows());
+    for (size_t i = 0; i < data.rows(); i++) {
+        series[i] = static_cast< value_type >(data(i, column));
+    }
+    vector< value_type > q(query.size());
+    for (size_t i = 0; i < q.size(); i++) {
+        q[i] = static_cast< value_type >(query[i]);
+    }
+    details::searcher< value_type > engine(std::move(series), std::move(q), measure, normalize, band);
+    // shared best-so-far (squared) distance, lowered atomically
+    atomic< value_type > shared(numeric_limits< value_type >::infinity());
+    size_t n = engine.offsets();
+    size_t tasks = (n + similarity::min_offsets - 1) / similarity::min_offsets;
+    vector< parallel::padded< match< value_type > > > best(tasks, parallel::padded< match< value_type > >{ { n, numeric_limits< value_type >::infinity() } });
+    parallel_for(0, tasks, [&](size_t first, size_t last) {
+        vector< value_type > work(engine.work_size());
+        for (size_t t = first; t < last; t++) {
+            match< value_type >& local = best[t].value;
+            size_t o1 = std::min(n, (t + 1) * similarity::min_offsets);
+            for (size_t o = t * similarity::min_offsets; o < o1; o++) {
+                // candidates equal to the best so far are kept (not abandoned), s.t. ties resolve to the lowest offset
+                value_type bound = std::min(shared.load(memory_order_relaxed), local.distance);
+                value_type d = engine.distance(o, bound, work.data());
+                if (d < local.distance) {
+                    local = { o, d };
+                    value_type current = shared.load(memory_order_relaxed);
+                    while (d < current && !shared.compare_exchange_weak(current, d, memory_order_relaxed)) {
+                    }
+                }
+            }
+        }
+    }, 1, pool);
+    match< value_type > out = { n, numeric_limits< value_type >::infinity() };
+    for (const auto& candidate : best) {
+        if (candidate.value.distance < out.distance) {
+            out = candidate.value;
+        }
+    }
+    out.distance = sqrt(out.distance);
+    return out;
+}
+
+
+
+template < typename T, typename Query >
+similarity::match< summation::accumulator_t< T > > similarity::search(const vector< T >& data, const Query& query, metric measure, bool normalize, size_t band) {
+    return search(matrix_view< const T >(data.data(), data.size(), 1), 0, query, measure, normalize, band);
+}
+
+
+
+template < typename T, typename Query >
+vector< summation::accumulator_t< T > > similarity::profile(matrix_view< const T > data, size_t column, const Query& query, metric measure, bool normalize, size_t band, work_stealing_pool& pool) {
+    typedef summation::accumulator_t< T > value_type;
+    if (column >= data.cols()) {
+        throw invalid_argument("similarity::profile(): invalid column");
+    }
+    vector< value_type > series(data.rows());
+    for (size_t i = 0; i < data.rows(); i++) {
+        series[i] = static_cast< value_type >(data(i, column));
+    }
+    vector< value_type > q(query.size());
+    for (size_t i = 0; i < q.size(); i++) {
+        q[i] = static_cast< value_type >(query[i]);
+    }
+    details::searcher< value_type > engine(std::move(series), std::move(q), measure, normalize, band);
+    vector< value_type > out(engine.offsets());
+    parallel_for(0, out.size(), [&](size_t first, size_t last) {
+        vector< value_type > work(engine.work_size());
+        for (size_t o = first; o < last; o++) {
+            out[o] = sqrt(engine.distance(o, numeric_limits< value_type >::infinity(), work.data()));
+        }
+    }, similarity::min_offsets, pool);
+    return out;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_SIMILARITY_HPP_
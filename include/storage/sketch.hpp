@@ -0,0 +1,922 @@
+//------------------------------------------------------------------------------
+/// @file       sketch.hpp
+/// @author     João André
+///
+/// @brief      Streaming, mergeable distribution sketches (fixed-bin histogram, KLL quantile sketch), and exact
+///             (selection-based) quantiles of in-memory data.
+///
+/// Sketches summarize arbitrarily long streams in bounded memory, and partial sketches of disjoint data can be merged
+/// (e.g. across threads, cf. std::sketch::accumulate(), or across recording sessions). Histograms count values onto
+/// fixed, evenly spaced bins (exact counts); KLL sketches answer rank & quantile queries w/ an additive rank error of
+/// about 1.7 / k (w/ high probability), using O(k) memory.
+///
+/// Exact quantiles use std::nth_element (expected linear time) instead of full sorts, w/ successive selections over
+/// shrinking ranges for multiple quantiles, and linear interpolation between order statistics.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_SKETCH_HPP_
+#define STORAGE_INCLUDE_STORAGE_SKETCH_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "storage/type_check.hpp"
+#include "storage/blas.hpp"
+#include "storage/summation.hpp"
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace sketch {
+
+//------------------------------------------------------------------------------
+/// @brief      Number of elements per chunk in parallel accumulation (cf. accumulate()).
+///
+constexpr size_t batch_chunk = 16384;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of interleaved sub-histograms in batch binning (breaks store-to-load dependencies on runs of
+///             values falling onto the same bin).
+///
+constexpr size_t sub_histograms = 4;
+
+//------------------------------------------------------------------------------
+/// @brief      Fixed-bin histogram over [low, high), w/ underflow, overflow & NaN counters.
+///
+/// @tparam     T     Value type.
+///
+template < typename T >
+class histogram {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Value & bin edge type.
+    ///
+    typedef summation::accumulator_t< T > value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  low   Lower edge of first bin.
+    /// @param[in]  high  Upper edge of last bin (> low).
+    /// @param[in]  bins  Number of bins (> 0).
+    ///
+    /// @throws     std::invalid_argument if range or number of bins is invalid.
+    ///
+    histogram(value_type low, value_type high, size_t bins);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Counts a value.
+    ///
+    void push(const T& value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Counts all values of given container.
+    ///
+    template < typename Container, typename = typename enable_if< is_generic_container< Container >() >::type >
+    void push(const Container& container);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Counts values [first, last) of an indexable accessor (batch binning).
+    ///
+    template < typename Accessor >
+    void push(const Accessor& x, size_t first, size_t last);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges counts of another histogram (w/ same bins).
+    ///
+    /// @throws     std::invalid_argument if bins differ.
+    ///
+    void merge(const histogram& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges counts of another histogram (w/ same bins).
+    ///
+    histogram& operator+=(const histogram& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets all counters.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of bins.
+    ///
+    size_t bins() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Count of bin *i*.
+    ///
+    size_t count(size_t i) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Bin counts.
+    ///
+    vector< size_t > counts() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Bin edges (bins() + 1 values).
+    ///
+    vector< value_type > edges() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values below range.
+    ///
+    size_t underflow() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values above (or @) upper range edge.
+    ///
+    size_t overflow() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of NaN values.
+    ///
+    size_t nan() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of (non-NaN) values, including underflow & overflow.
+    ///
+    size_t total() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Approximate quantile, interpolated linearly within bins (clamped to range).
+    ///
+    /// @param[in]  q     Quantile, in [0, 1].
+    ///
+    value_type quantile(double q) const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Counter slot of *value*, i.e. 0 (underflow), 1 + bin, bins() + 1 (overflow) or bins() + 2 (NaN).
+    ///
+    size_t slot(value_type value) const;
+
+    value_type _low;
+    value_type _high;
+    value_type _scale;           ///< bins per unit
+    vector< size_t > _counts;    ///< counter slots (bins + 3)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      KLL quantile sketch (Karnin, Lang & Liberty), i.e. hierarchy of compactors w/ geometrically decreasing
+///             capacities; randomized (seeded, reproducible) compactions.
+///
+/// @tparam     T     Value type.
+///
+template < typename T >
+class kll {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  k     Accuracy parameter, i.e. capacity of top compactor (>= 8). Defaults to 200.
+    /// @param[in]  seed  Random seed (compaction offsets). Defaults to 0.
+    ///
+    explicit kll(size_t k = 200, uint64_t seed = 0);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds a value (NaN values are ignored).
+    ///
+    void push(const T& value);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds all values of given container.
+    ///
+    template < typename Container, typename = typename enable_if< is_generic_container< Container >() >::type >
+    void push(const Container& container);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Adds values [first, last) of an indexable accessor.
+    ///
+    template < typename Accessor >
+    void push(const Accessor& x, size_t first, size_t last);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges another sketch.
+    ///
+    /// @throws     std::invalid_argument if accuracy parameters differ.
+    ///
+    void merge(const kll& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Merges another sketch.
+    ///
+    kll& operator+=(const kll& other);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Resets sketch.
+    ///
+    void clear();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values added.
+    ///
+    size_t count() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of values retained.
+    ///
+    size_t retained() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Smallest value added (exact).
+    ///
+    T min() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Largest value added (exact).
+    ///
+    T max() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Approximate normalized rank of *value*, i.e. fraction of values lower than *value*.
+    ///
+    double rank(const T& value) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Approximate quantile.
+    ///
+    /// @param[in]  q     Quantile, in [0, 1].
+    ///
+    /// @throws     std::invalid_argument if *q* is out of range, std::runtime_error if sketch is empty.
+    ///
+    T quantile(double q) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Approximate quantiles (single pass over retained values).
+    ///
+    vector< T > quantiles(const vector< double >& qs) const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Capacity of compactor @ given level.
+    ///
+    size_t capacity(size_t level) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Compacts levels until total size is within total capacity.
+    ///
+    void compress();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Retained values, sorted, w/ cumulative weights.
+    ///
+    vector< pair< T, uint64_t > > cumulative() const;
+
+    size_t _k;
+    size_t _count = 0;
+    size_t _size = 0;                 ///< number of retained values
+    T _min;
+    T _max;
+    vector< vector< T > > _levels;    ///< compactors (level h values weigh 2^h)
+    uint64_t _state;                  ///< random state (splitmix64)
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Sketch of a container, accumulated in parallel over fixed chunks & merged in chunk order (i.e. result
+///             does not depend on the number of threads).
+///
+/// @param[in]  container  Input container.
+/// @param[in]  prototype  Empty sketch (e.g. histogram w/ bins, kll w/ accuracy parameter).
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+template < typename Sketch, typename Container >
+Sketch accumulate(const Container& container, const Sketch& prototype, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Sketches of each column of a matrix/view (samples x channels), in parallel over columns.
+///
+/// @param[in]  data       Input samples.
+/// @param[in]  prototype  Empty sketch.
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+template < typename Sketch, typename T >
+vector< Sketch > columns(matrix_view< const T > data, const Sketch& prototype, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Exact quantile of range [first, last), w/ linear interpolation between order statistics. Partially
+///             reorders range.
+///
+/// @param[in]  q     Quantile, in [0, 1].
+///
+/// @throws     std::invalid_argument if range is empty or *q* is out of range.
+///
+template < typename RandomIt >
+auto quantile(RandomIt first, RandomIt last, double q);
+
+//------------------------------------------------------------------------------
+/// @brief      Exact quantiles of range [first, last) (cf. quantile()), w/ successive selections over shrinking
+///             ranges. Partially reorders range.
+///
+template < typename RandomIt >
+auto quantiles(RandomIt first, RandomIt last, const vector< double >& qs);
+
+//------------------------------------------------------------------------------
+/// @brief      Exact quantile of a container (copied).
+///
+template < typename Container >
+auto quantile(const Container& data, double q);
+
+//------------------------------------------------------------------------------
+/// @brief      Exact quantiles of a container (copied).
+///
+template < typename Container >
+auto quantiles(const Container& data, const vector< double >& qs);
+
+//------------------------------------------------------------------------------
+/// @brief      Exact median of a container (copied).
+///
+template < typename Container >
+auto median(const Container& data);
+
+//------------------------------------------------------------------------------
+/// @brief      Exact quantiles of each column of a matrix/view (samples x channels), in parallel over columns.
+///
+/// @return     Quantiles (qs.size() x channels).
+///
+template < typename T >
+matrix< summation::accumulator_t< T > > quantiles(matrix_view< const T > data, const vector< double >& qs, work_stealing_pool& pool = work_stealing_pool::instance());
+
+}  // namespace sketch
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename T >
+sketch::histogram< T >::histogram(value_type low, value_type high, size_t bins)
+    : _low(low), _high(high), _counts(bins + 3, 0) {
+    if (!bins || !(high > low) || !isfinite(low) || !isfinite(high)) {
+        throw invalid_argument("sketch::histogram(): invalid range or number of bins");
+    }
+    _scale = static_cast< value_type >(bins) / (high - low);
+}
+
+
+
+template < typename T >
+size_t sketch::histogram< T >::slot(value_type value) const {
+    size_t n = bins();
+    if (value != value) {
+        return n + 2;
+    }
+    // clamped in floating point to [1, n], i.e. conversion is always defined
+    value_type t = (value - _low) * _scale + value_type(1);
+    t = std::min(std::max(t, value_type(1)), static_cast< value_type >(n));
+    size_t s = static_cast< size_t >(t);
+    // under/overflow decided on values (not on t, which may round across either edge)
+    return (value < _low) ? 0 : ((value < _high) ? s : n + 1);
+}
+
+
+
+template < typename T >
+void sketch::histogram< T >::push(const T& value) {
+    _counts[slot(static_cast< value_type >(value))]++;
+}
+
+
+
+template < typename T >
+template < typename Container, typename >
+void sketch::histogram< T >::push(const Container& container) {
+    blas::details::dispatch(container, [&](const auto& x) {
+        push(x, 0, container.size());
+    });
+}
+
+
+
+template < typename T >
+template < typename Accessor >
+void sketch::histogram< T >::push(const Accessor& x, size_t first, size_t last) {
+    constexpr size_t lanes = summation::lanes;
+    constexpr size_t subs = sketch::sub_histograms;
+    size_t slots = _counts.size();
+    vector< size_t > sub(subs * slots, 0);
+    size_t indices[lanes];
+    size_t i = first;
+    for (; i + lanes <= last; i += lanes) {
+        // slot computation is branch-free across lanes, counting is interleaved across sub-histograms
+        for (size_t k = 0; k < lanes; k++) {
+            indices[k] = slot(static_cast< value_type >(x[i + k]));
+        }
+        for (size_t k = 0; k < lanes; k++) {
+            sub[(k % subs) * slots + indices[k]]++;
+        }
+    }
+    for (; i < last; i++) {
+        sub[slot(static_cast< value_type >(x[i]))]++;
+    }
+    for (size_t s = 0; s < subs; s++) {
+        for (size_t j = 0; j < slots; j++) {
+            _counts[j] += sub[s * slots + j];
+        }
+    }
+}
+
+
+
+template < typename T >
+void sketch::histogram< T >::merge(const histogram& other) {
+    if (other._low != _low || other._high != _high || other._counts.size() != _counts.size()) {
+        throw invalid_argument("sketch::histogram::merge(): bin mismatch");
+    }
+    for (size_t j = 0; j < _counts.size(); j++) {
+        _counts[j] += other._counts[j];
+    }
+}
+
+
+
+template < typename T >
+sketch::histogram< T >& sketch::histogram< T >::operator+=(const histogram& other) {
+    merge(other);
+    return *this;
+}
+
+
+
+template < typename T >
+void sketch::histogram< T >::clear() {
+    std::fill(_counts.begin(), _counts.end(), 0);
+}
+
+
+
+template < typename T >
+size_t sketch::histogram< T >::bins() const {
+    return _counts.size() - 3;
+}
+
+
+
+template < typename T >
+size_t sketch::histogram< T >::count(size_t i) const {
+    assert(i < bins());
+    return _counts[i + 1];
+}
+
+
+
+template < typename T >
+vector< size_t > sketch::histogram< T >::counts() const {
+    return vector< size_t >(_counts.begin() + 1, _counts.end() - 2);
+}
+
+
+
+template < typename T >
+vector< typename sketch::histogram< T >::value_type > sketch::histogram< T >::edges() const {
+    vector< value_type > out(bins() + 1);
+    for (size_t i = 0; i <= bins(); i++) {
+        out[i] = _low + (_high - _low) * static_cast< value_type >(i) / static_cast< value_type >(bins());
+    }
+    return out;
+}
+
+
+
+template < typename T >
+size_t sketch::histogram< T >::underflow() const {
+    return _counts.front();
+}
+
+
+
+template < typename T >
+size_t sketch::histogram< T >::overflow() const {
+    return _counts[bins() + 1];
+}
+
+
+
+template < typename T >
+size_t sketch::histogram< T >::nan() const {
+    return _counts.back();
+}
+
+
+
+template < typename T >
+size_t sketch::histogram< T >::total() const {
+    size_t out = 0;
+    for (size_t j = 0; j + 1 < _counts.size(); j++) {
+        out += _counts[j];
+    }
+    return out;
+}
+
+
+
+template < typename T >
+typename sketch::histogram< T >::value_type sketch::histogram< T >::quantile(double q) const {
+    if (!(q >= 0.0 && q <= 1.0)) {
+        throw invalid_argument("sketch::histogram::quantile(): invalid quantile");
+    }
+    size_t n = total();
+    if (!n) {
+        return numeric_limits< value_type >::quiet_NaN();
+    }
+    double target = q * static_cast< double >(n);
+    double cumulative = static_cast< double >(underflow());
+    if (target <= cumulative) {
+        return _low;
+    }
+    value_type width = (_high - _low) / static_cast< value_type >(bins());
+    for (size_t i = 0; i < bins(); i++) {
+        double c = static_cast< double >(count(i));
+        if (c > 0 && target <= cumulative + c) {
+            return _low + width * (static_cast< value_type >(i) + static_cast< value_type >((target - cumulative) / c));
+        }
+        cumulative += c;
+    }
+    return _high;
+}
+
+
+
+template < typename T >
+sketch::kll< T >::kll(size_t k, uint64_t seed)
+    : _k(std::max< size_t >(k, 8)), _min(numeric_limits< T >::max()), _max(numeric_limits< T >::lowest()), _levels(1), _state(seed) {
+    // ...
+}
+
+
+
+template < typename T >
+size_t sketch::kll< T >::capacity(size_t level) const {
+    // k (2/3)^depth, depth being the distance to the top level
+    size_t depth = _levels.size() - 1 - level;
+    double c = static_cast< double >(_k) * pow(2.0 / 3.0, static_cast< double >(depth));
+    return std::max< size_t >(2, static_cast< size_t >(ceil(c)));
+}
+
+
+
+template < typename T >
+void sketch::kll< T >::compress() {
+    for (;;) {
+        size_t total = 0;
+        for (size_t h = 0; h < _levels.size(); h++) {
+            total += capacity(h);
+        }
+        if (_size <= total) {
+            return;
+        }
+        // compact lowest full level: sort, promote every other value (random offset) w/ doubled weight
+        for (size_t h = 0; h < _levels.size(); h++) {
+            if (_levels[h].size() < capacity(h)) {
+                continue;
+            }
+            if (h + 1 == _levels.size()) {
+                _levels.emplace_back();
+            }
+            auto& level = _levels[h];
+            sort(level.begin(), level.end());
+            _state += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = _state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            size_t offset = static_cast< size_t >((z ^ (z >> 31)) & 1);
+            // odd sized levels keep their largest value
+            size_t even = level.size() & ~size_t(1);
+            auto& next = _levels[h + 1];
+            for (size_t i = offset; i < even; i += 2) {
+                next.push_back(level[i]);
+            }
+            _size -= even / 2;
+            level.erase(level.begin(), level.begin() + even);
+            break;
+        }
+    }
+}
+
+
+
+template < typename T >
+void sketch::kll< T >::push(const T& value) {
+    if (value != value) {
+        return;
+    }
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+    _levels[0].push_back(value);
+    _count++;
+    _size++;
+    if (_levels[0].size() >= capacity(0)) {
+        compress();
+    }
+}
+
+
+
+template < typename T >
+template < typename Container, typename >
+void sketch::kll< T >::push(const Container& container) {
+    blas::details::dispatch(container, [&](const auto& x) {
+        push(x, 0, container.size());
+    });
+}
+
+
+
+template < typename T >
+template < typename Accessor >
+void sketch::kll< T >::push(const Accessor& x, size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+        push(static_cast< T >(x[i]));
+    }
+}
+
+
+
+template < typename T >
+void sketch::kll< T >::merge(const kll& other) {
+    if (other._k != _k) {
+        throw invalid_argument("sketch::kll::merge(): accuracy mismatch");
+    }
+    if (!other._count) {
+        return;
+    }
+    if (_levels.size() < other._levels.size()) {
+        _levels.resize(other._levels.size());
+    }
+    for (size_t h = 0; h < other._levels.size(); h++) {
+        _levels[h].insert(_levels[h].end(), other._levels[h].begin(), other._levels[h].end());
+    }
+    _count += other._count;
+    _size += other._size;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    compress();
+}
+
+
+
+template < typename T >
+sketch::kll< T >& sketch::kll< T >::operator+=(const kll& other) {
+    merge(other);
+    return *this;
+}
+
+
+
+template < typename T >
+void sketch::kll< T >::clear() {
+    _levels.assign(1, vector< T >());
+    _count = 0;
+    _size = 0;
+    _min = numeric_limits< T >::max();
+    _max = numeric_limits< T >::lowest();
+}
+
+
+
+template < typename T >
+size_t sketch::kll< T >::count() const {
+    return _count;
+}
+
+
+
+template < typename T >
+size_t sketch::kll< T >::retained() const {
+    return _size;
+}
+
+
+
+template < typename T >
+T sketch::kll< T >::min() const {
+    return _min;
+}
+
+
+
+template < typename T >
+T sketch::kll< T >::max() const {
+    return _max;
+}
+
+
+
+template < typename T >
+vector< pair< T, uint64_t > > sketch::kll< T >::cumulative() const {
+    vector< pair< T, uint64_t > > out;
+    out.reserve(_size);
+    for (size_t h = 0; h < _levels.size(); h++) {
+        for (const T& value : _levels[h]) {
+            out.emplace_back(value, uint64_t(1) << h);
+        }
+    }
+    sort(out.begin(), out.end(), [](const pair< T, uint64_t >& a, const pair< T, uint64_t >& b) { return a.first < b.first; });
+    uint64_t sum = 0;
+    for (auto& entry : out) {
+        sum += entry.second;
+        entry.second = sum;
+    }
+    return out;
+}
+
+
+
+template < typename T >
+double sketch::kll< T >::rank(const T& value) const {
+    if (!_count) {
+        return numeric_limits< double >::quiet_NaN();
+    }
+    uint64_t below = 0;
+    uint64_t total = 0;
+    for (size_t h = 0; h < _levels.size(); h++) {
+        for (const T& v : _levels[h]) {
+            below += (v < value) ? (uint64_t(1) << h) : 0;
+            total += uint64_t(1) << h;
+        }
+    }
+    return static_cast< double >(below) / static_cast< double >(total);
+}
+
+
+
+template < typename T >
+T sketch::kll< T >::quantile(double q) const {
+    return quantiles({ q }).front();
+}
+
+
+
+template < typename T >
+vector< T > sketch::kll< T >::quantiles(const vector< double >& qs) const {
+    if (!_count) {
+        throw runtime_error("sketch::kll::quantiles(): empty sketch");
+    }
+    auto table = cumulative();
+    double total = static_cast< double >(table.back().second);
+    vector< T > out;
+    out.reserve(qs.size());
+    for (double q : qs) {
+        if (!(q >= 0.0 && q <= 1.0)) {
+            throw invalid_argument("sketch::kll::quantiles(): invalid quantile");
+        }
+        if (q == 0.0) {
+            out.push_back(_min);
+        } else if (q == 1.0) {
+            out.push_back(_max);
+        } else {
+            // first retained value whose cumulative weight reaches q * total
+            uint64_t target = static_cast< uint64_t >(ceil(q * total));
+            auto it = lower_bound(table.begin(), table.end(), target, [](const pair< T, uint64_t >& entry, uint64_t t) { return entry.second < t; });
+            out.push_back(it == table.end() ? _max : it->first);
+        }
+    }
+    return out;
+}
+
+
+
+template < typename Sketch, typename Container >
+Sketch sketch::accumulate(const Container& container, const Sketch& prototype, work_stealing_pool& pool) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    size_t n = container.size();
+    size_t n_chunks = (n + sketch::batch_chunk - 1) / sketch::batch_chunk;
+    vector< parallel::padded< Sketch > > partials(n_chunks, parallel::padded< Sketch >{ prototype });
+    blas::details::dispatch(container, [&](const auto& x) {
+        parallel_for(0, n_chunks, [&](size_t first, size_t last) {
+            for (size_t chunk = first; chunk < last; chunk++) {
+                size_t begin = chunk * sketch::batch_chunk;
+                partials[chunk].value.push(x, begin, std::min(n, begin + sketch::batch_chunk));
+            }
+        }, 1, pool);
+    });
+    // merge in chunk order, i.e. result is independent of the number of threads
+    Sketch out = prototype;
+    for (const auto& partial : partials) {
+        out.merge(partial.value);
+    }
+    return out;
+}
+
+
+
+template < typename Sketch, typename T >
+vector< Sketch > sketch::columns(matrix_view< const T > data, const Sketch& prototype, work_stealing_pool& pool) {
+    size_t rows = data.rows();
+    size_t cols = data.cols();
+    vector< Sketch > out(cols, prototype);
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        // row-contiguous reads, columns of a task pushed through a strided accessor
+        for (size_t j = first; j < last; j++) {
+            out[j].push(blas::details::strided< const T >{ data.data() + j, static_cast< ptrdiff_t >(cols) }, 0, rows);
+        }
+    }, 1, pool);
+    return out;
+}
+
+
+
+template < typename RandomIt >
+auto sketch::quantile(RandomIt first, RandomIt last, double q) {
+    return quantiles(first, last, { q }).front();
+}
+
+
+
+template < typename RandomIt >
+auto sketch::quantiles(RandomIt first, RandomIt last, const vector< double >& qs) {
+    typedef summation::accumulator_t< typename iterator_traits< RandomIt >::value_type > value_type;
+    size_t n = static_cast< size_t >(std::distance(first, last));
+    if (!n) {
+        throw invalid_argument("sketch::quantiles(): empty range");
+    }
+    // requested order statistics, in increasing order
+    vector< size_t > order(qs.size());
+    for (size_t i = 0; i < qs.size(); i++) {
+        if (!(qs[i] >= 0.0 && qs[i] <= 1.0)) {
+            throw invalid_argument("sketch::quantiles(): invalid quantile");
+        }
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&qs](size_t a, size_t b) { return qs[a] < qs[b]; });
+    vector< value_type > out(qs.size());
+    size_t selected = 0;   // [first, first + selected) is partitioned up to previously selected statistic
+    for (size_t i : order) {
+        double h = qs[i] * static_cast< double >(n - 1);
+        size_t lo = static_cast< size_t >(floor(h));
+        double fraction = h - static_cast< double >(lo);
+        if (lo >= selected) {
+            std::nth_element(first + selected, first + lo, last);
+            selected = lo + 1;
+        }
+        value_type a = static_cast< value_type >(*(first + lo));
+        value_type b = a;
+        if (fraction > 0.0 && lo + 1 < n) {
+            // next order statistic: minimum of upper partition
+            b = static_cast< value_type >(*std::min_element(first + lo + 1, last));
+        }
+        out[i] = a + static_cast< value_type >(fraction) * (b - a);
+    }
+    return out;
+}
+
+
+
+template < typename Container >
+auto sketch::quantile(const Container& data, double q) {
+    return quantiles(data, { q }).front();
+}
+
+
+
+template < typename Container >
+auto sketch::quantiles(const Container& data, const vector< double >& qs) {
+    vector< typename decay< decltype(data[0]) >::type > copy(std::begin(data), std::end(data));
+    return quantiles(copy.begin(), copy.end(), qs);
+}
+
+
+
+template < typename Container >
+auto sketch::median(const Container& data) {
+    return quantile(data, 0.5);
+}
+
+
+
+template < typename T >
+matrix< summation::accumulator_t< T > > sketch::quantiles(matrix_view< const T > data, const vector< double >& qs, work_stealing_pool& pool) {
+    size_t rows = data.rows();
+    size_t cols = data.cols();
+    matrix< summation::accumulator_t< T > > out(qs.size(), cols);
+    parallel_for(0, cols, [&](size_t first, size_t last) {
+        vector< T > column(rows);
+        for (size_t j = first; j < last; j++) {
+            for (size_t i = 0; i < rows; i++) {
+                column[i] = data.data()[i * cols + j];
+            }
+            auto values = quantiles(column.begin(), column.end(), qs);
+            for (size_t k = 0; k < qs.size(); k++) {
+                out(k, j) = values[k];
+            }
+        }
+    }, 1, pool);
+    return out;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_SKETCH_HPP_
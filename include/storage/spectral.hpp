@@ -0,0 +1,426 @@
+//------------------------------------------------------------------------------
+/// @file       spectral.hpp
+/// @author     João André
+///
+/// @brief      Spectral analysis over FFT plans (cf. storage/fft.hpp): Welch power spectral density & band powers,
+///             short-time Fourier transform over std::range_iterator windows, and fast convolution/correlation.
+///
+/// Multichannel inputs are row-major (samples x channels) matrices/views, and outputs keep one column per channel.
+/// Welch estimates are accumulated over fixed groups of segments in parallel, and merged in segment order, thus
+/// results do not depend on the number of threads.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_SPECTRAL_HPP_
+#define STORAGE_INCLUDE_STORAGE_SPECTRAL_HPP_
+
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+#include "storage/range_iterator.hpp"
+#include "storage/fft.hpp"
+
+namespace std {
+namespace spectral {
+
+//------------------------------------------------------------------------------
+/// @brief      Window (taper) functions.
+///
+enum class taper {
+    rectangular,
+    hann,
+    hamming,
+    blackman
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Pi (M_PI is not provided by standard C++).
+///
+constexpr double pi = 3.14159265358979323846;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of Welch segments accumulated per parallel task.
+///
+constexpr size_t segments_per_task = 8;
+
+//------------------------------------------------------------------------------
+/// @brief      Shortest operand length from which convolution/correlation use FFTs (direct evaluation otherwise).
+///
+constexpr size_t fft_length = 64;
+
+//------------------------------------------------------------------------------
+/// @brief      One-sided power spectral density estimate.
+///
+/// @tparam     R     Real (floating point) type.
+///
+template < typename R >
+struct spectrum {
+    vector< R > frequencies;   ///< bin frequencies (same units as sampling rate)
+    matrix< R > power;         ///< power spectral density (bins x channels), in units^2 / frequency unit
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Window (taper) coefficients, periodic (i.e. DFT-even) form as used in spectral estimation.
+///
+/// @param[in]  n     Window size.
+/// @param[in]  type  Window function.
+///
+template < typename R >
+vector< R > window(size_t n, taper type);
+
+//------------------------------------------------------------------------------
+/// @brief      Welch's power spectral density estimate, i.e. average of modified periodograms of overlapping,
+///             mean-detrended & tapered segments.
+///
+/// @param[in]  data     Input samples (samples x channels).
+/// @param[in]  rate     Sampling rate.
+/// @param[in]  segment  Segment size (samples), s.t. segment <= data.rows().
+/// @param[in]  overlap  Overlap between consecutive segments (samples), s.t. overlap < segment. Defaults to segment / 2.
+/// @param[in]  type     Window function. Defaults to Hann.
+/// @param      pool     Thread pool. Defaults to shared pool instance.
+///
+/// @throws     std::invalid_argument if *segment* is 0 or larger than input, or if *overlap* is not lower than *segment*.
+///
+template < typename R >
+spectrum< R > welch(matrix_view< const R > data, R rate, size_t segment, size_t overlap = size_t(-1), taper type = taper::hann, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Welch's power spectral density estimate of all columns of *data* (cf. welch()).
+///
+template < typename R >
+spectrum< R > welch(const matrix< R >& data, R rate, size_t segment, size_t overlap = size_t(-1), taper type = taper::hann);
+
+//------------------------------------------------------------------------------
+/// @brief      Welch's power spectral density estimate of a single channel (cf. welch()).
+///
+template < typename R >
+spectrum< R > welch(const vector< R >& data, R rate, size_t segment, size_t overlap = size_t(-1), taper type = taper::hann);
+
+//------------------------------------------------------------------------------
+/// @brief      Band power, i.e. integral of power spectral density over [low, high].
+///
+/// @param[in]  psd   Power spectral density estimate.
+/// @param[in]  low   Lower band limit.
+/// @param[in]  high  Upper band limit.
+///
+/// @return     Band power of each channel.
+///
+template < typename R >
+vector< R > band_power(const spectrum< R >& psd, R low, R high);
+
+//------------------------------------------------------------------------------
+/// @brief      Short-time Fourier transform over consecutive (full) windows of a range iterator.
+///
+/// @param[in]  frames     Range iterator @ first frame; frame size & hop are given by its width & overlap.
+/// @param[in]  type       Window function. Defaults to Hann.
+/// @param[in]  nfft       Transform size (zero padded). Defaults to frame size.
+/// @param      pool       Thread pool. Defaults to shared pool instance.
+///
+/// @return     One-sided complex spectra (frames x nfft / 2 + 1).
+///
+/// @tparam     R          Real (floating point) type.
+///
+template < typename R, typename Container, typename T >
+matrix< complex< R > > stft(range_iterator< Container, T > frames, taper type = taper::hann, size_t nfft = 0, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Full linear convolution, i.e. c[n] = sum(a[k] * b[n - k]), of size a.size() + b.size() - 1.
+///
+template < typename R >
+vector< R > convolve(const vector< R >& a, const vector< R >& b);
+
+//------------------------------------------------------------------------------
+/// @brief      Full cross-correlation, i.e. c[n] = sum(a[k + n - b.size() + 1] * b[k]), of size a.size() + b.size() - 1
+///             (lags from -(b.size() - 1) to a.size() - 1).
+///
+template < typename R >
+vector< R > correlate(const vector< R >& a, const vector< R >& b);
+
+//------------------------------------------------------------------------------
+/// @brief      Full linear convolution of all columns of *data* w/ *kernel*.
+///
+/// @return     Convolved samples (data.rows() + kernel.size() - 1 x channels).
+///
+template < typename R >
+matrix< R > convolve(matrix_view< const R > data, const vector< R >& kernel, work_stealing_pool& pool = work_stealing_pool::instance());
+
+}  // namespace spectral
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename R >
+vector< R > spectral::window(size_t n, taper type) {
+    static_assert(is_floating_point< R >::value, "INVALID REAL TYPE!");
+    vector< R > out(n, R(1));
+    const double step = 2.0 * pi / static_cast< double >(max< size_t >(n, 1));
+    for (size_t i = 0; i < n; i++) {
+        double x = step * static_cast< double >(i);
+        switch (type) {
+            case taper::rectangular: break;
+            case taper::hann: out[i] = static_cast< R >(0.5 - 0.5 * cos(x)); break;
+            case taper::hamming: out[i] = static_cast< R >(0.54 - 0.46 * cos(x)); break;
+            case taper::blackman: out[i] = static_cast< R >(0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x)); break;
+        }
+    }
+    return out;
+}
+
+
+
+template < typename R >
+spectral::spectrum< R > spectral::welch(matrix_view< const R > data, R rate, size_t segment, size_t overlap, taper type, work_stealing_pool& pool) {
+    static_assert(is_floating_point< R >::value, "INVALID REAL TYPE!");
+    if (overlap == size_t(-1)) {
+        overlap = segment / 2;
+    }
+    if (!segment || segment > data.rows() || overlap >= segment) {
+        throw invalid_argument("spectral::welch(): invalid segment size or overlap");
+    }
+    size_t cols = data.cols();
+    size_t step = segment - overlap;
+    size_t segments = (data.rows() - segment) / step + 1;
+    const auto& plan = fft::real_plan< R >::get(segment);
+    size_t bins = plan.bins();
+    vector< R > taps = window< R >(segment, type);
+    // per-task partial sums, merged in order (i.e. independent of scheduling)
+    size_t tasks = (segments + spectral::segments_per_task - 1) / spectral::segments_per_task;
+    vector< matrix< R > > partial(tasks);
+    parallel_for(0, tasks, [&](size_t first, size_t last) {
+        vector< R > samples(segment);
+        vector< complex< R > > bins_buffer(bins);
+        for (size_t t = first; t < last; t++) {
+            matrix< R > sum(bins, cols);
+            size_t s1 = min(segments, (t + 1) * spectral::segments_per_task);
+            for (size_t s = t * spectral::segments_per_task; s < s1; s++) {
+                const R* start = data.data() + s * step * cols;
+                for (size_t j = 0; j < cols; j++) {
+                    R mean = R(0);
+                    for (size_t i = 0; i < segment; i++) {
+                        samples[i] = start[i * cols + j];
+                        mean += samples[i];
+                    }
+                    mean /= static_cast< R >(segment);
+                    for (size_t i = 0; i < segment; i++) {
+                        samples[i] = (samples[i] - mean) * taps[i];
+                    }
+                    plan.forward(samples.data(), bins_buffer.data());
+                    for (size_t k = 0; k < bins; k++) {
+                        sum(k, j) += norm(bins_buffer[k]);
+                    }
+                }
+            }
+            partial[t] = std::move(sum);
+        }
+    }, 1, pool);
+    spectrum< R > out;
+    out.power = matrix< R >(bins, cols);
+    for (const auto& sum : partial) {
+        for (size_t i = 0; i < bins * cols; i++) {
+            out.power.data()[i] += sum.data()[i];
+        }
+    }
+    // density scaling, averaged over segments; one-sided i.e. all bins but DC (& Nyquist, if even) are doubled
+    R energy = R(0);
+    for (R w : taps) {
+        energy += w * w;
+    }
+    R scale = R(1) / (rate * energy * static_cast< R >(segments));
+    size_t last_doubled = (segment % 2) ? bins : bins - 1;
+    for (size_t k = 0; k < bins; k++) {
+        R factor = (k > 0 && k < last_doubled) ? 2 * scale : scale;
+        for (size_t j = 0; j < cols; j++) {
+            out.power(k, j) *= factor;
+        }
+    }
+    out.frequencies.resize(bins);
+    for (size_t k = 0; k < bins; k++) {
+        out.frequencies[k] = static_cast< R >(k) * rate / static_cast< R >(segment);
+    }
+    return out;
+}
+
+
+
+template < typename R >
+spectral::spectrum< R > spectral::welch(const matrix< R >& data, R rate, size_t segment, size_t overlap, taper type) {
+    return welch(matrix_view< const R >(data.data(), data.rows(), data.cols()), rate, segment, overlap, type);
+}
+
+
+
+template < typename R >
+spectral::spectrum< R > spectral::welch(const vector< R >& data, R rate, size_t segment, size_t overlap, taper type) {
+    return welch(matrix_view< const R >(data.data(), data.size(), 1), rate, segment, overlap, type);
+}
+
+
+
+template < typename R >
+vector< R > spectral::band_power(const spectrum< R >& psd, R low, R high) {
+    size_t cols = psd.power.cols();
+    vector< R > out(cols, R(0));
+    if (psd.frequencies.size() < 2) {
+        return out;
+    }
+    R resolution = psd.frequencies[1] - psd.frequencies[0];
+    for (size_t k = 0; k < psd.frequencies.size(); k++) {
+        if (psd.frequencies[k] >= low && psd.frequencies[k] <= high) {
+            for (size_t j = 0; j < cols; j++) {
+                out[j] += psd.power(k, j);
+            }
+        }
+    }
+    for (auto& value : out) {
+        value *= resolution;
+    }
+    return out;
+}
+
+
+
+template < typename R, typename Container, typename T >
+matrix< complex< R > > spectral::stft(range_iterator< Container, T > frames, taper type, size_t nfft, work_stealing_pool& pool) {
+    static_assert(is_floating_point< R >::value, "INVALID REAL TYPE!");
+    size_t width = frames.size();
+    if (!width) {
+        throw invalid_argument("spectral::stft(): empty frame");
+    }
+    nfft = max(nfft, width);
+    // gather full frames (sequential, range iterators are not thread-safe)
+    vector< R > samples;
+    size_t count = 0;
+    for (auto it = frames; it.size() == width; ++it) {
+        for (auto value = it.begin(); value != it.end(); ++value) {
+            samples.push_back(static_cast< R >(*value));
+        }
+        count++;
+        if (it.last()) {
+            break;
+        }
+    }
+    const auto& plan = fft::real_plan< R >::get(nfft);
+    vector< R > taps = window< R >(width, type);
+    matrix< complex< R > > out(count, plan.bins());
+    parallel_for(0, count, [&](size_t first, size_t last) {
+        vector< R > frame(nfft, R(0));
+        for (size_t f = first; f < last; f++) {
+            const R* source = samples.data() + f * width;
+            for (size_t i = 0; i < width; i++) {
+                frame[i] = source[i] * taps[i];
+            }
+            plan.forward(frame.data(), out.data() + f * plan.bins());
+        }
+    }, 1, pool);
+    return out;
+}
+
+
+
+template < typename R >
+vector< R > spectral::convolve(const vector< R >& a, const vector< R >& b) {
+    static_assert(is_floating_point< R >::value, "INVALID REAL TYPE!");
+    if (a.empty() || b.empty()) {
+        return vector< R >();
+    }
+    size_t n = a.size() + b.size() - 1;
+    vector< R > out(n, R(0));
+    if (min(a.size(), b.size()) < spectral::fft_length) {
+        for (size_t i = 0; i < a.size(); i++) {
+            R value = a[i];
+            R* target = out.data() + i;
+            for (size_t k = 0; k < b.size(); k++) {
+                target[k] += value * b[k];
+            }
+        }
+        return out;
+    }
+    size_t size = fft::next_fast_size(n);
+    const auto& plan = fft::real_plan< R >::get(size);
+    vector< R > padded(size, R(0));
+    vector< complex< R > > fa(plan.bins()), fb(plan.bins());
+    std::copy(a.begin(), a.end(), padded.begin());
+    plan.forward(padded.data(), fa.data());
+    std::fill(padded.begin(), padded.end(), R(0));
+    std::copy(b.begin(), b.end(), padded.begin());
+    plan.forward(padded.data(), fb.data());
+    for (size_t k = 0; k < fa.size(); k++) {
+        fa[k] = fft::details::multiply(fa[k], fb[k]);
+    }
+    plan.inverse(fa.data(), padded.data());
+    std::copy(padded.begin(), padded.begin() + n, out.begin());
+    return out;
+}
+
+
+
+template < typename R >
+vector< R > spectral::correlate(const vector< R >& a, const vector< R >& b) {
+    return convolve(a, vector< R >(b.rbegin(), b.rend()));
+}
+
+
+
+template < typename R >
+matrix< R > spectral::convolve(matrix_view< const R > data, const vector< R >& kernel, work_stealing_pool& pool) {
+    static_assert(is_floating_point< R >::value, "INVALID REAL TYPE!");
+    size_t rows = data.rows();
+    size_t cols = data.cols();
+    if (!rows || kernel.empty()) {
+        return matrix< R >(0, cols);
+    }
+    size_t n = rows + kernel.size() - 1;
+    matrix< R > out(n, cols);
+    if (min(rows, kernel.size()) < spectral::fft_length) {
+        // direct, vectorized across channels
+        parallel_for(0, n, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                R* target = out.data() + i * cols;
+                size_t k0 = (i >= rows) ? i - rows + 1 : 0;
+                size_t k1 = min(i + 1, kernel.size());
+                for (size_t k = k0; k < k1; k++) {
+                    R b = kernel[k];
+                    const R* source = data.data() + (i - k) * cols;
+                    for (size_t j = 0; j < cols; j++) {
+                        target[j] += b * source[j];
+                    }
+                }
+            }
+        }, 256, pool);
+        return out;
+    }
+    size_t size = fft::next_fast_size(n);
+    // kernel spectrum, then batched transform of zero padded columns
+    vector< R > padded(size, R(0));
+    std::copy(kernel.begin(), kernel.end(), padded.begin());
+    vector< complex< R > > response = fft::rfft(padded);
+    matrix< R > extended(size, cols);
+    std::copy(data.data(), data.data() + rows * cols, extended.data());
+    matrix< complex< R > > spectra = fft::rfft(matrix_view< const R >(extended.data(), size, cols), pool);
+    for (size_t k = 0; k < spectra.rows(); k++) {
+        complex< R >* row = spectra.data() + k * cols;
+        for (size_t j = 0; j < cols; j++) {
+            row[j] = fft::details::multiply(row[j], response[k]);
+        }
+    }
+    matrix< R > result = fft::irfft(matrix_view< const complex< R > >(spectra.data(), spectra.rows(), cols), size, pool);
+    std::copy(result.data(), result.data() + n * cols, out.data());
+    return out;
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_SPECTRAL_HPP_
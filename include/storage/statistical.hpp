@@ -1,9 +1,19 @@
 #ifndef NUMERICAL_HPP
 #define NUMERICAL_HPP
 
+#include <cmath>
 #include <vector>
-#include <matrix>
-#include <volume>
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+#include <storage/matrix.hpp>
+#include <storage/volume.hpp>
+#include <storage/blas.hpp>
+#include <storage/summation.hpp>
+#include <storage/moments.hpp>
+#include <storage/peaks.hpp>
+#include <storage/resample.hpp>
+#include <storage/similarity.hpp>
 #include <numeric>
 #include <stdio.h>      /* printf, scanf, puts, NULL */
 #include <stdlib.h>     /* srand, rand */
@@ -39,185 +49,66 @@ inline double round(double val, int dig) {
     return (rnd/mult);
 }
 /////////////////////////////////////////////////////////////////////////////
-int findPeaks(std::vector<float>& _output, std::vector<float>& _input, int _height, int _width){
-	int n=_input.size();
-	if (n<=0 || _height<1 || _width<1) return 1;
-
-	bool peak=false;
-	int c=0;
-	int imax=0;
-	float max=_height;
-
-	_output.resize(0);
-	//VectorXf inds;
-	std::vector<float> _maxs(0,0.0);
-	// VectorXf _maxs=VectorXf::Zero(0);
-
-	for (int i = 0; i < n; ++i){
-		if (_input[i]>=_height) {
-			// POTENTIAL PEAK
-			c++;
-			if (_input[i]>=max){
-				// at the start of any peak it!!
-				//printf("new max! i %d \n",i);
-				max=_input[i];
-				imax=i;
-				if (peak) {
-					// place values on container (only if inside a peak and a new maximum is found)
-					_output[_output.size()-1]=imax+0.0;
-					_maxs[_output.size()-1]=max;
-					//printf("peak value updated i %d\n",i);
-				}
-			}
-			if (c>=_width){
-				// IS A PEAK
-				if (!peak) {
-					printf("new peak! i %d! last imax %d\n",i,imax);
-					peak=true;
-					// increase container size
-					//printf("enlarging array %d to %d\n",_output.rows(),_output.rows()+1);
-					_output.resize(_output.size()+1);
-					_maxs.resize(_output.size()+1);
-					//printf("placing value %d at pos %d\n",imax,_output.rows()-1);
-					_output[_output.size()-1]=imax;
-					_maxs[_output.size()-1]=max;
-				}				
-			} 
-		} else {
-			// NOT A PEAK
-			//printf("no peak! i%d\n",i);
-			c=0;
-			peak=false;
-			max=_height;
+// peak indexes (maximum of regions at or above _height, at least _width samples wide), cf. storage/peaks.hpp
+inline int findPeaks(std::vector<float>& _output, const std::vector<float>& _input, int _height, int _width){
+	if (_input.empty() || _height<1 || _width<1) return 1;
+
+	auto found = std::peaks::find(_input, std::peaks::detector<float>(_height, _width));
+	_output.resize(found.size());
+	for (size_t i = 0; i < found.size(); ++i) {
+		// detector reports the first of tied maxima, legacy behaviour is the last one (within the same region)
+		size_t k = found[i].index;
+		for (size_t j = k + 1; j < _input.size() && _input[j] >= _height; ++j) {
+			if (_input[j] >= _input[k]) k = j;
 		}
-
-	// at the end of the loop maxs and inds are populated by the maximum vaues in each peak and index
+		_output[i] = k;
 	}
 
-	// avg_cycle=0.0;
-	// for (int i = 1; i < _output.rows(); ++i) avg_cycle+=(_output(i)-_output(i-1));
-	// avg_cycle=avg_cycle/_output.rows();
-
 	return 0;
 }
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-float vectorDistance (std::vector<float> _ref, std::vector<float> _sol) {
-	// if (_ref.size() < _sol.size()) _ref.resize(_sol.size());
-	// else if (_sol.size() < _ref.size()) _sol.resize(_ref.size());
-	if (_ref.size() != _sol.size()) return std::numeric_limits<float>::max();
+// lock-step euclidean distance, cf. storage/similarity.hpp (DTW, subsequence search); throws on size mismatch
+inline float vectorDistance (const std::vector<float>& _ref, const std::vector<float>& _sol) {
+	if (_ref.size() != _sol.size()) throw std::invalid_argument("statistical::vectorDistance(): size mismatch");
 
-	float distance=0.0;
-	for (int instant = 0; instant < _ref.size(); ++instant)	{
-		distance+=sqrt(pow(_ref[instant]-_sol[instant],2)); 
-	}
-	return distance;
+	return static_cast<float>(std::similarity::euclidean(_ref, _sol));
 };
 /////////////////////////////////////////////////////////////////////////////
-float vectorAverage(float& _avg, std::vector<float>& _input){
-	float sum=0.0;
-	float size=(float)(_input.size());
-	for (int i=0; i< _input.size(); i++) sum+=_input[i];
-	return (sum/size);
+// averages use pairwise summation (cf. storage/summation.hpp)
+inline float vectorAverage(float& _avg, const std::vector<float>& _input){
+	_avg = std::summation::mean(_input);
+	return _avg;
 }
 /////////////////////////////////////////////////////////////////////////////
 template <typename _type>
-_type average(std::vector<_type>& _input){
-	_type avg;
-	_type ss = (_type)_input.size();
-	for (auto& val : _input) avg += val;
-	return (avg/ss);
+_type average(const std::vector<_type>& _input){
+	return static_cast<_type>(std::summation::mean(_input));
 }
 template <typename _type>
-_type average(std::matrix<_type>& _input){
-	return average(_input.vector());
+_type average(const std::matrix<_type>& _input){
+	return static_cast<_type>(std::summation::mean(_input));
 }
 template <typename _type>
-_type average(std::volume<_type>& _input){
-	return average(_input.vector());
+_type average(const std::volume<_type>& _input){
+	return static_cast<_type>(std::summation::mean(_input));
 }
 /////////////////////////////////////////////////////////////////////////////
-float vectorStdDeviation(float& _std, std::vector<float>& _input){
-	float avg = 0.0;
-	vectorAverage(avg,_input);
-	float w=(float)(1.0/_input.size());
-	for (auto& val : _input) avg += w*val;
-	return avg;
+// single-pass (population) standard deviation (cf. storage/moments.hpp)
+inline float vectorStdDeviation(float& _std, const std::vector<float>& _input){
+	_std = std::stats::accumulate(_input).stddev();
+	return _std;
 }
 /////////////////////////////////////////////////////////////////////////////
-int reSample(std::vector<float>& _input, std::vector<float>& _output, int _size){
-	// printf("resampling %d to %d\n", _input.size(), _size);
+// linear resampling to _size samples (first/last samples aligned), cf. storage/resample.hpp
+inline int reSample(const std::vector<float>& _input, std::vector<float>& _output, int _size){
 	int _prev_size=_input.size();
 	if (_size>1 && _prev_size>0 && _prev_size!=_size) {
-		
-		std::vector<float> ids (_size,0.0);
-		float step=(_prev_size-1.0)/_size;
-		for (int i = 0; i < ids.size(); ++i) ids[i]=i*step;
-
-		//_output.resize(_size);//,0.0);
-		_output.assign(_size,0.0);
-
-		_output[0]=_input[0];
-		_output[_size-1]=_input[_prev_size-1];
-
-		int li=0;
-		int ui=0;
-		float sl=0.0;
-
-		for (int i = 0; i < _size; ++i){
-			li=(int)(ids[i]);
-			ui=(int)(ids[i]+1.0);
-
-			if (ui==_prev_size) {
-				ui--;
-				li--;
-			}			
-			sl=(_input[ui]-_input[li])/(ui-li);
-			_output[i]=_input[li]+sl*(ids[i]-((int)(ids[i])));
-			if (i==0) printf("li %d(%f) ui %d(%f)\n",li,_input[li],ui,_input[ui]);
-
-		}
+		_output = std::resampling::plan<float>(_prev_size, _size).apply(_input);
 	} else return 1;
 	return 0;
 }	
 /////////////////////////////////////////////////////////////////////////////
-int reSample(VectorXf& _input, VectorXf& _output, int _size){
-	//printf("resampling %d to %d\n", _input.rows(), _size);
-	int _prev_size=_input.rows();
-	if (_size>1 && _prev_size>0 && _prev_size!=_size) {
-		
-		VectorXf ids=Eigen::VectorXf::LinSpaced(_size,0,_prev_size-1);
-
-		_output=VectorXf::Zero(_size);
-
-		_output(0)=_input(0);
-		_output(_size-1)=_input(_prev_size-1);
-
-		int li=0;
-		int ui=0;
-		float sl=0.0;
-
-		//std::cout << ids << std::endl;
-		//printf("sadsdadsadsada----çsad\n");
-		for (int i = 0; i < _size; ++i){
-			li=(int)(ids(i));
-			ui=(int)(ids(i)+1.0);
-
-			if (ui==_prev_size) {
-				ui--;
-				li--;
-			}
-
-			///printf("%d -- %d\n",li,ui);
-
-			sl=(_input(ui)-_input(li))/(ui-li);
-			_output(i)=_input(li)+sl*(ids(i)-((int)(ids(i))));
-		}
-	} else return 1;
-
-	return 0;
-}
-/////////////////////////////////////////////////////////////////////////////
-int reSample2(std::vector<float>& _inputRef, std::vector<float>& _inputVal, std::vector<float>& _outputRef, std::vector<float>& _outputVal, bool _periodic){
+inline int reSample2(std::vector<float>& _inputRef, std::vector<float>& _inputVal, std::vector<float>& _outputRef, std::vector<float>& _outputVal, bool _periodic){
 	// printf("resampling %d to %d\n", _input.size(), _size);
 	// assumes _inputRef and _outputRef are sorted!!!!
 	//bool _periodic=true;
@@ -265,13 +156,14 @@ int reSample2(std::vector<float>& _inputRef, std::vector<float>& _inputVal, std:
 	return 0;
 }	
 /////////////////////////////////////////////////////////////////////////////
-VectorXf kfolds(int _samples, int _nfolds){
-	VectorXf labels=VectorXf::Zero(_samples);
-	for (int i = 0; i < _samples; ++i) labels(i)=rand() % _nfolds;
+// random fold labels in [0, _nfolds)
+inline std::vector<int> kfolds(int _samples, int _nfolds){
+	std::vector<int> labels(_samples, 0);
+	for (int i = 0; i < _samples; ++i) labels[i]=rand() % _nfolds;
 	return labels;
 }	
 /////////////////////////////////////////////////////////////////////////////
-int rocTest(int _metric, VectorXf _input){
+inline int rocTest(int _metric, const std::vector<float>& _input){
 	/// ...
 	return 0;
 }
@@ -279,15 +171,19 @@ int rocTest(int _metric, VectorXf _input){
 //int pca();
 
 /////////////////////////////////////////////////////////////////////////////
-float weighted2DMean(const MatrixXf& _input, const VectorXf& _weights){
+// weighted sum of row means (_weights: one per row)
+inline float weighted2DMean(const std::matrix<float>& _input, const std::vector<float>& _weights){
+	assert(_weights.size() >= _input.rows());
 	float mn=0.0;
-	for (int i = 0; i < _input.rows(); ++i){
-		mn+=_weights(i)*(_input.row(i).mean());
+	for (size_t i = 0; i < _input.rows(); ++i){
+		float row=0.0;
+		for (size_t j = 0; j < _input.cols(); ++j) row+=_input(i,j);
+		if (_input.cols()) mn+=_weights[i]*(row/_input.cols());
 	}
 	return mn;
 }
 ////////////////////////////////////////////////////////////////////////////
-int meanFilter(const std::vector<float>& _ref, const std::vector<float>& _input, std::vector<float>& _output, int _filter_type){
+inline int meanFilter(const std::vector<float>& _ref, const std::vector<float>& _input, std::vector<float>& _output, int _filter_type){
 //low pass average field
 	//weighted average with neightbours
 	_output.assign (_input.size(),0.0);
@@ -356,7 +252,7 @@ std::vector<size_t> sort_indexes(std::vector<T> &v) {
   return idx;
 }
 ////////////////////////////////////////////////////////////////////////////
-std::vector<float> periodicInterpolation(std::vector<float> _x, std::vector<float> _y, std::vector<float> _ref, bool _filtering){
+inline std::vector<float> periodicInterpolation(std::vector<float> _x, std::vector<float> _y, std::vector<float> _ref, bool _filtering){
 	//ideally, supply vector with desired phase values/indexes, output resampled/interpolated values
 	//input values may be too close, info may overlap, as such a precision value is set, values are rounded and then averaged
 	//this also helps with periodic signals with a bad/noisy period or local outlier data points
@@ -0,0 +1,640 @@
+//------------------------------------------------------------------------------
+/// @file       stencil.hpp
+/// @author     João André
+///
+/// @brief      Stencil/convolution engine for std::volume and std::matrix (and their views): separable filters
+///             (e.g. Gaussian, Sobel, box) and arbitrary small kernels, with clamp, wrap and zero boundary modes.
+///
+/// Separable filters are applied as a sequence of 1D passes, one per axis. Passes along columns operate on padded
+/// (contiguous) lines; passes along rows and layers accumulate whole input rows/planes, one tile of contiguous elements
+/// at a time, so that the kernel footprint stays in cache regardless of the volume size. All inner loops run over
+/// contiguous memory with no per-element index computation or boundary checks, and are thus auto-vectorized (SIMD) by
+/// the compiler. Work (lines or tiles) is distributed over a std::work_stealing_pool.
+///
+/// @note       Kernels are applied as stencils (correlation) i.e. out[i] = sum_j kernel[j] * in[i + j - radius],
+///             without flipping. Kernel dimensions must be odd, with the center element as origin.
+///
+/// @note       Matrices are handled as single-layer volumes.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_STENCIL_HPP_
+#define STORAGE_INCLUDE_STORAGE_STENCIL_HPP_
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include "storage/matrix.hpp"
+#include "storage/volume.hpp"
+#include "storage/view.hpp"
+#include "storage/parallel.hpp"
+
+namespace std {
+namespace stencil {
+
+//------------------------------------------------------------------------------
+/// @brief      Boundary handling modes, i.e. values assumed for elements outside of input bounds.
+///
+enum class boundary {
+    clamp,  ///< nearest edge element
+    wrap,   ///< periodic extension
+    zero    ///< zero padding
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Number of contiguous elements processed per tile (passes along rows/layers).
+///
+/// @note       Tiles of kernel_size * tile_size elements are meant to fit in L1/L2 cache for typical (small) kernels.
+///
+constexpr size_t tile_size = 1024;
+
+//------------------------------------------------------------------------------
+/// @brief      Builds a normalized 1D Gaussian kernel.
+///
+/// @param[in]  sigma   Standard deviation (in elements).
+/// @param[in]  radius  Kernel radius. Defaults to 0 i.e. ceil(3 * sigma).
+///
+/// @tparam     K       Kernel value type. Defaults to double.
+///
+/// @return     Kernel with 2 * radius + 1 weights, summing up to 1.
+///
+template < typename K = double >
+vector< K > gaussian(double sigma, size_t radius = 0);
+
+//------------------------------------------------------------------------------
+/// @brief      Builds a normalized 1D box (moving average) kernel.
+///
+/// @param[in]  radius  Kernel radius.
+///
+/// @tparam     K       Kernel value type. Defaults to double.
+///
+/// @return     Kernel with 2 * radius + 1 equal weights, summing up to 1.
+///
+template < typename K = double >
+vector< K > box(size_t radius);
+
+//------------------------------------------------------------------------------
+/// @brief      Builds the Sobel (central difference) derivative kernel, i.e. { -1, 0, 1 }.
+///
+template < typename K = double >
+vector< K > derivative();
+
+//------------------------------------------------------------------------------
+/// @brief      Builds the Sobel smoothing kernel, i.e. { 1, 2, 1 }.
+///
+template < typename K = double >
+vector< K > smoothing();
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Resolves (possibly out-of-bounds) position *pos* within [0, *n*) according to boundary mode.
+///
+/// @return     False if element is outside of bounds and boundary mode is zero, true otherwise (*idx* holds resolved index).
+///
+bool resolve(ptrdiff_t pos, size_t n, boundary mode, size_t& idx);
+
+//------------------------------------------------------------------------------
+/// @brief      Copies *n* elements from *src* into *dst*, padded with *radius* elements on each side according to boundary mode.
+///
+template < typename iT, typename aT >
+void pad(const iT* src, size_t n, size_t radius, boundary mode, aT* dst);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies 1D *kernel* along the middle axis of a [outer][extent][inner] layout.
+///
+/// @param[in]  in      Pointer to input data.
+/// @param      out     Pointer to output data (may *not* alias input).
+/// @param[in]  outer   Product of dimensions before filtered axis.
+/// @param[in]  extent  Dimension of filtered axis.
+/// @param[in]  inner   Product of dimensions after filtered axis (1 if filtering along contiguous axis).
+/// @param[in]  kernel  Kernel weights (odd size).
+/// @param[in]  mode    Boundary mode.
+/// @param      pool    Thread pool.
+///
+/// @tparam     iT      Input value type.
+/// @tparam     oT      Output value type.
+/// @tparam     K       Kernel value type.
+///
+template < typename iT, typename oT, typename K >
+void pass(const iT* in, oT* out, size_t outer, size_t extent, size_t inner, const vector< K >& kernel, boundary mode, work_stealing_pool& pool);
+
+}  // namespace details
+}  // namespace stencil
+
+
+//------------------------------------------------------------------------------
+/// @brief      Applies a separable filter to volume view *in*, writing results to *out*.
+///
+/// @param[in]  in        Input view.
+/// @param[in]  out       Output view (same shape as *in*, may *not* overlap *in*).
+/// @param[in]  k_layers  1D kernel along layers (empty for no filtering along layers).
+/// @param[in]  k_rows    1D kernel along rows (empty for no filtering along rows).
+/// @param[in]  k_cols    1D kernel along columns (empty for no filtering along columns).
+/// @param[in]  mode      Boundary mode. Defaults to clamp.
+/// @param      pool      Thread pool. Defaults to shared pool instance.
+///
+/// @tparam     iT        Input value type (possibly const).
+/// @tparam     oT        Output value type.
+/// @tparam     K         Kernel value type.
+///
+/// @note       Intermediate results are kept in common_type< iT, K > precision.
+///
+template < typename iT, typename oT, typename K >
+void separable_filter(const volume_view< iT >& in, const volume_view< oT >& out, const vector< K >& k_layers, const vector< K >& k_rows, const vector< K >& k_cols,
+                      stencil::boundary mode = stencil::boundary::clamp, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Applies a separable filter to matrix view *in*, writing results to *out*.
+///
+/// @param[in]  in        Input view.
+/// @param[in]  out       Output view (same shape as *in*, may *not* overlap *in*).
+/// @param[in]  k_rows    1D kernel along rows (empty for no filtering along rows).
+/// @param[in]  k_cols    1D kernel along columns (empty for no filtering along columns).
+/// @param[in]  mode      Boundary mode. Defaults to clamp.
+/// @param      pool      Thread pool. Defaults to shared pool instance.
+///
+template < typename iT, typename oT, typename K >
+void separable_filter(const matrix_view< iT >& in, const matrix_view< oT >& out, const vector< K >& k_rows, const vector< K >& k_cols,
+                      stencil::boundary mode = stencil::boundary::clamp, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Applies an arbitrary (small) 3D kernel to volume view *in*, writing results to *out*.
+///
+/// @param[in]  in      Input view.
+/// @param[in]  out     Output view (same shape as *in*, may *not* overlap *in*).
+/// @param[in]  kernel  Kernel view, with odd dimensions.
+/// @param[in]  mode    Boundary mode. Defaults to clamp.
+/// @param      pool    Thread pool. Defaults to shared pool instance.
+///
+/// @note       Cost is proportional to the number of *non-zero* kernel weights; separable kernels should be applied
+///             w/ separable_filter() instead.
+///
+template < typename iT, typename oT, typename K >
+void stencil_filter(const volume_view< iT >& in, const volume_view< oT >& out, const volume_view< K >& kernel,
+                    stencil::boundary mode = stencil::boundary::clamp, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Applies an arbitrary (small) 2D kernel to matrix view *in*, writing results to *out*.
+///
+template < typename iT, typename oT, typename K >
+void stencil_filter(const matrix_view< iT >& in, const matrix_view< oT >& out, const matrix_view< K >& kernel,
+                    stencil::boundary mode = stencil::boundary::clamp, work_stealing_pool& pool = work_stealing_pool::instance());
+
+//------------------------------------------------------------------------------
+/// @brief      Applies a separable filter to a volume.
+///
+/// @return     Filtered volume, same shape as *in*.
+///
+template < typename T, typename K >
+volume< T > separable_filter(const volume< T >& in, const vector< K >& k_layers, const vector< K >& k_rows, const vector< K >& k_cols, stencil::boundary mode = stencil::boundary::clamp);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies a separable filter to a matrix.
+///
+/// @return     Filtered matrix, same shape as *in*.
+///
+template < typename T, typename K >
+matrix< T > separable_filter(const matrix< T >& in, const vector< K >& k_rows, const vector< K >& k_cols, stencil::boundary mode = stencil::boundary::clamp);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies an arbitrary (small) kernel to a volume.
+///
+/// @return     Filtered volume, same shape as *in*.
+///
+template < typename T, typename K >
+volume< T > stencil_filter(const volume< T >& in, const volume< K >& kernel, stencil::boundary mode = stencil::boundary::clamp);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies an arbitrary (small) kernel to a matrix.
+///
+/// @return     Filtered matrix, same shape as *in*.
+///
+template < typename T, typename K >
+matrix< T > stencil_filter(const matrix< T >& in, const matrix< K >& kernel, stencil::boundary mode = stencil::boundary::clamp);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies an isotropic Gaussian filter (same *sigma* along all axes).
+///
+/// @param[in]  in     Input volume/matrix.
+/// @param[in]  sigma  Standard deviation (in elements).
+/// @param[in]  mode   Boundary mode. Defaults to clamp.
+///
+/// @return     Smoothed volume/matrix.
+///
+template < typename T >
+volume< T > gaussian_filter(const volume< T >& in, double sigma, stencil::boundary mode = stencil::boundary::clamp);
+
+template < typename T >
+matrix< T > gaussian_filter(const matrix< T >& in, double sigma, stencil::boundary mode = stencil::boundary::clamp);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies a box (moving average) filter of given *radius* along all axes.
+///
+template < typename T >
+volume< T > box_filter(const volume< T >& in, size_t radius, stencil::boundary mode = stencil::boundary::clamp);
+
+template < typename T >
+matrix< T > box_filter(const matrix< T >& in, size_t radius, stencil::boundary mode = stencil::boundary::clamp);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies the Sobel operator, i.e. derivative along *axis* and smoothing along remaining axes.
+///
+/// @param[in]  in     Input volume/matrix.
+/// @param[in]  axis   Derivative axis: 0 (layers), 1 (rows) or 2 (cols) for volumes; 0 (rows) or 1 (cols) for matrices.
+/// @param[in]  mode   Boundary mode. Defaults to clamp.
+///
+/// @return     Unnormalized gradient component along *axis*.
+///
+template < typename T >
+volume< T > sobel_filter(const volume< T >& in, size_t axis, stencil::boundary mode = stencil::boundary::clamp);
+
+template < typename T >
+matrix< T > sobel_filter(const matrix< T >& in, size_t axis, stencil::boundary mode = stencil::boundary::clamp);
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+namespace stencil {
+
+template < typename K >
+vector< K > gaussian(double sigma, size_t radius) {
+    assert(sigma > 0.0);
+    if (!radius) {
+        radius = static_cast< size_t >(ceil(3.0 * sigma));
+    }
+    vector< double > weights(2 * radius + 1);
+    double sum = 0.0;
+    for (size_t i = 0; i < weights.size(); i++) {
+        double x = static_cast< double >(i) - static_cast< double >(radius);
+        weights[i] = exp(-(x * x) / (2.0 * sigma * sigma));
+        sum += weights[i];
+    }
+    vector< K > kernel(weights.size());
+    for (size_t i = 0; i < weights.size(); i++) {
+        kernel[i] = static_cast< K >(weights[i] / sum);
+    }
+    return kernel;
+}
+
+
+
+template < typename K >
+vector< K > box(size_t radius) {
+    return vector< K >(2 * radius + 1, static_cast< K >(1.0 / static_cast< double >(2 * radius + 1)));
+}
+
+
+
+template < typename K >
+vector< K > derivative() {
+    return vector< K >({ static_cast< K >(-1), static_cast< K >(0), static_cast< K >(1) });
+}
+
+
+
+template < typename K >
+vector< K > smoothing() {
+    return vector< K >({ static_cast< K >(1), static_cast< K >(2), static_cast< K >(1) });
+}
+
+
+
+namespace details {
+
+inline bool resolve(ptrdiff_t pos, size_t n, boundary mode, size_t& idx) {
+    ptrdiff_t size = static_cast< ptrdiff_t >(n);
+    if (pos >= 0 && pos < size) {
+        idx = static_cast< size_t >(pos);
+        return true;
+    }
+    switch (mode) {
+        case boundary::clamp:
+            idx = (pos < 0) ? 0 : n - 1;
+            return true;
+        case boundary::wrap:
+            idx = static_cast< size_t >(((pos % size) + size) % size);
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+
+template < typename iT, typename aT >
+void pad(const iT* src, size_t n, size_t radius, boundary mode, aT* dst) {
+    for (size_t i = 0; i < n; i++) {
+        dst[radius + i] = static_cast< aT >(src[i]);
+    }
+    for (size_t i = 0; i < radius; i++) {
+        size_t idx = 0;
+        ptrdiff_t offset = static_cast< ptrdiff_t >(radius - i);
+        dst[i] = resolve(-offset, n, mode, idx) ? static_cast< aT >(src[idx]) : static_cast< aT >(0);
+        dst[radius + n + i] = resolve(static_cast< ptrdiff_t >(n + i), n, mode, idx) ? static_cast< aT >(src[idx]) : static_cast< aT >(0);
+    }
+}
+
+
+
+template < typename iT, typename oT, typename K >
+void pass(const iT* in, oT* out, size_t outer, size_t extent, size_t inner, const vector< K >& kernel, boundary mode, work_stealing_pool& pool) {
+    using acc_t = typename common_type< typename remove_const< iT >::type, K >::type;
+    assert(kernel.size() % 2 == 1);
+    size_t radius = kernel.size() / 2;
+    if (inner == 1) {
+        // filtering along contiguous axis: one task per line, over a padded copy of the line
+        parallel_for(0, outer, [&](size_t first, size_t last) {
+            vector< acc_t > line(extent + 2 * radius);
+            vector< acc_t > acc(extent);
+            for (size_t o = first; o < last; o++) {
+                pad(in + o * extent, extent, radius, mode, line.data());
+                fill(acc.begin(), acc.end(), static_cast< acc_t >(0));
+                for (size_t j = 0; j < kernel.size(); j++) {
+                    const acc_t w = static_cast< acc_t >(kernel[j]);
+                    const acc_t* src = line.data() + j;
+                    acc_t* dst = acc.data();
+                    for (size_t i = 0; i < extent; i++) {
+                        dst[i] += w * src[i];
+                    }
+                }
+                oT* dst = out + o * extent;
+                for (size_t i = 0; i < extent; i++) {
+                    dst[i] = static_cast< oT >(acc[i]);
+                }
+            }
+        }, 1, pool);
+        return;
+    }
+    // filtering along strided axis: whole input rows/planes are accumulated, one tile at a time
+    // task order is [outer][tile][extent], so that neighbouring tasks (same chunk) reuse the same input tiles
+    size_t n_tiles = (inner + tile_size - 1) / tile_size;
+    parallel_for(0, outer * n_tiles * extent, [&](size_t first, size_t last) {
+        vector< acc_t > acc(min(tile_size, inner));
+        for (size_t task = first; task < last; task++) {
+            size_t e    = task % extent;
+            size_t tile = (task / extent) % n_tiles;
+            size_t o    = task / (extent * n_tiles);
+            size_t begin = tile * tile_size;
+            size_t n     = min(tile_size, inner - begin);
+            fill(acc.begin(), acc.begin() + n, static_cast< acc_t >(0));
+            for (size_t j = 0; j < kernel.size(); j++) {
+                size_t src_e = 0;
+                if (!resolve(static_cast< ptrdiff_t >(e + j) - static_cast< ptrdiff_t >(radius), extent, mode, src_e)) {
+                    continue;
+                }
+                const acc_t w = static_cast< acc_t >(kernel[j]);
+                const iT* src = in + (o * extent + src_e) * inner + begin;
+                acc_t* dst = acc.data();
+                for (size_t i = 0; i < n; i++) {
+                    dst[i] += w * static_cast< acc_t >(src[i]);
+                }
+            }
+            oT* dst = out + (o * extent + e) * inner + begin;
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = static_cast< oT >(acc[i]);
+            }
+        }
+    }, 1, pool);
+}
+
+}  // namespace details
+}  // namespace stencil
+
+
+
+template < typename iT, typename oT, typename K >
+void separable_filter(const volume_view< iT >& in, const volume_view< oT >& out, const vector< K >& k_layers, const vector< K >& k_rows, const vector< K >& k_cols,
+                      stencil::boundary mode, work_stealing_pool& pool) {
+    using acc_t = typename common_type< typename remove_const< iT >::type, K >::type;
+    assert(in.shape() == out.shape());
+    if (in.isEmpty()) {
+        return;
+    }
+    size_t dims[3] = { in.layers(), in.rows(), in.cols() };
+    const vector< K >* kernels[3] = { &k_layers, &k_rows, &k_cols };
+    vector< size_t > axes;
+    for (size_t axis = 3; axis-- > 0; ) {
+        if (!kernels[axis]->empty()) {
+            axes.push_back(axis);  // columns first: first pass reads (possibly non-floating point) input once, contiguously
+        }
+    }
+    if (axes.empty()) {
+        parallel_transform(in, out, [](const typename remove_const< iT >::type& val) { return static_cast< oT >(val); }, 0, pool);
+        return;
+    }
+    // intermediate passes ping-pong between two buffers, first pass reads input and last pass writes output
+    vector< acc_t > buffers[2];
+    const acc_t* src = nullptr;
+    for (size_t p = 0; p < axes.size(); p++) {
+        size_t axis  = axes[p];
+        size_t outer = 1;
+        size_t inner = 1;
+        for (size_t a = 0; a < axis; a++) {
+            outer *= dims[a];
+        }
+        for (size_t a = axis + 1; a < 3; a++) {
+            inner *= dims[a];
+        }
+        bool last = (p == axes.size() - 1);
+        acc_t* dst = nullptr;
+        if (!last) {
+            buffers[p % 2].resize(in.size());
+            dst = buffers[p % 2].data();
+        }
+        if (!p && last) {
+            stencil::details::pass(in.data(), out.data(), outer, dims[axis], inner, *kernels[axis], mode, pool);
+        } else if (!p) {
+            stencil::details::pass(in.data(), dst, outer, dims[axis], inner, *kernels[axis], mode, pool);
+        } else if (last) {
+            stencil::details::pass(src, out.data(), outer, dims[axis], inner, *kernels[axis], mode, pool);
+        } else {
+            stencil::details::pass(src, dst, outer, dims[axis], inner, *kernels[axis], mode, pool);
+        }
+        src = dst;
+    }
+}
+
+
+
+template < typename iT, typename oT, typename K >
+void separable_filter(const matrix_view< iT >& in, const matrix_view< oT >& out, const vector< K >& k_rows, const vector< K >& k_cols,
+                      stencil::boundary mode, work_stealing_pool& pool) {
+    separable_filter(volume_view< iT >(in.data(), 1, in.rows(), in.cols()), volume_view< oT >(out.data(), 1, out.rows(), out.cols()),
+                     vector< K >(), k_rows, k_cols, mode, pool);
+}
+
+
+
+template < typename iT, typename oT, typename K >
+void stencil_filter(const volume_view< iT >& in, const volume_view< oT >& out, const volume_view< K >& kernel,
+                    stencil::boundary mode, work_stealing_pool& pool) {
+    using acc_t = typename common_type< typename remove_const< iT >::type, typename remove_const< K >::type >::type;
+    assert(in.shape() == out.shape());
+    assert(kernel.layers() % 2 == 1 && kernel.rows() % 2 == 1 && kernel.cols() % 2 == 1);
+    if (in.isEmpty()) {
+        return;
+    }
+    const ptrdiff_t r_layers = static_cast< ptrdiff_t >(kernel.layers() / 2);
+    const ptrdiff_t r_rows   = static_cast< ptrdiff_t >(kernel.rows() / 2);
+    const size_t    r_cols   = kernel.cols() / 2;
+    const size_t    n_cols   = in.cols();
+    // one task per output row; each contributing input row is padded once and accumulated for every kernel column
+    parallel_for(0, in.layers() * in.rows(), [&](size_t first, size_t last) {
+        vector< acc_t > line(n_cols + 2 * r_cols);
+        vector< acc_t > acc(n_cols);
+        for (size_t task = first; task < last; task++) {
+            size_t l = task / in.rows();
+            size_t r = task % in.rows();
+            fill(acc.begin(), acc.end(), static_cast< acc_t >(0));
+            for (size_t kl = 0; kl < kernel.layers(); kl++) {
+                size_t src_l = 0;
+                if (!stencil::details::resolve(static_cast< ptrdiff_t >(l + kl) - r_layers, in.layers(), mode, src_l)) {
+                    continue;
+                }
+                for (size_t kr = 0; kr < kernel.rows(); kr++) {
+                    size_t src_r = 0;
+                    if (!stencil::details::resolve(static_cast< ptrdiff_t >(r + kr) - r_rows, in.rows(), mode, src_r)) {
+                        continue;
+                    }
+                    bool padded = false;
+                    for (size_t kc = 0; kc < kernel.cols(); kc++) {
+                        const acc_t w = static_cast< acc_t >(kernel(kl, kr, kc));
+                        if (w == static_cast< acc_t >(0)) {
+                            continue;
+                        }
+                        if (!padded) {
+                            stencil::details::pad(&in(src_l, src_r, 0), n_cols, r_cols, mode, line.data());
+                            padded = true;
+                        }
+                        const acc_t* src = line.data() + kc;
+                        acc_t* dst = acc.data();
+                        for (size_t i = 0; i < n_cols; i++) {
+                            dst[i] += w * src[i];
+                        }
+                    }
+                }
+            }
+            oT* dst = &out(l, r, 0);
+            for (size_t i = 0; i < n_cols; i++) {
+                dst[i] = static_cast< oT >(acc[i]);
+            }
+        }
+    }, 1, pool);
+}
+
+
+
+template < typename iT, typename oT, typename K >
+void stencil_filter(const matrix_view< iT >& in, const matrix_view< oT >& out, const matrix_view< K >& kernel,
+                    stencil::boundary mode, work_stealing_pool& pool) {
+    stencil_filter(volume_view< iT >(in.data(), 1, in.rows(), in.cols()), volume_view< oT >(out.data(), 1, out.rows(), out.cols()),
+                   volume_view< K >(kernel.data(), 1, kernel.rows(), kernel.cols()), mode, pool);
+}
+
+
+
+template < typename T, typename K >
+volume< T > separable_filter(const volume< T >& in, const vector< K >& k_layers, const vector< K >& k_rows, const vector< K >& k_cols, stencil::boundary mode) {
+    volume< T > out;
+    if (!in.isEmpty()) {
+        out = volume< T >(in.layers(), in.rows(), in.cols());
+        separable_filter(in.view(), out.view(), k_layers, k_rows, k_cols, mode);
+    }
+    return out;
+}
+
+
+
+template < typename T, typename K >
+matrix< T > separable_filter(const matrix< T >& in, const vector< K >& k_rows, const vector< K >& k_cols, stencil::boundary mode) {
+    matrix< T > out(in.rows(), in.cols());
+    separable_filter(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()), k_rows, k_cols, mode);
+    return out;
+}
+
+
+
+template < typename T, typename K >
+volume< T > stencil_filter(const volume< T >& in, const volume< K >& kernel, stencil::boundary mode) {
+    volume< T > out;
+    if (!in.isEmpty()) {
+        out = volume< T >(in.layers(), in.rows(), in.cols());
+        stencil_filter(in.view(), out.view(), kernel.view(), mode);
+    }
+    return out;
+}
+
+
+
+template < typename T, typename K >
+matrix< T > stencil_filter(const matrix< T >& in, const matrix< K >& kernel, stencil::boundary mode) {
+    matrix< T > out(in.rows(), in.cols());
+    stencil_filter(matrix_view< const T >(in.data(), in.rows(), in.cols()), matrix_view< T >(out.data(), out.rows(), out.cols()),
+                   matrix_view< const K >(kernel.data(), kernel.rows(), kernel.cols()), mode);
+    return out;
+}
+
+
+
+template < typename T >
+volume< T > gaussian_filter(const volume< T >& in, double sigma, stencil::boundary mode) {
+    auto kernel = stencil::gaussian(sigma);
+    return separable_filter(in, kernel, kernel, kernel, mode);
+}
+
+
+
+template < typename T >
+matrix< T > gaussian_filter(const matrix< T >& in, double sigma, stencil::boundary mode) {
+    auto kernel = stencil::gaussian(sigma);
+    return separable_filter(in, kernel, kernel, mode);
+}
+
+
+
+template < typename T >
+volume< T > box_filter(const volume< T >& in, size_t radius, stencil::boundary mode) {
+    auto kernel = stencil::box(radius);
+    return separable_filter(in, kernel, kernel, kernel, mode);
+}
+
+
+
+template < typename T >
+matrix< T > box_filter(const matrix< T >& in, size_t radius, stencil::boundary mode) {
+    auto kernel = stencil::box(radius);
+    return separable_filter(in, kernel, kernel, mode);
+}
+
+
+
+template < typename T >
+volume< T > sobel_filter(const volume< T >& in, size_t axis, stencil::boundary mode) {
+    assert(axis < 3);
+    vector< double > kernels[3] = { stencil::smoothing(), stencil::smoothing(), stencil::smoothing() };
+    kernels[axis] = stencil::derivative();
+    return separable_filter(in, kernels[0], kernels[1], kernels[2], mode);
+}
+
+
+
+template < typename T >
+matrix< T > sobel_filter(const matrix< T >& in, size_t axis, stencil::boundary mode) {
+    assert(axis < 2);
+    vector< double > kernels[2] = { stencil::smoothing(), stencil::smoothing() };
+    kernels[axis] = stencil::derivative();
+    return separable_filter(in, kernels[0], kernels[1], mode);
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_STENCIL_HPP_
@@ -4,7 +4,7 @@
 ///
 /// @brief      I/O stream utilities, including shift operator overloads
 ///
-/// @todo       Missing some overloads for std::volume and std::st_subset_base
+/// @todo       Missing some input overloads for std::st_subset_base
 ///
 /// @note       print_into() and load_from() could be included and employed (should work with iteratable types in any case),
 ///             but these implementations specialize towards storage types (e.g. formatting)
@@ -18,6 +18,7 @@
 #include "storage/matrix.hpp"
 #include "storage/volume.hpp"
 #include "storage/subset.hpp"
+#include "storage/view.hpp"
 
 //------------------------------------------------------------------------------
 // @note        Default delimiter, employed by left/right shift operators
@@ -52,6 +53,12 @@ ostream& write(ostream& os, const volume< T >& vol, char delimiter = DEFAULT_DEL
 template < typename CT >
 ostream& write(ostream& os, const storage::st_subset_base< CT >& st_subset, char delimiter = DEFAULT_DELIMITER, bool formatted = true);
 
+template < typename T >
+ostream& write(ostream& os, const matrix_view< T >& view, char delimiter = DEFAULT_DELIMITER, bool formatted = true);
+
+template < typename T >
+ostream& write(ostream& os, const volume_view< T >& view, char delimiter = DEFAULT_DELIMITER, bool formatted = true);
+
 
 //------------------------------------------------------------------------------
 /// @brief      Reads from an input stream into a matrix object.
@@ -76,6 +83,12 @@ istream& read(istream& is, volume< T >& vol, char delimiter = DEFAULT_DELIMITER,
 template < typename T >
 istream& read(istream& is, storage::st_subset_base< T >& st_subset, char delimiter = DEFAULT_DELIMITER, bool ignore_break = false);
 
+template < typename T >
+istream& read(istream& is, const matrix_view< T >& view, char delimiter = DEFAULT_DELIMITER, bool ignore_break = false);  // views are handles, source data is modified
+
+template < typename T >
+istream& read(istream& is, const volume_view< T >& view, char delimiter = DEFAULT_DELIMITER, bool ignore_break = false);
+
 
 //------------------------------------------------------------------------------
 /// @brief      Left shift operator overload, for output streams.
@@ -107,6 +120,18 @@ ostream& operator<<(ostream& ostream, const storage::st_subset_base< CT >& subse
     return write(ostream, subset, '\t');
 }
 
+template < typename T >
+ostream& operator<<(ostream& ostream, const std::matrix_view< T >& view) {
+    std::cout.precision(5);
+    return write(ostream, view, '\t');
+}
+
+template < typename T >
+ostream& operator<<(ostream& ostream, const std::volume_view< T >& view) {
+    std::cout.precision(5);
+    return write(ostream, view, '\t');
+}
+
 // // template < typename T, typename ST, typename = typename enable_if< is_same< ST, matrix< T > >::value || is_same< ST, volume< T > >::value || is_same< ST, storage::st_subset_base< T > >::value >::type >
 // template < typename ST, typename T, typename = typename enable_if< is_same< ST, storage::st_subset_base< T > >::value >::type >
 // ostream& operator<<(ostream& ostream, const ST< T >& subset) {
@@ -140,22 +165,49 @@ std::istream& operator>>(std::istream& istream, std::matrix< T >& mat) {
 
 template < typename T >
 ostream& write(ostream& ostream, const matrix< T >& mat, char delimiter, bool formatted) {
-    for (size_t row = 0; row < mat.rows(); row++) {
-        ostream << mat(row, 0);
-        for (size_t col = 1; col < mat.cols(); col++) {
-            ostream << delimiter << mat(row, col);
+    return write(ostream, matrix_view< const T >(mat.data(), mat.rows(), mat.cols()), delimiter, formatted);
+}
+
+template < typename T >
+ostream& write(ostream& ostream, const volume< T >& vol, char delimiter, bool formatted) {
+    return write(ostream, vol.view(), delimiter, formatted);
+}
+
+template < typename T >
+ostream& write(ostream& ostream, const matrix_view< T >& view, char delimiter, bool formatted) {
+    for (size_t row = 0; row < view.rows(); row++) {
+        ostream << view(row, 0);
+        for (size_t col = 1; col < view.cols(); col++) {
+            ostream << delimiter << view(row, col);
         }
-        if (formatted && row < mat.rows() - 1) {
+        if (formatted && row < view.rows() - 1) {
             ostream << "\n";
         }
     }
     if (formatted) {
-        ostream << " [" << mat.rows() << " x " << mat.cols() << "]";
+        ostream << " [" << view.rows() << " x " << view.cols() << "]";
     }
     return ostream;
 }
 
-/// ... add std::volume<> overload
+template < typename T >
+ostream& write(ostream& ostream, const volume_view< T >& view, char delimiter, bool formatted) {
+    // layers are written as consecutive matrices (separated by an empty line), shape is written only once (at the end)
+    auto rows = view.flatten();
+    for (size_t row = 0; row < rows.rows(); row++) {
+        ostream << rows(row, 0);
+        for (size_t col = 1; col < rows.cols(); col++) {
+            ostream << delimiter << rows(row, col);
+        }
+        if (formatted && row < rows.rows() - 1) {
+            ostream << (((row + 1) % view.rows()) ? "\n" : "\n\n");
+        }
+    }
+    if (formatted) {
+        ostream << " [" << view.layers() << " x " << view.rows() << " x " << view.cols() << "]";
+    }
+    return ostream;
+}
 
 template < typename CT >
 ostream& write(ostream& ostream, const storage::st_subset_base< CT >& subset, char delimiter, bool formatted) {
@@ -172,13 +224,30 @@ ostream& write(ostream& ostream, const storage::st_subset_base< CT >& subset, ch
 
 template < typename T >
 istream& read(istream& istream, matrix< T >& mat, char delimiter, bool ignore_break) {
-    for (auto& val : mat.container()) {
+    return read(istream, matrix_view< T >(mat.data(), mat.rows(), mat.cols()), delimiter, ignore_break);
+}
+
+template < typename T >
+istream& read(istream& istream, volume< T >& vol, char delimiter, bool ignore_break) {
+    return read(istream, vol.view(), delimiter, ignore_break);
+}
+
+template < typename T >
+istream& read(istream& istream, const matrix_view< T >& view, char delimiter, bool /*ignore_break*/) {
+    for (auto& val : view) {
         istream >> val;
+        if (istream.peek() == delimiter) {
+            istream.ignore();
+        }
     }
     return istream;
 }
 
-/// ... add std::volume<> overload
+template < typename T >
+istream& read(istream& istream, const volume_view< T >& view, char delimiter, bool ignore_break) {
+    return read(istream, view.flatten(), delimiter, ignore_break);
+}
+
 /// ... add std::st_subset_base<> overload
 
 /// @endcond
@@ -44,11 +44,6 @@ class st_subset_base {
     vector< size_t > idx;
 
  public:
-    //--------------------------------------------------------------------------
-    /// @brief      Static assertion
-    ///
-    static_assert(is_generic_container< _CT >(), "_CT IS NOT A GENERIC ITERATABLE CONTAINER");
-
     //--------------------------------------------------------------------------
     /// @brief      Container element value type
     ///
@@ -62,6 +57,16 @@ class st_subset_base {
     ///
     st_subset_base(_CT* container, const vector< size_t >& idx);
 
+    //--------------------------------------------------------------------------
+    /// @brief      Copy constructor (subset view is copied, not the source elements).
+    ///
+    st_subset_base(const st_subset_base< _CT >& other) = default;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Move constructor (index list is moved, e.g. when subsets are held by comparers).
+    ///
+    st_subset_base(st_subset_base< _CT >&& other) = default;
+
     //--------------------------------------------------------------------------
     /// @brief      Bulk copy assignment operator.
     ///             All subset elements set to given *in* value.
@@ -236,6 +241,9 @@ class st_subset_base {
 
 template < typename _CT >
 st_subset_base< _CT >::st_subset_base(_CT* container, const std::vector< size_t >& idx):  _container(container), idx(idx) {
+    // checked on construction rather than at class scope: overload resolution on _CT::operator[] (e.g. while evaluating
+    // is_generic_container< _CT >() itself) may instantiate this class before _CT is complete
+    static_assert(is_generic_container< _CT >(), "_CT IS NOT A GENERIC ITERATABLE CONTAINER");
     for (size_t i : idx) {
         assert(i <= source_size());
     }
@@ -0,0 +1,296 @@
+//------------------------------------------------------------------------------
+/// @file       summation.hpp
+/// @author     João André
+///
+/// @brief      Summation backend for generic storage containers (e.g. std::vector, std::matrix, std::volume, views and
+///             subsets), w/ selectable algorithms, and the mean/variance routines built on top of it.
+///
+/// All algorithms accumulate over multiple independent lanes (cf. lanes), i.e. element *i* is added to lane i % lanes,
+/// which removes the loop-carried dependency on a single accumulator and lets the compiler vectorize the inner loop:
+/// - naive:    plain lane-wise summation; fastest, error grows as O(n * eps);
+/// - pairwise: recursive halving down to blocks of block_size elements (summed lane-wise); error grows as O(log(n) * eps)
+///             at virtually the same cost as naive summation. Default;
+/// - kahan:    Kahan-Babuska-Neumaier compensated summation (per lane, over chunks of kahan_chunk elements); error
+///             independent of n (O(eps)), ~2x slower.
+///
+/// Integer data is accumulated in double precision; floating point data in its own precision.
+///
+/// @note       Compensated summation relies on strict floating point semantics, and is defeated by -ffast-math (or
+///             equivalent) compiler flags.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_SUMMATION_HPP_
+#define STORAGE_INCLUDE_STORAGE_SUMMATION_HPP_
+
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include "storage/type_check.hpp"
+#include "storage/blas.hpp"
+
+namespace std {
+namespace summation {
+
+//------------------------------------------------------------------------------
+/// @brief      Summation algorithms.
+///
+enum class method {
+    naive,     ///< lane-wise accumulation
+    pairwise,  ///< pairwise (cascade) summation
+    kahan      ///< Kahan-Babuska-Neumaier compensated summation
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Number of independent accumulators (lanes).
+///
+constexpr size_t lanes = 8;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of elements below which pairwise summation stops recursing.
+///
+constexpr size_t block_size = 256;
+
+//------------------------------------------------------------------------------
+/// @brief      Number of elements per compensated (kahan) chunk.
+///
+constexpr size_t kahan_chunk = 4096;
+
+//------------------------------------------------------------------------------
+/// @brief      Accumulator type for *T* values (double for integer types).
+///
+template < typename T >
+using accumulator_t = typename conditional< is_floating_point< T >::value, T, double >::type;
+
+namespace details {
+
+//------------------------------------------------------------------------------
+/// @brief      Lane-wise sum of f(x[i]) for i in [first, last).
+///
+template < typename R, typename Accessor, typename Function >
+R naive(const Accessor& x, size_t first, size_t last, const Function& f);
+
+//------------------------------------------------------------------------------
+/// @brief      Pairwise sum of f(x[i]) for i in [first, last).
+///
+template < typename R, typename Accessor, typename Function >
+R pairwise(const Accessor& x, size_t first, size_t last, const Function& f);
+
+//------------------------------------------------------------------------------
+/// @brief      Compensated (Kahan-Babuska-Neumaier) sum of f(x[i]) for i in [first, last).
+///
+template < typename R, typename Accessor, typename Function >
+R kahan(const Accessor& x, size_t first, size_t last, const Function& f);
+
+}  // namespace details
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Sums transformed elements of *container*, i.e. sum(f(x[i])).
+///
+/// @param[in]  container  Input container.
+/// @param[in]  transform  Element transform, with signature R(value_type), R being the accumulator type.
+/// @param[in]  algorithm  Summation algorithm. Defaults to pairwise.
+///
+/// @tparam     Container  Container type, requiring size() and operator[](size_t).
+/// @tparam     Function   Transform type.
+///
+/// @return     Sum (accumulator_t of transform result).
+///
+template < typename Container, typename Function, typename = typename enable_if< !is_same< Function, method >::value >::type >
+auto sum(const Container& container, Function transform, method algorithm = method::pairwise);
+
+//------------------------------------------------------------------------------
+/// @brief      Sums elements of *container*.
+///
+/// @param[in]  container  Input container.
+/// @param[in]  algorithm  Summation algorithm. Defaults to pairwise.
+///
+/// @return     Sum (accumulator_t of value type).
+///
+template < typename Container >
+auto sum(const Container& container, method algorithm = method::pairwise);
+
+//------------------------------------------------------------------------------
+/// @brief      Arithmetic mean of elements of *container*.
+///
+/// @param[in]  container  Input container.
+/// @param[in]  algorithm  Summation algorithm. Defaults to pairwise.
+///
+/// @return     Mean (accumulator_t of value type). NaN if empty.
+///
+template < typename Container >
+auto mean(const Container& container, method algorithm = method::pairwise);
+
+//------------------------------------------------------------------------------
+/// @brief      Variance of elements of *container*, w/ corrected two-pass algorithm (sum of squared deviations from the mean,
+///             minus the squared sum of deviations, which compensates for rounding errors in the mean).
+///
+/// @param[in]  container  Input container.
+/// @param[in]  ddof       Delta degrees of freedom, i.e. divisor is N - ddof (0 for population variance, 1 for sample variance).
+/// @param[in]  algorithm  Summation algorithm. Defaults to pairwise.
+///
+/// @return     Variance (accumulator_t of value type). NaN if N <= ddof.
+///
+template < typename Container >
+auto variance(const Container& container, size_t ddof = 0, method algorithm = method::pairwise);
+
+//------------------------------------------------------------------------------
+/// @brief      Standard deviation of elements of *container*, i.e. sqrt(variance()).
+///
+template < typename Container >
+auto stddev(const Container& container, size_t ddof = 0, method algorithm = method::pairwise);
+
+}  // namespace summation
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename R, typename Accessor, typename Function >
+R summation::details::naive(const Accessor& x, size_t first, size_t last, const Function& f) {
+    R acc[lanes] = { };
+    size_t i = first;
+    for (; i + lanes <= last; i += lanes) {
+        for (size_t k = 0; k < lanes; k++) {
+            acc[k] += f(x[i + k]);
+        }
+    }
+    for (size_t k = 0; i < last; i++, k++) {
+        acc[k] += f(x[i]);
+    }
+    // pairwise combination of lanes
+    for (size_t width = lanes / 2; width > 0; width /= 2) {
+        for (size_t k = 0; k < width; k++) {
+            acc[k] += acc[k + width];
+        }
+    }
+    return acc[0];
+}
+
+
+
+template < typename R, typename Accessor, typename Function >
+R summation::details::pairwise(const Accessor& x, size_t first, size_t last, const Function& f) {
+    size_t n = last - first;
+    if (n <= block_size) {
+        return naive< R >(x, first, last, f);
+    }
+    // split on a multiple of block_size, so that all leaves (but the last) are full blocks
+    size_t half = first + ((n / 2 + block_size - 1) / block_size) * block_size;
+    return pairwise< R >(x, first, half, f) + pairwise< R >(x, half, last, f);
+}
+
+
+
+template < typename R, typename Accessor, typename Function >
+R summation::details::kahan(const Accessor& x, size_t first, size_t last, const Function& f) {
+    auto add = [](R& s, R& c, R v) {
+        R t = s + v;
+        // branch-free Neumaier step: recover low-order bits of the smaller operand
+        c += (std::abs(s) >= std::abs(v)) ? ((s - t) + v) : ((v - t) + s);
+        s = t;
+    };
+    // chunks are summed w/ fresh lanes, so that compensation terms remain small (exactly representable), and chunk totals
+    // are then added into a single compensated accumulator
+    R total = R(0);
+    R correction = R(0);
+    for (size_t chunk = first; chunk < last; chunk += kahan_chunk) {
+        size_t chunk_last = min(last, chunk + kahan_chunk);
+        R sum[lanes] = { };
+        R compensation[lanes] = { };
+        size_t i = chunk;
+        for (; i + lanes <= chunk_last; i += lanes) {
+            for (size_t k = 0; k < lanes; k++) {
+                add(sum[k], compensation[k], f(x[i + k]));
+            }
+        }
+        for (size_t k = 0; i < chunk_last; i++, k++) {
+            add(sum[k], compensation[k], f(x[i]));
+        }
+        R chunk_total = R(0);
+        R chunk_correction = R(0);
+        for (size_t k = 0; k < lanes; k++) {
+            add(chunk_total, chunk_correction, sum[k]);
+            chunk_correction += compensation[k];
+        }
+        add(total, correction, chunk_total);
+        add(total, correction, chunk_correction);
+    }
+    return total + correction;
+}
+
+
+
+template < typename Container, typename Function, typename >
+auto summation::sum(const Container& container, Function transform, method algorithm) {
+    static_assert(is_generic_container< Container >(), "INVALID INPUT CONTAINER!");
+    typedef typename decay< decltype(container[0]) >::type value_type;
+    typedef accumulator_t< typename decay< decltype(transform(declval< value_type >())) >::type > result_type;
+    size_t n = container.size();
+    return blas::details::dispatch(container, [&](const auto& x) {
+        auto f = [&transform](const value_type& v) { return static_cast< result_type >(transform(v)); };
+        switch (algorithm) {
+            case method::naive:
+                return details::naive< result_type >(x, 0, n, f);
+            case method::kahan:
+                return details::kahan< result_type >(x, 0, n, f);
+            default:
+                return details::pairwise< result_type >(x, 0, n, f);
+        }
+    });
+}
+
+
+
+template < typename Container >
+auto summation::sum(const Container& container, method algorithm) {
+    typedef typename decay< decltype(container[0]) >::type value_type;
+    return sum(container, [](const value_type& v) { return static_cast< accumulator_t< value_type > >(v); }, algorithm);
+}
+
+
+
+template < typename Container >
+auto summation::mean(const Container& container, method algorithm) {
+    typedef accumulator_t< typename decay< decltype(container[0]) >::type > result_type;
+    if (!container.size()) {
+        return numeric_limits< result_type >::quiet_NaN();
+    }
+    return sum(container, algorithm) / static_cast< result_type >(container.size());
+}
+
+
+
+template < typename Container >
+auto summation::variance(const Container& container, size_t ddof, method algorithm) {
+    typedef typename decay< decltype(container[0]) >::type value_type;
+    typedef accumulator_t< value_type > result_type;
+    size_t n = container.size();
+    if (n <= ddof) {
+        return numeric_limits< result_type >::quiet_NaN();
+    }
+    result_type mu = mean(container, algorithm);
+    result_type squares = sum(container, [mu](const value_type& v) { result_type d = result_type(v) - mu; return d * d; }, algorithm);
+    result_type deviations = sum(container, [mu](const value_type& v) { return result_type(v) - mu; }, algorithm);
+    return (squares - deviations * deviations / result_type(n)) / result_type(n - ddof);
+}
+
+
+
+template < typename Container >
+auto summation::stddev(const Container& container, size_t ddof, method algorithm) {
+    return sqrt(variance(container, ddof, algorithm));
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_SUMMATION_HPP_
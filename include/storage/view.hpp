@@ -0,0 +1,653 @@
+//------------------------------------------------------------------------------
+/// @file       view.hpp
+/// @author     João André
+///
+/// @brief      Header file providing declaration & definition of std::matrix_view and std::volume_view, non-owning
+///             views over contiguous (row-major) storage, e.g. single layers or slabs of a std::volume.
+///
+/// Views hold a pointer to external storage and its shape, and provide the same generic (nd) container interface as
+/// std::matrix and std::volume (size(), shape(), position(), operator[], data(), begin()/end()), thus can be used with
+/// any algorithm taking generic containers (e.g. parallel_reduce(), stream I/O, std::matrix constructors) without
+/// copying elements.
+///
+/// @note       Views do not own data: any operation reallocating source storage (e.g. volume::pushRow()) invalidates them.
+///
+/// @note       Constness of source is encoded in element type i.e. matrix_view< const T > is a read-only view.
+///
+//------------------------------------------------------------------------------
+
+#ifndef STORAGE_INCLUDE_STORAGE_VIEW_HPP_
+#define STORAGE_INCLUDE_STORAGE_VIEW_HPP_
+
+#include <vector>
+#include <cassert>
+#include <type_traits>
+#include "storage/subset.hpp"
+
+namespace std {
+
+template < typename T > class matrix_view;  // forward declaration required for 'using' typedefs below
+
+template < typename dT >
+using matrix_view_subset = storage::st_subset_base< matrix_view< dT > >;
+
+//------------------------------------------------------------------------------
+/// @brief      Non-owning 2D view over contiguous row-major storage.
+///
+/// @tparam     T     Element data type. Const-qualified for read-only views.
+///
+template < typename T >
+class matrix_view {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Element value type (const-qualified for read-only views, cf. storage::st_subset_base).
+    ///
+    typedef T value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param      data  Pointer to first element of source storage.
+    /// @param[in]  rows  Number of rows.
+    /// @param[in]  cols  Number of columns.
+    ///
+    matrix_view(T* data = nullptr, size_t rows = 0, size_t cols = 0);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Conversion to read-only view.
+    ///
+    operator matrix_view< const T >() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Element-wise accessor.
+    ///
+    /// @param[in]  row   Row index.
+    /// @param[in]  col   Column index.
+    ///
+    /// @return     Reference to element @ (row, col).
+    ///
+    T& operator()(size_t row, size_t col) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Positional element accessor.
+    ///
+    /// @param[in]  idx   Index/position of element (row-major).
+    ///
+    /// @return     Reference to element @ idx.
+    ///
+    T& operator[](size_t idx) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get pointer to first element.
+    ///
+    T* data() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of rows.
+    ///
+    size_t rows() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of columns.
+    ///
+    size_t cols() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get view dimensions.
+    ///
+    /// @return     Vector with number of rows and columns.
+    ///
+    vector< size_t > shape() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get row and column of element @ given index/position (cf. std::matrix::position()).
+    ///
+    vector< size_t > position(size_t idx) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Check if view is empty.
+    ///
+    bool isEmpty() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get (contiguous, zero-copy) view over a single row.
+    ///
+    /// @param[in]  row   Row index.
+    ///
+    /// @return     1 x cols view.
+    ///
+    matrix_view< T > row(size_t row) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get (contiguous, zero-copy) view over a range of rows [*first_row*, *last_row*).
+    ///
+    /// @param[in]  first_row  First row index.
+    /// @param[in]  last_row   Last row index (exclusive).
+    ///
+    matrix_view< T > rows(size_t first_row, size_t last_row) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get subset of elements in given column.
+    ///
+    /// @param[in]  col   Column index.
+    ///
+    /// @note       Columns are strided in row-major storage, thus an (index-based) subset is returned.
+    ///
+    matrix_view_subset< T > col(size_t col);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get index of every element in given column.
+    ///
+    vector< size_t > colID(size_t col) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Copies all elements from generic container *in*.
+    ///
+    /// @param[in]  in    Input container. Must hold at least size() elements.
+    ///
+    /// @tparam     iT    Input container type.
+    ///
+    template < typename iT >
+    void set(const iT& in) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sets all elements to given value.
+    ///
+    void fill(const typename remove_const< T >::type& value) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator to first element.
+    ///
+    T* begin() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator past last element.
+    ///
+    T* end() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Pointer to first element.
+    ///
+    T* _data;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of rows.
+    ///
+    size_t _rows;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of columns.
+    ///
+    size_t _cols;
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @brief      Non-owning 3D view over contiguous layer-major storage (same layout as std::volume).
+///
+/// @tparam     T     Element data type. Const-qualified for read-only views.
+///
+template < typename T >
+class volume_view {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Element value type (const-qualified for read-only views, cf. storage::st_subset_base).
+    ///
+    typedef T value_type;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param      data    Pointer to first element of source storage.
+    /// @param[in]  layers  Number of layers.
+    /// @param[in]  rows    Number of rows.
+    /// @param[in]  cols    Number of columns.
+    ///
+    volume_view(T* data = nullptr, size_t layers = 0, size_t rows = 0, size_t cols = 0);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Conversion to read-only view.
+    ///
+    operator volume_view< const T >() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Element-wise accessor.
+    ///
+    /// @param[in]  layer  Layer index.
+    /// @param[in]  row    Row index.
+    /// @param[in]  col    Column index.
+    ///
+    /// @return     Reference to element @ (layer, row, col).
+    ///
+    T& operator()(size_t layer, size_t row, size_t col) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Positional element accessor.
+    ///
+    /// @param[in]  idx   Index/position of element (layer-major).
+    ///
+    /// @return     Reference to element @ idx.
+    ///
+    T& operator[](size_t idx) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get pointer to first element.
+    ///
+    T* data() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of layers.
+    ///
+    size_t layers() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of rows.
+    ///
+    size_t rows() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of columns.
+    ///
+    size_t cols() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of elements.
+    ///
+    size_t size() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get view dimensions.
+    ///
+    /// @return     Vector with number of layers, rows and columns.
+    ///
+    vector< size_t > shape() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get layer, row and column of element @ given index/position (cf. std::volume::pos()).
+    ///
+    vector< size_t > position(size_t idx) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Check if view is empty.
+    ///
+    bool isEmpty() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get (zero-copy) matrix view over a single layer.
+    ///
+    /// @param[in]  layer  Layer index.
+    ///
+    matrix_view< T > layer(size_t layer) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get (zero-copy) view over a range of layers [*first_layer*, *last_layer*).
+    ///
+    /// @param[in]  first_layer  First layer index.
+    /// @param[in]  last_layer   Last layer index (exclusive).
+    ///
+    volume_view< T > slab(size_t first_layer, size_t last_layer) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get (zero-copy) matrix view over all elements, with layers stacked along rows i.e. (layers * rows) x cols.
+    ///
+    matrix_view< T > flatten() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Copies all elements from generic container *in*.
+    ///
+    /// @param[in]  in    Input container. Must hold at least size() elements.
+    ///
+    /// @tparam     iT    Input container type.
+    ///
+    template < typename iT >
+    void set(const iT& in) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sets all elements to given value.
+    ///
+    void fill(const typename remove_const< T >::type& value) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator to first element.
+    ///
+    T* begin() const;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get iterator past last element.
+    ///
+    T* end() const;
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Pointer to first element.
+    ///
+    T* _data;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of layers.
+    ///
+    size_t _layers;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of rows.
+    ///
+    size_t _rows;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of columns.
+    ///
+    size_t _cols;
+};
+
+
+
+//------------------------------------------------------------------------------
+/// @cond
+
+template < typename T >
+matrix_view< T >::matrix_view(T* data, size_t rows, size_t cols) : _data(data), _rows(rows), _cols(cols) {
+    assert(data || !rows || !cols);
+}
+
+
+
+template < typename T >
+matrix_view< T >::operator matrix_view< const T >() const {
+    return matrix_view< const T >(_data, _rows, _cols);
+}
+
+
+
+template < typename T >
+T& matrix_view< T >::operator()(size_t row, size_t col) const {
+    assert(row < _rows && col < _cols);
+    return _data[row * _cols + col];
+}
+
+
+
+template < typename T >
+T& matrix_view< T >::operator[](size_t idx) const {
+    assert(idx < size());
+    return _data[idx];
+}
+
+
+
+template < typename T >
+T* matrix_view< T >::data() const {
+    return _data;
+}
+
+
+
+template < typename T >
+size_t matrix_view< T >::rows() const {
+    return _rows;
+}
+
+
+
+template < typename T >
+size_t matrix_view< T >::cols() const {
+    return _cols;
+}
+
+
+
+template < typename T >
+size_t matrix_view< T >::size() const {
+    return _rows * _cols;
+}
+
+
+
+template < typename T >
+vector< size_t > matrix_view< T >::shape() const {
+    return vector< size_t >({ _rows, _cols });
+}
+
+
+
+template < typename T >
+vector< size_t > matrix_view< T >::position(size_t idx) const {
+    assert(idx < size());
+    return vector< size_t >({ idx / _cols, idx % _cols });
+}
+
+
+
+template < typename T >
+bool matrix_view< T >::isEmpty() const {
+    return !(_rows && _cols);
+}
+
+
+
+template < typename T >
+matrix_view< T > matrix_view< T >::row(size_t row) const {
+    assert(row < _rows);
+    return matrix_view< T >(_data + row * _cols, 1, _cols);
+}
+
+
+
+template < typename T >
+matrix_view< T > matrix_view< T >::rows(size_t first_row, size_t last_row) const {
+    assert(first_row <= last_row && last_row <= _rows);
+    return matrix_view< T >(_data + first_row * _cols, last_row - first_row, _cols);
+}
+
+
+
+template < typename T >
+matrix_view_subset< T > matrix_view< T >::col(size_t col) {
+    return matrix_view_subset< T >(this, colID(col));
+}
+
+
+
+template < typename T >
+vector< size_t > matrix_view< T >::colID(size_t col) const {
+    assert(col < _cols);
+    vector< size_t > ids(_rows);
+    for (size_t r = 0; r < _rows; r++) {
+        ids[r] = r * _cols + col;
+    }
+    return ids;
+}
+
+
+
+template < typename T >
+template < typename iT >
+void matrix_view< T >::set(const iT& in) const {
+    static_assert(is_generic_container< iT >(), "INVALID INPUT CONTAINER!");
+    assert(in.size() >= size());
+    for (size_t i = 0; i < size(); i++) {
+        _data[i] = in[i];
+    }
+}
+
+
+
+template < typename T >
+void matrix_view< T >::fill(const typename remove_const< T >::type& value) const {
+    for (size_t i = 0; i < size(); i++) {
+        _data[i] = value;
+    }
+}
+
+
+
+template < typename T >
+T* matrix_view< T >::begin() const {
+    return _data;
+}
+
+
+
+template < typename T >
+T* matrix_view< T >::end() const {
+    return _data + size();
+}
+
+
+
+template < typename T >
+volume_view< T >::volume_view(T* data, size_t layers, size_t rows, size_t cols) : _data(data), _layers(layers), _rows(rows), _cols(cols) {
+    assert(data || !layers || !rows || !cols);
+}
+
+
+
+template < typename T >
+volume_view< T >::operator volume_view< const T >() const {
+    return volume_view< const T >(_data, _layers, _rows, _cols);
+}
+
+
+
+template < typename T >
+T& volume_view< T >::operator()(size_t layer, size_t row, size_t col) const {
+    assert(layer < _layers && row < _rows && col < _cols);
+    return _data[(layer * _rows + row) * _cols + col];
+}
+
+
+
+template < typename T >
+T& volume_view< T >::operator[](size_t idx) const {
+    assert(idx < size());
+    return _data[idx];
+}
+
+
+
+template < typename T >
+T* volume_view< T >::data() const {
+    return _data;
+}
+
+
+
+template < typename T >
+size_t volume_view< T >::layers() const {
+    return _layers;
+}
+
+
+
+template < typename T >
+size_t volume_view< T >::rows() const {
+    return _rows;
+}
+
+
+
+template < typename T >
+size_t volume_view< T >::cols() const {
+    return _cols;
+}
+
+
+
+template < typename T >
+size_t volume_view< T >::size() const {
+    return _layers * _rows * _cols;
+}
+
+
+
+template < typename T >
+vector< size_t > volume_view< T >::shape() const {
+    return vector< size_t >({ _layers, _rows, _cols });
+}
+
+
+
+template < typename T >
+vector< size_t > volume_view< T >::position(size_t idx) const {
+    assert(idx < size());
+    size_t layer_size = _rows * _cols;
+    return vector< size_t >({ idx / layer_size, (idx % layer_size) / _cols, idx % _cols });
+}
+
+
+
+template < typename T >
+bool volume_view< T >::isEmpty() const {
+    return !(_layers && _rows && _cols);
+}
+
+
+
+template < typename T >
+matrix_view< T > volume_view< T >::layer(size_t layer) const {
+    assert(layer < _layers);
+    return matrix_view< T >(_data + layer * _rows * _cols, _rows, _cols);
+}
+
+
+
+template < typename T >
+volume_view< T > volume_view< T >::slab(size_t first_layer, size_t last_layer) const {
+    assert(first_layer <= last_layer && last_layer <= _layers);
+    return volume_view< T >(_data + first_layer * _rows * _cols, last_layer - first_layer, _rows, _cols);
+}
+
+
+
+template < typename T >
+matrix_view< T > volume_view< T >::flatten() const {
+    return matrix_view< T >(_data, _layers * _rows, _cols);
+}
+
+
+
+template < typename T >
+template < typename iT >
+void volume_view< T >::set(const iT& in) const {
+    static_assert(is_generic_container< iT >(), "INVALID INPUT CONTAINER!");
+    assert(in.size() >= size());
+    for (size_t i = 0; i < size(); i++) {
+        _data[i] = in[i];
+    }
+}
+
+
+
+template < typename T >
+void volume_view< T >::fill(const typename remove_const< T >::type& value) const {
+    for (size_t i = 0; i < size(); i++) {
+        _data[i] = value;
+    }
+}
+
+
+
+template < typename T >
+T* volume_view< T >::begin() const {
+    return _data;
+}
+
+
+
+template < typename T >
+T* volume_view< T >::end() const {
+    return _data + size();
+}
+
+/// @endcond
+//------------------------------------------------------------------------------
+
+}  // namespace std
+
+#endif  // STORAGE_INCLUDE_STORAGE_VIEW_HPP_
@@ -4,10 +4,14 @@
 #include <vector>
 #include <iostream>
 #include <utility>
+#include <algorithm>
+#include <iterator>
 #include <random>
 #include <ctime>
 // #include "matrix.hpp"
 #include <storage/subset.hpp>
+#include <storage/view.hpp>
+#include <storage/parallel.hpp>
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helper classes
@@ -23,21 +27,26 @@ template <typename T>
 class volume {
 
 protected:
-	int nLayers,nRows,nCols;
-	vector<T> data;
+	size_t nLayers,nRows,nCols;
+	vector<T> _data;
+
+	// cache-blocked copy of _in (shape _dims) into _out, w/ axes reordered (cf. permute())
+	static void permuteBlocked(const T* _in, T* _out, const size_t* _dims, const vector<size_t>& _axes, work_stealing_pool& _pool);
+	static bool isPermutation(const vector<size_t>& _axes);
 
 public:
 	// value type typedef
 	typedef T value_type; // alternative: typename std::remove_reference_t<decltype(std::declval<std::volume<T>>()[0])>
 
 	// basic constructors 
+	// storage is allocated once, with no spare capacity (cf. reserve() for incremental growth)
 	volume();						   	
-	volume(int _layers, int _rows, int _cols);
-	volume(int _layers, int _rows, int _cols, const T& _val); // allows implicitely cast types
+	volume(size_t _layers, size_t _rows, size_t _cols);
+	volume(size_t _layers, size_t _rows, size_t _cols, const T& _val); // allows implicitely cast types
 
 	// templated constructors
 	template <typename iT> volume(const vector<vector<vector<iT>>>& _in);
-	template <typename iT, typename = typename enable_if<is_generic_container<iT>()>::type> volume(int _rows, int _cols, int _layers, const iT& _in);  	// from generic container (e.g. volume, volume subset, vector, etc)
+	template <typename iT, typename = typename enable_if<is_generic_container<iT>()>::type> volume(size_t _rows, size_t _cols, size_t _layers, const iT& _in);  	// from generic container (e.g. volume, volume subset, vector, etc)
 
 	// destructor
 	~volume();	
@@ -49,92 +58,128 @@ public:
 	template <typename iT> volume<T>& operator=(const iT& _in);
 
 	// element-wise accessors/modifiers (operator () overloads)
-	T& 			operator()(int _l, int _r, int _c); 
-	const T& 	operator()(int _l, int _r, int _c) const; 
-	T& 			operator[](int _id);     
-	const T& 	operator[](int _id) const; 
+	T& 			operator()(size_t _l, size_t _r, size_t _c); 
+	const T& 	operator()(size_t _l, size_t _r, size_t _c) const; 
+	T& 			operator[](size_t _id);     
+	const T& 	operator[](size_t _id) const; 
 
 	// bulk accessors/modifiers (operator [] overloads)
-	volume_subset<T> 	   operator[](const vector<int>& _idx);
-	volume_subset_const<T> operator[](const vector<int>& _idx) const;
+	volume_subset<T> 	   operator[](const vector<size_t>& _idx);
+	volume_subset_const<T> operator[](const vector<size_t>& _idx) const;
 	volume_subset<T> 	   operator[](volume_subset<T>&& _sbst);  
 	volume_subset_const<T> operator[](volume_subset<T>&& _sbst) const; 
 
 	// access to inner vector object (read-only)
 	const vector<T>& data_vector() 	const;
 
+	// access to raw (contiguous, layer-major) storage
+	T* 			data();
+	const T* 	data() const;
+
 	// size assessment
 	size_t rows() 	const;
 	size_t cols() 	const;
 	size_t layers() const;
 	size_t size() 	const;
 	vector<size_t> dim() 	  const;
-	vector<size_t> pos(int i) const;
+	vector<size_t> pos(size_t i) const;
+	vector<size_t> shape() 	  const;  	// alias to dim(), for compatibility with nd-container checks (cf. type_check.hpp)
+	vector<size_t> position(size_t i) const; // alias to pos(), for compatibility with std::matrix subset constructor
+	size_t index(size_t _l, size_t _r, size_t _c) const; // flat index of element @ (_l, _r, _c)
+
+	// capacity control
+	// no spare capacity is allocated by default; reserve() should be called before incremental growth (e.g. pushLayer())
+	void reserve(size_t _layers, size_t _rows, size_t _cols);
+	size_t capacity() const;
+	void shrink_to_fit();
 
 	// content assessment 
 	bool isCubic()  const;
 	bool isEmpty() 	const; 
 
 	// segment index identifiers
-	vector<int> allID() 	  			const; 	   
-	vector<int> rowID(int _l, int _r) 	const;  
-	vector<int> colID(int _l, int _c) 	const;  
-	vector<int> towID(int _r, int _c) 	const;  
-	vector<int> diagID(int _l) 			const; 
-	vector<int> layerID(int _l) 		const;  
-	vector<int> rowLayerID(int _r) 		const;  
-	vector<int> colLayerID(int _c) 		const;  
-	vector<int> layerBlockID(int _l, int _first_row, int _last_row, int _first_col, int _last_col) 	const;  
-	vector<int> rowBlockID(int _r, int _first_lay, int _last_lay, int _first_col, int _last_col) 	const;  
-	vector<int> colBlockID(int _c, int _first_lay, int _last_lay, int _first_row, int _last_row) 	const;  
-	vector<int> cubeID(int _first_lay, int _last_lay, int _first_row, int _last_row, int _first_col, int _last_col) const;  
+	vector<size_t> allID() 	  			const; 	   
+	vector<size_t> rowID(size_t _l, size_t _r) 	const;  
+	vector<size_t> colID(size_t _l, size_t _c) 	const;  
+	vector<size_t> towID(size_t _r, size_t _c) 	const;  
+	vector<size_t> diagID(size_t _l) 			const; 
+	vector<size_t> layerID(size_t _l) 		const;  
+	vector<size_t> rowLayerID(size_t _r) 		const;  
+	vector<size_t> colLayerID(size_t _c) 		const;  
+	vector<size_t> layerBlockID(size_t _l, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) 	const;  
+	vector<size_t> rowBlockID(size_t _r, size_t _first_lay, size_t _last_lay, size_t _first_col, size_t _last_col) 	const;  
+	vector<size_t> colBlockID(size_t _c, size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row) 	const;  
+	vector<size_t> cubeID(size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) const;  
 
 	//segment acessors/modifiers
 	volume_subset<T> 		all();
 	volume_subset_const<T>	all() const;
-	volume_subset<T> 		row(int _l, int _r);
-	volume_subset_const<T>	row(int _l, int _r) const;
-	volume_subset<T> 		col(int _l, int _c);
-	volume_subset_const<T>	col(int _l, int _c) const;
-	volume_subset<T> 		tow(int _r, int _c);
-	volume_subset_const<T>	tow(int _r, int _c) const;
-	volume_subset<T> 		diag(int _l);
-	volume_subset_const<T>	diag(int _l) const;
-	volume_subset<T> 		layer(int _l);
-	volume_subset_const<T>	layer(int _l) const;
-	volume_subset<T> 		rowLayer(int _r);
-	volume_subset_const<T>	rowLayer(int _r) const;
-	volume_subset<T> 		colLayer(int _c);
-	volume_subset_const<T>	colLayer(int _c) const;
-	volume_subset<T> 		layerBlock(int _l, int _first_row, int _last_row, int _first_col, int _last_col);
-	volume_subset_const<T>	layerBlock(int _l, int _first_row, int _last_row, int _first_col, int _last_col) const;
-	volume_subset<T> 		rowBlock(int _r, int _first_lay, int _last_lay, int _first_col, int _last_col);
-	volume_subset_const<T>	rowBlock(int _r, int _first_lay, int _last_lay, int _first_col, int _last_col) const;
-	volume_subset<T> 		colBlock(int _c, int _first_lay, int _last_lay, int _first_row, int _last_row);
-	volume_subset_const<T>	colBlock(int _c, int _first_lay, int _last_lay, int _first_row, int _last_row) const;
-	volume_subset<T> 		cube(int _first_lay, int _last_lay, int _first_row, int _last_row, int _first_col, int _last_col);
-	volume_subset_const<T>	cube(int _first_lay, int _last_lay, int _first_row, int _last_row, int _first_col, int _last_col) const;
+	volume_subset<T> 		row(size_t _l, size_t _r);
+	volume_subset_const<T>	row(size_t _l, size_t _r) const;
+	volume_subset<T> 		col(size_t _l, size_t _c);
+	volume_subset_const<T>	col(size_t _l, size_t _c) const;
+	volume_subset<T> 		tow(size_t _r, size_t _c);
+	volume_subset_const<T>	tow(size_t _r, size_t _c) const;
+	volume_subset<T> 		diag(size_t _l);
+	volume_subset_const<T>	diag(size_t _l) const;
+	volume_subset<T> 		layer(size_t _l);
+	volume_subset_const<T>	layer(size_t _l) const;
+	volume_subset<T> 		rowLayer(size_t _r);
+	volume_subset_const<T>	rowLayer(size_t _r) const;
+	volume_subset<T> 		colLayer(size_t _c);
+	volume_subset_const<T>	colLayer(size_t _c) const;
+	volume_subset<T> 		layerBlock(size_t _l, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col);
+	volume_subset_const<T>	layerBlock(size_t _l, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) const;
+	volume_subset<T> 		rowBlock(size_t _r, size_t _first_lay, size_t _last_lay, size_t _first_col, size_t _last_col);
+	volume_subset_const<T>	rowBlock(size_t _r, size_t _first_lay, size_t _last_lay, size_t _first_col, size_t _last_col) const;
+	volume_subset<T> 		colBlock(size_t _c, size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row);
+	volume_subset_const<T>	colBlock(size_t _c, size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row) const;
+	volume_subset<T> 		cube(size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col);
+	volume_subset_const<T>	cube(size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) const;
+
+	// zero-copy (non-owning) views over contiguous storage, cf. view.hpp
+	// layers [_first_lay, _last_lay) are contiguous, thus no index vector is built (unlike layer()/cube())
+	// views are invalidated by any operation reallocating storage (push*/delete*/reshape/resize)
+	volume_view<T> 			view();
+	volume_view<const T> 	view() const;
+	matrix_view<T> 			layer_view(size_t _l);
+	matrix_view<const T> 	layer_view(size_t _l) const;
+	volume_view<T> 			slab(size_t _first_lay, size_t _last_lay);
+	volume_view<const T> 	slab(size_t _first_lay, size_t _last_lay) const;
 
 	// template <typename iT, typename = typename conditional<is_nd_container<iT>()>::type> void pushRow(const iT& _in);
 
 	// bulk data modifiers 
 	template <typename iT> void setData(const iT& _in);
-	template <typename iT, typename=typename enable_if< is_nd_container<iT>()>::type> void pushRow(const iT& _in);
-	template <typename iT, typename=typename enable_if<!is_nd_container<iT>()>::type, typename = void> void pushRow(const iT& _in);
-	template <typename iT, typename=typename enable_if< is_nd_container<iT>()>::type> void pushCol(const iT& _in);
-	template <typename iT, typename=typename enable_if<!is_nd_container<iT>()>::type, typename = void> void pushCol(const iT& _in);
-	template <typename iT, typename=typename enable_if< is_nd_container<iT>()>::type> void pushLayer(const iT& _in);
-	template <typename iT, typename=typename enable_if<!is_nd_container<iT>()>::type, typename = void> void pushLayer(const iT& _in);
+	template <typename iT> void pushRow(const iT& _in);
+	template <typename iT> void pushCol(const iT& _in);
+	template <typename iT> void pushLayer(const iT& _in); // amortized O(1) per element
 	void popRow();
 	void popCol();
 	void popLayer();
-	void deleteRow(int _r);
-	void deleteCol(int _c);
-	void deleteLayer(int _l);
-	void reshape(int _new_layers, int _new_rows, int _new_cols);
-	void resize(int _new_rows, int _new_cols, int _new_layers);
+	void deleteRow(size_t _r);
+	void deleteCol(size_t _c);
+	void deleteLayer(size_t _l);
+	void reshape(size_t _new_layers, size_t _new_rows, size_t _new_cols);
+
+	// axis-generic modifiers, storage is rebuilt in a single pass
+	// _axis: 0 (layers), 1 (rows) or 2 (cols)
+	// _slab holds one or more slices along _axis, spanning the full extent of remaining axes, laid out as a sub-volume (layer-major)
+	// if volume is empty, remaining dimensions are taken from _slab.shape() (nd containers) or, otherwise, set to 1 x _slab.size()
+	// insertion/removal along layers is done in place, and appending layers grows storage geometrically (amortized O(1) per element)
+	template <typename iT> void insert(size_t _axis, size_t _pos, const iT& _slab);
+	void erase(size_t _axis, size_t _first, size_t _last);
+	void resize(size_t _new_rows, size_t _new_cols, size_t _new_layers);
 	void clear();	
 
+	// axis permutation (generalized transpose): output axis i is input axis _axes[i]
+	// e.g. permute({2,1,0}) turns (layers, rows, cols) into (cols, rows, layers), making each (row, col) series contiguous
+	// permute() is out-of-place, cache-blocked (3D tiles) and multithreaded
+	// permuteInPlace() requires no second copy of the volume: (0,2,1) transposes each layer through a per-thread layer buffer,
+	// other permutations follow cycles (sequential, 1 bit of extra memory per moved unit; whole rows are moved when cols stay last)
+	volume<T>  permute(const vector<size_t>& _axes, work_stealing_pool& _pool = work_stealing_pool::instance()) const;
+	volume<T>& permuteInPlace(const vector<size_t>& _axes, work_stealing_pool& _pool = work_stealing_pool::instance());
+
 	//iterator members (advanced vector access, and range-based for (:) loops)
 	//wrappers for STL std::vector iterators and const_iterators
 	typename vector<T>::iterator begin();
@@ -149,30 +194,18 @@ public:
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // CONSTRUCTORS
 template <typename T> 
-volume<T>::volume() { 
-	data  = vector<T> (0); 
-	nRows = 0;
-	nCols = 0;
-	nLayers = 0;
-	data.reserve(10*10*10); //assumed required vector size for faster resizing and pushing 
+volume<T>::volume() : nLayers(0), nRows(0), nCols(0) { 
+	/* no storage allocated until required */
 };
 template <typename T> 
-volume<T>::volume(int _layers, int _rows, int _cols) {
+volume<T>::volume(size_t _layers, size_t _rows, size_t _cols) : nLayers(_layers), nRows(_rows), nCols(_cols) {
 	assert(_rows>0 && _cols>0 && _layers>0);
-	for (int i = 0; i < _rows*_cols*_layers; ++i) data.push_back(static_cast<T> (NULL));
-	nRows=_rows;
-	nCols=_cols;
-	nLayers=_layers;
-	data.reserve(2*nRows*nCols*nLayers); 
+	_data.assign(_layers*_rows*_cols, static_cast<T> (NULL)); // single allocation
 };
 template <typename T> 
-volume<T>::volume(int _layers, int _rows, int _cols, const T& _val){
+volume<T>::volume(size_t _layers, size_t _rows, size_t _cols, const T& _val) : nLayers(_layers), nRows(_rows), nCols(_cols) {
 	assert(_rows>0 && _cols>0 && _layers>0);
-	for (int i = 0; i < _rows*_cols*_layers; ++i) data.push_back(_val);
-	nRows=_rows;
-	nCols=_cols;
-	nLayers=_layers;
-	data.reserve(2*nRows*nCols*nLayers); 
+	_data.assign(_layers*_rows*_cols, _val); // single allocation
 };
 template <typename T> 
 template <typename iT> 
@@ -180,32 +213,28 @@ volume<T>::volume(const vector<vector<vector<iT>>>& _in){
 	nLayers = _in.size();
 	nRows   = 0;
 	nCols 	= 0;
-	for (int l = 0; l < nLayers; ++l) {
+	for (size_t l = 0; l < nLayers; ++l) {
 		if (_in[l].size() > nRows) nRows = _in[l].size();
-		for (int r = 0; r < nRows; ++r)	{
+		for (size_t r = 0; r < _in[l].size(); ++r)	{
 			if (_in[l][r].size() > nCols) nCols = _in[l][r].size();
 		}
 	}
-	data  = vector<T> (nLayers*nRows*nCols); 
-	for (int l = 0; l < nLayers; ++l){
-		for (int r = 0; r < nRows; ++r) {
-			for (int c = 0; c < nCols; ++c) if (c<_in[l][r].size()) (*this)(l,r,c) = static_cast<T>(_in[l][r][c]);
+	_data.assign(nLayers*nRows*nCols, T()); 
+	for (size_t l = 0; l < nLayers; ++l){
+		for (size_t r = 0; r < _in[l].size(); ++r) {
+			T* dst = &_data[index(l,r,0)];
+			for (size_t c = 0; c < _in[l][r].size(); ++c) dst[c] = static_cast<T>(_in[l][r][c]);
 		}
 	}
-	data.reserve(2*nRows*nCols*nLayers); 
 };
 template <typename T> 
 template <typename iT, typename> 
-volume<T>::volume(int _rows, int _cols, int _layers, const iT& _in){ 
+volume<T>::volume(size_t _rows, size_t _cols, size_t _layers, const iT& _in) : nLayers(_layers), nRows(_rows), nCols(_cols) { 
 	static_assert(is_generic_container<iT>(), "");
 	assert(_rows>0 && _cols>0 && _layers>0);
 	assert(_in.size() >= _rows*_cols*_layers); 
-	nRows 	= _rows;
-	nCols 	= _cols;
-	nLayers = _layers;
-	data  	=  std::vector<T> (0); 
-	for (int i = 0; i < _rows*_cols*_layers; ++i) data.push_back(static_cast<T>(_in[i]));
-	data.reserve(2*_rows*_cols*_layers);
+	_data.resize(_rows*_cols*_layers); // single allocation
+	for (size_t i = 0; i < _data.size(); ++i) _data[i] = static_cast<T>(_in[i]);
 };
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // DESTRUCTOR
@@ -217,8 +246,8 @@ volume<T>::~volume(){
 // INDIRECTION OPERATOR
 template <typename T>
 T& volume<T>::operator*(){
-	assert(data.size() > 0);
-	return data[0];
+	assert(_data.size() > 0);
+	return _data[0];
 };
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ASSIGNMENT OPERATOR
@@ -226,40 +255,40 @@ template <typename T>
 template <typename iT> 
 volume<T>& volume<T>::operator=(const iT& _in){ 
 	static_assert(is_generic_container<iT>(), "");
-	assert(_in.size() >= data.size());
-	for (int i = 0; i < data.size(); ++i) data[i] = static_cast<T>(_in[i]); 
+	assert(_in.size() >= _data.size());
+	for (size_t i = 0; i < _data.size(); ++i) _data[i] = static_cast<T>(_in[i]); 
 	return *this;	
 };
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ELEMENT ACCESSORS AND MODIFIERS
 template <typename T> 
-T& volume<T>::operator()(int _l, int _r, int _c) {
-	assert(_l>=0 && _l<nLayers && _r>=0 && _r<nRows && _c>=0 && _c<nCols);
- 	return data[_l*(nRows*nCols)+_r*nCols+_c];
+T& volume<T>::operator()(size_t _l, size_t _r, size_t _c) {
+	assert(_l<nLayers && _r<nRows && _c<nCols);
+ 	return _data[index(_l,_r,_c)];
 };
 template <typename T> 
-const T& volume<T>::operator()(int _l, int _r, int _c) const {
-	assert(_l>=0 && _l<nLayers && _r>=0 && _r<nRows && _c>=0 && _c<nCols);
- 	return data[_l*(nRows*nCols)+_r*nCols+_c];
+const T& volume<T>::operator()(size_t _l, size_t _r, size_t _c) const {
+	assert(_l<nLayers && _r<nRows && _c<nCols);
+ 	return _data[index(_l,_r,_c)];
 };
 template <typename T> 
-T& volume<T>::operator[](int _id) {
-	assert(_id < data.size()); 
- 	return data[_id];
+T& volume<T>::operator[](size_t _id) {
+	assert(_id < _data.size()); 
+ 	return _data[_id];
 };
 template <typename T> 
-const T& volume<T>::operator[](int _id) const {
-	assert(_id < data.size()); 
- 	return data[_id];
+const T& volume<T>::operator[](size_t _id) const {
+	assert(_id < _data.size()); 
+ 	return _data[_id];
 };
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // BULK ACCESSORS AND MODIFIERS
 template <typename T>
-volume_subset<T> volume<T>::operator[](const std::vector<int>& _idx) {
+volume_subset<T> volume<T>::operator[](const std::vector<size_t>& _idx) {
 	return volume_subset<T>(this,_idx); // container_subset constructor asserts index validity
 };
 template <typename T>
-volume_subset_const<T> volume<T>::operator[](const std::vector<int>& _idx) const {
+volume_subset_const<T> volume<T>::operator[](const std::vector<size_t>& _idx) const {
 	return volume_subset_const<T>(this,_idx); // container_subset constructor asserts index validity
 };
 template <typename T>
@@ -276,7 +305,15 @@ volume_subset_const<T> volume<T>::operator[](volume_subset<T>&& _sbst) const {
 // INNER DATA VECTOR ACCESSOR
 template <typename T> 
 const vector<T>& volume<T>::data_vector() const {
-	return data;
+	return _data;
+};
+template <typename T> 
+T* volume<T>::data() {
+	return _data.data();
+};
+template <typename T> 
+const T* volume<T>::data() const {
+	return _data.data();
 };
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // SIZE ASSESSMENT MEMBERS 
@@ -294,24 +331,44 @@ size_t volume<T>::layers() const{
 };
 template <typename T> 
 size_t volume<T>::size() const{ 
-	return data.size(); 
+	return _data.size(); 
 };
 template <typename T> 
 vector<size_t> volume<T>::dim() const{ 
 	return vector<size_t>({nLayers,nRows,nCols}); 
 };
 template <typename T> 
-vector<size_t> volume<T>::pos(int _i) const{
-	vector<size_t> dims = dim();
-	vector<size_t> ind(3);
-	int comp = _i;
-	for (int i = 0; i <= 3; i++){
-		int dim_sz = 1;
-		for (int j = i+1; j < 3; j++) dim_sz*=dims[j];
-		while (comp-dim_sz>=0) { ind[i]++; comp-=dim_sz; }
-	}
-	return ind;
+vector<size_t> volume<T>::pos(size_t _i) const{
+	assert(_i < _data.size());
+	size_t layer_sz = nRows*nCols;
+	return vector<size_t>({_i/layer_sz, (_i%layer_sz)/nCols, _i%nCols});
 }; 
+template <typename T> 
+vector<size_t> volume<T>::shape() const{ 
+	return dim(); 
+};
+template <typename T> 
+vector<size_t> volume<T>::position(size_t _i) const{ 
+	return pos(_i); 
+};
+template <typename T> 
+size_t volume<T>::index(size_t _l, size_t _r, size_t _c) const{ 
+	return (_l*nRows + _r)*nCols + _c;  // size_t arithmetic, valid beyond 2^31 elements
+};
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// CAPACITY CONTROL
+template <typename T> 
+void volume<T>::reserve(size_t _layers, size_t _rows, size_t _cols){ 
+	_data.reserve(_layers*_rows*_cols); 
+};
+template <typename T> 
+size_t volume<T>::capacity() const{ 
+	return _data.capacity(); 
+};
+template <typename T> 
+void volume<T>::shrink_to_fit(){ 
+	_data.shrink_to_fit(); 
+};
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // COMPARISON/VALUE ASSESSMENT MEMBERS
 template <typename T> 
@@ -325,110 +382,109 @@ bool volume<T>::isEmpty() const{
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // INDEX ACCESSORS
 template <typename T> 
-vector<int> volume<T>::allID() const {  
-	int i = 0;
-	vector<int> ids(0);
-	for (auto& val : data) ids.push_back(i++);
+vector<size_t> volume<T>::allID() const {  
+	vector<size_t> ids(_data.size());
+	for (size_t i = 0; i < ids.size(); i++) ids[i] = i;
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::rowID(int _l, int _r) const {  
-	assert(_r>=0 && _r < nRows);
-	assert(_l>=0 && _l < nLayers);
-	vector<int> ids (0);
-	for (int c = 0; c < nCols; c++) ids.push_back(_l*(nRows*nCols) + _r*nCols + c);
+vector<size_t> volume<T>::rowID(size_t _l, size_t _r) const {  
+	assert(_r < nRows);
+	assert(_l < nLayers);
+	vector<size_t> ids (0);
+	for (size_t c = 0; c < nCols; c++) ids.push_back(_l*(nRows*nCols) + _r*nCols + c);
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::colID(int _l, int _c) const {  
-	assert(_c>=0 && _c < nCols);
-	assert(_l>=0 && _l < nLayers);
-	vector<int> ids (0); 
-	for (int r = 0; r < nRows; r++) ids.push_back(_l*(nRows*nCols) + r*nCols + _c);
+vector<size_t> volume<T>::colID(size_t _l, size_t _c) const {  
+	assert(_c < nCols);
+	assert(_l < nLayers);
+	vector<size_t> ids (0); 
+	for (size_t r = 0; r < nRows; r++) ids.push_back(_l*(nRows*nCols) + r*nCols + _c);
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::towID(int _r, int _c) const {  
-	assert(_r>=0 && _r < nRows);
-	assert(_c>=0 && _c < nCols);
-	vector<int> ids (0); 
-	for (int l = 0; l < nLayers; l++) ids.push_back(l*(nRows*nCols) + _r*nCols + _c);
+vector<size_t> volume<T>::towID(size_t _r, size_t _c) const {  
+	assert(_r < nRows);
+	assert(_c < nCols);
+	vector<size_t> ids (0); 
+	for (size_t l = 0; l < nLayers; l++) ids.push_back(l*(nRows*nCols) + _r*nCols + _c);
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::diagID(int _l) const{ 
-	assert(_l>=0 && _l < nLayers);
-	vector<int> ids(0); 
-	for (int r = 0; r < nRows; r++) ids.push_back(_l*(nRows*nCols) + r*(nCols+1));
+vector<size_t> volume<T>::diagID(size_t _l) const{ 
+	assert(_l < nLayers);
+	vector<size_t> ids(0); 
+	for (size_t r = 0; r < nRows; r++) ids.push_back(_l*(nRows*nCols) + r*(nCols+1));
 	return ids;
 }; 
 template <typename T> 
-vector<int> volume<T>::layerID(int _l) const {  
-	assert(_l>=0 && _l < nLayers);
-	vector<int> ids(0);
-	for (int i = 0; i < (nRows*nCols); i++) ids.push_back(_l*(nRows*nCols) + i);
+vector<size_t> volume<T>::layerID(size_t _l) const {  
+	assert(_l < nLayers);
+	vector<size_t> ids(0);
+	for (size_t i = 0; i < (nRows*nCols); i++) ids.push_back(_l*(nRows*nCols) + i);
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::rowLayerID(int _r) const {  
-	assert(_r>=0 && _r < nRows);
-	vector<int> ids(0);
-	for (int l = 0; l < nLayers; l++) {
-		for (int c = 0; c < nCols; c++) ids.push_back(l*(nRows*nCols) + _r*(nCols) + c);
+vector<size_t> volume<T>::rowLayerID(size_t _r) const {  
+	assert(_r < nRows);
+	vector<size_t> ids(0);
+	for (size_t l = 0; l < nLayers; l++) {
+		for (size_t c = 0; c < nCols; c++) ids.push_back(l*(nRows*nCols) + _r*(nCols) + c);
 	}
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::colLayerID(int _c) const {  
-	assert(_c>=0 && _c < nCols);
-	vector<int> ids(0);
-	for (int l = 0; l < nLayers; l++) {
-		for (int r = 0; r < nRows; r++) ids.push_back(l*(nRows*nCols) + r*(nCols) + _c);
+vector<size_t> volume<T>::colLayerID(size_t _c) const {  
+	assert(_c < nCols);
+	vector<size_t> ids(0);
+	for (size_t l = 0; l < nLayers; l++) {
+		for (size_t r = 0; r < nRows; r++) ids.push_back(l*(nRows*nCols) + r*(nCols) + _c);
 	}
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::layerBlockID(int _l, int _first_row, int _last_row, int _first_col, int _last_col) const{  
-	assert(_l>=0 && _l < nLayers);
-	assert(_first_row>=0 && _first_row<_last_row && _last_row<nRows);
-	assert(_first_col>=0 && _first_col<_last_col && _last_col<nCols);
-	vector<int> ids(0);
-	for (int r = _first_row; r < _last_row; ++r) {
-		for (int c = _first_col; c < _last_col; ++c) ids.push_back(_l*(nRows*nCols) + r*nCols + c);
+vector<size_t> volume<T>::layerBlockID(size_t _l, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) const{  
+	assert(_l < nLayers);
+	assert(_first_row<_last_row && _last_row<nRows);
+	assert(_first_col<_last_col && _last_col<nCols);
+	vector<size_t> ids(0);
+	for (size_t r = _first_row; r < _last_row; ++r) {
+		for (size_t c = _first_col; c < _last_col; ++c) ids.push_back(_l*(nRows*nCols) + r*nCols + c);
 	}
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::rowBlockID(int _r, int _first_lay, int _last_lay, int _first_col, int _last_col) const{  
-	assert(_r>=0 && _r < nRows);
-	assert(_first_col>=0 && _first_col<_last_col && _last_col<nCols);
-	assert(_first_lay>=0 && _first_lay<_last_lay && _last_lay<nLayers);
-	vector<int> ids(0);
-	for (int l = _first_lay; l < _last_lay; l++) {
-		for (int c = _first_col; c < _last_col; c++) ids.push_back(l*(nRows*nCols) + _r*nCols + c);
+vector<size_t> volume<T>::rowBlockID(size_t _r, size_t _first_lay, size_t _last_lay, size_t _first_col, size_t _last_col) const{  
+	assert(_r < nRows);
+	assert(_first_col<_last_col && _last_col<nCols);
+	assert(_first_lay<_last_lay && _last_lay<nLayers);
+	vector<size_t> ids(0);
+	for (size_t l = _first_lay; l < _last_lay; l++) {
+		for (size_t c = _first_col; c < _last_col; c++) ids.push_back(l*(nRows*nCols) + _r*nCols + c);
 	}
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::colBlockID(int _c, int _first_lay, int _last_lay, int _first_row, int _last_row) const{  
-	assert(_c>=0 && _c < nCols);
-	assert(_first_row>=0 && _first_row<_last_row && _last_row<nRows);
-	assert(_first_lay>=0 && _first_lay<_last_lay && _last_lay<nLayers);
-	vector<int> ids(0);
-	for (int l = _first_lay; l < _last_lay; l++) {
-		for (int r = _first_row; r < _last_row; ++r) ids.push_back(l*(nRows*nCols) + r*nCols + _c);
+vector<size_t> volume<T>::colBlockID(size_t _c, size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row) const{  
+	assert(_c < nCols);
+	assert(_first_row<_last_row && _last_row<nRows);
+	assert(_first_lay<_last_lay && _last_lay<nLayers);
+	vector<size_t> ids(0);
+	for (size_t l = _first_lay; l < _last_lay; l++) {
+		for (size_t r = _first_row; r < _last_row; ++r) ids.push_back(l*(nRows*nCols) + r*nCols + _c);
 	}
 	return ids;
 };
 template <typename T> 
-vector<int> volume<T>::cubeID(int _first_lay, int _last_lay, int _first_row, int _last_row, int _first_col, int _last_col) const{  
-	assert(_first_row>=0 && _first_row<_last_row && _last_row<nRows);
-	assert(_first_col>=0 && _first_col<_last_col && _last_col<nCols);
-	assert(_first_lay>=0 && _first_lay<_last_lay && _last_lay<nLayers);
-	vector<int> ids(0);
-	for (int l = _first_lay; l < _last_lay; ++l) {
-		for (int r = _first_row; r < _last_row; ++r) {
-			for (int c = _first_col; c < _last_col; ++c) ids.push_back(l*(nRows*nCols) + r*nCols + c);
+vector<size_t> volume<T>::cubeID(size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) const{  
+	assert(_first_row<_last_row && _last_row<nRows);
+	assert(_first_col<_last_col && _last_col<nCols);
+	assert(_first_lay<_last_lay && _last_lay<nLayers);
+	vector<size_t> ids(0);
+	for (size_t l = _first_lay; l < _last_lay; ++l) {
+		for (size_t r = _first_row; r < _last_row; ++r) {
+			for (size_t c = _first_col; c < _last_col; ++c) ids.push_back(l*(nRows*nCols) + r*nCols + c);
 		}
 	}
 	return ids;
@@ -444,304 +500,386 @@ volume_subset_const<T> volume<T>::all() const{
 	return volume_subset_const<T>(this,allID());
 };
 template <typename T>
-volume_subset<T> volume<T>::row(int _l, int _r){
+volume_subset<T> volume<T>::row(size_t _l, size_t _r){
 	return volume_subset<T>(this,rowID(_l,_r));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::row(int _l, int _r) const{
+volume_subset_const<T> volume<T>::row(size_t _l, size_t _r) const{
 	return volume_subset_const<T>(this,rowID(_l,_r));
 };
 template <typename T>
-volume_subset<T> volume<T>::col(int _l, int _c){
+volume_subset<T> volume<T>::col(size_t _l, size_t _c){
 	return volume_subset<T>(this,colID(_l,_c));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::col(int _l, int _c) const{
+volume_subset_const<T> volume<T>::col(size_t _l, size_t _c) const{
 	return volume_subset_const<T>(this,colID(_l,_c));
 };
 template <typename T>
-volume_subset<T> volume<T>::tow(int _r, int _c){
+volume_subset<T> volume<T>::tow(size_t _r, size_t _c){
 	return volume_subset<T>(this,towID(_r,_c));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::tow(int _r, int _c) const{
+volume_subset_const<T> volume<T>::tow(size_t _r, size_t _c) const{
 	return volume_subset_const<T>(this,towID(_r,_c));
 };
 template <typename T>
-volume_subset<T> volume<T>::diag(int _l){
+volume_subset<T> volume<T>::diag(size_t _l){
 	return volume_subset<T>(this,diagID(_l));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::diag(int _l) const{
+volume_subset_const<T> volume<T>::diag(size_t _l) const{
 	return volume_subset_const<T>(this,diagID(_l));
 };
 template <typename T>
-volume_subset<T> volume<T>::layer(int _l){
+volume_subset<T> volume<T>::layer(size_t _l){
 	return volume_subset<T>(this,layerID(_l));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::layer(int _l) const{
+volume_subset_const<T> volume<T>::layer(size_t _l) const{
 	return volume_subset_const<T>(this,layerID(_l));
 };
 template <typename T>
-volume_subset<T> volume<T>::rowLayer(int _r){
+volume_subset<T> volume<T>::rowLayer(size_t _r){
 	return volume_subset<T>(this,rowLayerID(_r));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::rowLayer(int _r) const{
+volume_subset_const<T> volume<T>::rowLayer(size_t _r) const{
 	return volume_subset_const<T>(this,rowLayerID(_r));
 };
 template <typename T>
-volume_subset<T> volume<T>::colLayer(int _c){
+volume_subset<T> volume<T>::colLayer(size_t _c){
 	return volume_subset<T>(this,colLayerID(_c));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::colLayer(int _c) const{
+volume_subset_const<T> volume<T>::colLayer(size_t _c) const{
 	return volume_subset_const<T>(this,colLayerID(_c));
 };
 template <typename T>
-volume_subset<T> volume<T>::layerBlock(int _l, int _first_row, int _last_row, int _first_col, int _last_col){
+volume_subset<T> volume<T>::layerBlock(size_t _l, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col){
 	return volume_subset<T>(this,layerBlockID(_l,_first_row,_last_row,_first_col,_last_col));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::layerBlock(int _l, int _first_row, int _last_row, int _first_col, int _last_col) const{
+volume_subset_const<T> volume<T>::layerBlock(size_t _l, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) const{
 	return volume_subset_const<T>(this,layerBlockID(_l,_first_row,_last_row,_first_col,_last_col));
 };
 template <typename T>
-volume_subset<T> volume<T>::rowBlock(int _r, int _first_lay, int _last_lay, int _first_col, int _last_col){
+volume_subset<T> volume<T>::rowBlock(size_t _r, size_t _first_lay, size_t _last_lay, size_t _first_col, size_t _last_col){
 	return volume_subset<T>(this,rowBlockID(_r,_first_lay,_last_lay,_first_col,_last_col));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::rowBlock(int _r, int _first_lay, int _last_lay, int _first_col, int _last_col) const{
+volume_subset_const<T> volume<T>::rowBlock(size_t _r, size_t _first_lay, size_t _last_lay, size_t _first_col, size_t _last_col) const{
 	return volume_subset_const<T>(this,rowBlockID(_r,_first_lay,_last_lay,_first_col,_last_col));
 };
 template <typename T>
-volume_subset<T> volume<T>::colBlock(int _c, int _first_lay, int _last_lay, int _first_row, int _last_row){
+volume_subset<T> volume<T>::colBlock(size_t _c, size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row){
 	return volume_subset<T>(this,colBlockID(_c,_first_lay,_last_lay,_first_row,_last_row));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::colBlock(int _c, int _first_lay, int _last_lay, int _first_row, int _last_row) const{
+volume_subset_const<T> volume<T>::colBlock(size_t _c, size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row) const{
 	return volume_subset_const<T>(this,colBlockID(_c,_first_lay,_last_lay,_first_row,_last_row));
 };
 template <typename T>
-volume_subset<T> volume<T>::cube(int _first_lay, int _last_lay, int _first_row, int _last_row, int _first_col, int _last_col){
+volume_subset<T> volume<T>::cube(size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col){
 	return volume_subset<T>(this,cubeID(_first_lay,_last_lay,_first_row,_last_row,_first_col,_last_col));
 }; 
 template <typename T>
-volume_subset_const<T> volume<T>::cube(int _first_lay, int _last_lay, int _first_row, int _last_row, int _first_col, int _last_col) const{
+volume_subset_const<T> volume<T>::cube(size_t _first_lay, size_t _last_lay, size_t _first_row, size_t _last_row, size_t _first_col, size_t _last_col) const{
 	return volume_subset_const<T>(this,cubeID(_first_lay,_last_lay,_first_row,_last_row,_first_col,_last_col));
 };
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// VIEW ACCESSORS (NO COPY)
+template <typename T>
+volume_view<T> volume<T>::view(){
+	return volume_view<T>(_data.data(),nLayers,nRows,nCols);
+};
+template <typename T>
+volume_view<const T> volume<T>::view() const{
+	return volume_view<const T>(_data.data(),nLayers,nRows,nCols);
+};
+template <typename T>
+matrix_view<T> volume<T>::layer_view(size_t _l){
+	assert(_l < nLayers);
+	return matrix_view<T>(_data.data()+index(_l,0,0),nRows,nCols);
+};
+template <typename T>
+matrix_view<const T> volume<T>::layer_view(size_t _l) const{
+	assert(_l < nLayers);
+	return matrix_view<const T>(_data.data()+index(_l,0,0),nRows,nCols);
+};
+template <typename T>
+volume_view<T> volume<T>::slab(size_t _first_lay, size_t _last_lay){
+	assert(_first_lay<=_last_lay && _last_lay<=nLayers);
+	return volume_view<T>(_data.data()+index(_first_lay,0,0),_last_lay-_first_lay,nRows,nCols);
+};
+template <typename T>
+volume_view<const T> volume<T>::slab(size_t _first_lay, size_t _last_lay) const{
+	assert(_first_lay<=_last_lay && _last_lay<=nLayers);
+	return volume_view<const T>(_data.data()+index(_first_lay,0,0),_last_lay-_first_lay,nRows,nCols);
+};
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // MODIFIERS
 template <typename T>
 template <typename iT>  
 void volume<T>::setData(const iT& _in) { 
 	static_assert(is_generic_container<iT>(), "");
-	assert(_in.size() >= data.size());
-	for (int i = 0; i < data.size(); ++i) data[i] = _in[i]; // 
+	assert(_in.size() >= _data.size());
+	for (size_t i = 0; i < _data.size(); ++i) _data[i] = _in[i]; // 
 };
 template <typename T> 
-template <typename iT, typename>  
-void volume<T>::pushRow(const iT& _in){
-	static_assert(is_nd_container<iT>(), "");
-	if (!nLayers && !nCols){
-		vector<size_t> dims = _in.dim();
-		assert (dims.size() == 2);
-		nLayers = dims[0];
-		nCols 	= dims[1];
-	} else assert(_in.size() >= nLayers*nCols);
-	for (int l = nLayers-1; l>=0; l--) { 
-		// add new row to each layer 
-		// storage is row-major, range insert can be used
-		data.insert(data.begin()+(l+1)*(nRows*nCols),_in.begin()+l*nCols,_in.begin()+l*nCols+nCols );
-	}
-	nRows++;
-}
-template <typename T> 
-template <typename iT, typename, typename>  
+template <typename iT>  
 void volume<T>::pushRow(const iT& _in){
-	static_assert(is_generic_container<iT>(), "");
-	if (!nLayers && !nCols) {
-		nLayers = 1;
-		nCols 	= _in.size();
-	} else assert(_in.size() >= nLayers*nCols);
-	for (int l = nLayers-1; l>=0; l--) { 
-		// add new row to each layer
-		// storage is row-major, range insert can be used
-		data.insert(data.begin()+(l+1)*(nRows*nCols),_in.begin()+l*nCols,_in.begin()+l*nCols+nCols );
-	}
-	nRows++;
-}
-template <typename T> 
-template <typename iT, typename>  
-void volume<T>::pushCol(const iT& _in){
-	static_assert(is_nd_container<iT>(), "");
-	if (!nLayers && !nRows){
-		vector<size_t> dims = _in.dim();
-		assert (dims.size() == 2);
-		nLayers = dims[0];
-		nRows 	= dims[1];
-	} 
-	assert(_in.size() >= nLayers*nRows);
-	for (int l=nLayers-1; l>=0; l--){ //add new col to each layer
-		for (int r=nRows-1; r>=0; r--) data.insert(data.begin()+(l*(nRows*nCols) + r*nCols + (nCols)),_in[r*nLayers+l]); //bulk insert possible?
-	}
-	nCols++;
+	insert(1, nRows, _in);
 }
 template <typename T> 
-template <typename iT, typename,typename>  
+template <typename iT>  
 void volume<T>::pushCol(const iT& _in){
-	static_assert(is_generic_container<iT>(), "");
-	if (!nLayers && !nRows){
-		nLayers = 1;
-		nRows 	= _in.size();
-	} 
-	assert(_in.size() >= nLayers*nRows);
-	for (int l=nLayers-1; l>=0; l--){ //add new col to each layer
-		for (int r=nRows-1; r>=0; r--) data.insert(data.begin()+(l*(nRows*nCols) + r*nCols + (nCols)),_in[r*nLayers+l]); //bulk insert possible?
-	}
-	nCols++;
-}
-template <typename T> 
-template <typename iT, typename>  
-void volume<T>::pushLayer(const iT& _in){
-	static_assert(is_nd_container<iT>(), "");
-	if (!nRows && !nCols){
-		vector<size_t> dims = _in.dim();
-		assert (dims.size() == 2);
-		nRows = dims[0];
-		nCols = dims[1];
-	}
-	assert(_in.size() >= nRows*nCols);
-	for (int i = 0; i < nRows*nCols; ++i) data.push_back(_in[i]);
-	nLayers++;
+	insert(2, nCols, _in);
 }
 template <typename T> 
-template <typename iT, typename, typename>  
+template <typename iT>  
 void volume<T>::pushLayer(const iT& _in){
-	static_assert(is_generic_container<iT>(), "");
-	if (!nRows && !nCols){
-		nRows = 1;
-		nCols = _in.size();
-	}
-	assert(_in.size() >= nRows*nCols);
-	for (int i = 0; i < nRows*nCols; ++i) data.push_back(_in[i]);
-	nLayers++;
+	insert(0, nLayers, _in);
 }
 template <typename T> 
 void volume<T>::popRow(){
 	assert(nRows > 0);
-	if (nRows==1){
-		clear();
-	} else {
-		for (int l = 0; l < nLayers; ++l) {
-			for (int c = (nCols-1); c >= 0 ; ++c) data.erase(data.begin()+(l*(nRows*nCols) + (nRows-1)*nCols + c));
-		}
-	nRows--;
-	}
+	erase(1, nRows-1, nRows);
 }
 template <typename T> 
 void volume<T>::popCol(){
 	assert(nCols > 0);
-	if (nCols==1){
-		clear();
-	} else {
-		for (int l = 0; l < nLayers; ++l){
-			for (int r = (nRows-1); r >= 0; ++r) data.erase(data.begin()+(l*(nRows*nCols) + r*nCols + (nCols-1)));
-		}
-		nCols--;
-	}	
+	erase(2, nCols-1, nCols);
 }
 template <typename T> 
 void volume<T>::popLayer(){
 	assert(nLayers > 0);
-	if (nLayers==1) {
-		clear();
-	} else {
-		data.resize(nRows*nCols*(nLayers-1));
-		nLayers--;
-	}	
+	erase(0, nLayers-1, nLayers);
 }
 template <typename T> 
-void volume<T>::deleteRow(int _r){
-	assert(_r>=0 && _r < nRows);
-	if (nRows==1) {
-		clear();
-	} else {
-		for (int l = 0; l < nLayers; ++l) {
-			for (int c = (nCols-1); c >= 0 ; ++c) data.erase(data.begin()+(l*(nRows*nCols) + _r*nCols + c));
-		}
-		nRows--;
-	}	
+void volume<T>::deleteRow(size_t _r){
+	erase(1, _r, _r+1);
 }
 template <typename T> 
-void volume<T>::deleteCol(int _c){
-	assert(_c>=0 && _c < nCols);
-	if (nCols==1) {
-		clear();
+void volume<T>::deleteCol(size_t _c){
+	erase(2, _c, _c+1);
+}
+template <typename T> 
+void volume<T>::deleteLayer(size_t _l){
+	erase(0, _l, _l+1);
+}
+template <typename T> 
+void volume<T>::reshape(size_t _new_layers, size_t _new_rows, size_t _new_cols){
+	// overlapping elements are kept in place, new elements are zero-initialized (single pass, cf. resize())
+	if (!_new_rows || !_new_cols || !_new_layers) {
+		clear(); 
+		return;
+	}
+	resize(_new_rows, _new_cols, _new_layers);
+};
+template <typename T> 
+template <typename iT>  
+void volume<T>::insert(size_t _axis, size_t _pos, const iT& _slab){
+	static_assert(is_generic_container<iT>(), "");
+	assert(_axis < 3);
+	size_t dims[3] = {nLayers, nRows, nCols};
+	if (isEmpty()) {
+		// take remaining dimensions from input
+		size_t face[2] = {1, _slab.size()};
+		if constexpr (is_nd_container<iT>()) {
+			vector<size_t> shp = _slab.shape();
+			if (shp.size() == 3) {
+				face[0] = shp[_axis == 0 ? 1 : 0];
+				face[1] = shp[_axis == 2 ? 1 : 2];
+			} else if (shp.size() == 2) {
+				face[0] = shp[0];
+				face[1] = shp[1];
+			}
+		}
+		if (!face[0] || !face[1]) return;
+		for (size_t a = 0, f = 0; a < 3; a++) dims[a] = (a == _axis) ? 0 : face[f++];
+		_pos = 0;
+	}
+	assert(_pos <= dims[_axis]);
+	// storage seen as [outer][extent][inner] blocks, split along _axis
+	size_t outer = 1, inner = 1;
+	for (size_t a = 0; a < _axis; a++) outer *= dims[a];
+	for (size_t a = _axis+1; a < 3; a++) inner *= dims[a];
+	assert(_slab.size() % (outer*inner) == 0);
+	size_t count  = _slab.size() / (outer*inner);   // number of inserted slices
+	size_t extent = dims[_axis];
+	if (!count) return;
+	if (_axis == 0) {
+		// in place; geometric growth when reallocation is required (explicit reserve() calls are still honoured)
+		size_t old_sz = _data.size();
+		size_t new_sz = old_sz + _slab.size();
+		if (new_sz > _data.capacity()) _data.reserve(max(new_sz, 2*_data.capacity()));
+		_data.resize(new_sz);
+		std::move_backward(_data.begin()+_pos*inner, _data.begin()+old_sz, _data.end());
+		T* dst = _data.data()+_pos*inner;
+		for (size_t i = 0; i < _slab.size(); ++i) dst[i] = static_cast<T>(_slab[i]);
 	} else {
-		for (int l = 0; l < nLayers; ++l){
-			for (int r = (nRows-1); r >= 0; ++r) data.erase(data.begin()+(l*(nRows*nCols) + r*nCols + _c));
+		vector<T> tmp_data;
+		tmp_data.reserve(_data.size() + _slab.size());
+		size_t in_blk  = count*inner;
+		for (size_t o = 0; o < outer; ++o) {
+			auto src = _data.begin() + o*extent*inner;
+			tmp_data.insert(tmp_data.end(), std::make_move_iterator(src), std::make_move_iterator(src + _pos*inner));
+			for (size_t i = o*in_blk; i < (o+1)*in_blk; ++i) tmp_data.push_back(static_cast<T>(_slab[i]));
+			tmp_data.insert(tmp_data.end(), std::make_move_iterator(src + _pos*inner), std::make_move_iterator(src + extent*inner));
 		}
-		nCols--;	
-	}	
+		_data.swap(tmp_data);
+	}
+	dims[_axis] += count;
+	nLayers = dims[0];
+	nRows   = dims[1];
+	nCols   = dims[2];
 }
 template <typename T> 
-void volume<T>::deleteLayer(int _l){
-	assert(_l>=0 && _l < nLayers);
-	if (nLayers==1) {
+void volume<T>::erase(size_t _axis, size_t _first, size_t _last){
+	assert(_axis < 3);
+	size_t dims[3] = {nLayers, nRows, nCols};
+	assert(_first <= _last && _last <= dims[_axis]);
+	if (_first == _last) return;
+	if (_last - _first == dims[_axis]) {
 		clear();
+		return;
+	}
+	size_t outer = 1, inner = 1;
+	for (size_t a = 0; a < _axis; a++) outer *= dims[a];
+	for (size_t a = _axis+1; a < 3; a++) inner *= dims[a];
+	size_t extent = dims[_axis];
+	if (_axis == 0) {
+		_data.erase(_data.begin()+_first*inner, _data.begin()+_last*inner);
 	} else {
-		data.erase(data.begin()+_l*(nRows*nCols),data.begin()+(_l+1)*(nRows*nCols));
-		nLayers--;
-	}	
+		// in-place forward compaction (destination never overtakes source), no reallocation
+		auto dst = _data.begin();
+		for (size_t o = 0; o < outer; ++o) {
+			auto src = _data.begin() + o*extent*inner;
+			dst = std::move(src, src + _first*inner, dst);
+			dst = std::move(src + _last*inner, src + extent*inner, dst);
+		}
+		_data.erase(dst, _data.end());
+	}
+	dims[_axis] -= (_last - _first);
+	nLayers = dims[0];
+	nRows   = dims[1];
+	nCols   = dims[2];
 }
 template <typename T> 
-void volume<T>::reshape(int _new_layers, int _new_rows, int _new_cols){
-	assert(_new_rows>=0 && _new_cols>=0 && _new_layers>=0);
-	if (!_new_rows || !_new_cols || !_new_layers) clear(); 
-	//match cols
-	while (nCols>_new_cols) popCol();
-	while (nCols<_new_cols) pushCol(vector<T> (nLayers*nRows, static_cast<T> (NULL)));
-	// printf("matched cols %lu -> %lu [%lu]\n",nCols,_new_cols,data.size());
-	//match rows
-	while (nRows>_new_rows) popRow();
-	while (nRows<_new_rows) pushRow(vector<T> (nLayers*nCols, static_cast<T> (NULL)));
-	// printf("matched rows %lu -> %lu [%lu,%lu,%lu]\n",nRows,_new_rows,nLayers,nRows,nCols);
-	//match layers	static_cast<T> (NULL)
-	while (nLayers>_new_layers) popLayer();
-	while (nLayers<_new_layers) pushLayer(vector<T> (nRows*nCols, static_cast<T> (NULL)));
-	// data.resize(_new_rows*_new_cols*_new_layers);
-	// nLayers=_new_layers;
-};
-template <typename T> 
-void volume<T>::resize(int _new_rows, int _new_cols, int _new_layers){
+void volume<T>::resize(size_t _new_rows, size_t _new_cols, size_t _new_layers){
 	if (!_new_layers || !_new_rows || !_new_cols) clear();
 	if (_new_layers<1 || _new_rows<1 || _new_cols<1) throw std::string("INVALID INPUT ARGUMENT");
 	if (_new_rows == nRows && _new_cols == nCols){
 		//directly resize data vector
-		if (_new_layers>nLayers) for (int i = nLayers*nRows*nCols; i < _new_layers*nRows*nCols; ++i) data.push_back(0);
-		if (_new_layers<nLayers) data.resize(_new_layers*nRows*nCols);
+		_data.resize(_new_layers*nRows*nCols, static_cast<T>(0)); // single (re)allocation
 		nLayers=_new_layers;
 	} else {
-		std::vector<T> tmp_data = data; //(_new_rows*_new_cols);
-		data.resize(_new_layers*_new_rows*_new_cols);
-		for (int l = 0; l< _new_layers; l++) {
-			for (int r = 0; r < _new_rows; ++r)	{
-				for (int c = 0; c < _new_cols; ++c) {
-					if (l<nLayers && r<nRows && c<nCols) data[l*(_new_rows*_new_cols)+r*_new_cols+c]=(*this)(l,r,c);
-					else data[l*(_new_rows*_new_cols)+r*_new_cols+c] = 0.0;
-				}
+		// copy into newly allocated storage, swapped in place of old one
+		std::vector<T> tmp_data(_new_layers*_new_rows*_new_cols, static_cast<T>(0));
+		size_t n_cols = min(_new_cols, nCols);
+		for (size_t l = 0; l < min(_new_layers, nLayers); l++) {
+			for (size_t r = 0; r < min(_new_rows, nRows); ++r)	{
+				// overlapping row segments are contiguous in both layouts
+				std::move(_data.begin()+index(l,r,0), _data.begin()+index(l,r,0)+n_cols, tmp_data.begin()+(l*_new_rows + r)*_new_cols);
 			}
 		}
+		_data.swap(tmp_data);
 		nLayers=_new_layers;
 		nRows=_new_rows;
 		nCols=_new_cols;
 	}
 };
 template <typename T> 
+bool volume<T>::isPermutation(const vector<size_t>& _axes){
+	return (_axes.size() == 3 && _axes[0] < 3 && _axes[1] < 3 && _axes[2] < 3 && 
+	        _axes[0] != _axes[1] && _axes[1] != _axes[2] && _axes[0] != _axes[2]);
+};
+template <typename T> 
+void volume<T>::permuteBlocked(const T* _in, T* _out, const size_t* _dims, const vector<size_t>& _axes, work_stealing_pool& _pool){
+	// tile edge (elements): one cache line, so that each 2D tile slice spans ~(block^2) cache lines on either side (L1-sized)
+	const size_t block = max<size_t>(8, parallel::cache_line / sizeof(T));
+	const size_t in_stride[3] = {_dims[1]*_dims[2], _dims[2], 1};
+	const size_t out_dims[3]  = {_dims[_axes[0]], _dims[_axes[1]], _dims[_axes[2]]};
+	// input stride along each output axis
+	const size_t stride[3]    = {in_stride[_axes[0]], in_stride[_axes[1]], in_stride[_axes[2]]};
+	size_t tiles[3];
+	for (size_t a = 0; a < 3; a++) tiles[a] = (out_dims[a] + block - 1) / block;
+	// tiles are disjoint output regions, processed in parallel
+	parallel_for(0, tiles[0]*tiles[1]*tiles[2], [&](size_t _first, size_t _last){
+		for (size_t t = _first; t < _last; t++) {
+			size_t b0 = (t / (tiles[1]*tiles[2])) * block;
+			size_t b1 = ((t / tiles[2]) % tiles[1]) * block;
+			size_t b2 = (t % tiles[2]) * block;
+			size_t e0 = min(b0+block, out_dims[0]), e1 = min(b1+block, out_dims[1]), e2 = min(b2+block, out_dims[2]);
+			for (size_t i0 = b0; i0 < e0; i0++) {
+				for (size_t i1 = b1; i1 < e1; i1++) {
+					T* dst = _out + (i0*out_dims[1] + i1)*out_dims[2];
+					const T* src = _in + i0*stride[0] + i1*stride[1];
+					for (size_t i2 = b2; i2 < e2; i2++) dst[i2] = src[i2*stride[2]];
+				}
+			}
+		}
+	}, 1, _pool);
+};
+template <typename T> 
+volume<T> volume<T>::permute(const vector<size_t>& _axes, work_stealing_pool& _pool) const{
+	assert(isPermutation(_axes));
+	volume<T> out;
+	if (isEmpty()) return out;
+	const size_t dims[3] = {nLayers, nRows, nCols};
+	out = volume<T>(dims[_axes[0]], dims[_axes[1]], dims[_axes[2]]);
+	permuteBlocked(_data.data(), out._data.data(), dims, _axes, _pool);
+	return out;
+};
+template <typename T> 
+volume<T>& volume<T>::permuteInPlace(const vector<size_t>& _axes, work_stealing_pool& _pool){
+	assert(isPermutation(_axes));
+	const size_t dims[3] = {nLayers, nRows, nCols};
+	if (isEmpty() || (_axes[0] == 0 && _axes[1] == 1 && _axes[2] == 2)) return *this;
+	if (_axes[0] == 0 && _axes[1] == 2) {
+		// per-layer transpose, through a layer-sized buffer per task
+		const size_t layer_dims[3] = {1, nRows, nCols};
+		const size_t layer_size = nRows*nCols;
+		parallel_for(0, nLayers, [&](size_t _first, size_t _last){
+			vector<T> buffer(layer_size);
+			for (size_t l = _first; l < _last; l++) {
+				T* layer = _data.data() + l*layer_size;
+				permuteBlocked(layer, buffer.data(), layer_dims, _axes, _pool);  // nested call, runs sequentially on calling worker
+				std::copy(buffer.begin(), buffer.end(), layer);
+			}
+		}, 1, _pool);
+	} else {
+		// cycle following over units: whole rows if cols axis stays last, single elements otherwise
+		const size_t unit = (_axes[2] == 2) ? nCols : 1;
+		const size_t udims[3] = {nLayers, nRows, (unit == 1) ? nCols : 1};
+		const size_t out_dims[3] = {udims[_axes[0]], udims[_axes[1]], udims[_axes[2]]};
+		const size_t n_units = _data.size() / unit;
+		vector<bool> visited(n_units, false);
+		vector<T> carry(unit);
+		for (size_t start = 0; start < n_units; start++) {
+			if (visited[start]) continue;
+			std::copy(_data.begin()+start*unit, _data.begin()+(start+1)*unit, carry.begin());
+			size_t src = start;
+			do {
+				// destination of unit @ src (input layout), in output layout
+				size_t in_pos[3] = {src / (udims[1]*udims[2]), (src / udims[2]) % udims[1], src % udims[2]};
+				size_t dst = (in_pos[_axes[0]]*out_dims[1] + in_pos[_axes[1]])*out_dims[2] + in_pos[_axes[2]];
+				auto it = _data.begin()+dst*unit;
+				std::swap_ranges(carry.begin(), carry.end(), it);
+				visited[dst] = true;
+				src = dst;
+			} while (src != start);
+		}
+	}
+	nLayers = dims[_axes[0]];
+	nRows   = dims[_axes[1]];
+	nCols   = dims[_axes[2]];
+	return *this;
+};
+template <typename T> 
 void volume<T>::clear() {
-	data.resize(0);
+	_data.resize(0);
 	nRows = 0;
 	nCols = 0;
 	nLayers = 0;
@@ -751,44 +889,41 @@ void volume<T>::clear() {
 // ITERATORS
 template <typename T> 
 typename vector<T>::iterator volume<T>::begin() {
-	return data.begin();
+	return _data.begin();
 };
 template <typename T> 
 typename vector<T>::iterator volume<T>::end() {
-	return data.end();
+	return _data.end();
 };
 template <typename T> 
 typename vector<T>::const_iterator volume<T>::begin() const {
-	return data.begin();
+	return _data.begin();
 };
 template <typename T> 
 typename vector<T>::const_iterator volume<T>::end() const {
-	return data.end();
+	return _data.end();
 };
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // CAST OPERATOR OVERLOADS
 template <typename T> 
 template <typename oT>
 volume<T>::operator volume<oT>(){
-	return volume<oT> (nRows,nCols,nLayers,std::vector<oT>(data.begin(),data.end()));  
+	return volume<oT> (nRows,nCols,nLayers,_data);  // element-wise cast, no intermediate copy  
 };
 template <typename T> 
 template <typename oT>
 volume<T>::operator const volume<oT>() const {
-	return volume<oT> (nRows,nCols,nLayers,std::vector<oT>(data.begin(),data.end()));  
+	return volume<oT> (nRows,nCols,nLayers,_data);  // element-wise cast, no intermediate copy  
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // COMPARISON OPERATORS (NON-MEMBERS)
 // negation(!) operator is defined by default
 template <typename T, typename _inputT> 
 inline bool operator==(const volume<T>& _vol, const volume<_inputT>& _input_vol){ 
-	if (_vol.rows() != _input_vol.rows() || _vol.cols() != _input_vol.cols()) return false;
-	for (int r = 0; r < _vol.rows(); ++r){
-		for (int c=0; c < _vol.cols(); ++c){
-			for (int l=0; l < _vol.layers(); ++l){
-				if (_vol(l,r,c)!=_input_vol(l,r,c)) return false;
-			}
-		}	
+	if (_vol.layers() != _input_vol.layers() || _vol.rows() != _input_vol.rows() || _vol.cols() != _input_vol.cols()) return false;
+	// same shape, storage can be traversed linearly
+	for (size_t i = 0; i < _vol.size(); ++i){
+		if (_vol[i]!=_input_vol[i]) return false;
 	}
 	return true;
 };
@@ -798,7 +933,7 @@ inline bool operator!=(const volume<T>& _vol, const volume<_inputT>& _input_vol)
 };
 template <typename T, typename _inputT> 
 inline bool operator< (const volume<T>& _vol, const volume<_inputT>& _input_vol){ 
-	return (_vol.length() < _input_vol.length());
+	return (_vol.size() < _input_vol.size());
 };
 template <typename T, typename _inputT> 
 inline bool operator> (const volume<T>& _vol, const volume<_inputT>& _input_vol){
@@ -0,0 +1,392 @@
+//------------------------------------------------------------------------------
+/// @file       work_stealing_pool.hpp
+/// @author     João André
+///
+/// @brief      Header file providing declaration & definition of std::work_stealing_pool, a persistent thread pool for fork-join
+///             execution of a fixed set of indexed tasks.
+///
+/// Each call to run() splits the task index range evenly into one contiguous block per worker. Workers consume their own block
+/// front-to-back (preserving locality of neighbouring tasks) and, once exhausted, steal single tasks from the back of other
+/// workers' blocks. The calling thread participates as worker #0, and run() returns only once all tasks are complete.
+///
+/// Unlike std::basic_executor, no third-party dependency (boost::asio) is required.
+///
+//------------------------------------------------------------------------------
+
+#ifndef CPPUTILS_INCLUDE_CPPUTILS_THREAD_WORKSTEALINGPOOL_HPP_
+#define CPPUTILS_INCLUDE_CPPUTILS_THREAD_WORKSTEALINGPOOL_HPP_
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace std {
+
+//------------------------------------------------------------------------------
+/// @brief      Persistent thread pool executing batches of indexed tasks with work stealing.
+///
+/// @note       Nested or concurrent calls to run() (e.g. from within a task, or from two unrelated threads) do not deadlock:
+///             if the pool is already busy, tasks are executed sequentially on the calling thread.
+///
+class work_stealing_pool {
+ public:
+    //--------------------------------------------------------------------------
+    /// @brief      Constructs a new instance.
+    ///
+    /// @param[in]  workers  Total number of workers, *including* the calling thread. Defaults to the number of hardware threads.
+    ///
+    explicit work_stealing_pool(size_t workers = thread::hardware_concurrency());
+
+    //--------------------------------------------------------------------------
+    /// @brief      Destroys the object. Joins all worker threads.
+    ///
+    ~work_stealing_pool();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Deleted copy constructor (workers are bound to the instance).
+    ///
+    work_stealing_pool(const work_stealing_pool&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Deleted copy assignment operator (workers are bound to the instance).
+    ///
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Get number of workers (including the calling thread).
+    ///
+    size_t size() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Executes *task(idx)* for every idx in [0, *n_tasks*), blocking until all tasks are complete.
+    ///
+    /// @param[in]  n_tasks  Number of tasks.
+    /// @param      task     Callable with signature void(size_t).
+    ///
+    /// @tparam     Task     Callable type.
+    ///
+    /// @throw      Rethrows the first exception thrown by any task; remaining tasks are skipped.
+    ///
+    template < typename Task >
+    void run(size_t n_tasks, Task&& task);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Access shared (process-wide) pool instance, sized to the number of hardware threads.
+    ///
+    static work_stealing_pool& instance();
+
+ protected:
+    //--------------------------------------------------------------------------
+    /// @brief      Task block owned by a single worker. Packs [front, back) into a single atomic word.
+    ///
+    /// @note       Aligned to a cache line, in order to avoid false sharing between workers.
+    ///
+    struct alignas(64) block {
+        atomic< uint64_t > range { 0 };
+    };
+
+    //--------------------------------------------------------------------------
+    /// @brief      Pops a task from the front of the block owned by worker *owner*.
+    ///
+    /// @return     True if a task was claimed (index written into *idx*), false if block is empty.
+    ///
+    bool pop(size_t owner, size_t& idx);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Steals a task from the back of the block owned by worker *victim*.
+    ///
+    /// @return     True if a task was claimed (index written into *idx*), false if block is empty.
+    ///
+    bool steal(size_t victim, size_t& idx);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Consumes own block and steals from other workers until no tasks remain.
+    ///
+    /// @param[in]  id    Worker index.
+    ///
+    void work(size_t id);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Worker thread loop.
+    ///
+    void loop(size_t id);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Type-erased task dispatcher (avoids std::function allocation).
+    ///
+    void (*_invoke)(void*, size_t);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Type-erased pointer to current task callable.
+    ///
+    void* _task;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Per-worker task blocks.
+    ///
+    unique_ptr< block[] > _blocks;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of workers (including calling thread).
+    ///
+    size_t _size;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Worker threads (excluding calling thread).
+    ///
+    vector< thread > _threads;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Serializes batches; concurrent batches run sequentially on the calling thread.
+    ///
+    mutex _batch;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Guards batch start/finish signaling.
+    ///
+    mutex _mutex;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Signals worker threads of a new batch (or shutdown).
+    ///
+    condition_variable _start;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Signals calling thread of workers leaving current batch.
+    ///
+    condition_variable _finish;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Batch counter, incremented on each run().
+    ///
+    size_t _generation;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Number of worker threads still within current batch.
+    ///
+    size_t _busy;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Shutdown flag.
+    ///
+    bool _stop;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Cancellation flag, set when a task throws.
+    ///
+    atomic< bool > _cancel;
+
+    //--------------------------------------------------------------------------
+    /// @brief      First exception thrown within current batch.
+    ///
+    exception_ptr _error;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Flags threads currently executing pool tasks (nested run() calls are serialized).
+    ///
+    static bool& in_worker();
+};
+
+
+
+//--------------------------------------------------------------------------
+/// @cond
+
+inline work_stealing_pool::work_stealing_pool(size_t workers) :
+    _invoke(nullptr),
+    _task(nullptr),
+    _size(workers > 0 ? workers : 1),
+    _generation(0),
+    _busy(0),
+    _stop(false),
+    _cancel(false) {
+        _blocks.reset(new block[_size]);
+        _threads.reserve(_size - 1);
+        for (size_t id = 1; id < _size; id++) {
+            _threads.emplace_back(&work_stealing_pool::loop, this, id);
+        }
+}
+
+
+
+inline work_stealing_pool::~work_stealing_pool() {
+    {
+        lock_guard< mutex > lock(_mutex);
+        _stop = true;
+    }
+    _start.notify_all();
+    for (auto& worker : _threads) {
+        worker.join();
+    }
+}
+
+
+
+inline size_t work_stealing_pool::size() const noexcept {
+    return _size;
+}
+
+
+
+template < typename Task >
+void work_stealing_pool::run(size_t n_tasks, Task&& task) {
+    if (n_tasks == 0) {
+        return;
+    }
+    // sequential fallback: single task, single worker, nested call or pool already in use
+    // @note batch lock is only attempted off worker threads, as nested calls may already hold it
+    auto sequential = [&]() {
+        for (size_t idx = 0; idx < n_tasks; idx++) {
+            task(idx);
+        }
+    };
+    if (n_tasks == 1 || _size == 1 || in_worker()) {
+        sequential();
+        return;
+    }
+    unique_lock< mutex > batch(_batch, try_to_lock);
+    if (!batch.owns_lock()) {
+        sequential();
+        return;
+    }
+    // distribute task range evenly over worker blocks
+    for (size_t id = 0; id < _size; id++) {
+        uint64_t front = (n_tasks * id) / _size;
+        uint64_t back  = (n_tasks * (id + 1)) / _size;
+        _blocks[id].range.store((front << 32) | back, memory_order_relaxed);
+    }
+    using task_type = typename remove_reference< Task >::type;
+    _task   = const_cast< void* >(static_cast< const void* >(&task));
+    _invoke = [](void* callable, size_t idx) { (*static_cast< task_type* >(callable))(idx); };
+    _cancel.store(false, memory_order_relaxed);
+    _error = nullptr;
+    {
+        lock_guard< mutex > lock(_mutex);
+        _busy = _size - 1;
+        _generation++;
+    }
+    _start.notify_all();
+    // calling thread works as worker #0
+    in_worker() = true;
+    work(0);
+    in_worker() = false;
+    // wait for remaining workers to leave batch (task reference must outlive them)
+    {
+        unique_lock< mutex > lock(_mutex);
+        _finish.wait(lock, [this] { return _busy == 0; });
+    }
+    if (_error) {
+        rethrow_exception(_error);
+    }
+}
+
+
+
+inline work_stealing_pool& work_stealing_pool::instance() {
+    static work_stealing_pool pool;
+    return pool;
+}
+
+
+
+inline bool work_stealing_pool::pop(size_t owner, size_t& idx) {
+    auto& range = _blocks[owner].range;
+    uint64_t current = range.load(memory_order_acquire);
+    while (true) {
+        uint64_t front = current >> 32;
+        uint64_t back  = current & 0xFFFFFFFF;
+        if (front >= back) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, ((front + 1) << 32) | back, memory_order_acq_rel)) {
+            idx = front;
+            return true;
+        }
+    }
+}
+
+
+
+inline bool work_stealing_pool::steal(size_t victim, size_t& idx) {
+    auto& range = _blocks[victim].range;
+    uint64_t current = range.load(memory_order_acquire);
+    while (true) {
+        uint64_t front = current >> 32;
+        uint64_t back  = current & 0xFFFFFFFF;
+        if (front >= back) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, (front << 32) | (back - 1), memory_order_acq_rel)) {
+            idx = back - 1;
+            return true;
+        }
+    }
+}
+
+
+
+inline void work_stealing_pool::work(size_t id) {
+    size_t idx = 0;
+    while (!_cancel.load(memory_order_relaxed)) {
+        bool found = pop(id, idx);
+        // own block exhausted, look for work on remaining blocks (starting w/ closest neighbour)
+        for (size_t offset = 1; !found && offset < _size; offset++) {
+            found = steal((id + offset) % _size, idx);
+        }
+        if (!found) {
+            return;
+        }
+        try {
+            _invoke(_task, idx);
+        } catch (...) {
+            lock_guard< mutex > lock(_mutex);
+            if (!_error) {
+                _error = current_exception();
+            }
+            _cancel.store(true, memory_order_relaxed);
+        }
+    }
+}
+
+
+
+inline void work_stealing_pool::loop(size_t id) {
+    in_worker() = true;
+    size_t generation = 0;
+    while (true) {
+        {
+            unique_lock< mutex > lock(_mutex);
+            _start.wait(lock, [&] { return _stop || _generation != generation; });
+            if (_stop) {
+                return;
+            }
+            generation = _generation;
+        }
+        work(id);
+        {
+            lock_guard< mutex > lock(_mutex);
+            _busy--;
+        }
+        _finish.notify_one();
+    }
+}
+
+
+
+inline bool& work_stealing_pool::in_worker() {
+    static thread_local bool flag = false;
+    return flag;
+}
+
+/// @endcond
+
+}  // namespace std
+
+#endif  // CPPUTILS_INCLUDE_CPPUTILS_THREAD_WORKSTEALINGPOOL_HPP_
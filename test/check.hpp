@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+/// @file       check.hpp
+/// @author     João André
+///
+/// @brief      Minimal check macros for unit test executables (independent of NDEBUG, unlike assert).
+///
+//------------------------------------------------------------------------------
+
+#ifndef CPP_UTILS_TEST_CHECK_HPP_
+#define CPP_UTILS_TEST_CHECK_HPP_
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+//------------------------------------------------------------------------------
+/// @brief      Aborts test executable (w/ location) if *condition* does not hold.
+///
+#define CHECK(condition)                                                                                   \
+    do {                                                                                                   \
+        if (!(condition)) {                                                                                \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);             \
+            std::exit(EXIT_FAILURE);                                                                       \
+        }                                                                                                  \
+    } while (0)
+
+//------------------------------------------------------------------------------
+/// @brief      Aborts test executable if |*a* - *b*| exceeds *tolerance*.
+///
+#define CHECK_NEAR(a, b, tolerance)                                                                        \
+    do {                                                                                                   \
+        double _a = static_cast< double >(a);                                                              \
+        double _b = static_cast< double >(b);                                                              \
+        if (!(std::fabs(_a - _b) <= (tolerance))) {                                                        \
+            std::fprintf(stderr, "%s:%d: check failed: %s (%.17g) ~ %s (%.17g)\n", __FILE__, __LINE__, #a, _a, #b, _b); \
+            std::exit(EXIT_FAILURE);                                                                       \
+        }                                                                                                  \
+    } while (0)
+
+#endif  // CPP_UTILS_TEST_CHECK_HPP_
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/// @file       fft.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of FFT plans (storage/fft.hpp) against a naive DFT, and of Welch PSD & fast convolution
+///             (storage/spectral.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include "storage/fft.hpp"
+#include "storage/spectral.hpp"
+#include "check.hpp"
+
+//------------------------------------------------------------------------------
+/// @brief      Naive (long double) DFT of *x*.
+///
+std::vector< std::complex< double > > dft(const std::vector< std::complex< double > >& x) {
+    const long double pi = 3.141592653589793238462643383279502884L;
+    size_t n = x.size();
+    std::vector< std::complex< double > > out(n);
+    for (size_t k = 0; k < n; k++) {
+        std::complex< long double > sum = 0.0L;
+        for (size_t j = 0; j < n; j++) {
+            long double angle = -2.0L * pi * static_cast< long double >((k * j) % n) / n;
+            sum += std::complex< long double >(x[j].real(), x[j].imag()) * std::complex< long double >(std::cos(angle), std::sin(angle));
+        }
+        out[k] = std::complex< double >(static_cast< double >(sum.real()), static_cast< double >(sum.imag()));
+    }
+    return out;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Maximum absolute difference of *a* & *b*.
+///
+template < typename A, typename B >
+double difference(const A& a, const B& b) {
+    double error = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        error = std::max(error, static_cast< double >(std::abs(a[i] - b[i])));
+    }
+    return error;
+}
+
+int main() {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution< double > uniform(-1.0, 1.0);
+
+    // powers of two, primes (generic butterflies & Bluestein) and mixed radices
+    for (size_t n : { 1, 2, 4, 8, 64, 256, 3, 5, 7, 13, 31, 37, 97, 131, 6, 12, 30, 45, 100, 360, 1000 }) {
+        std::vector< std::complex< double > > x(n);
+        std::vector< double > real(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = std::complex< double >(uniform(generator), uniform(generator));
+            real[i] = x[i].real();
+        }
+        double tolerance = 1e-12 * std::max< double >(1.0, n);
+        auto expected = dft(x);
+        auto transformed = std::fft::forward(x);
+        CHECK(difference(transformed, expected) < tolerance);
+        CHECK(difference(std::fft::inverse(transformed), x) < tolerance);
+
+        // real transform: first n / 2 + 1 bins of the complex transform, and round trip
+        std::vector< std::complex< double > > promoted(real.begin(), real.end());
+        auto full = dft(promoted);
+        auto bins = std::fft::rfft(real);
+        CHECK(bins.size() == n / 2 + 1);
+        CHECK(difference(bins, std::vector< std::complex< double > >(full.begin(), full.begin() + bins.size())) < tolerance);
+        CHECK(difference(std::fft::irfft(bins, n), real) < tolerance);
+
+        // batched (column-wise) transform matches single transforms
+        std::matrix< std::complex< double > > columns(n, 3);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < 3; j++) {
+                columns(i, j) = x[i] * static_cast< double >(j + 1);
+            }
+        }
+        std::fft::forward(std::matrix_view< std::complex< double > >(columns.data(), n, 3));
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < 3; j++) {
+                CHECK(std::abs(columns(i, j) - transformed[i] * static_cast< double >(j + 1)) < 3.0 * tolerance);
+            }
+        }
+    }
+
+    // Welch PSD: peak @ sinusoid frequency, total power equals signal power (periodic Hann, one-sided density)
+    double rate = 1000.0;
+    std::vector< double > signal(8000);
+    for (size_t i = 0; i < signal.size(); i++) {
+        signal[i] = std::sqrt(2.0) * std::sin(2.0 * 3.14159265358979323846 * 125.0 * i / rate);
+    }
+    auto psd = std::spectral::welch(signal, rate, 256);
+    size_t peak = 0;
+    for (size_t k = 0; k < psd.frequencies.size(); k++) {
+        peak = (psd.power(k, 0) > psd.power(peak, 0)) ? k : peak;
+    }
+    CHECK_NEAR(psd.frequencies[peak], 125.0, 1e-9);
+    CHECK_NEAR(std::spectral::band_power(psd, 0.0, rate / 2)[0], 1.0, 1e-2);
+
+    // fast convolution matches direct evaluation
+    std::vector< double > a(300);
+    std::vector< double > b(90);
+    for (auto& v : a) {
+        v = uniform(generator);
+    }
+    for (auto& v : b) {
+        v = uniform(generator);
+    }
+    auto c = std::spectral::convolve(a, b);
+    CHECK(c.size() == a.size() + b.size() - 1);
+    for (size_t n = 0; n < c.size(); n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < a.size(); k++) {
+            if (n >= k && n - k < b.size()) {
+                sum += a[k] * b[n - k];
+            }
+        }
+        CHECK_NEAR(c[n], sum, 1e-10);
+    }
+    return 0;
+}
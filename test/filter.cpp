@@ -0,0 +1,45 @@
+//------------------------------------------------------------------------------
+/// @file       filter.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of zero-phase filtering edge handling (storage/filter.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+#include "storage/filter.hpp"
+#include "check.hpp"
+
+int main() {
+    std::filtering::iir< double > lowpass(std::filtering::butterworth(4, 10.0, 100.0));
+    size_t pad = lowpass.padding();
+
+    // inputs not longer than padding are rejected (odd extension would be truncated)
+    bool thrown = false;
+    try {
+        std::filtering::filtfilt(lowpass, std::vector< double >(pad, 1.0));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(std::filtering::filtfilt(lowpass, std::vector< double >()).empty());
+
+    // shortest accepted input: constant signal passes unchanged (unit DC gain, steady state initialization)
+    auto out = std::filtering::filtfilt(lowpass, std::vector< double >(pad + 1, 2.5));
+    CHECK(out.size() == pad + 1);
+    for (auto v : out) {
+        CHECK_NEAR(v, 2.5, 1e-9);
+    }
+
+    // linear trend is preserved by odd extension (no edge transients)
+    std::vector< double > ramp(200);
+    for (size_t i = 0; i < ramp.size(); i++) {
+        ramp[i] = 0.1 * i;
+    }
+    out = std::filtering::filtfilt(std::filtering::moving_average< double >(5), ramp);
+    CHECK_NEAR(out.front(), ramp.front(), 1e-9);
+    CHECK_NEAR(out.back(), ramp.back(), 1e-9);
+    return 0;
+}
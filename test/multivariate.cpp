@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+/// @file       multivariate.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of covariance, correlation and pairwise distance matrices (storage/multivariate.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "storage/multivariate.hpp"
+#include "check.hpp"
+
+//------------------------------------------------------------------------------
+/// @brief      Maximum error of *c* relative to long double two-pass covariance of *x* (relative to its largest entry).
+///
+double covariance_error(const std::matrix< double >& x, const std::matrix< double >& c) {
+    size_t n = x.rows();
+    size_t d = x.cols();
+    std::vector< long double > mean(d, 0.0L);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < d; j++) {
+            mean[j] += x(i, j);
+        }
+    }
+    for (auto& m : mean) {
+        m /= n;
+    }
+    long double error = 0.0L;
+    long double scale = 0.0L;
+    for (size_t a = 0; a < d; a++) {
+        for (size_t b = 0; b < d; b++) {
+            long double sum = 0.0L;
+            for (size_t i = 0; i < n; i++) {
+                sum += (x(i, a) - mean[a]) * (x(i, b) - mean[b]);
+            }
+            sum /= (n - 1);
+            error = std::max(error, std::fabs(sum - c(a, b)));
+            scale = std::max(scale, std::fabs(sum));
+        }
+    }
+    return static_cast< double >(error / scale);
+}
+
+int main() {
+    std::work_stealing_pool pool(4);
+    std::mt19937 generator(7);
+    std::normal_distribution< double > noise;
+
+    // large offsets (several batches, w/ shifting batch means) must not degrade accuracy
+    for (double offset : { 0.0, 1e6, 1e8 }) {
+        size_t n = 3 * std::multivariate::batch_rows + 123;
+        size_t d = 9;
+        std::matrix< double > x(n, d);
+        for (size_t i = 0; i < n; i++) {
+            double common = noise(generator);
+            for (size_t j = 0; j < d; j++) {
+                x(i, j) = offset + ((i > n / 2) ? 3.0 * j : 0.0) + common * (j % 3) + noise(generator);
+            }
+        }
+        auto c = std::multivariate::covariance(x, 1, pool);
+        CHECK(covariance_error(x, c) < 1e-13);
+        // symmetric & bounded correlation
+        auto r = std::multivariate::correlation(x, pool);
+        for (size_t a = 0; a < d; a++) {
+            CHECK_NEAR(r(a, a), 1.0, 1e-12);
+            for (size_t b = 0; b < d; b++) {
+                CHECK(r(a, b) == r(b, a) && std::fabs(r(a, b)) <= 1.0);
+                CHECK_NEAR(r(a, b), c(a, b) / std::sqrt(c(a, a) * c(b, b)), 1e-12);
+            }
+        }
+        // streaming (uneven batches) & merged accumulators match one-shot result
+        std::multivariate::scatter< double > first(d);
+        std::multivariate::scatter< double > second(d);
+        first.push(std::matrix_view< const double >(x.data(), 1000, d), pool);
+        first.push(std::matrix_view< const double >(x.data() + 1000 * d, 5000, d), pool);
+        second.push(std::matrix_view< const double >(x.data() + 6000 * d, n - 6000, d), pool);
+        first += second;
+        CHECK(first.count() == n);
+        CHECK(covariance_error(x, first.covariance()) < 1e-13);
+        long double mean = 0.0L;
+        for (size_t i = 0; i < n; i++) {
+            mean += x(i, d - 1);
+        }
+        CHECK_NEAR(first.means()[d - 1], mean / n, 1e-12 * std::max(1.0, offset));
+    }
+
+    // pairwise distances vs direct evaluation
+    std::matrix< double > a(150, 70);
+    std::matrix< double > b(40, 70);
+    for (size_t i = 0; i < a.rows() * a.cols(); i++) {
+        a.data()[i] = 100.0 + noise(generator);
+    }
+    for (size_t i = 0; i < b.rows() * b.cols(); i++) {
+        b.data()[i] = 100.0 + noise(generator);
+    }
+    auto self = std::multivariate::pairwise_distances(a, false, pool);
+    auto cross = std::multivariate::pairwise_distances(a, b, false, pool);
+    for (size_t i = 0; i < a.rows(); i++) {
+        CHECK(self(i, i) == 0.0);
+        for (size_t j = 0; j < a.rows(); j++) {
+            double sum = 0.0;
+            for (size_t k = 0; k < a.cols(); k++) {
+                sum += (a(i, k) - a(j, k)) * (a(i, k) - a(j, k));
+            }
+            CHECK_NEAR(self(i, j), std::sqrt(sum), 1e-9);
+        }
+        for (size_t j = 0; j < b.rows(); j++) {
+            double sum = 0.0;
+            for (size_t k = 0; k < a.cols(); k++) {
+                sum += (a(i, k) - b(j, k)) * (a(i, k) - b(j, k));
+            }
+            CHECK_NEAR(cross(i, j), std::sqrt(sum), 1e-9);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+//------------------------------------------------------------------------------
+/// @file       parallel.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of parallel algorithms over storage containers (storage/parallel.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <vector>
+#include <cstddef>
+#include "storage/parallel.hpp"
+#include "check.hpp"
+
+int main() {
+    std::work_stealing_pool pool(4);
+    std::vector< double > twos(100000, 2.0);
+    std::vector< double > negatives(100000, -1.0);
+
+    // homogeneous fold
+    double sum = std::parallel_reduce(twos, 1.0, [](double a, double b) { return a + b; }, 0, pool);
+    CHECK_NEAR(sum, 200001.0, 1e-9);
+
+    // heterogeneous folds (fold & combine differ)
+    double squares = std::parallel_reduce(twos, 0.0, [](double a, double x) { return a + x * x; }, [](double a, double b) { return a + b; }, 0, pool);
+    CHECK_NEAR(squares, 400000.0, 1e-9);
+    size_t count = std::parallel_reduce(negatives, size_t(0), [](size_t n, double x) { return n + (x < 0.0); }, [](size_t a, size_t b) { return a + b; }, 16, pool);
+    CHECK(count == negatives.size());
+
+    // empty input yields identity
+    std::vector< double > empty;
+    CHECK(std::parallel_reduce(empty, size_t(3), [](size_t n, double) { return n + 1; }, [](size_t a, size_t b) { return a + b; }, 0, pool) == 3);
+
+    // nested runs fall back to sequential execution
+    size_t nested = std::parallel_reduce(twos, size_t(0), [&](size_t n, double) {
+        return n + 0 * std::parallel_reduce(std::vector< double >(2, 1.0), 0.0, [](double a, double b) { return a + b; }, 0, pool) + 1;
+    }, [](size_t a, size_t b) { return a + b; }, 0, pool);
+    CHECK(nested == twos.size());
+    return 0;
+}
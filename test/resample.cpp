@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+/// @file       resample.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of resampling plans, splines and polyphase resamplers (storage/resample.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <vector>
+#include "storage/resample.hpp"
+#include "check.hpp"
+
+int main() {
+    using std::resampling::method;
+    const double pi = 3.14159265358979323846;
+
+    // single input sample: constant output, for every method & spline
+    for (auto algorithm : { method::nearest, method::linear, method::cubic }) {
+        std::resampling::plan< double > explicit_base({ 2.0 }, { -1.0, 2.0, 3.5 }, algorithm);
+        for (auto v : explicit_base.apply(std::vector< double >{ 4.0 })) {
+            CHECK(v == 4.0);
+        }
+        std::resampling::plan< double > uniform(1, 5, algorithm);
+        for (auto v : uniform.apply(std::vector< double >{ -1.5 })) {
+            CHECK(v == -1.5);
+        }
+    }
+    std::resampling::spline< double > knot({ 1.0 });
+    knot.fit(std::vector< double >{ 7.0 });
+    CHECK(knot(0.0) == 7.0 && knot(1.0) == 7.0 && knot(3.0) == 7.0);
+
+    // two input samples: cubic reduces to linear interpolation
+    std::resampling::plan< double > pair({ 0.0, 1.0 }, { 0.0, 0.25, 1.0, 2.0 }, method::cubic);
+    auto line = pair.apply(std::vector< double >{ 1.0, 3.0 });
+    CHECK_NEAR(line[1], 1.5, 1e-12);
+    CHECK_NEAR(line[3], 5.0, 1e-12);
+
+    // linear data is reproduced exactly (within range) by linear & natural cubic plans
+    std::vector< double > from(20);
+    std::vector< double > to(57);
+    std::vector< double > y(from.size());
+    for (size_t i = 0; i < from.size(); i++) {
+        from[i] = i + 0.1 * (i % 3);
+        y[i] = 2.0 * from[i] - 1.0;
+    }
+    for (size_t i = 0; i < to.size(); i++) {
+        to[i] = from.back() * i / (to.size() - 1);
+    }
+    for (auto algorithm : { method::linear, method::cubic }) {
+        auto out = std::resampling::plan< double >(from, to, algorithm).apply(y);
+        for (size_t i = 0; i < to.size(); i++) {
+            CHECK_NEAR(out[i], 2.0 * to[i] - 1.0, 1e-9);
+        }
+    }
+
+    // periodic spline of a sine, plan & spline objects agree
+    size_t n = 32;
+    std::vector< double > knots(n);
+    std::vector< double > wave(n);
+    for (size_t i = 0; i < n; i++) {
+        knots[i] = 2.0 * pi * i / n;
+        wave[i] = std::sin(knots[i]);
+    }
+    std::vector< double > points = { -1.0, 0.05, 3.0, 6.2, 9.0 };
+    auto periodic = std::resampling::plan< double >(knots, points, method::cubic, 2.0 * pi).apply(wave);
+    std::resampling::spline< double > fitted(knots, 2.0 * pi);
+    fitted.fit(wave);
+    for (size_t i = 0; i < points.size(); i++) {
+        CHECK_NEAR(periodic[i], std::sin(points[i]), 1e-4);
+        CHECK_NEAR(fitted(points[i]), periodic[i], 1e-12);
+    }
+
+    // streaming polyphase resampling matches one-shot processing
+    std::vector< double > signal(500);
+    for (size_t i = 0; i < signal.size(); i++) {
+        signal[i] = std::sin(0.05 * i) + 0.3 * std::cos(0.31 * i);
+    }
+    std::resampling::polyphase< double > once(3, 2);
+    std::resampling::polyphase< double > blocks(3, 2);
+    auto whole = once.process(signal);
+    std::vector< double > streamed;
+    for (size_t first = 0; first < signal.size(); first += 77) {
+        std::vector< double > block(signal.begin() + first, signal.begin() + std::min(signal.size(), first + 77));
+        auto part = blocks.process(block);
+        streamed.insert(streamed.end(), part.begin(), part.end());
+    }
+    CHECK(streamed.size() == whole.size());
+    for (size_t i = 0; i < whole.size(); i++) {
+        CHECK_NEAR(streamed[i], whole[i], 1e-12);
+    }
+    CHECK(std::resampling::resample(signal, 3, 2).size() == 750);
+    return 0;
+}
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+/// @file       rolling.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of incremental rolling-window aggregators against brute-force windows (storage/rolling.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "storage/rolling.hpp"
+#include "check.hpp"
+
+//------------------------------------------------------------------------------
+/// @brief      Brute-force aggregates of all full windows of *x* (*width* samples, every *step* samples).
+///
+std::vector< std::vector< double > > reference(const std::vector< double >& x, size_t width, size_t step) {
+    std::vector< std::vector< double > > out(6);
+    for (size_t first = 0; first + width <= x.size(); first += step) {
+        std::vector< double > w(x.begin() + first, x.begin() + first + width);
+        double sum = 0.0;
+        for (auto v : w) {
+            sum += v;
+        }
+        double mean = sum / width;
+        double m2 = 0.0;
+        for (auto v : w) {
+            m2 += (v - mean) * (v - mean);
+        }
+        std::sort(w.begin(), w.end());
+        double median = (width % 2) ? w[width / 2] : 0.5 * (w[width / 2 - 1] + w[width / 2]);
+        out[0].push_back(sum);
+        out[1].push_back(mean);
+        out[2].push_back((width > 1) ? m2 / (width - 1) : std::nan(""));
+        out[3].push_back(w.front());
+        out[4].push_back(w.back());
+        out[5].push_back(median);
+    }
+    return out;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Checks *values* against *expected* (NaNs must match).
+///
+void compare(const std::vector< double >& values, const std::vector< double >& expected) {
+    CHECK(values.size() == expected.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        if (std::isnan(expected[i])) {
+            CHECK(std::isnan(values[i]));
+        } else {
+            CHECK_NEAR(values[i], expected[i], 1e-9 * std::max(1.0, std::fabs(expected[i])));
+        }
+    }
+}
+
+int main() {
+    std::mt19937 generator(5);
+    std::uniform_int_distribution< int > small(-3, 3);
+    std::normal_distribution< double > noise(0.0, 1.0);
+    // heavy duplicates (small integers), and continuous values
+    std::vector< double > duplicates(103);
+    std::vector< double > continuous(103);
+    for (size_t i = 0; i < duplicates.size(); i++) {
+        duplicates[i] = small(generator);
+        continuous[i] = 100.0 + noise(generator);
+    }
+    for (auto* x : { &duplicates, &continuous }) {
+        auto& data = *x;
+        // odd & even widths, overlapping & disjoint windows, windows not aligned w/ input end, & wider than input
+        for (size_t width : { 1, 2, 3, 4, 7, 10, 103, 150 }) {
+            for (size_t overlap : { size_t(0), width / 2, width - 1 }) {
+                auto expected = reference(data, width, width - overlap);
+                auto frames = [&]() { return std::range_iterator< std::vector< double > >(&data, 0, width, overlap); };
+                compare(std::rolling::apply(frames(), std::rolling::sum< double >()), expected[0]);
+                compare(std::rolling::apply(frames(), std::rolling::mean< double >()), expected[1]);
+                compare(std::rolling::apply(frames(), std::rolling::variance< double >()), expected[2]);
+                compare(std::rolling::apply(frames(), std::rolling::min< double >()), expected[3]);
+                compare(std::rolling::apply(frames(), std::rolling::max< double >()), expected[4]);
+                compare(std::rolling::apply(frames(), std::rolling::median< double >()), expected[5]);
+            }
+        }
+    }
+    return 0;
+}
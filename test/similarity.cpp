@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+/// @file       similarity.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of DTW band handling in subsequence search (storage/similarity.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "storage/similarity.hpp"
+#include "check.hpp"
+
+int main() {
+    std::mt19937 generator(3);
+    std::normal_distribution< double > noise(0.0, 1.0);
+    std::vector< double > series(400);
+    double level = 0.0;
+    for (auto& v : series) {
+        v = (level += noise(generator));
+    }
+    std::vector< double > query(series.begin() + 150, series.begin() + 190);
+    for (auto& v : query) {
+        v += 0.5 * noise(generator);
+    }
+    std::matrix_view< const double > data(series.data(), series.size(), 1);
+    size_t m = query.size();
+    size_t candidates = series.size() - m + 1;
+    using std::similarity::metric;
+
+    // any band at least as wide as both sequences is unconstrained (no window overflow)
+    std::vector< double > a = { 1.0, 2.0, 3.0 };
+    std::vector< double > b = { 1.0, 2.0, 3.0, 4.0 };
+    for (size_t band : { size_t(3), std::similarity::default_band, std::similarity::unconstrained }) {
+        CHECK_NEAR(std::similarity::dtw(a, b, band), 1.0, 1e-12);
+        CHECK_NEAR(std::similarity::dtw(b, a, band), 1.0, 1e-12);
+    }
+
+    // explicit unconstrained band is honoured (full warping window), default band is 5% of query size
+    auto full = std::similarity::profile(data, 0, query, metric::dtw, false, std::similarity::unconstrained);
+    auto narrow = std::similarity::profile(data, 0, query, metric::dtw, false);
+    CHECK(full.size() == candidates && narrow.size() == candidates);
+    size_t best = 0;
+    for (size_t i = 0; i < candidates; i++) {
+        std::vector< double > candidate(series.begin() + i, series.begin() + i + m);
+        CHECK_NEAR(full[i], std::similarity::dtw(query, candidate, std::similarity::unconstrained), 1e-9);
+        CHECK_NEAR(narrow[i], std::similarity::dtw(query, candidate, m / 20), 1e-9);
+        CHECK(full[i] <= narrow[i] + 1e-9);
+        best = (full[i] < full[best]) ? i : best;
+    }
+    auto found = std::similarity::search(series, query, metric::dtw, false, std::similarity::unconstrained);
+    CHECK(found.offset == best);
+    CHECK_NEAR(found.distance, full[best], 1e-9);
+    return 0;
+}
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+/// @file       sketch.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of fixed-bin histogram edge handling (storage/sketch.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "storage/sketch.hpp"
+#include "check.hpp"
+
+int main() {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution< double > uniform(-1e3, 1e3);
+    std::uniform_int_distribution< size_t > bins(1, 1000);
+
+    // values adjacent to range edges are never rounded across them
+    for (size_t trial = 0; trial < 1000; trial++) {
+        double low = (trial == 0) ? 0.0 : uniform(generator);
+        double high = low + std::fabs(uniform(generator)) + 1e-3;
+        size_t n = bins(generator);
+        std::sketch::histogram< double > h(low, high, n);
+        h.push(std::nextafter(low, -std::numeric_limits< double >::infinity()));
+        CHECK(h.underflow() == 1 && h.count(0) == 0);
+        h.push(low);
+        CHECK(h.count(0) == 1);
+        h.push(std::nextafter(high, low));
+        CHECK(h.count(n - 1) == (n == 1 ? 2 : 1) && h.overflow() == 0);
+        h.push(high);
+        CHECK(h.overflow() == 1);
+    }
+
+    // non-finite values
+    std::sketch::histogram< double > h(0.0, 1.0, 4);
+    h.push(-std::numeric_limits< double >::infinity());
+    h.push(std::numeric_limits< double >::infinity());
+    h.push(std::numeric_limits< double >::quiet_NaN());
+    CHECK(h.underflow() == 1 && h.overflow() == 1 && h.nan() == 1 && h.total() == 2);
+
+    // batch binning matches scalar binning
+    std::vector< float > x(10000);
+    for (auto& v : x) {
+        v = static_cast< float >(uniform(generator) * 1e-3);
+    }
+    std::sketch::histogram< float > batch(-0.5f, 0.5f, 37);
+    std::sketch::histogram< float > scalar(-0.5f, 0.5f, 37);
+    batch.push(x);
+    for (auto v : x) {
+        scalar.push(v);
+    }
+    CHECK(batch.counts() == scalar.counts());
+    CHECK(batch.underflow() == scalar.underflow() && batch.overflow() == scalar.overflow());
+    CHECK(batch.total() == x.size());
+    return 0;
+}
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+/// @file       statistical.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of legacy statistical helpers (storage/statistical.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+#include "storage/statistical.hpp"
+#include "check.hpp"
+
+int main() {
+    // vectorDistance: Euclidean distance, throws on size mismatch
+    std::vector< float > a = { 0.0f, 3.0f, 1.0f };
+    std::vector< float > b = { 4.0f, 0.0f, 1.0f };
+    CHECK_NEAR(std::statistical::vectorDistance(a, b), 5.0, 1e-6);
+    bool thrown = false;
+    try {
+        std::statistical::vectorDistance(a, std::vector< float >(2, 0.0f));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // vectorAverage: pairwise summation, accurate where naive float accumulation drifts
+    std::vector< float > offset(1000000);
+    long double exact = 0.0L;
+    for (size_t i = 0; i < offset.size(); i++) {
+        offset[i] = 1000.0f + static_cast< float >(i % 7) * 0.125f;
+        exact += offset[i];
+    }
+    exact /= offset.size();
+    float avg = 0.0f;
+    CHECK(std::statistical::vectorAverage(avg, offset) == avg);
+    CHECK_NEAR(avg, exact, 1e-3);
+    CHECK_NEAR(std::statistical::average(offset), exact, 1e-3);
+
+    // vectorStdDeviation: population standard deviation, matching moments accumulator & two-pass reference
+    long double squares = 0.0L;
+    for (float value : offset) {
+        squares += (value - exact) * (value - exact);
+    }
+    float sd = 0.0f;
+    CHECK(std::statistical::vectorStdDeviation(sd, offset) == sd);
+    CHECK_NEAR(sd, std::sqrt(squares / offset.size()), 1e-4);
+    CHECK_NEAR(sd, std::stats::accumulate(offset).stddev(), 1e-6);
+    CHECK(std::statistical::vectorStdDeviation(sd, std::vector< float >(10, 3.0f)) == 0.0f);
+
+    // findPeaks: (last) maximum of each region at or above height, at least width samples long
+    std::vector< float > signal = { 0, 5, 7, 6, 0, 0, 9, 0, 0, 4, 8, 8, 5, 0, 8, 6, 8, 7 };
+    std::vector< float > found;
+    CHECK(std::statistical::findPeaks(found, signal, 4, 2) == 0);
+    CHECK(found.size() == 3);
+    CHECK(found[0] == 2.0f && found[1] == 11.0f && found[2] == 16.0f);
+    CHECK(std::statistical::findPeaks(found, signal, 4, 1) == 0);
+    CHECK(found.size() == 4 && found[1] == 6.0f);
+    CHECK(std::statistical::findPeaks(found, std::vector< float >(), 4, 1) == 1);
+
+    // ported (formerly Eigen-based) helpers
+    std::matrix< float > rows(2, 3);
+    for (size_t j = 0; j < 3; j++) {
+        rows(0, j) = 1.0f;
+        rows(1, j) = static_cast< float >(j);
+    }
+    CHECK_NEAR(std::statistical::weighted2DMean(rows, { 0.5f, 2.0f }), 0.5 + 2.0, 1e-6);
+    std::vector< int > folds = std::statistical::kfolds(100, 5);
+    CHECK(folds.size() == 100);
+    for (int label : folds) {
+        CHECK(label >= 0 && label < 5);
+    }
+
+    // reSample: linear resampling w/ aligned endpoints
+    std::vector< float > ramp = { 0.0f, 1.0f, 2.0f, 3.0f };
+    std::vector< float > resampled;
+    CHECK(std::statistical::reSample(ramp, resampled, 7) == 0);
+    CHECK(resampled.size() == 7);
+    for (size_t i = 0; i < resampled.size(); i++) {
+        CHECK_NEAR(resampled[i], 0.5 * i, 1e-6);
+    }
+    CHECK(std::statistical::reSample(ramp, resampled, 4) == 1);
+    return 0;
+}
@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+/// @file       view.cpp
+/// @author     João André
+///
+/// @brief      Unit tests of matrix views & their use w/ std::matrix constructors (storage/view.hpp).
+///
+//------------------------------------------------------------------------------
+
+#include <vector>
+#include "storage/matrix.hpp"
+#include "storage/view.hpp"
+#include "check.hpp"
+
+int main() {
+    std::matrix< double > a(3, 4);
+    for (size_t i = 0; i < a.size(); i++) {
+        a.data()[i] = static_cast< double >(i);
+    }
+
+    // converting constructor keeps view shape
+    std::matrix_view< double > full(a.data(), a.rows(), a.cols());
+    std::matrix< double > copy(full);
+    CHECK(copy.rows() == 3 && copy.cols() == 4);
+    for (size_t i = 0; i < a.size(); i++) {
+        CHECK(copy.data()[i] == a.data()[i]);
+    }
+
+    // read-only row range, converted to another element type
+    std::matrix_view< const double > rows(a.data() + a.cols(), 2, a.cols());
+    std::matrix< float > narrow(rows);
+    CHECK(narrow.rows() == 2 && narrow.cols() == 4);
+    CHECK(narrow(0, 0) == 4.0f && narrow(1, 3) == 11.0f);
+
+    // copies are independent of source storage
+    copy(0, 0) = -1.0;
+    CHECK(a(0, 0) == 0.0);
+
+    // reshaping constructor (generic container)
+    std::matrix< double > reshaped(4, 3, full);
+    CHECK(reshaped(1, 0) == 3.0 && reshaped(3, 2) == 11.0);
+    return 0;
+}